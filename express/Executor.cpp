@@ -15,6 +15,7 @@
 #include "geometry/GeometryComputerUtils.hpp"
 #include <MNN/expr/ExecutorScope.hpp>
 #include "core/Backend.hpp"
+#include "backend/cpu/CPUElementwiseFuse.hpp"
 #include "RuntimeAttr.hpp"
 #include <stack>
 #define DEFAULT_BACKUP_RUNTIME_KEY (std::make_pair(MNN_FORWARD_CPU, 1))
@@ -249,7 +250,7 @@ void Executor::RuntimeManager::setHint(Interpreter::HintMode mode, int value) {
     mInside->modes.setHint(mode, value);
 }
 bool Executor::RuntimeManager::getInfo(Interpreter::SessionInfoCode code, void* ptr) {
-    // Only support get memory
+    // Only support get memory, backends, clone info and memory report
     switch (code) {
         case Interpreter::MEMORY: {
             auto dst     = (float*)ptr;
@@ -268,6 +269,42 @@ bool Executor::RuntimeManager::getInfo(Interpreter::SessionInfoCode code, void*
                 *dst = mInside->mRuntime.first.begin()->first;
             }
         } break;
+        case Interpreter::CLONE_INFO: {
+            auto dst = (float*)ptr;
+            auto statistic = mInside->mCloneStatistic;
+            std::unique_lock<std::mutex> _l(statistic->lock);
+            int liveNumber = 0;
+            float memory = 0.0f;
+            for (auto& iter : statistic->sessions) {
+                auto session = iter.lock();
+                if (nullptr == session) {
+                    continue;
+                }
+                liveNumber++;
+                memory += session->getDynamicMemoryInMB();
+            }
+            dst[0] = liveNumber;
+            dst[1] = statistic->cloneNumber > 0 ? statistic->cloneTimeInMs / statistic->cloneNumber : 0.0f;
+            dst[2] = liveNumber > 0 ? memory / liveNumber : 0.0f;
+            dst[3] = statistic->cloneNumber > 0 ? (float)statistic->rebuildExecutions / statistic->cloneNumber : 0.0f;
+            return true;
+        } break;
+        case Interpreter::MEMORY_REPORT: {
+            auto statistic = mInside->mCloneStatistic;
+            std::unique_lock<std::mutex> _l(statistic->lock);
+            std::vector<std::shared_ptr<Session>> liveSessions;
+            std::vector<const Session*> sessions;
+            for (auto& iter : statistic->allSessions) {
+                auto session = iter.lock();
+                if (nullptr == session) {
+                    continue;
+                }
+                sessions.emplace_back(session.get());
+                liveSessions.emplace_back(std::move(session));
+            }
+            Session::getMemoryReport(mInside->mRuntime, sessions, *(Interpreter::MemoryReport*)ptr);
+            return true;
+        } break;
         default: {
             // Do nothing
         } break;
@@ -277,6 +314,7 @@ bool Executor::RuntimeManager::getInfo(Interpreter::SessionInfoCode code, void*
 
 Executor::RuntimeManager::RuntimeManager() {
     mInside = new RuntimeAttr;
+    mInside->mCloneStatistic.reset(new CloneStatistic);
     // Default set release for better performance
     mInside->modes.callBackMode = Interpreter::Session_Release;
     mInside->modes.inputMode = Interpreter::Session_Input_User;
@@ -456,6 +494,190 @@ ErrorCode Executor::computeInfo(Expr* expr) {
     return NO_ERROR;
 }
 
+static bool _supportElementwiseFuse(const Schedule::OpCacheInfo& info) {
+    if (info.outputs.size() != 1) {
+        return false;
+    }
+    auto op = info.op;
+    auto output = info.outputs[0];
+    auto format = TensorUtils::getDescribe(output)->dimensionFormat;
+    if (output->getType() != halide_type_of<float>() || format == MNN_DATA_FORMAT_NC4HW4 || nullptr != TensorUtils::getDescribe(output)->quantAttr) {
+        return false;
+    }
+    auto size = TensorUtils::getRawSize(output);
+    if (0 == size) {
+        return false;
+    }
+    if (op->type() == OpType_UnaryOp) {
+        if (info.inputs.size() != 1 || nullptr == op->main_as_UnaryOp()) {
+            return false;
+        }
+        switch (op->main_as_UnaryOp()->opType()) {
+            case UnaryOpOperation_ABS:
+            case UnaryOpOperation_NEG:
+            case UnaryOpOperation_SQUARE:
+            case UnaryOpOperation_SQRT:
+            case UnaryOpOperation_RSQRT:
+            case UnaryOpOperation_EXP:
+            case UnaryOpOperation_LOG:
+            case UnaryOpOperation_RECIPROCAL:
+            case UnaryOpOperation_SIGMOID:
+            case UnaryOpOperation_TANH:
+                break;
+            default:
+                return false;
+        }
+    } else if (op->type() == OpType_BinaryOp) {
+        if (info.inputs.size() != 2 || nullptr == op->main_as_BinaryOp() || 0 != op->main_as_BinaryOp()->activationType()) {
+            return false;
+        }
+        switch (op->main_as_BinaryOp()->opType()) {
+            case BinaryOpOperation_ADD:
+            case BinaryOpOperation_SUB:
+            case BinaryOpOperation_MUL:
+            case BinaryOpOperation_REALDIV:
+            case BinaryOpOperation_MINIMUM:
+            case BinaryOpOperation_MAXIMUM:
+            case BinaryOpOperation_SquaredDifference:
+                break;
+            default:
+                return false;
+        }
+    } else {
+        return false;
+    }
+    for (auto input : info.inputs) {
+        auto des = TensorUtils::getDescribe(input);
+        if (input->getType() != halide_type_of<float>() || des->dimensionFormat != format || nullptr != des->quantAttr) {
+            return false;
+        }
+        auto inputSize = TensorUtils::getRawSize(input);
+        if (inputSize != size && inputSize != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Merge the chains of elementwise ops into one ElementwiseFuse op, whose intermediate results needn't write back to memory
+static void _fuseElementwise(std::vector<Schedule::OpCacheInfo>& pipeline, std::vector<std::shared_ptr<BufferStorage>>& opBuffers) {
+    struct FuseGroup {
+        std::vector<CPUElementwiseFuse::Step> steps;
+        std::vector<Tensor*> inputs;
+        std::vector<int> members;
+        int addInput(Tensor* t) {
+            for (int i = 0; i < inputs.size(); ++i) {
+                if (inputs[i] == t) {
+                    return i;
+                }
+            }
+            inputs.emplace_back(t);
+            return (int)inputs.size() - 1;
+        }
+    };
+    std::map<Tensor*, int> useCount;
+    for (auto& info : pipeline) {
+        for (auto t : info.inputs) {
+            useCount[t]++;
+        }
+    }
+    // Key: output of the group's last op
+    std::map<Tensor*, std::shared_ptr<FuseGroup>> groups;
+    for (int i = 0; i < pipeline.size(); ++i) {
+        auto& info = pipeline[i];
+        if (!_supportElementwiseFuse(info)) {
+            continue;
+        }
+        auto size = TensorUtils::getRawSize(info.outputs[0]);
+        std::shared_ptr<FuseGroup> group(new FuseGroup);
+        int src[2] = {0, 0};
+        for (int j = 0; j < info.inputs.size(); ++j) {
+            auto t = info.inputs[j];
+            auto iter = groups.find(t);
+            bool merge = iter != groups.end() && useCount[t] == 1 && TensorUtils::getRawSize(t) == size && TensorUtils::getDescribe(t)->usage != Tensor::InsideDescribe::OUTPUT;
+            if (!merge) {
+                src[j] = group->addInput(t);
+                continue;
+            }
+            auto sub = iter->second;
+            groups.erase(iter);
+            int stepOffset = (int)group->steps.size();
+            auto remap = [&](int s) {
+                if (s >= 0) {
+                    return group->addInput(sub->inputs[s]);
+                }
+                return s - stepOffset;
+            };
+            for (auto step : sub->steps) {
+                step.src0 = remap(step.src0);
+                if (CPUElementwiseFuse::STEP_BINARY == step.kind) {
+                    step.src1 = remap(step.src1);
+                }
+                group->steps.emplace_back(step);
+            }
+            group->members.insert(group->members.end(), sub->members.begin(), sub->members.end());
+            src[j] = -(int)group->steps.size();
+        }
+        CPUElementwiseFuse::Step step;
+        if (info.op->type() == OpType_UnaryOp) {
+            step.kind = CPUElementwiseFuse::STEP_UNARY;
+            step.opType = info.op->main_as_UnaryOp()->opType();
+        } else {
+            step.kind = CPUElementwiseFuse::STEP_BINARY;
+            step.opType = info.op->main_as_BinaryOp()->opType();
+        }
+        step.src0 = src[0];
+        step.src1 = src[1];
+        group->steps.emplace_back(step);
+        group->members.emplace_back(i);
+        groups.insert(std::make_pair(info.outputs[0], group));
+    }
+    std::vector<bool> removed(pipeline.size(), false);
+    bool hasFused = false;
+    for (auto& iter : groups) {
+        auto group = iter.second;
+        if (group->members.size() < 2) {
+            continue;
+        }
+        hasFused = true;
+        std::vector<int32_t> program {(int32_t)group->inputs.size(), (int32_t)group->steps.size()};
+        for (auto& step : group->steps) {
+            program.insert(program.end(), {step.kind, step.opType, step.src0, step.src1});
+        }
+        std::unique_ptr<OpT> op(new OpT);
+        op->type = OpType_Extra;
+        op->main.type = OpParameter_Extra;
+        op->main.value = new ExtraT;
+        auto extra = op->main.AsExtra();
+        extra->type = CPUElementwiseFuse::TYPE;
+        extra->engine = "MNN";
+        extra->info.resize(program.size() * sizeof(int32_t));
+        ::memcpy(extra->info.data(), program.data(), extra->info.size());
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(Op::Pack(builder, op.get()));
+        std::shared_ptr<BufferStorage> storage(new BufferStorage);
+        storage->storage = builder.ReleaseRaw(storage->allocated_size, storage->offset);
+        opBuffers.emplace_back(storage);
+        // Replace the last op by fused op, which is after all inputs computed
+        auto& last = pipeline[group->members.back()];
+        last.op = flatbuffers::GetRoot<Op>(storage->buffer());
+        last.inputs = group->inputs;
+        for (int i = 0; i < group->members.size() - 1; ++i) {
+            removed[group->members[i]] = true;
+        }
+    }
+    if (!hasFused) {
+        return;
+    }
+    std::vector<Schedule::OpCacheInfo> fusedPipeline;
+    for (int i = 0; i < pipeline.size(); ++i) {
+        if (!removed[i]) {
+            fusedPipeline.emplace_back(std::move(pipeline[i]));
+        }
+    }
+    pipeline = std::move(fusedPipeline);
+}
+
 void Executor::_makeCache(const std::vector<EXPRP>& expr, bool forceCPU) {
     std::set<std::shared_ptr<Executor::ComputeCache>> inputCaches;
     std::set<std::shared_ptr<Expr::Inside>> inputNode;
@@ -575,6 +797,10 @@ void Executor::_makeCache(const std::vector<EXPRP>& expr, bool forceCPU) {
         group.callBackMode = Interpreter::Session_Release;
     }
     group.memoryUsageMode = Interpreter::Session_Memory_Cache;
+    bool runOnCPU = forceCPU || current->getAttr()->firstType.first == MNN_FORWARD_CPU;
+    if (0 == (mLazyMode & LAZY_CONTENT) && runOnCPU && group.callBackMode == Interpreter::Session_Release) {
+        _fuseElementwise(pipeline, opBuffers);
+    }
     std::shared_ptr<ComputeCache> cahce(new ComputeCache);
     for (auto& iter : dstExpr) {
         auto expr = iter.first;
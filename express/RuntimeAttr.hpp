@@ -1,5 +1,6 @@
 #ifndef RuntimeAttr_hpp
 #define RuntimeAttr_hpp
+#include <mutex>
 #include "core/Session.hpp"
 namespace MNN{
 namespace Express {
@@ -10,6 +11,16 @@ struct Cache {
     std::string cacheFile;
     size_t lastCacheSize = 0;
 };
+// Statistic of the sessions cloned from the modules loaded by one RuntimeManager, see Interpreter::CLONE_INFO
+struct CloneStatistic {
+    std::mutex lock;
+    std::vector<std::weak_ptr<Session>> sessions;
+    int cloneNumber = 0;
+    float cloneTimeInMs = 0.0f;
+    int rebuildExecutions = 0;
+    // Sessions of the loaded modules and their clones, see Interpreter::MEMORY_REPORT
+    std::vector<std::weak_ptr<Session>> allSessions;
+};
 struct RuntimeAttr {
     Session::ModeGroup modes;
     RuntimeInfo mRuntime;
@@ -21,6 +32,7 @@ struct RuntimeAttr {
     // Use for static module to compute flops
     float mFlops;
     std::string mExternalFile;
+    std::shared_ptr<CloneStatistic> mCloneStatistic;
 };
 struct ExecutorAttr {
     std::shared_ptr<Backend> constantBackend;
@@ -11,6 +11,7 @@
 #include <set>
 #include <stack>
 #include <MNN/expr/ExecutorScope.hpp>
+#include <MNN/expr/Module.hpp>
 #include "MNN_generated.h"
 #include "core/TensorUtils.hpp"
 #include "core/Session.hpp"
@@ -18,6 +19,8 @@
 #include "core/Backend.hpp"
 #include "core/Execution.hpp"
 #include "core/ConvolutionCommon.hpp"
+#include "core/TraceBuffer.hpp"
+#include "RuntimeAttr.hpp"
 
 namespace MNN {
 namespace Express {
@@ -255,6 +258,7 @@ ErrorCode Executor::ComputeCache::compute() {
         } else {
             visited.insert(cache);
             dfsStack.pop();
+            TraceScope _trace("Executor::compute", "express");
             if (debug->after != nullptr && debug->before != nullptr) {
                 code = cache->mSession->runWithCallBack(debug->before, debug->after);
             } else {
@@ -318,6 +322,22 @@ ErrorCode Executor::ComputeCache::resize() {
 int Executor::ComputeCache::gInstanceCount = 0;
 #endif
 
+std::shared_ptr<Executor> Utils::createAsyncExecutor(const Module* module) {
+    if (module->type() == "Net") {
+        auto info = module->getInfo();
+        if (nullptr != info && nullptr != info->runTimeManager && !info->runTimeManager->getInside()->mRuntime.first.empty()) {
+            auto inside = info->runTimeManager->getInside();
+            BackendConfig config;
+            if (inside->mUserConfig) {
+                config = inside->mConfig;
+            }
+            return Executor::newExecutor(inside->mRuntime.first.begin()->first, config, inside->mNumberThread);
+        }
+    }
+    auto attr = ExecutorScope::Current()->getAttr();
+    BackendConfig config;
+    return Executor::newExecutor(attr->firstType.first, config, attr->firstType.second);
+}
 
 } // namespace Express
 } // namespace MNN
@@ -16,6 +16,7 @@
 namespace MNN {
 class Session;
 namespace Express {
+class Module;
 struct Expr::Inside {
     Inside(int outputSize);
     Inside(Tensor* tensor, bool own = false);
@@ -81,6 +82,8 @@ public:
     static bool releaseMemoryForHostTensor(Tensor* dest);
     static Tensor* getTensor(VARP var);
     static EXPRP makeRaster(const std::vector<VARP>& vars, const std::vector<int>& regions, const std::vector<int>& shape, halide_type_t dataType, MNN_DATA_FORMAT format);
+    // Create an Executor for forwarding a clone of module in another thread, with the runtime of the module if it has
+    static std::shared_ptr<Executor> createAsyncExecutor(const Module* module);
 };
 
 } // namespace Express
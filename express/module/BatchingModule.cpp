@@ -0,0 +1,212 @@
+//
+//  BatchingModule.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/13.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/expr/BatchingModule.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "Utils.hpp"
+
+namespace MNN {
+namespace Express {
+
+BatchingModule::BatchingModule(std::shared_ptr<Module> module, const BatchConfig& config) {
+    setType("BatchingModule");
+    mConfig = config;
+    // Neither the Executor nor the runtime is thread-safe, the worker forwards a clone with its own Executor
+    mExecutor = Utils::createAsyncExecutor(module.get());
+    {
+        ExecutorScope scope(mExecutor);
+        mModule.reset(Module::clone(module.get(), true), Module::destroy);
+    }
+    if (nullptr == mModule) {
+        // Can't be cloned, the module is only used by the worker
+        mModule = module;
+    }
+    mWorker = std::thread([this]() {
+        _run();
+    });
+}
+
+BatchingModule::~BatchingModule() {
+    {
+        std::unique_lock<std::mutex> _l(mLock);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    mWorker.join();
+    ExecutorScope scope(mExecutor);
+    mModule.reset();
+}
+
+std::future<std::vector<VARP>> BatchingModule::submit(const std::vector<VARP>& inputs) {
+    std::shared_ptr<Request> request(new Request);
+    request->inputs = inputs;
+    request->batch = -1;
+    request->time = std::chrono::steady_clock::now();
+    // Only the inputs with the same batch at dim 0 can be merged with others
+    for (int i = 0; i < inputs.size(); ++i) {
+        auto info = inputs[i]->getInfo();
+        if (nullptr == info || info->dim.empty()) {
+            request->batch = -1;
+            break;
+        }
+        if (0 == i) {
+            request->batch = info->dim[0];
+        } else if (request->batch != info->dim[0]) {
+            request->batch = -1;
+            break;
+        }
+    }
+    // Compute the inputs in caller thread, the worker only reads them
+    Variable::compute(inputs);
+    auto result = request->result.get_future();
+    {
+        std::unique_lock<std::mutex> _l(mLock);
+        mRequests.emplace_back(request);
+    }
+    mCondition.notify_all();
+    return result;
+}
+
+std::vector<VARP> BatchingModule::onForward(const std::vector<VARP>& inputs) {
+    return submit(inputs).get();
+}
+
+std::future<std::vector<VARP>> BatchingModule::onForwardAsync(const std::vector<VARP>& inputs) {
+    return submit(inputs);
+}
+
+bool BatchingModule::_canMerge(const Request* a, const Request* b) {
+    if (a == b) {
+        return true;
+    }
+    if (a->batch <= 0 || b->batch <= 0 || a->inputs.size() != b->inputs.size()) {
+        return false;
+    }
+    for (int i = 0; i < a->inputs.size(); ++i) {
+        auto infoA = a->inputs[i]->getInfo();
+        auto infoB = b->inputs[i]->getInfo();
+        if (infoA->order != infoB->order || infoA->type != infoB->type || infoA->dim.size() != infoB->dim.size()) {
+            return false;
+        }
+        for (int d = 1; d < infoA->dim.size(); ++d) {
+            if (infoA->dim[d] != infoB->dim[d]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void BatchingModule::_run() {
+    ExecutorScope scope(mExecutor);
+    while (true) {
+        std::vector<std::shared_ptr<Request>> requests;
+        {
+            std::unique_lock<std::mutex> _l(mLock);
+            mCondition.wait(_l, [this]() {
+                return mStop || !mRequests.empty();
+            });
+            if (mRequests.empty()) {
+                // Stopped and all requests finished
+                break;
+            }
+            auto first = mRequests.front();
+            // Wait for more requests until the batch is full or the first request timeout. A request without batch
+            // can't be merged, forward it at once
+            auto deadline = first->time + std::chrono::microseconds(first->batch > 0 ? mConfig.maxWaitUs : 0);
+            mCondition.wait_until(_l, deadline, [this, &first]() {
+                if (mStop) {
+                    return true;
+                }
+                int batch = 0;
+                for (auto& iter : mRequests) {
+                    if (_canMerge(first.get(), iter.get())) {
+                        batch += iter->batch;
+                    }
+                }
+                return batch >= mConfig.maxBatch;
+            });
+            int batch = 0;
+            for (auto iter = mRequests.begin(); iter != mRequests.end();) {
+                bool merge = _canMerge(first.get(), iter->get()) && (requests.empty() || batch + (*iter)->batch <= mConfig.maxBatch);
+                if (!merge) {
+                    ++iter;
+                    continue;
+                }
+                batch += (*iter)->batch;
+                requests.emplace_back(*iter);
+                iter = mRequests.erase(iter);
+            }
+        }
+        _forward(requests);
+    }
+}
+
+void BatchingModule::_forward(std::vector<std::shared_ptr<Request>>& requests) {
+    std::vector<VARP> inputs;
+    int totalBatch = 0;
+    if (1 == requests.size()) {
+        inputs = requests[0]->inputs;
+    } else {
+        inputs.resize(requests[0]->inputs.size());
+        for (int i = 0; i < inputs.size(); ++i) {
+            std::vector<VARP> batchInputs;
+            for (auto& request : requests) {
+                batchInputs.emplace_back(request->inputs[i]);
+            }
+            inputs[i] = _Concat(batchInputs, 0);
+        }
+        for (auto& request : requests) {
+            totalBatch += request->batch;
+        }
+    }
+    auto outputs = mModule->onForward(inputs);
+    std::vector<std::vector<VARP>> results(requests.size());
+    bool valid = !outputs.empty();
+    for (int i = 0; i < outputs.size() && valid; ++i) {
+        auto output = outputs[i];
+        if (nullptr != output->getInfo() && output->getInfo()->order == NC4HW4) {
+            output = _Convert(output, NCHW);
+        }
+        auto info = output->getInfo();
+        auto ptr = output->readMap<uint8_t>();
+        if (nullptr == info || nullptr == ptr) {
+            valid = false;
+            break;
+        }
+        // Copy outputs to host, the module's output memory will be reused by next forward
+        if (1 == requests.size()) {
+            results[0].emplace_back(_Const(ptr, info->dim, info->order, info->type));
+            continue;
+        }
+        if (info->dim.empty() || info->dim[0] != totalBatch) {
+            MNN_ERROR("BatchingModule: the %d output has no batch axis\n", i);
+            valid = false;
+            break;
+        }
+        size_t batchBytes = (size_t)info->size / totalBatch * info->type.bytes();
+        size_t offset = 0;
+        for (int r = 0; r < requests.size(); ++r) {
+            auto dims = info->dim;
+            dims[0] = requests[r]->batch;
+            results[r].emplace_back(_Const(ptr + offset, dims, info->order, info->type));
+            offset += batchBytes * requests[r]->batch;
+        }
+    }
+    for (int r = 0; r < requests.size(); ++r) {
+        if (valid) {
+            requests[r]->result.set_value(std::move(results[r]));
+        } else {
+            requests[r]->result.set_value({});
+        }
+    }
+}
+
+} // namespace Express
+} // namespace MNN
@@ -9,6 +9,8 @@
 #include <MNN/expr/Module.hpp>
 #include <MNN/expr/ExprCreator.hpp>
 #include <MNN/expr/ExecutorScope.hpp>
+#include <map>
+#include <mutex>
 #include "PipelineModule.hpp"
 #include "core/FileLoader.hpp"
 #include "backend/cpu/CPUBackend.hpp"
@@ -75,6 +77,125 @@ Module* Module::createEmpty(const std::vector<Express::VARP>& parameters) {
 Express::VARP Module::forward(Express::VARP input) {
     return this->onForward({input})[0];
 }
+
+// Copy the content of var to a new variable in host
+static VARP _copyContent(VARP var) {
+    auto info = var->getInfo();
+    if (nullptr == info) {
+        return var;
+    }
+    if (info->order != NC4HW4) {
+        return _Clone(var, true);
+    }
+    // NC4HW4 has padding in memory, copy it as NCHW and convert back lazily by the reader's Executor
+    return _Convert(_Clone(_Convert(var, NCHW), true), NC4HW4);
+}
+
+// The clone and Executor running the async forwards of a module
+struct AsyncForward {
+    ~AsyncForward() {
+        if (nullptr != module) {
+            ExecutorScope scope(executor);
+            module.reset();
+        }
+    }
+    std::shared_ptr<Executor> executor;
+    std::shared_ptr<Module> module;
+    bool doubleBuffer = false;
+    // Finish of the last two async forwards, indexed by index % 2
+    std::shared_future<void> forwards[2];
+    int index = 0;
+};
+
+// The async forwards are kept out of Module, so that the layout of Module is unchanged
+struct AsyncForwardTable {
+    std::mutex lock;
+    std::map<const Module*, std::shared_ptr<AsyncForward>> forwards;
+};
+// Never released, modules may be destroyed after static objects at exit
+static AsyncForwardTable* _getAsyncForwardTable() {
+    static AsyncForwardTable* gTable = new AsyncForwardTable;
+    return gTable;
+}
+static std::shared_ptr<AsyncForward> _getAsyncForward(const Module* module) {
+    auto table = _getAsyncForwardTable();
+    std::lock_guard<std::mutex> _l(table->lock);
+    auto& async = table->forwards[module];
+    if (nullptr == async) {
+        async.reset(new AsyncForward);
+    }
+    return async;
+}
+
+Module::~Module() {
+    std::shared_ptr<AsyncForward> async;
+    {
+        auto table = _getAsyncForwardTable();
+        std::lock_guard<std::mutex> _l(table->lock);
+        auto iter = table->forwards.find(this);
+        if (iter == table->forwards.end()) {
+            return;
+        }
+        async = iter->second;
+        table->forwards.erase(iter);
+    }
+    // Release out of the lock, the destructor of the clone removes its own record
+}
+
+void Module::setAsyncDoubleBuffer(bool enable) {
+    _getAsyncForward(this)->doubleBuffer = enable;
+}
+
+std::future<std::vector<Express::VARP>> Module::onForwardAsync(const std::vector<Express::VARP>& inputs) {
+    auto async = _getAsyncForward(this);
+    if (nullptr == async->module) {
+        // Neither the Executor nor the runtime is thread-safe, run the forwards in a clone with its own Executor
+        async->executor = Utils::createAsyncExecutor(this);
+        if (nullptr != async->executor) {
+            ExecutorScope scope(async->executor);
+            async->module.reset(Module::clone(this, true), Module::destroy);
+        }
+    }
+    // Compute the inputs in caller thread
+    Variable::compute(inputs);
+    if (nullptr == async->module) {
+        std::promise<std::vector<Express::VARP>> result;
+        result.set_value(onForward(inputs));
+        return result.get_future();
+    }
+    auto slot = async->index % 2;
+    auto prev = async->forwards[(async->index + 1) % 2];
+    async->index++;
+    auto forwardInputs = inputs;
+    if (async->doubleBuffer) {
+        // Wait for the forward two requests before
+        if (async->forwards[slot].valid()) {
+            async->forwards[slot].wait();
+        }
+        for (int i = 0; i < forwardInputs.size(); ++i) {
+            // The computed inputs may also be dirty after the source variables are written, so copy all of them
+            if (nullptr != forwardInputs[i].get()) {
+                forwardInputs[i] = _copyContent(forwardInputs[i]);
+            }
+        }
+    }
+    std::shared_ptr<std::promise<void>> finish(new std::promise<void>);
+    async->forwards[slot] = finish->get_future().share();
+    return std::async(std::launch::async, [async, forwardInputs, prev, finish]() {
+        if (prev.valid()) {
+            prev.wait();
+        }
+        ExecutorScope scope(async->executor);
+        auto outputs = async->module->onForward(forwardInputs);
+        for (auto& output : outputs) {
+            if (nullptr != output.get()) {
+                output = _copyContent(output);
+            }
+        }
+        finish->set_value();
+        return outputs;
+    });
+}
 std::vector<Express::VARP> Module::parameters() const {
     std::vector<Express::VARP> result;
     _collectParameters(result);
@@ -240,6 +361,9 @@ public:
         mModule->clearCache();
         return outputs;
     }
+    virtual bool onBindOutput(int index, void* ptr, size_t size) override {
+        return mChildren[0]->bindOutput(index, ptr, size);
+    }
     virtual Module* clone(CloneContext* ctx) const override {
         auto mModule = mChildren[0];
         std::shared_ptr<Module> submodule(mModule->clone(ctx));
@@ -485,6 +609,14 @@ int Module::traceOrOptimize(Interpreter::SessionMode stage) {
     return this->onOptimize(stage);
 }
 
+bool Module::bindOutput(int index, void* ptr, size_t size) {
+    if (nullptr != ptr && 0 != ((size_t)ptr) % 16) {
+        MNN_ERROR("The memory bound to output %d is not aligned to 16 bytes\n", index);
+        return false;
+    }
+    return this->onBindOutput(index, ptr, size);
+}
+
 
 } // namespace Express
 } // namespace MNN
@@ -23,6 +23,7 @@
 #include "geometry/GeometryComputerUtils.hpp"
 
 #include <MNN/expr/ExecutorScope.hpp>
+#include <future>
 using namespace MNN::Express;
 namespace MNN {
 namespace Express {
@@ -198,6 +199,43 @@ std::vector<int> PipelineModule::countOutputReference(std::vector<int> outputInd
     return countResult;
 }
 
+bool PipelineModule::_forwardSubModule(int index, std::vector<VARP>& stack) {
+    auto& m = mSubModules[index];
+    std::vector<VARP> tempInputs(std::get<1>(m).size());
+    for (int i = 0; i < tempInputs.size(); ++i) {
+        auto stackInput = std::get<1>(m)[i];
+        tempInputs[i] = stack[stackInput];
+        MNN_ASSERT(nullptr != tempInputs[i]);
+    }
+    std::vector<VARP> tempOutputs = std::get<0>(m)->onForward(tempInputs);
+    if(tempOutputs.size() != std::get<2>(m).size()) {
+        // Execute has error
+        return false;
+    }
+    for (int i = 0; i < tempOutputs.size(); ++i) {
+        stack[std::get<2>(m)[i]] = tempOutputs[i];
+        MNN_ASSERT(nullptr != tempOutputs[i]);
+    }
+    return true;
+}
+
+bool PipelineModule::onBindOutput(int index, void* ptr, size_t size) {
+    if (index < 0 || index >= mOutputIndex.size()) {
+        return false;
+    }
+    // Bind to the last submodule writing the output
+    auto stackIndex = mOutputIndex[index];
+    for (int i = (int)mSubModules.size() - 1; i >= 0; --i) {
+        auto& outputs = std::get<2>(mSubModules[i]);
+        for (int j = 0; j < outputs.size(); ++j) {
+            if (outputs[j] == stackIndex) {
+                return std::get<0>(mSubModules[i])->bindOutput(j, ptr, size);
+            }
+        }
+    }
+    return false;
+}
+
 std::vector<VARP> PipelineModule::onForward(const std::vector<VARP>& inputs) {
     std::vector<VARP> mStack(mStackSize);
     for (int i = 0; i < mInitVars.size(); ++i) {
@@ -207,22 +245,55 @@ std::vector<VARP> PipelineModule::onForward(const std::vector<VARP>& inputs) {
     for (int i = 0; i < mInputSize; ++i) {
         mStack[i] = inputs[i];
     }
-    for (int index = 0; index < mSubModules.size(); ++index) {
-        auto& m = mSubModules[index];
-        std::vector<VARP> tempInputs(std::get<1>(m).size());
-        for (int i = 0; i < tempInputs.size(); ++i) {
-            auto stackInput = std::get<1>(m)[i];
-            tempInputs[i] = mStack[stackInput];
-            MNN_ASSERT(nullptr != tempInputs[i]);
-        }
-        std::vector<VARP> tempOutputs = std::get<0>(m)->onForward(tempInputs);
-        if(tempOutputs.size() != std::get<2>(m).size()) {
-            // Execute has error
-            return {};
+    if (mParallelWaves.empty()) {
+        for (int index = 0; index < mSubModules.size(); ++index) {
+            if (!_forwardSubModule(index, mStack)) {
+                return {};
+            }
         }
-        for (int i = 0; i < tempOutputs.size(); ++i) {
-            mStack[std::get<2>(m)[i]] = tempOutputs[i];
-            MNN_ASSERT(nullptr != tempOutputs[i]);
+    } else {
+        auto forwardLane = [this, &mStack](const std::vector<int>& lane) {
+            for (auto index : lane) {
+                if (!_forwardSubModule(index, mStack)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        for (auto& wave : mParallelWaves) {
+            // Compute the lazy inputs of the lanes in current thread, so that the lanes only read them
+            std::vector<VARP> laneInputs;
+            for (int l = 1; l < wave.size(); ++l) {
+                for (auto index : wave[l]) {
+                    for (auto stackInput : std::get<1>(mSubModules[index])) {
+                        laneInputs.emplace_back(mStack[stackInput]);
+                    }
+                }
+            }
+            Variable::compute(laneInputs);
+            // The lanes write different stack index, each lane uses its own Executor, lane 1 runs in current thread
+            std::vector<std::future<bool>> futures;
+            for (int l = 2; l < wave.size(); ++l) {
+                auto& lane = wave[l];
+                auto executor = mLaneExecutors[l - 1];
+                futures.emplace_back(std::async(std::launch::async, [&forwardLane, &lane, executor]() {
+                    ExecutorScope scope(executor);
+                    return forwardLane(lane);
+                }));
+            }
+            bool success = true;
+            if (wave.size() > 1) {
+                ExecutorScope scope(mLaneExecutors[0]);
+                success = forwardLane(wave[1]);
+            }
+            for (auto& f : futures) {
+                success = f.get() && success;
+            }
+            // The serial submodules use the origin runtime and Executor
+            success = success && forwardLane(wave[0]);
+            if (!success) {
+                return {};
+            }
         }
     }
     std::vector<VARP> outputs(mOutputIndex.size());
@@ -231,6 +302,7 @@ std::vector<VARP> PipelineModule::onForward(const std::vector<VARP>& inputs) {
     }
     return outputs;
 }
+
 void PipelineModule::onClearCache() {
     // Do nothing
 }
@@ -511,8 +583,71 @@ struct ModuleRuntimeConfig {
     const BackendConfig* userConfig = nullptr;
     Session::ModeGroup modes;
     std::string externalFile;
+    std::shared_ptr<CloneStatistic> cloneStatistic;
 };
 
+// If / While / NMS module use the RuntimeManager of the PipelineModule for its subgraph
+static bool _isControlFlowSubModule(const MNN::Net* net, const SubModuleInfo& info) {
+    if (1 != info.opList.size()) {
+        return false;
+    }
+    auto op = net->oplists()->GetAs<Op>(info.opList[0]);
+    return OpType_If == op->type() || OpType_NonMaxSuppressionV2 == op->type() || (OpType_While == op->type() && op->main_type() != OpParameter_LoopParam);
+}
+
+/**
+ Split the submodules into waves by data dependency, the submodules in one wave are independent. In each wave, lane 0
+ contains the submodules run after the others with the origin runtime: the control flow submodules and the only
+ submodule of the wave. The other submodules are spread to lane 1 ... parallel, which run concurrently.
+ Return empty if no concurrency.
+ */
+static std::vector<std::vector<std::vector<int>>> _computeParallelWaves(const MNN::Net* net, const std::vector<SubModuleInfo>& infos, int parallel) {
+    std::map<int, int> producer;
+    std::vector<int> waveIndexes(infos.size(), 0);
+    int waveNumber = 0;
+    for (int i = 0; i < infos.size(); ++i) {
+        int wave = 0;
+        for (auto index : infos[i].inputs) {
+            auto iter = producer.find(index);
+            if (iter != producer.end()) {
+                wave = ALIMAX(wave, waveIndexes[iter->second] + 1);
+            }
+        }
+        waveIndexes[i] = wave;
+        waveNumber = ALIMAX(waveNumber, wave + 1);
+        for (auto index : infos[i].outputs) {
+            producer[index] = i;
+        }
+    }
+    std::vector<int> concurrentCount(waveNumber, 0);
+    for (int i = 0; i < infos.size(); ++i) {
+        if (!_isControlFlowSubModule(net, infos[i])) {
+            concurrentCount[waveIndexes[i]]++;
+        }
+    }
+    std::vector<std::vector<std::vector<int>>> waves(waveNumber, std::vector<std::vector<int>>(parallel + 1));
+    std::vector<int> laneCount(waveNumber, 0);
+    bool hasConcurrency = false;
+    for (int i = 0; i < infos.size(); ++i) {
+        auto waveIndex = waveIndexes[i];
+        int lane = 0;
+        if (concurrentCount[waveIndex] > 1 && !_isControlFlowSubModule(net, infos[i])) {
+            lane = 1 + (laneCount[waveIndex]++) % parallel;
+            hasConcurrency = true;
+        }
+        waves[waveIndex][lane].emplace_back(i);
+    }
+    if (!hasConcurrency) {
+        return {};
+    }
+    for (auto& wave : waves) {
+        while (wave.size() > 1 && wave.back().empty()) {
+            wave.pop_back();
+        }
+    }
+    return waves;
+}
+
 static Module* _createSubModule(std::shared_ptr<BufferStorage> bufferStorage, const SubModuleInfo& info, const std::map<std::string, SubGraph>& subs, std::shared_ptr<Schedule::ScheduleInfo> sharedConst, const Module::Config& config, const ModuleRuntimeConfig& runtimeConfig) {
     auto net = flatbuffers::GetRoot<Net>(bufferStorage->buffer());
     if (1 == info.opList.size()) {
@@ -562,7 +697,7 @@ static Module* _createSubModule(std::shared_ptr<BufferStorage> bufferStorage, co
 
     std::vector<std::shared_ptr<BufferStorage>> buffers = {bufferStorage};
 
-    return new StaticModule(info.inputs, info.outputs, std::move(buffers), std::move(scheduleInfo), sharedConst, std::move(modes), std::move(rt), config);
+    return new StaticModule(info.inputs, info.outputs, std::move(buffers), std::move(scheduleInfo), sharedConst, std::move(modes), std::move(rt), config, runtimeConfig.cloneStatistic);
 }
 
 Module* PipelineModule::load(const std::vector<std::string>& inputs, const std::vector<std::string>& outputs, const uint8_t* buffer, size_t length, const std::shared_ptr<MNN::Express::Executor::RuntimeManager> rtMgr, const Module::Config* config) {
@@ -630,16 +765,29 @@ Module* PipelineModule::load(const std::vector<std::string>& inputs, const std::
         modRuntime.modes = rtMgr->getInside()->modes;
         modRuntime.rt = rtMgr->getInside()->mRuntime;
         modRuntime.externalFile = rtMgr->getInside()->mExternalFile;
+        modRuntime.cloneStatistic = rtMgr->getInside()->mCloneStatistic;
         modRuntime.userConfig = &rtMgr->getInside()->mConfig;
         modRuntime.compute.type      = modRuntime.rt.first.begin()->first;
         modRuntime.compute.numThread = 1;
+    }
+    auto applyModes = [&rtMgr](RuntimeInfo& runtime) {
         // set allocator type
-        modRuntime.rt.first.begin()->second->setAllocatorType(rtMgr->getInside()->modes.memoryAllocatorType);
-        modRuntime.rt.second->setAllocatorType(rtMgr->getInside()->modes.memoryAllocatorType);
+        runtime.first.begin()->second->setAllocatorType(rtMgr->getInside()->modes.memoryAllocatorType);
+        runtime.second->setAllocatorType(rtMgr->getInside()->modes.memoryAllocatorType);
         // set winograd memory type
-        modRuntime.rt.first.begin()->second->setWinogradMemoryLevel(rtMgr->getInside()->modes.winogradMemoryUsed);
-        modRuntime.rt.second->setWinogradMemoryLevel(rtMgr->getInside()->modes.winogradMemoryUsed);
-    }
+        runtime.first.begin()->second->setWinogradMemoryLevel(rtMgr->getInside()->modes.winogradMemoryUsed);
+        runtime.second->setWinogradMemoryLevel(rtMgr->getInside()->modes.winogradMemoryUsed);
+        // set weight pack mode
+        runtime.first.begin()->second->setWeightPackMode(rtMgr->getInside()->modes.weightPackMode);
+        runtime.second->setWeightPackMode(rtMgr->getInside()->modes.weightPackMode);
+        // set kernel tuning mode
+        runtime.first.begin()->second->setKernelTuning(rtMgr->getInside()->modes.cpuKernelTuning);
+        runtime.second->setKernelTuning(rtMgr->getInside()->modes.cpuKernelTuning);
+        // set dynamic quant mode
+        runtime.first.begin()->second->setDynamicQuant(rtMgr->getInside()->modes.cpuDynamicQuant);
+        runtime.second->setDynamicQuant(rtMgr->getInside()->modes.cpuDynamicQuant);
+    };
+    applyModes(modRuntime.rt);
     auto& rt = modRuntime.rt;
     auto firstRt = rt.first[modRuntime.compute.type];
     sharedConst->constReplaceBackend.reset(firstRt->onCreate(modRuntime.userConfig));
@@ -695,11 +843,52 @@ Module* PipelineModule::load(const std::vector<std::string>& inputs, const std::
         initVars.insert(std::make_pair(index, constVar));
     }
     auto subModulesInfo = _createSubModuleInfo(bufferStorage, inputIndexes, outputIndexes, noneedComputeIndexes, sharedConst);
+    std::vector<std::vector<std::vector<int>>> parallelWaves;
+    int parallel = rtMgr->getInside()->modes.subModuleParallel;
+    if (parallel >= 2 && modRuntime.compute.type == MNN_FORWARD_CPU) {
+        parallelWaves = _computeParallelWaves(net, subModulesInfo, parallel);
+    }
+    // Neither the runtime nor the Executor can be used by multi thread, create them for each concurrent lane
+    std::vector<ModuleRuntimeConfig> laneRuntimes(1, modRuntime);
+    std::vector<std::shared_ptr<Executor>> laneExecutors;
+    std::vector<int> subModuleLanes(subModulesInfo.size(), 0);
+    if (!parallelWaves.empty()) {
+        int laneNumber = 0;
+        for (auto& wave : parallelWaves) {
+            laneNumber = ALIMAX(laneNumber, (int)wave.size() - 1);
+        }
+        // The concurrent lanes share the threads of the RuntimeManager, at least one thread each
+        int laneThread = ALIMAX(1, rtMgr->getInside()->mNumberThread / laneNumber);
+        BackendConfig laneConfig;
+        if (nullptr != rtMgr->getBnConfig()) {
+            laneConfig = *rtMgr->getBnConfig();
+        }
+        for (int l = 0; l < laneNumber; ++l) {
+            auto executor = Executor::newExecutor(MNN_FORWARD_CPU, laneConfig, laneThread);
+            ModuleRuntimeConfig laneRuntime = modRuntime;
+            {
+                ExecutorScope scope(executor);
+                laneRuntime.rt = Executor::getRuntime();
+            }
+            applyModes(laneRuntime.rt);
+            laneRuntimes.emplace_back(laneRuntime);
+            laneExecutors.emplace_back(executor);
+        }
+        for (auto& wave : parallelWaves) {
+            for (int l = 0; l < wave.size(); ++l) {
+                for (auto index : wave[l]) {
+                    subModuleLanes[index] = l;
+                }
+            }
+        }
+    }
     std::vector<std::shared_ptr<Module>> subModules(subModulesInfo.size());
     for (int i=0; i<subModulesInfo.size(); ++i) {
-        subModules[i].reset(_createSubModule(bufferStorage, subModulesInfo[i], subGraphMap, sharedConst, *config, modRuntime));
+        subModules[i].reset(_createSubModule(bufferStorage, subModulesInfo[i], subGraphMap, sharedConst, *config, laneRuntimes[subModuleLanes[i]]));
     }
     auto result = new PipelineModule;
+    result->mParallelWaves = std::move(parallelWaves);
+    result->mLaneExecutors = std::move(laneExecutors);
     result->mInputSize = inputs.size();
     /**
      Compute:
@@ -805,6 +994,7 @@ Module* PipelineModule::clone(CloneContext* ctx) const {
     module->mStackSize = mStackSize;
     module->mInitVars = mInitVars;
     module->mSharedConst = mSharedConst;
+    // The cloned submodules share current runtime, so don't run them concurrently
     return this->cloneBaseTo(ctx, module);
 }
 
@@ -45,6 +45,7 @@ public:
     MNN_PUBLIC static Module* load(const std::vector<std::string>& inputs, const std::vector<std::string>& outputs, const uint8_t* buffer, size_t length, std::shared_ptr<MNN::Express::Executor::RuntimeManager> rtMgr, const Module::Config* config = nullptr);
     virtual std::vector<Express::VARP> onForward(const std::vector<Express::VARP>& inputs) override;
     virtual void onClearCache() override;
+    virtual bool onBindOutput(int index, void* ptr, size_t size) override;
     MNN_PUBLIC std::vector<int> countOutputReference(std::vector<int> outputIndices);
 
     MNN_PUBLIC PipelineModule(std::vector<Express::VARP> inputs, std::vector<Express::VARP> outputs,
@@ -56,6 +57,7 @@ private:
     PipelineModule(){}
 
     Module* clone(CloneContext* ctx) const override;
+    bool _forwardSubModule(int index, std::vector<VARP>& stack);
 
     std::vector<std::tuple<std::shared_ptr<Module>, std::vector<int>, std::vector<int>>> mSubModules;
     int mStackSize = 0;
@@ -64,6 +66,11 @@ private:
     friend class NN;
     std::vector<VARP> mInitVars;
     std::shared_ptr<Schedule::ScheduleInfo> mSharedConst;
+    // Submodule indexes of each wave and lane for SUBMODULE_PARALLEL, the lanes of one wave except lane 0 run
+    // concurrently. Empty means running submodules in order.
+    std::vector<std::vector<std::vector<int>>> mParallelWaves;
+    // Executor of lane 1, 2 ...
+    std::vector<std::shared_ptr<Executor>> mLaneExecutors;
 };
 } // namespace Express
 } // namespace MNN
@@ -18,12 +18,15 @@
 #include "core/TensorUtils.hpp"
 #include "core/FileLoader.hpp"
 #include "core/OpCommonUtils.hpp"
+#include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
 
 namespace MNN {
 namespace Express {
 
+// packSources: the weights loaded for the executions, which their lazy packing reads
 static std::vector<std::shared_ptr<BufferStorage>> preRearrangeWeights( // NOLINT
-    Schedule::ScheduleInfo& scheduleInfo, Backend* backend, Backend* backupBackend) {
+    Schedule::ScheduleInfo& scheduleInfo, Backend* backend, Backend* backupBackend, std::vector<std::shared_ptr<BufferStorage>>& packSources) {
     FileLoader loader(scheduleInfo.externalWeightPath.c_str());
     auto&& pipelineInfo = scheduleInfo.pipelineInfo[0].second;
     std::vector<std::shared_ptr<BufferStorage>> splitOps(pipelineInfo.size());
@@ -84,6 +87,9 @@ static std::vector<std::shared_ptr<BufferStorage>> preRearrangeWeights( // NOLIN
                     exe = nullptr;
                     break;
                 }
+                if (nullptr != tmpstorage) {
+                    packSources.emplace_back(tmpstorage);
+                }
                 if (OpParameter_Convolution2D == op_table->main.type) {
                     op_table->main.AsConvolution2D()->bias.clear();
                     op_table->main.AsConvolution2D()->weight.clear();
@@ -134,6 +140,19 @@ static std::vector<std::shared_ptr<BufferStorage>> preRearrangeWeights( // NOLIN
     return splitOps;
 }
 
+// Keep the session for RuntimeManager::getInfo(MEMORY_REPORT), statistic->lock must be held
+static void _registerSession(CloneStatistic* statistic, const std::shared_ptr<Session>& session) {
+    auto& sessions = statistic->allSessions;
+    for (auto iter = sessions.begin(); iter != sessions.end();) {
+        if (iter->expired()) {
+            iter = sessions.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    sessions.emplace_back(session);
+}
+
 static bool _reshapeTensor(Tensor* tensor, const Tensor* dims) {
     bool dirty = false;
     if (tensor->buffer().dimensions != dims->dimensions()) {
@@ -198,6 +217,228 @@ void StaticModule::resetInputOutputs() {
     }
 }
 
+// Each output element of these ops depends only on the input elements at the same position, so zero-padding the
+// inputs doesn't change the outputs in the requested region
+static bool _positionWise(const Op* op) {
+    switch (op->type()) {
+        case OpType_Input:
+        case OpType_Const:
+        case OpType_TrainableParam:
+        case OpType_BinaryOp:
+        case OpType_UnaryOp:
+        case OpType_Eltwise:
+        case OpType_ReLU:
+        case OpType_ReLU6:
+        case OpType_PReLU:
+        case OpType_Sigmoid:
+        case OpType_TanH:
+        case OpType_ELU:
+        case OpType_Selu:
+        case OpType_Cast:
+        case OpType_Select:
+        case OpType_ConvertTensor:
+        case OpType_Scale:
+        case OpType_BatchNorm:
+            return true;
+        case OpType_Convolution:
+        case OpType_ConvolutionDepthwise: {
+            auto conv = op->main_as_Convolution2D();
+            if (nullptr == conv || nullptr == conv->common()) {
+                return false;
+            }
+            auto common = conv->common();
+            bool noPad = nullptr == common->pads() && common->padX() == 0 && common->padY() == 0;
+            return common->kernelX() == 1 && common->kernelY() == 1 && common->strideX() == 1 && common->strideY() == 1 && noPad;
+        }
+        default:
+            break;
+    }
+    return false;
+}
+
+// Axis in NCHW order counted from the end, the same for an input and the outputs broadcast / converted from it
+static int _bucketAxis(const Variable::Info* info, int axis) {
+    int dimensions = (int)info->dim.size();
+    if (info->order == NHWC && 4 == dimensions) {
+        static const int nchwAxis[4] = {0, 2, 3, 1};
+        axis = nchwAxis[axis];
+    }
+    return dimensions - 1 - axis;
+}
+
+std::vector<Express::VARP> StaticModule::_bucketInputs(const std::vector<Express::VARP>& inputs, std::map<int, std::pair<int, int>>& crops) const {
+    auto bucket = mResource->mModes.shapeBucketSize;
+    std::vector<Express::VARP> result = inputs;
+    for (int i = 0; i < inputs.size(); ++i) {
+        auto& dynamicDims = mResource->mInputDynamicDims[i];
+        if (dynamicDims.empty()) {
+            continue;
+        }
+        auto info = inputs[i]->getInfo();
+        if (nullptr == info || info->order == NC4HW4) {
+            continue;
+        }
+        int dimensions = (int)info->dim.size();
+        std::vector<int> paddings(2 * dimensions, 0);
+        bool needPad = false;
+        for (auto axis : dynamicDims) {
+            // A dim of 1 may be broadcast by the net, keep it
+            if (axis >= dimensions || info->dim[axis] <= 1) {
+                continue;
+            }
+            auto length = info->dim[axis];
+            auto padded = UP_DIV(length, bucket) * bucket;
+            if (padded == length) {
+                continue;
+            }
+            paddings[2 * axis + 1] = padded - length;
+            crops.insert(std::make_pair(_bucketAxis(info, axis), std::make_pair(padded, length)));
+            needPad = true;
+        }
+        if (needPad) {
+            result[i] = _Pad(inputs[i], _Const(paddings.data(), {dimensions, 2}, NCHW, halide_type_of<int>()));
+        }
+    }
+    return result;
+}
+
+// Crop the outputs computed from the padded inputs back to the requested shape
+void StaticModule::_cropOutputs(std::vector<Express::VARP>& outputs, const std::map<int, std::pair<int, int>>& crops) const {
+    for (auto index : mResource->mOutputFromTensor) {
+        auto info = outputs[index]->getInfo();
+        if (nullptr == info || info->type.code == halide_type_handle) {
+            continue;
+        }
+        int dimensions = (int)info->dim.size();
+        std::vector<int> starts(dimensions, 0);
+        std::vector<int> sizes = info->dim;
+        bool needCrop = false;
+        for (int axis = 0; axis < dimensions; ++axis) {
+            auto iter = crops.find(_bucketAxis(info, axis));
+            if (iter != crops.end() && info->dim[axis] == iter->second.first) {
+                sizes[axis] = iter->second.second;
+                needCrop = true;
+            }
+        }
+        if (!needCrop) {
+            continue;
+        }
+        auto startsVar = _Const(starts.data(), {dimensions}, NCHW, halide_type_of<int>());
+        auto sizesVar = _Const(sizes.data(), {dimensions}, NCHW, halide_type_of<int>());
+        if (info->order == NC4HW4) {
+            outputs[index] = _Convert(_Slice(_Convert(outputs[index], NCHW), startsVar, sizesVar), NC4HW4);
+        } else {
+            outputs[index] = _Slice(outputs[index], startsVar, sizesVar);
+        }
+    }
+}
+
+void StaticModule::_selectSession(const std::vector<Express::VARP>& inputs) {
+    std::vector<int> key;
+    for (auto& input : inputs) {
+        auto tensor = Utils::getTensor(input);
+        key.emplace_back(tensor->dimensions());
+        for (int i = 0; i < tensor->dimensions(); ++i) {
+            key.emplace_back(tensor->length(i));
+        }
+        key.emplace_back(TensorUtils::getDescribe(tensor)->dimensionFormat);
+    }
+    if (mShapeKey.empty()) {
+        mShapeKey = std::move(key);
+        return;
+    }
+    if (key == mShapeKey) {
+        return;
+    }
+    // The clone of this module may be reading mSession
+    std::unique_lock<std::mutex> _l(mCloneLock);
+    ShapeCache current;
+    current.mKey = std::move(mShapeKey);
+    current.mSession = mSession;
+    current.mInputTensors = std::move(mInputTensors);
+    current.mPrevInputTensor = std::move(mPrevInputTensor);
+    current.mOutputTensors = std::move(mOutputTensors);
+    auto iter = mShapeCaches.begin();
+    for (; iter != mShapeCaches.end(); ++iter) {
+        if (iter->mKey == key) {
+            break;
+        }
+    }
+    if (iter != mShapeCaches.end()) {
+        mSession = iter->mSession;
+        mInputTensors = std::move(iter->mInputTensors);
+        mPrevInputTensor = std::move(iter->mPrevInputTensor);
+        mOutputTensors = std::move(iter->mOutputTensors);
+        mShapeCaches.erase(iter);
+    } else {
+        RuntimeInfo rt = mSession->getRuntime();
+        std::shared_ptr<Session> newSession(mSession->clone(std::move(rt), mResource->mSharedConst));
+        if (!newSession->valid()) {
+            // Can't clone, resize current session
+            mSession = current.mSession;
+            mInputTensors = std::move(current.mInputTensors);
+            mPrevInputTensor = std::move(current.mPrevInputTensor);
+            mOutputTensors = std::move(current.mOutputTensors);
+            mShapeKey = std::move(key);
+            return;
+        }
+        mSession = newSession;
+        if (nullptr != mResource->mCloneStatistic) {
+            std::unique_lock<std::mutex> _l(mResource->mCloneStatistic->lock);
+            _registerSession(mResource->mCloneStatistic.get(), newSession);
+        }
+        resetInputOutputs();
+    }
+    mShapeKey = std::move(key);
+    mShapeCaches.emplace_front(std::move(current));
+    while ((int)mShapeCaches.size() + 1 > mResource->mModes.shapeCacheSize) {
+        mShapeCaches.pop_back();
+    }
+}
+
+bool StaticModule::onBindOutput(int index, void* ptr, size_t size) {
+    for (int i = 0; i < mResource->mOutputFromTensor.size(); ++i) {
+        if (mResource->mOutputFromTensor[i] == index) {
+            mOutputBuffers.resize(mResource->mOutputFromTensor.size());
+            mOutputBuffers[i] = std::make_pair(ptr, size);
+            return true;
+        }
+    }
+    // The output is one of the inputs
+    return false;
+}
+
+void StaticModule::_applyOutputBuffers() {
+    for (int i = 0; i < mOutputBuffers.size(); ++i) {
+        auto tensor = mOutputTensors[i];
+        auto des = TensorUtils::getDescribe(tensor);
+        auto& origin = TensorUtils::getDescribeOrigin(tensor)->mem;
+        auto backend = TensorUtils::getDescribeOrigin(tensor)->getBackend();
+        if (nullptr == origin.get() || nullptr == backend || des->usage != Tensor::InsideDescribe::OUTPUT) {
+            continue;
+        }
+        auto ptr = (uint8_t*)mOutputBuffers[i].first;
+        // The executions on CPU read the tensor's host at execute, so the output can be redirected after resize
+        bool canBind = nullptr != ptr && (backend->type() == MNN_FORWARD_CPU || backend->type() == MNN_FORWARD_CPU_EXTENSION)
+            && des->dimensionFormat != MNN_DATA_FORMAT_NC4HW4 && des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND
+            && nullptr == des->quantAttr.get() && (tensor->getType().code != halide_type_float || static_cast<CPUBackend*>(backend)->functions()->bytes == 4)
+            && tensor->size() <= mOutputBuffers[i].second;
+        if (!canBind) {
+            if (nullptr != ptr) {
+                MNN_ERROR("Can't bind memory to output %d, use the module's memory\n", mResource->mOutputFromTensor[i]);
+                mOutputBuffers[i].first = nullptr;
+            }
+            // Restore the module's memory
+            auto host = origin->chunk().ptr();
+            if (nullptr != host) {
+                tensor->buffer().host = host;
+            }
+            continue;
+        }
+        tensor->buffer().host = ptr;
+    }
+}
+
 StaticModule::StaticModule(std::vector<int> inputs,
                            std::vector<int> outputs,
                            std::vector<std::shared_ptr<BufferStorage>>&& buffer,
@@ -205,10 +446,12 @@ StaticModule::StaticModule(std::vector<int> inputs,
                            std::shared_ptr<Schedule::ScheduleInfo> sharedConst,
                            Session::ModeGroup&& mode,
                            RuntimeInfo&& rt,
-                           const Module::Config& config
+                           const Module::Config& config,
+                           std::shared_ptr<CloneStatistic> cloneStatistic
                            ) {
     setType("StaticModule");
     mResource.reset(new Resource);
+    mResource->mCloneStatistic = cloneStatistic;
     mResource->mSharedConst = sharedConst;
     mResource->mModes = std::move(mode);
     mResource->mBnInfo.user = &mResource->mBnConfig;
@@ -233,7 +476,17 @@ StaticModule::StaticModule(std::vector<int> inputs,
         }
     }
     if (config.rearrange) {
-        mResource->mBuffer = preRearrangeWeights(scheduleInfo, bnCache.cache.first.get(), bnCache.cache.second.get());
+        std::vector<std::shared_ptr<BufferStorage>> packSources;
+        mResource->mBuffer = preRearrangeWeights(scheduleInfo, bnCache.cache.first.get(), bnCache.cache.second.get(), packSources);
+        // The rearranged ops drop the source weights, but the lazy packing of the executions still reads them
+        bool lazyPack = rt.second->getWeightPackMode() > 0;
+        for (auto& iter : rt.first) {
+            lazyPack = lazyPack || iter.second->getWeightPackMode() > 0;
+        }
+        if (lazyPack) {
+            packSources.insert(packSources.end(), buffer.begin(), buffer.end());
+            mResource->mPackSources = std::move(packSources);
+        }
     } else {
         mResource->mBuffer = std::move(buffer);
     }
@@ -278,9 +531,32 @@ StaticModule::StaticModule(std::vector<int> inputs,
         }
     }
     mResource->mOutputs = std::move(outputs);
+    mResource->mInputDynamicDims.resize(mResource->mInputs.size());
+    bool positionWise = true;
+    for (auto& info : scheduleInfo.pipelineInfo[0].second) {
+        positionWise = positionWise && _positionWise(info.op);
+    }
+    if (mResource->mModes.shapeBucketSize > 1 && !positionWise) {
+        MNN_PRINT("SHAPE_BUCKET_SIZE is ignored: the net has ops mixing elements of different positions\n");
+    }
+    if (mResource->mModes.shapeBucketSize > 1 && positionWise) {
+        for (int i=0; i<mResource->mInputs.size(); ++i) {
+            auto inputT = scheduleInfo.allTensors[mResource->mInputs[i]].get();
+            // The batch is never padded
+            for (int d=1; d<inputT->dimensions(); ++d) {
+                if (inputT->length(d) < 0) {
+                    mResource->mInputDynamicDims[i].emplace_back(d);
+                }
+            }
+        }
+    }
 
     bool needResize = scheduleInfo.validForResize && mResource->mModes.inputMode == Interpreter::Session_Input_Inside;
     mSession.reset(new Session(std::move(scheduleInfo), mResource->mModes, std::move(rt)));
+    if (nullptr != cloneStatistic) {
+        std::unique_lock<std::mutex> _l(cloneStatistic->lock);
+        _registerSession(cloneStatistic.get(), mSession);
+    }
     resetInputOutputs();
     if (needResize) {
         mSession->resize();
@@ -299,19 +575,37 @@ void StaticModule::onClearCache() {
             std::get<3>(iter.second) = true;
         }
     }
+    for (auto& cache : mShapeCaches) {
+        for (auto& prev : cache.mPrevInputTensor) {
+            prev.first = nullptr;
+            prev.second = nullptr;
+        }
+        for (auto& iter : cache.mSession->getPipelineInfo(0).first.inputTensorCopyCache) {
+            std::get<3>(iter.second) = true;
+        }
+    }
 }
 
-std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VARP>& inputs) {
+std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VARP>& originInputs) {
 
     AUTOTIME;
     std::vector<Express::VARP> outputs(mResource->mOutputNumbers);
     for (auto& iter : mResource->mOutputFromInput) {
-        outputs[iter.first] = inputs[iter.second];
+        outputs[iter.first] = originInputs[iter.second];
     }
     if (mResource->mOutputFromTensor.empty()) {
         return outputs;
     }
+    bool useShapeCache = mResource->mModes.inputMode == Interpreter::Session_Input_User && !mResource->mUseContentInputs;
+    auto inputs = originInputs;
+    std::map<int, std::pair<int, int>> crops;
+    if (useShapeCache && mResource->mModes.shapeBucketSize > 1) {
+        inputs = _bucketInputs(originInputs, crops);
+    }
     Variable::compute(inputs);
+    if (useShapeCache && mResource->mModes.shapeCacheSize > 1) {
+        _selectSession(inputs);
+    }
 #ifdef MNN_DUMP_MEMORY
     auto rt = Executor::getRuntime();
     auto mem = rt.second->onGetMemoryInMB();
@@ -398,7 +692,13 @@ std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VA
         if (mResource->mUseContentInputs) {
             mSession->setNeedResize();
         }
-        auto code = mSession->resize();
+        ErrorCode code;
+        if (mSession->needResizeOrMalloc()) {
+            std::unique_lock<std::mutex> _l(mCloneLock);
+            code = mSession->resize();
+        } else {
+            code = mSession->resize();
+        }
         if (NO_ERROR != code) {
             FUNC_PRINT(code);
             return {};
@@ -416,7 +716,12 @@ std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VA
             mInputTensors[i]->buffer().type = inputTensor->buffer().type;
             _resizeTensor(mInputTensors[i], inputTensor, mSession.get(), nullptr);
         }
-        mSession->resize();
+        if (mSession->needResizeOrMalloc()) {
+            std::unique_lock<std::mutex> _l(mCloneLock);
+            mSession->resize();
+        } else {
+            mSession->resize();
+        }
         // Copy
         for (int i = 0; i < inputs.size(); ++i) {
             if (nullptr == mInputTensors[i]) {
@@ -440,6 +745,9 @@ std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VA
 #endif
 
 
+    if (!mOutputBuffers.empty()) {
+        _applyOutputBuffers();
+    }
     ErrorCode code;
     if (mResource->mModes.callBackMode == Interpreter::Session_Debug) {
         auto globalExecutor = ExecutorScope::Current();
@@ -455,6 +763,10 @@ std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VA
     if (NO_ERROR != code) {
         return {};
     }
+    // All executions have run, so have their lazy packs
+    std::call_once(mResource->mPackSourcesRelease, [this]() {
+        mResource->mPackSources.clear();
+    });
     for (int i = 0; i < mOutputTensors.size(); ++i) {
         auto tensor = Tensor::clone(mOutputTensors[i]);
         outputs[mResource->mOutputFromTensor[i]] = Express::Variable::create(Express::Expr::create(tensor, true));
@@ -476,6 +788,9 @@ std::vector<Express::VARP> StaticModule::onForward(const std::vector<Express::VA
     mSession->getInfo(Interpreter::FLOPS, &flops);
     glo->getDebugTools()->flops += flops;
 #endif
+    if (!crops.empty()) {
+        _cropOutputs(outputs, crops);
+    }
     return outputs;
 }
 
@@ -485,10 +800,51 @@ Module* StaticModule::clone(CloneContext* ctx) const {
     if (mResource->mOutputFromTensor.empty()) {
         return this->cloneBaseTo(ctx, module);
     }
+    Timer cloneTimer;
     // TODO: If RuntimeManager is not the same as Runtime, may copy error
     auto rt = Executor::getRuntime();
+    // The constant tensors and the executions' packed weights are shared with this module,
+    // the clone's activation memory is allocated by its first resize
+    std::unique_lock<std::mutex> _cloneLock(mCloneLock);
     module->mSession.reset(mSession->clone(std::move(rt), mResource->mSharedConst));
     module->resetInputOutputs();
+    auto statistic = mResource->mCloneStatistic;
+    if (nullptr != statistic) {
+        // The execution that can't be cloned will be created again on resize, with its own weights.
+        // So does the op not created by this module yet: clone after the first forward to share all of them
+        int rebuildNumber = 0;
+        // After the source's resize, an op without execution is computed by geometry and needs none
+        bool sourceResized = !mSession->needResizeOrMalloc();
+        auto& srcOps = mSession->getPipelineInfo(0).second;
+        auto& dstOps = module->mSession->getPipelineInfo(0).second;
+        for (int i = 0; i < srcOps.size() && i < dstOps.size(); ++i) {
+            if (srcOps[i].type == Schedule::CONSTANT) {
+                continue;
+            }
+            if (srcOps[i].executionCache.empty()) {
+                if (!sourceResized) {
+                    rebuildNumber++;
+                }
+                continue;
+            }
+            rebuildNumber += (int)(srcOps[i].executionCache.size() - dstOps[i].executionCache.size());
+        }
+        _cloneLock.unlock();
+        float cloneTime = cloneTimer.durationInUs() / 1000.0f;
+        std::unique_lock<std::mutex> _l(statistic->lock);
+        for (auto iter = statistic->sessions.begin(); iter != statistic->sessions.end();) {
+            if (iter->expired()) {
+                iter = statistic->sessions.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        statistic->sessions.emplace_back(module->mSession);
+        _registerSession(statistic.get(), module->mSession);
+        statistic->cloneNumber++;
+        statistic->cloneTimeInMs += cloneTime;
+        statistic->rebuildExecutions += rebuildNumber;
+    }
     return this->cloneBaseTo(ctx, module);
 }
 int StaticModule::onOptimize(Interpreter::SessionMode stage) {
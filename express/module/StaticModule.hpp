@@ -9,6 +9,8 @@
 #ifndef StaticModule_hpp
 #define StaticModule_hpp
 
+#include <list>
+#include <mutex>
 #include <MNN/expr/Module.hpp>
 #include "core/Schedule.hpp"
 #include "core/Session.hpp"
@@ -18,17 +20,24 @@ class Session;
 class Backend;
 struct BufferStorage;
 namespace Express {
+struct CloneStatistic;
 class StaticModule : public Module {
 public:
-    StaticModule(std::vector<int> inputs, std::vector<int> outputs, std::vector<std::shared_ptr<BufferStorage>>&& buffer, Schedule::ScheduleInfo&& scheduleInfo, std::shared_ptr<Schedule::ScheduleInfo> sharedConst, Session::ModeGroup&& mode, RuntimeInfo&& rt, const Module::Config& config);
+    StaticModule(std::vector<int> inputs, std::vector<int> outputs, std::vector<std::shared_ptr<BufferStorage>>&& buffer, Schedule::ScheduleInfo&& scheduleInfo, std::shared_ptr<Schedule::ScheduleInfo> sharedConst, Session::ModeGroup&& mode, RuntimeInfo&& rt, const Module::Config& config, std::shared_ptr<CloneStatistic> cloneStatistic = nullptr);
     virtual ~ StaticModule();
     virtual std::vector<Express::VARP> onForward(const std::vector<Express::VARP>& inputs) override;
     virtual void onClearCache() override;
     virtual int onOptimize(Interpreter::SessionMode stage) override;
+    virtual bool onBindOutput(int index, void* ptr, size_t size) override;
 
 private:
     StaticModule() = default;
     void resetInputOutputs();
+    // crops: padded length and requested length of the padded axes, see _bucketAxis
+    std::vector<Express::VARP> _bucketInputs(const std::vector<Express::VARP>& inputs, std::map<int, std::pair<int, int>>& crops) const;
+    void _cropOutputs(std::vector<Express::VARP>& outputs, const std::map<int, std::pair<int, int>>& crops) const;
+    void _selectSession(const std::vector<Express::VARP>& inputs);
+    void _applyOutputBuffers();
 
     Module* clone(CloneContext* ctx) const override;
     struct Resource {
@@ -45,13 +54,36 @@ private:
         std::shared_ptr<Schedule::ScheduleInfo> mSharedConst;
         Session::ModeGroup mModes;
         std::vector<std::shared_ptr<BufferStorage>> mBuffer;
+        // The source weights of the rearranged ops for lazy packing, released after the first forward
+        std::vector<std::shared_ptr<BufferStorage>> mPackSources;
+        std::once_flag mPackSourcesRelease;
         std::vector<bool> mInputNeedCPU;
+        // Dims declared < 0 for each input except batch, padded by SHAPE_BUCKET_SIZE. Empty if the net isn't position-wise
+        std::vector<std::vector<int>> mInputDynamicDims;
+        // Shared with the RuntimeManager loading the module, may be nullptr
+        std::shared_ptr<CloneStatistic> mCloneStatistic;
+    };
+    // Session encoded for one input shape, see SHAPE_CACHE_SIZE
+    struct ShapeCache {
+        std::vector<int> mKey;
+        std::shared_ptr<Session> mSession;
+        std::vector<Tensor*> mInputTensors;
+        std::vector<std::pair<Tensor*, Backend*>> mPrevInputTensor;
+        std::vector<Tensor*> mOutputTensors;
     };
     std::shared_ptr<Session> mSession;
+    // Held by clone while it walks the executions of mSession, and by the resize of mSession creating executions.
+    // A resize keeping the shapes creates nothing, so the forwards of the module and its clones don't wait for it
+    mutable std::mutex mCloneLock;
     std::vector<Tensor*> mInputTensors;
     std::vector<std::pair<Tensor*, Backend*>> mPrevInputTensor;
     std::vector<Tensor*> mOutputTensors;
+    // Caller's memory bound to mOutputTensors, see Module::bindOutput
+    std::vector<std::pair<void*, size_t>> mOutputBuffers;
     std::shared_ptr<Resource> mResource;
+    // Input shape key of mSession and the inactive sessions, most recently used first
+    std::vector<int> mShapeKey;
+    std::list<ShapeCache> mShapeCaches;
 };
 }
 }
@@ -11,6 +11,8 @@
 #include <MNN/expr/ExprCreator.hpp>
 #include <MNN/expr/ExecutorScope.hpp>
 #include "RuntimeAttr.hpp"
+#include "Utils.hpp"
+#include "core/TensorUtils.hpp"
 #include "MNN_generated.h"
 //#define MNN_OPEN_TIME_TRACE
 #include <MNN/AutoTime.hpp>
@@ -162,18 +164,246 @@ WhileModule* WhileModule::create(const Op* op, const std::map<std::string, SubGr
     return module;
 }
 
+// The body rewrites its outputs when it runs again, so a scan output not stacked in place is copied
+static VARP _keepScanOutput(VARP value) {
+    auto info = value->getInfo();
+    if (nullptr == info || info->type.code == halide_type_handle) {
+        return value;
+    }
+    if (info->order == NC4HW4) {
+        return _Convert(_Clone(_Convert(value, NCHW), true), NC4HW4);
+    }
+    return _Clone(value, true);
+}
+
+// The loop-carried state alternates between two persistent tensors: the body run at even steps reads the first one
+// and writes the second, the body run at odd steps (a clone sharing the weights) reads the second and writes the
+// first. So each body sees the same input and output memory every step and needn't resize / malloc again, and the
+// body writes the state in place through Module::bindOutput. The state is only copied when the output can't be bound.
+class LoopState {
+public:
+    bool used() const {
+        return mEnable > 0;
+    }
+    // Let the body running at the parity write the buffer read by the next step
+    void bind(Module* body, int index, int parity) {
+        if (mEnable <= 0 || !mBind) {
+            return;
+        }
+        mBound[parity] = body->bindOutput(index, mPtr[1 - parity], mBytes);
+        if (!mBound[parity]) {
+            mBind = false;
+        }
+    }
+    void unbind(Module** bodies, int index) {
+        for (int i = 0; i < 2; ++i) {
+            if (mBound[i]) {
+                bodies[i]->bindOutput(index, nullptr, 0);
+                mBound[i] = false;
+            }
+        }
+    }
+    // Return the state for the next step
+    VARP update(Module** bodies, int index, VARP value, int parity) {
+        if (mEnable < 0) {
+            return value;
+        }
+        auto info = value->getInfo();
+        if (nullptr == info || info->order == NC4HW4 || info->type.code == halide_type_handle
+            || nullptr != TensorUtils::getDescribe(Utils::getTensor(value))->tensorArrayAttr.get()) {
+            return _disable(bodies, index, value);
+        }
+        if (0 == mEnable) {
+            mBytes = (size_t)info->size * info->type.bytes();
+            for (int i = 0; i < 2; ++i) {
+                mBuffer[i] = _Input(info->dim, info->order, info->type);
+                mPtr[i] = mBuffer[i]->writeMap<uint8_t>();
+                if (nullptr == mPtr[i]) {
+                    return _disable(bodies, index, value);
+                }
+            }
+            mEnable = 1;
+        } else {
+            auto bufferInfo = mBuffer[0]->getInfo();
+            if (bufferInfo->dim != info->dim || bufferInfo->type != info->type || bufferInfo->order != info->order) {
+                return _disable(bodies, index, value);
+            }
+        }
+        auto dst = mPtr[1 - parity];
+        auto src = value->readMap<uint8_t>();
+        if (nullptr == src) {
+            return _disable(bodies, index, value);
+        }
+        if (src != dst) {
+            if (mBound[parity]) {
+                // The body computes the output in its own memory
+                mBind = false;
+                unbind(bodies, index);
+            }
+            ::memcpy(dst, src, mBytes);
+        }
+        return mBuffer[1 - parity];
+    }
+private:
+    VARP _disable(Module** bodies, int index, VARP value) {
+        unbind(bodies, index);
+        mEnable = -1;
+        return value;
+    }
+    VARP mBuffer[2];
+    uint8_t* mPtr[2] = {nullptr, nullptr};
+    size_t mBytes = 0;
+    // 0 for not created, 1 for used, -1 for disabled by shape change
+    int mEnable = 0;
+    // false if the body can't write the output to the buffer
+    bool mBind = true;
+    bool mBound[2] = {false, false};
+};
+
+// The scan output of each step is written to its row of the stacked output, which grows by doubling up to the limit
+class ScanState {
+public:
+    void bind(Module* body, int index, int parity, int step, int limit) {
+        if (mEnable <= 0 || !mBind) {
+            return;
+        }
+        if (step >= mCapacity && !_grow(std::min(limit, mCapacity * 2), step)) {
+            return;
+        }
+        mBound[parity] = body->bindOutput(index, mPtr + step * mRowBytes, mRowBytes);
+        if (!mBound[parity]) {
+            mBind = false;
+        }
+    }
+    void unbind(Module** bodies, int index) {
+        for (int i = 0; i < 2; ++i) {
+            if (mBound[i]) {
+                bodies[i]->bindOutput(index, nullptr, 0);
+                mBound[i] = false;
+            }
+        }
+    }
+    bool update(Module** bodies, int index, VARP value, int parity, int step, int limit) {
+        if (mEnable < 0) {
+            mRows.emplace_back(_keepScanOutput(value));
+            return true;
+        }
+        auto info = value->getInfo();
+        if (0 == mEnable) {
+            if (nullptr == info || info->order == NC4HW4 || info->type.code == halide_type_handle) {
+                mEnable = -1;
+                mRows.emplace_back(_keepScanOutput(value));
+                return true;
+            }
+            mRowInfo = *info;
+            mRowBytes = (size_t)info->size * info->type.bytes();
+            // A row not aligned to 16 bytes can't be bound, copy it
+            mBind = 0 == mRowBytes % 16;
+            mEnable = 1;
+        } else if (nullptr == info || info->dim != mRowInfo.dim || info->type != mRowInfo.type || info->order != mRowInfo.order) {
+            MNN_ERROR("The scan output's shape changes in loop\n");
+            unbind(bodies, index);
+            return false;
+        }
+        if (step >= mCapacity && !_grow(std::min(limit, std::max(mCapacity * 2, 16)), step)) {
+            unbind(bodies, index);
+            return false;
+        }
+        auto dst = mPtr + step * mRowBytes;
+        auto src = value->readMap<uint8_t>();
+        if (nullptr == src) {
+            unbind(bodies, index);
+            return false;
+        }
+        if (src != dst) {
+            if (mBound[parity]) {
+                mBind = false;
+                unbind(bodies, index);
+            }
+            ::memcpy(dst, src, mRowBytes);
+        }
+        return true;
+    }
+    VARP result(int step) {
+        if (mEnable <= 0) {
+            return _Stack(mRows);
+        }
+        if (step == mCapacity) {
+            return mStack;
+        }
+        auto res = _Input(_rowsShape(step), mRowInfo.order, mRowInfo.type);
+        ::memcpy(res->writeMap<uint8_t>(), mPtr, step * mRowBytes);
+        return res;
+    }
+private:
+    std::vector<int> _rowsShape(int rows) const {
+        std::vector<int> shape = {rows};
+        shape.insert(shape.end(), mRowInfo.dim.begin(), mRowInfo.dim.end());
+        return shape;
+    }
+    bool _grow(int capacity, int step) {
+        if (capacity <= step) {
+            return false;
+        }
+        auto stack = _Input(_rowsShape(capacity), mRowInfo.order, mRowInfo.type);
+        auto ptr = stack->writeMap<uint8_t>();
+        if (nullptr == ptr) {
+            return false;
+        }
+        if (step > 0) {
+            ::memcpy(ptr, mPtr, step * mRowBytes);
+        }
+        mStack = stack;
+        mPtr = ptr;
+        mCapacity = capacity;
+        return true;
+    }
+    // Rows of the scan output that can't be stacked in place
+    std::vector<VARP> mRows;
+    VARP mStack;
+    uint8_t* mPtr = nullptr;
+    int mCapacity = 0;
+    Variable::Info mRowInfo;
+    size_t mRowBytes = 0;
+    // 0 for not created, 1 for used, -1 for kept as rows
+    int mEnable = 0;
+    bool mBind = true;
+    bool mBound[2] = {false, false};
+};
+
+// The module running the odd steps, cloned once with shared weights
+static Module* _swapModule(const std::shared_ptr<Module>& origin, std::shared_ptr<Module>& swap) {
+    if (nullptr == swap.get()) {
+        swap.reset(Module::clone(origin.get(), true));
+    }
+    if (nullptr == swap.get()) {
+        return origin.get();
+    }
+    return swap.get();
+}
+
 std::vector<Express::VARP> WhileModule::onForward(const std::vector<Express::VARP>& inputsI) {
     std::vector<Express::VARP> bodyInputs(mInfo->mBodyInputNumber);
     auto& inputs = inputsI;
     int step = 0;
     std::vector<Express::VARP> outputs(mInfo->mOutputNumber);
+    Module* bodies[2] = {mBody.get(), mBody.get()};
     if (mCond == nullptr) {
         auto limit = inputs[0]->readMap<int>()[0];
         int cond = inputs[1]->readMap<int>()[0];
         // Body Input: 2 + N, Body Output: 1 + N + K, Op output: N + K
         int N = mInfo->mBodyInputNumber - 2;
         int K = mInfo->mOutputNumber - N;
-        std::vector<std::vector<VARP>> spans(K);
+        std::vector<ScanState> scans(K);
+        std::vector<LoopState> states(N);
+        auto unbind = [&]() {
+            for (int i=0; i<N; ++i) {
+                states[i].unbind(bodies, i + 1);
+            }
+            for (int i=0; i<K; ++i) {
+                scans[i].unbind(bodies, 1 + N + i);
+            }
+        };
         std::vector<VARP> bodyOutputs;
         for (int i=0; i<N; ++i) {
             outputs[i] = inputs[i+2];
@@ -182,27 +412,48 @@ std::vector<Express::VARP> WhileModule::onForward(const std::vector<Express::VAR
             bodyInputs = inputs;
             bodyInputs[0] = _Input({}, NCHW, halide_type_of<int>());
             while (step < limit && cond > 0) {
+                int parity = step % 2;
+                if (1 == step) {
+                    for (auto& s : states) {
+                        if (s.used()) {
+                            bodies[1] = _swapModule(mBody, mBodySwap);
+                            break;
+                        }
+                    }
+                }
+                auto body = bodies[parity];
+                for (int i=0; i<N; ++i) {
+                    states[i].bind(body, i + 1, parity);
+                }
+                for (int i=0; i<K; ++i) {
+                    scans[i].bind(body, 1 + N + i, parity, step, limit);
+                }
                 bodyInputs[0]->writeMap<int>()[0] = step;
-                bodyOutputs = mBody->onForward(bodyInputs);
+                bodyOutputs = body->onForward(bodyInputs);
                 if (bodyOutputs.empty()) {
                     // Has Error
+                    unbind();
                     return {};
                 }
                 for (int i=0; i<N; ++i) {
-                    bodyInputs[i + 2] = bodyOutputs[i + 1];
+                    bodyInputs[i + 2] = states[i].update(bodies, i + 1, bodyOutputs[i + 1], parity);
                 }
                 for (int i=0; i<K; ++i) {
-                    spans[i].emplace_back(bodyOutputs[1+N+i]);
+                    if (!scans[i].update(bodies, 1 + N + i, bodyOutputs[1 + N + i], parity, step, limit)) {
+                        unbind();
+                        return {};
+                    }
                 }
                 step++;
                 cond = bodyOutputs[0]->readMap<int>()[0];
             }
+            unbind();
             for (int i=0; i<N; ++i) {
-                outputs[i] = bodyOutputs[i+1];
+                outputs[i] = bodyInputs[i + 2];
             }
         }
         for (int i=0; i<K; ++i) {
-            outputs[i+N] = _Stack(spans[i]);
+            outputs[i+N] = scans[i].result(step);
         }
         return outputs;
     }
@@ -217,11 +468,38 @@ std::vector<Express::VARP> WhileModule::onForward(const std::vector<Express::VAR
     for (int i = 0; i < mInfo->mOutputFromInput.size(); ++i) {
         outputs[i] = inputs[mInfo->mOutputFromInput[i]];
     }
+    // The body outputs updating cond / body inputs
+    std::set<int> stateIndexes;
+    for (auto& p : mInfo->mUpdateForCond) {
+        stateIndexes.insert(p.second);
+    }
+    for (auto& p : mInfo->mUpdateForBody) {
+        stateIndexes.insert(p.second);
+    }
+    std::vector<LoopState> states(stateIndexes.empty() ? 0 : *stateIndexes.rbegin() + 1);
+    auto unbind = [&]() {
+        for (auto index : stateIndexes) {
+            states[index].unbind(bodies, index);
+        }
+    };
+    // The cond of a step reads the same buffers as the body
+    Module* conds[2] = {mCond.get(), mCond.get()};
     while (true) {
+        int parity = step % 2;
+        if (1 == step) {
+            for (auto index : stateIndexes) {
+                if (states[index].used()) {
+                    bodies[1] = _swapModule(mBody, mBodySwap);
+                    conds[1] = _swapModule(mCond, mCondSwap);
+                    break;
+                }
+            }
+        }
         VARP res;
         {
-            auto condOutputs = mCond->onForward(condInputs);
+            auto condOutputs = conds[parity]->onForward(condInputs);
             if (condOutputs.empty()) {
+                unbind();
                 return {};
             }
             res = condOutputs[0];
@@ -232,10 +510,18 @@ std::vector<Express::VARP> WhileModule::onForward(const std::vector<Express::VAR
         }
         step++;
         // MNN_PRINT("before while op name: %s, step:%d\n", name().c_str(), step);
-        auto bodyOutputs = mBody->onForward(bodyInputs);
+        auto body = bodies[parity];
+        for (auto index : stateIndexes) {
+            states[index].bind(body, index, parity);
+        }
+        auto bodyOutputs = body->onForward(bodyInputs);
         if (bodyOutputs.empty()) {
+            unbind();
             return {};
         }
+        for (auto index : stateIndexes) {
+            bodyOutputs[index] = states[index].update(bodies, index, bodyOutputs[index], parity);
+        }
         for (auto& p : mInfo->mUpdateForCond) {
             condInputs[p.first] = bodyOutputs[p.second];
         }
@@ -255,6 +541,7 @@ std::vector<Express::VARP> WhileModule::onForward(const std::vector<Express::VAR
             outputs[mInfo->mOutputFromBodyInput[i].first] = bodyInputs[mInfo->mOutputFromBodyInput[i].second];
         }
     }
+    unbind();
     for (auto o : outputs) {
         MNN_ASSERT(nullptr != o);
     }
@@ -47,6 +47,10 @@ private:
 
     std::shared_ptr<Module> mCond;
     std::shared_ptr<Module> mBody;
+
+    // Clones of cond / body sharing the weights, run at odd steps for double-buffered loop state
+    std::shared_ptr<Module> mCondSwap;
+    std::shared_ptr<Module> mBodySwap;
 };
 }
 }
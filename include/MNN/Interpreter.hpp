@@ -111,6 +111,14 @@ public:
      * @return created net if success, NULL otherwise.
      */
     static Interpreter* createFromFile(const char* file);
+    /**
+     * @brief create net from file by read-only memory mapping, fallback to createFromFile if mapping failed.
+     * Const tensors for cpu alias the mapped model / external weight file instead of copying them,
+     * so the weights are paged in on first use. updateSessionToModel is not supported for mapped net.
+     * @param file  given file.
+     * @return created net if success, NULL otherwise.
+     */
+    static Interpreter* createFromMappedFile(const char* file);
     /**
      * @brief create net from buffer.
      * @param buffer    given data buffer.
@@ -163,6 +171,10 @@ public:
         /** Dynamic Reisze Optimization */
         Session_Resize_Check = 14, // Open Trace for resize
         Session_Resize_Fix = 15, // Apply Resize Optimization
+
+        /** Determine whether the sessions created by the interpreter share const tensors and packed weights, default Session_Const_Separate */
+        Session_Const_Separate = 16, // Each session holds its own const tensors and weights
+        Session_Const_Share = 17, // Sessions share const tensors and packed weights, so N sessions cost one copy of weights
     };
     /**
      * @brief The API shoud be called before create session.
@@ -206,6 +218,38 @@ public:
 
         // Geometry Compute option, default is 0xFFFF
         GEOMETRY_COMPUTE_MASK = 4,
+
+        // Inter-op parallel for CPU: max number of independent ops run at the same time, default 0 (close).
+        // If set >= 2, independent branches of the net are computed concurrently and each op uses one thread.
+        INTER_OP_PARALLEL = 5,
+
+        // Weight packing for CPU convolution, default 0 (pack when creating session).
+        // 1: pack each weight on its first execution. 2: as 1, and pack weights on a background thread in execution order.
+        // If not 0, releaseModel keeps the model buffer, since unpacked weights still refer to it.
+        WEIGHT_PACK_MODE = 6,
+
+        // For Module with shapeMutable: max number of sessions encoded for different input shapes and kept in LRU order,
+        // a recurring input shape reuses its session and skip resize. Default 0 (close).
+        SHAPE_CACHE_SIZE = 7,
+        // For Module with shapeMutable: pad the dynamic dims of input (declared < 0 in model, except batch and dims of 1)
+        // up to a multiple of this value with zero, so that near shapes share one cached session, and crop the outputs
+        // back to the requested shape. Default 0 (close). Only applies to position-wise nets (element-wise ops and 1x1
+        // convolutions), it's ignored for a net with ops such as reduction, softmax, pooling or larger convolutions.
+        SHAPE_BUCKET_SIZE = 8,
+
+        // For Module on CPU: max number of independent submodules run at the same time, default 0 (close). The module is
+        // split into submodules at control flow ops (If / While), a net without them stays one session.
+        // If set >= 2, each concurrent submodule uses its own CPU runtime with the threads divided among them.
+        SUBMODULE_PARALLEL = 9,
+
+        // For CPU: measure the candidate kernels (Winograd unit, Strassen or tiled GEMM) of each float convolution shape
+        // when creating executions and use the fastest one, default 0 (close). The choices are stored to the cache file
+        // set by setCacheFile / RuntimeManager::setCache, so that later runs reuse them without measuring.
+        CPU_KERNEL_TUNING = 10,
+
+        // For CPU: compute the 1x1 float convolutions (linear layers) with 8 bit quantized weight by int8 GEMM, the input is
+        // quantized on the fly with a scale for each row (token), default 0 (close). Other convolutions are not changed.
+        CPU_DYNAMIC_QUANT = 11,
     };
 
     enum GeometryComputeMask {
@@ -380,9 +424,57 @@ public:
         /** Mode / NumberThread, int* */
         THREAD_NUMBER = 4,
 
+        /** Sessions cloned by Module::clone for the modules loaded by a RuntimeManager, float*, length >= 4:
+         live cloned session number / average clone time in ms / activation memory per live cloned session in MB /
+         executions per cloned session that can't share the packed weights and are rebuilt on resize.
+         Only supported by Executor::RuntimeManager::getInfo */
+        CLONE_INFO = 5,
+
+        /** Detailed memory usage, MemoryReport*, set MemoryReport::topNumber before calling.
+         For Executor::RuntimeManager::getInfo, the sessions of the modules loaded by it are counted */
+        MEMORY_REPORT = 6,
+
         ALL
     };
 
+    /** Memory usage for MEMORY_REPORT, the dynamic part is recorded by the last resize of the sessions */
+    struct MemoryReport {
+        struct OpMemory {
+            std::string name;
+            /** static memory (packed weights, constants) allocated when creating the op's executions */
+            size_t staticBytes = 0;
+            /** dynamic memory in use when resizing the op, including its inputs, outputs and temporary buffers */
+            size_t dynamicBytes = 0;
+        };
+        struct TensorMemory {
+            /** name of the op producing the tensor, "input" for the session's inputs */
+            std::string op;
+            size_t bytes = 0;
+        };
+        /** max number of peakTensors, negative means no limit */
+        int topNumber = 10;
+
+        /** memory allocated by the runtimes, the same as MEMORY but in bytes */
+        size_t runtimeBytes = 0;
+        /** memory kept in the runtimes' free lists, and its fragmentation: 1 - largest free block / runtimeFreeBytes */
+        size_t runtimeFreeBytes = 0;
+        float runtimeFragmentation = 0.0f;
+
+        /** ops allocating static memory or resized with dynamic memory, in execution order */
+        std::vector<OpMemory> ops;
+
+        /** size of dynamic memory arena (activations) and its high-water mark */
+        size_t dynamicBytes = 0;
+        size_t dynamicPeakBytes = 0;
+
+        /** op reaching the high-water mark, the dynamic memory used then, and the fragmentation of the dynamic free lists */
+        std::string peakOpName;
+        size_t peakOpBytes = 0;
+        float peakFragmentation = 0.0f;
+        /** largest dynamic tensors alive at the high-water mark, in descending order of bytes */
+        std::vector<TensorMemory> peakTensors;
+    };
+
     /**
      * @brief get session info
      * @param session   given session.
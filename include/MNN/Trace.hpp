@@ -0,0 +1,42 @@
+//
+//  Trace.hpp
+//  MNN
+//
+//  Created by MNN on 2024/03/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MNN_Trace_hpp
+#define MNN_Trace_hpp
+
+#include <MNN/MNNDefine.h>
+
+namespace MNN {
+/**
+ Process-wide op tracing. When started, each op run by a session (Interpreter, Module or lazy Express compute) records
+ its name, type, begin / end time, thread, flops and bytes of inputs / outputs, and session resize is recorded as a whole.
+ The events are kept in a ring buffer and can be written as Chrome trace JSON, which is opened by Perfetto or chrome://tracing.
+ */
+class MNN_PUBLIC Trace {
+public:
+    /**
+     * @brief start recording and clear recorded events.
+     * @param capacity  max number of events kept, the earliest events are overwritten when more are recorded.
+     */
+    static void start(int capacity = 65536);
+
+    // stop recording, the recorded events are kept for dump
+    static void stop();
+
+    static bool enabled();
+
+    /**
+     * @brief write recorded events as Chrome trace JSON.
+     * @param fileName  path of json file.
+     * @return false if nothing recorded or the file can't be written.
+     */
+    static bool dump(const char* fileName);
+};
+} // namespace MNN
+
+#endif
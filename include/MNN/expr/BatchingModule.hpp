@@ -0,0 +1,77 @@
+//
+//  BatchingModule.hpp
+//  MNN
+//
+//  Created by MNN on 2024/03/13.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MNN_BatchingModule_hpp
+#define MNN_BatchingModule_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <MNN/expr/Module.hpp>
+
+namespace MNN {
+namespace Express {
+/**
+ Merge concurrent requests to a loaded Module along batch axis (dim 0) and run them by one onForward.
+ The requests are merged if their inputs have the same shape except batch, all outputs of the Module
+ must have the batch axis at dim 0 too. Each caller get its own part of outputs, stored in host memory.
+ */
+class MNN_PUBLIC BatchingModule : public Module {
+public:
+    struct BatchConfig {
+        // Max sum of batch merged into one forward
+        int maxBatch = 8;
+        // Max time in microseconds the first request waits for others, a request without batch axis doesn't wait
+        int maxWaitUs = 1000;
+    };
+    /**
+     * @brief create batching module, the forward runs on a worker thread with its own Executor, on a clone of
+     * the module sharing weights.
+     * @param module    loaded module. If it can't be cloned, it must not be used by others at the same time.
+     * @param config    batch config.
+     */
+    BatchingModule(std::shared_ptr<Module> module, const BatchConfig& config);
+    virtual ~BatchingModule();
+
+    /**
+     * @brief submit a request, the inputs must be computable.
+     * @return future of outputs, empty if forward failed.
+     */
+    std::future<std::vector<VARP>> submit(const std::vector<VARP>& inputs);
+
+    // Submit and wait
+    virtual std::vector<VARP> onForward(const std::vector<VARP>& inputs) override;
+    // Same as submit
+    virtual std::future<std::vector<VARP>> onForwardAsync(const std::vector<VARP>& inputs) override;
+
+private:
+    struct Request {
+        std::vector<VARP> inputs;
+        int batch;
+        std::chrono::steady_clock::time_point time;
+        std::promise<std::vector<VARP>> result;
+    };
+    void _run();
+    void _forward(std::vector<std::shared_ptr<Request>>& requests);
+    static bool _canMerge(const Request* a, const Request* b);
+
+    std::shared_ptr<Module> mModule;
+    std::shared_ptr<Executor> mExecutor;
+    BatchConfig mConfig;
+    std::deque<std::shared_ptr<Request>> mRequests;
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    bool mStop = false;
+    std::thread mWorker;
+};
+} // namespace Express
+} // namespace MNN
+
+#endif
@@ -10,6 +10,7 @@
 #define MNN_Train_Module_hpp
 
 #include <vector>
+#include <future>
 #include <unordered_map>
 
 #include <MNN/expr/Expr.hpp>
@@ -22,7 +23,7 @@ struct SubGraph;
 class MNN_PUBLIC Module {
 public:
     Module()                                                                               = default;
-    virtual ~Module()                                                                      = default;
+    virtual ~Module();
     virtual std::vector<Express::VARP> onForward(const std::vector<Express::VARP>& inputs) = 0;
     Express::VARP forward(Express::VARP input);
     std::vector<Express::VARP> parameters() const;
@@ -74,6 +75,10 @@ public:
     
     static Module* extract(std::vector<Express::VARP> inputs, std::vector<Express::VARP> outputs, bool fortrain, const std::map<std::string, SubGraph>& subGraph = {});
 
+    // Clone for another thread: the loaded constant tensors and packed weights are shared, the clone allocates its
+    // activation memory on first forward. It's safe to clone a module while it or its clones run in other threads.
+    // Clone after the first forward to share all weights; the ops whose execution can't be cloned still pack their
+    // own weights, counted by Interpreter::CLONE_INFO
     static Module* clone(const Module* module, const bool shareParams = false);
 
     struct Info {
@@ -117,13 +122,43 @@ public:
     static void destroy(Module* m);
 
     int traceOrOptimize(Interpreter::SessionMode stage);
+
+    /**
+     * @brief bind caller-owned host memory as the storage of an output for the following onForward, the output
+     * is written there directly and the returned VARP refers to it. Supported by the static module's output on CPU
+     * backend in NCHW / NHWC, others are still computed in the module's memory.
+     * The input is not copied either if it's created as Variable::create(Expr::create(info, ptr, VARP::INPUT,
+     * Expr::REF)) and the module is loaded with shapeMutable = true.
+     * @param index output index.
+     * @param ptr   host memory aligned to 16 bytes at least, keep valid until rebound. nullptr for unbind.
+     * @param size  size of the memory in bytes.
+     * @return false if the output can't be bound.
+     */
+    bool bindOutput(int index, void* ptr, size_t size);
 protected:
     virtual int onOptimize(Interpreter::SessionMode stage) {
         return 0;
     }
+    virtual bool onBindOutput(int index, void* ptr, size_t size) {
+        return false;
+    }
     virtual void onClearCache() {
     }
-
+public:
+    /**
+     * @brief Run onForward in a worker thread. The inputs are computed in the caller thread before return, so the
+     * preprocess of next request (such as NCHW -> NC4HW4) overlaps with the running forward. The forwards of one
+     * module run in submit order, and the outputs are copied out so the next forward won't overwrite them.
+     * The forward runs on a clone of the module sharing weights, with its own Executor, so the caller can keep
+     * using its Executor meanwhile. A module that can't be cloned runs the forward in the caller thread.
+     */
+    virtual std::future<std::vector<Express::VARP>> onForwardAsync(const std::vector<Express::VARP>& inputs);
+    /**
+     * @brief Copy the input variables in onForwardAsync, so the caller can write next request into them at once.
+     * At most two requests are in flight in this mode, the third one waits for the first one.
+     */
+    void setAsyncDoubleBuffer(bool enable);
+protected:
     Module* cloneBaseTo(CloneContext* ctx, Module* module) const;
 
     std::vector<std::shared_ptr<Module>> mChildren;
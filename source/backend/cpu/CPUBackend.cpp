@@ -9,6 +9,7 @@
 #include "backend/cpu/CPUBackend.hpp"
 #include <cmath>
 #include <mutex>
+#include <sstream>
 #include "CPUResizeCache.hpp"
 #include "core/BufferAllocator.hpp"
 #include "CPUTensorConvert.hpp"
@@ -19,6 +20,7 @@
 #include "CPUCast.hpp"
 #include "core/OpCommonUtils.hpp"
 #include "core/WrapExecution.hpp"
+#include "core/FileLoader.hpp"
 #ifdef _OPENMP
 #include <omp.h>
 #endif // _OPENMP
@@ -108,6 +110,78 @@ float CPURuntime::onGetMemoryInMB() {
     auto staticMemoryInMB = mStaticAllocator->totalSize() / 1024.0f / 1024.0f;
     return staticMemoryInMB;
 }
+bool CPURuntime::onGetMemoryStatistic(BufferAllocator::Statistic& statistic) const {
+    mStaticAllocator->getStatistic(statistic);
+    return true;
+}
+// Cache content: magic line, then a "key choice" line for each measured op
+static const char* gTuneCacheMagic = "MNN_CPU_TUNE_V1";
+
+bool CPURuntime::onSetCache(const void* buffer, size_t size) {
+    std::unique_lock<std::mutex> _l(mTuneLock);
+    mTuneBuffer.clear();
+    if (nullptr == buffer) {
+        // Only release the serialized buffer, the measured choices are still valid for this runtime
+        return true;
+    }
+    std::istringstream input(std::string((const char*)buffer, size));
+    std::string line;
+    if (!std::getline(input, line) || line != gTuneCacheMagic) {
+        // Not written by CPU, keep it valid if tuning is not used
+        return 0 == getKernelTuning();
+    }
+    std::string key;
+    int choice;
+    while (input >> key >> choice) {
+        mTuneChoices[key] = choice;
+    }
+    return true;
+}
+
+std::pair<const void*, size_t> CPURuntime::onGetCache() {
+    std::unique_lock<std::mutex> _l(mTuneLock);
+    if (mTuneChoices.empty()) {
+        return std::make_pair(nullptr, 0);
+    }
+    std::ostringstream output;
+    output << gTuneCacheMagic << "\n";
+    for (auto& iter : mTuneChoices) {
+        output << iter.first << " " << iter.second << "\n";
+    }
+    mTuneBuffer = output.str();
+    return std::make_pair(mTuneBuffer.c_str(), mTuneBuffer.size());
+}
+
+bool CPURuntime::findTuneChoice(const std::string& key, int& choice) const {
+    std::unique_lock<std::mutex> _l(mTuneLock);
+    auto iter = mTuneChoices.find(key);
+    if (iter == mTuneChoices.end()) {
+        return false;
+    }
+    choice = iter->second;
+    return true;
+}
+
+void CPURuntime::addTuneChoice(const std::string& key, int choice) const {
+    std::unique_lock<std::mutex> _l(mTuneLock);
+    mTuneChoices[key] = choice;
+}
+
+std::shared_ptr<FileMapper> CPURuntime::mapFile(const std::string& file) const {
+    std::unique_lock<std::mutex> _l(mMapperLock);
+    auto mapper = mMappers[file].lock();
+    if (nullptr != mapper) {
+        return mapper;
+    }
+    mapper.reset(new FileMapper(file.c_str()));
+    if (!mapper->valid()) {
+        mMappers.erase(file);
+        return nullptr;
+    }
+    mMappers[file] = mapper;
+    return mapper;
+}
+
 bool CPURuntime::onCheckInfo(Backend::Info& info) const {
 #ifdef MNN_USE_THREAD_POOL
     int threadNumber = mThreadNumber;
@@ -244,6 +318,9 @@ CPUBackend::CPUBackend(const CPURuntime* runtime, BackendConfig::PrecisionMode p
 }
 
 CPUBackend::~CPUBackend() {
+    if (mLazyPackWarmup.valid()) {
+        mLazyPackWarmup.wait();
+    }
     mCacheGroup.clear();
 }
 
@@ -278,11 +355,91 @@ bool CPUBackend::onSelectDynamicAllocator(int index, int maxIndex) {
     return true;
 }
 
+float CPUBackend::onGetDynamicMemoryInMB() const {
+    size_t total = mDynamicAllocator->totalSize();
+    if (nullptr != mDynamicAllocatorBackup.get()) {
+        total += mDynamicAllocatorBackup->totalSize();
+    }
+    return total / 1024.0f / 1024.0f;
+}
+
+bool CPUBackend::onGetDynamicMemoryStatistic(BufferAllocator::Statistic& statistic, bool resetPeak) {
+    mCurrentDynamicAllocator->getStatistic(statistic);
+    if (resetPeak) {
+        mCurrentDynamicAllocator->resetPeak();
+    }
+    statistic.totalBytes = mDynamicAllocator->totalSize();
+    if (nullptr != mDynamicAllocatorBackup.get()) {
+        statistic.totalBytes += mDynamicAllocatorBackup->totalSize();
+    }
+    return true;
+}
+
 ErrorCode CPUBackend::onResizeEnd() {
     getCache()->release();
+    for (auto& cache : mParallelCache) {
+        cache->release();
+    }
+    if (2 == weightPackMode() && !mLazyPacks.empty()) {
+        // Warm up: pack weights in background by execution order, the execution waits only for its own weight
+        std::vector<std::weak_ptr<CPULazyPack>> packs;
+        packs.swap(mLazyPacks);
+        mLazyPackWarmup = std::async(std::launch::async, [](std::vector<std::weak_ptr<CPULazyPack>> packs) {
+            for (auto& iter : packs) {
+                auto pack = iter.lock();
+                if (nullptr != pack) {
+                    pack->run();
+                }
+            }
+        }, std::move(packs));
+    }
     return mCurrentDynamicAllocator->compute();
 }
 
+void CPUBackend::addLazyPack(std::shared_ptr<CPULazyPack> pack) {
+    if (2 == weightPackMode()) {
+        mLazyPacks.emplace_back(pack);
+    }
+}
+
+void CPUBackend::onParallelResizeBegin() {
+    mCurrentDynamicAllocator->barrierBegin();
+}
+
+void CPUBackend::onParallelResizeEnd() {
+    mCurrentDynamicAllocator->barrierEnd();
+}
+
+void CPUBackend::onParallelGroupBegin() {
+    mCurrentDynamicAllocator->beginGroup();
+    std::shared_ptr<CPUResizeCache> cache(new CPUResizeCache);
+    mParallelCache.emplace_back(cache);
+    mParallelOriginCache = mCache;
+    mCache = cache.get();
+}
+
+void CPUBackend::onParallelGroupEnd() {
+    mCache = mParallelOriginCache;
+    mParallelOriginCache = nullptr;
+    mCurrentDynamicAllocator->endGroup();
+}
+
+void CPUBackend::onParallelExecute(const std::function<void(int)>& task, int size) const {
+#ifdef MNN_USE_THREAD_POOL
+    auto taskIndex = mRuntime->mTaskIndex;
+    if (taskIndex >= 0 && size > 1) {
+        // The executions compute in one thread when taskIndex < 0
+        mRuntime->mTaskIndex = -1;
+        ThreadPool::enqueue(std::make_pair(task, size), taskIndex);
+        mRuntime->mTaskIndex = taskIndex;
+        return;
+    }
+#endif
+    for (int i = 0; i < size; ++i) {
+        task(i);
+    }
+}
+
 Backend::MemObj* CPUBackend::allocBuffer(size_t size, Tensor* dest, StorageType storageType) {
     auto originMem = TensorUtils::getDescribeOrigin(dest)->mem.get();
     if (nullptr != originMem) {
@@ -470,7 +627,15 @@ const Runtime* CPUBackend::getRuntime() {
 }
 
 bool CPUBackend::onClearBuffer() {
+    // Executions will be released after clear buffer, make sure no weight is packing
+    if (mLazyPackWarmup.valid()) {
+        mLazyPackWarmup.wait();
+    }
     mCache->reset();
+    for (auto& cache : mParallelCache) {
+        cache->reset();
+    }
+    mParallelCache.clear();
     mCurrentDynamicAllocator->release(true);
     return true;
 }
@@ -9,14 +9,19 @@
 #ifndef CPUBackend_hpp
 #define CPUBackend_hpp
 
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include "core/Backend.hpp"
 #include "core/Execution.hpp"
 #include "core/BufferAllocator.hpp"
 #include "MNN_generated.h"
 
 namespace MNN {
+class FileMapper;
 class CPURuntime : public Runtime {
 public:
     friend class CPUBackend;
@@ -26,12 +31,27 @@ public:
     virtual Backend* onCreate(const BackendConfig* config) const override;
     virtual void onGabageCollect(int level) override;
     virtual float onGetMemoryInMB() override;
+    virtual bool onGetMemoryStatistic(BufferAllocator::Statistic& statistic) const override;
     virtual CompilerType onGetCompilerType() const override {
         return Compiler_Loop;
     }
     void onConcurrencyBegin() const;
     void onConcurrencyEnd() const;
     virtual bool onCheckInfo(Backend::Info& info) const override;
+    // Store the measured kernel choices of CPU_KERNEL_TUNING
+    virtual bool onSetCache(const void* buffer, size_t size) override;
+    virtual std::pair<const void*, size_t> onGetCache() override;
+
+    /**
+     Kernel choices measured for Interpreter::CPU_KERNEL_TUNING, key is the op signature.
+     findTuneChoice returns false if the key hasn't been measured.
+     */
+    bool findTuneChoice(const std::string& key, int& choice) const;
+    void addTuneChoice(const std::string& key, int choice) const;
+
+    // Read-only mapping of an external weight file, shared by the executions of this runtime reading the file.
+    // Return nullptr if the file can't be mapped
+    std::shared_ptr<FileMapper> mapFile(const std::string& file) const;
 
 private:
     std::shared_ptr<EagerBufferAllocator> mStaticAllocator;
@@ -47,6 +67,13 @@ private:
     static Backend*(*gExtraCreate)(const Runtime* runtime);
     size_t mFlags = 0;
     int mAllocator = 0;
+
+    mutable std::mutex mTuneLock;
+    mutable std::map<std::string, int> mTuneChoices;
+    std::string mTuneBuffer;
+
+    mutable std::mutex mMapperLock;
+    mutable std::map<std::string, std::weak_ptr<FileMapper>> mMappers;
 };
 struct CoreFunctions;
 struct CoreInt8Functions;
@@ -54,7 +81,7 @@ struct CoreInt8Functions;
 class CPUResizeCache;
 class CPUMemObj : public Backend::MemObj {
 public:
-    CPUMemObj(BufferAllocator* allocator, MemChunk chunk, int size) : mAllocator(allocator), mChunk(chunk), mSize(size) {}
+    CPUMemObj(BufferAllocator* allocator, MemChunk chunk, size_t size) : mAllocator(allocator), mChunk(chunk), mSize(size) {}
     virtual ~ CPUMemObj() {
         if (mAllocator) {
             mAllocator->free(mChunk);
@@ -63,14 +90,40 @@ public:
     virtual MemChunk chunk() {
         return mChunk;
     }
-    inline int getSize() const {
+    inline size_t getSize() const {
         return mSize;
     }
 private:
     BufferAllocator* mAllocator;
     MemChunk mChunk;
-    int mSize;
+    size_t mSize;
 };
+// Memory aliasing a mapped file, keeps the mapping valid. The tensor owning it is read only
+class MappedMemObj : public CPUMemObj {
+public:
+    MappedMemObj(std::shared_ptr<FileMapper> mapper, const void* ptr, size_t size) : CPUMemObj(nullptr, MemChunk((void*)ptr), size), mMapper(mapper) {
+    }
+    virtual ~ MappedMemObj() = default;
+private:
+    std::shared_ptr<FileMapper> mMapper;
+};
+// Weight packing deferred to first execution, see Interpreter::WEIGHT_PACK_MODE
+class CPULazyPack {
+public:
+    CPULazyPack(std::function<void()>&& pack) : mPack(std::move(pack)) {
+    }
+    // Pack if not packed yet, wait if another thread is packing
+    void run() {
+        std::call_once(mFlag, [this]() {
+            mPack();
+            mPack = nullptr;
+        });
+    }
+private:
+    std::function<void()> mPack;
+    std::once_flag mFlag;
+};
+
 class CPUBackend : public Backend {
 public:
     CPUBackend(const CPURuntime* runtime, BackendConfig::PrecisionMode precision, BackendConfig::MemoryMode memory, MNNForwardType type = MNN_FORWARD_CPU, size_t flags = 0);
@@ -79,6 +132,8 @@ public:
     // Return sizeDivide, scheduleNumber aligned memory
     std::pair<int, int> multiThreadDivide(int size) const;
     virtual bool onSelectDynamicAllocator(int index, int maxIndex) override;
+    virtual float onGetDynamicMemoryInMB() const override;
+    virtual bool onGetDynamicMemoryStatistic(BufferAllocator::Statistic& statistic, bool resetPeak) override;
 
 public:
     virtual MemObj* onAcquire(const Tensor* nativeTensor, StorageType storageType) override;
@@ -97,6 +152,30 @@ public:
     virtual void onResizeBegin() override;
     virtual ErrorCode onResizeEnd() override;
 
+    /**
+     Inter-op parallel support, used by Pipeline to run independent commands concurrently.
+     Between onParallelResizeBegin / onParallelResizeEnd, the dynamic memory acquired in different
+     groups (onParallelGroupBegin / onParallelGroupEnd) won't overlap.
+     */
+    void onParallelResizeBegin();
+    void onParallelResizeEnd();
+    void onParallelGroupBegin();
+    void onParallelGroupEnd();
+    /**
+     Run task(0) ... task(size-1) concurrently on the thread pool, each task runs with only one thread.
+     */
+    void onParallelExecute(const std::function<void(int)>& task, int size) const;
+
+    /**
+     Lazy weight packing. If weightPackMode() > 0, executions can pack weight by CPULazyPack and register it by
+     addLazyPack, then call CPULazyPack::run before using the weight. If weightPackMode() == 2, the registered
+     packings run on a background thread in creation order after resize.
+     */
+    int weightPackMode() const {
+        return mRuntime->getWeightPackMode();
+    }
+    void addLazyPack(std::shared_ptr<CPULazyPack> pack);
+
     const CoreFunctions* functions() const {
         return mCoreFunctions;
     }
@@ -156,6 +235,11 @@ private:
     static std::map<OpType, CPUBackend::Creator*>* gCreator;
     CPUResizeCache* mCache;
     std::vector<std::shared_ptr<CPUResizeCache>> mCacheGroup;
+    // Separate resize cache for each parallel group, avoid sharing converted tensor among concurrent commands
+    std::vector<std::shared_ptr<CPUResizeCache>> mParallelCache;
+    std::vector<std::weak_ptr<CPULazyPack>> mLazyPacks;
+    std::future<void> mLazyPackWarmup;
+    CPUResizeCache* mParallelOriginCache = nullptr;
     BufferAllocator* mCurrentDynamicAllocator = nullptr;
 };
 /** execution cast wrapper. insert tensor cast dynamic. */
@@ -49,6 +49,8 @@ public:
         std::shared_ptr<Tensor> mBias;
         ResourceDequantizeInfo mDequantize;
         Backend* backend;
+        // Not null if the weight is packed lazily, run it before using mWeight
+        std::shared_ptr<CPULazyPack> mLazyPack;
         bool copyBiasAlign(const float* bias, int outputCount);
         int hU;
         int lU;
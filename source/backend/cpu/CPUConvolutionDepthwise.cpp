@@ -207,6 +207,26 @@ ErrorCode CPUConvolutionDepthwise::BasicFloatExecution::onResize(const std::vect
             }
         }
     };
+    // The mid rect is computed with bias and activation by linePostFunc, then only the border needs postFunc
+    auto linePostFunc = bytes == 4 ? core->MNNConvRunForLineDepthwisePost : nullptr;
+    bool hardSwish = mHardSwish;
+    auto linePostData = postData;
+    linePostData.emplace_back(hardSwish ? 1.0f : 0.0f);
+    auto runPost = [=](uint8_t* dst_z, const uint8_t* bias_z, int L, int T, int R, int B) {
+        if (R <= L) {
+            return;
+        }
+        for (int dy = T; dy < B; ++dy) {
+            auto dst_x = (float*)(dst_z + (dy * dst_y_step + L * unit) * bytes);
+            postFunc(dst_x, dst_x, (const float*)bias_z, R - L, 0, 0, 1, postData.data());
+            if (hardSwish) {
+                MNNHardSwishCommon(dst_x, dst_x, (R - L) * unit);
+            }
+        }
+    };
+    bool hasEpilogue = !mEpilogue.empty();
+    auto epilogue = &mEpilogue;
+    int plane = dst_width * dst_height;
     mExecutor   = [=](const uint8_t* srcOrigin, uint8_t* dstOrigin, int tId) {
         auto biasP   = inputs[2]->host<uint8_t>();
         auto weightP = inputs[1]->host<uint8_t>();
@@ -220,13 +240,31 @@ ErrorCode CPUConvolutionDepthwise::BasicFloatExecution::onResize(const std::vect
             runBasic(dst_z, src_z, weight_dz, 0, b, dst_width, dst_height);
             runBasic(dst_z, src_z, weight_dz, 0, t, l, b);
             runBasic(dst_z, src_z, weight_dz, r, t, dst_width, b);
-            if (r > l && b > t) {
-                lineFunc((float*)(dst_z + (t * dst_y_step + l * unit) * bytes),
-                                           (const float*)(src_z + ((t * strideY - padY) * src_y_step + (l * strideX - padX) * unit) * bytes),
-                                           (const float*)weight_dz, r - l, strideX * unit, kernel_width, kernel_height, dilateX_step,
-                                           dilateY_step, b - t, src_y_step * strideY, dst_y_step);
+            if (nullptr != linePostFunc) {
+                if (r > l && b > t) {
+                    linePostFunc((float*)(dst_z + (t * dst_y_step + l * unit) * bytes),
+                                 (const float*)(src_z + ((t * strideY - padY) * src_y_step + (l * strideX - padX) * unit) * bytes),
+                                 (const float*)weight_dz, r - l, strideX * unit, kernel_width, kernel_height, dilateX_step,
+                                 dilateY_step, b - t, src_y_step * strideY, dst_y_step, (const float*)bias_z, linePostData.data());
+                    runPost(dst_z, bias_z, 0, 0, dst_width, t);
+                    runPost(dst_z, bias_z, 0, b, dst_width, dst_height);
+                    runPost(dst_z, bias_z, 0, t, l, b);
+                    runPost(dst_z, bias_z, r, t, dst_width, b);
+                } else {
+                    runPost(dst_z, bias_z, 0, 0, dst_width, dst_height);
+                }
+            } else {
+                if (r > l && b > t) {
+                    lineFunc((float*)(dst_z + (t * dst_y_step + l * unit) * bytes),
+                                               (const float*)(src_z + ((t * strideY - padY) * src_y_step + (l * strideX - padX) * unit) * bytes),
+                                               (const float*)weight_dz, r - l, strideX * unit, kernel_width, kernel_height, dilateX_step,
+                                               dilateY_step, b - t, src_y_step * strideY, dst_y_step);
+                }
+                postFunc((float*)dst_z, (float*)dst_z, (const float*)bias_z, dst_width * dst_height, 0, 0, 1, postData.data());
+            }
+            if (hasEpilogue) {
+                epilogue->applyPack(dz, dz + 1, (index % batch) * plane, plane);
             }
-            postFunc((float*)dst_z, (float*)dst_z, (const float*)bias_z, dst_width * dst_height, 0, 0, 1, postData.data());
         }
     };
     mNumber = numberThread;
@@ -234,8 +272,20 @@ ErrorCode CPUConvolutionDepthwise::BasicFloatExecution::onResize(const std::vect
     return NO_ERROR;
 }
 
+bool CPUConvolutionDepthwise::BasicFloatExecution::onSetEpilogue(const Epilogue& epilogue) {
+    auto core = static_cast<CPUBackend*>(backend())->functions();
+    mHardSwish = false;
+    if (core->bytes == 4 && nullptr != core->MNNConvRunForLineDepthwisePost && !epilogue.residual && epilogue.quantScale.empty()
+        && Epilogue::UNARY == epilogue.activation && UnaryOpOperation_HARDSWISH == epilogue.unaryType) {
+        mHardSwish = true;
+        return mEpilogue.set(Epilogue(), backend());
+    }
+    return mEpilogue.set(epilogue, backend());
+}
+
 ErrorCode CPUConvolutionDepthwise::BasicFloatExecution::onExecute(const std::vector<Tensor*>& inputs,
                                                                   const std::vector<Tensor*>& outputs) {
+    mEpilogue.prepare(inputs, outputs);
     auto inputTensor  = inputs[0];
     auto outputTensor = outputs[0];
     const auto srcOrigin = inputTensor->host<uint8_t>();
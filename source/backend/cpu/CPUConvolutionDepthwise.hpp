@@ -12,6 +12,7 @@
 #include "core/AutoStorage.h"
 #include "backend/cpu/CPUConvolution.hpp"
 #include "backend/cpu/compute/ConvolutionIntFactory.hpp"
+#include "backend/cpu/compute/GemmEpilogue.hpp"
 
 namespace MNN {
 class CPUConvolutionDepthwise {
@@ -23,10 +24,14 @@ public:
         virtual ~BasicFloatExecution() = default;
         virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
         virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+        virtual bool onSetEpilogue(const Epilogue& epilogue) override;
 
     private:
         std::function<void(const uint8_t *, uint8_t *, int)> mExecutor;
         int mNumber = 1;
+        // Hardswish is computed by MNNConvRunForLineDepthwisePost, the other epilogue runs after each channel block
+        bool mHardSwish = false;
+        GemmEpilogue mEpilogue;
     };
     class MultiInputFloatExecution : public BasicFloatExecution {
     public:
@@ -35,6 +40,9 @@ public:
         virtual ~MultiInputFloatExecution() = default;
         virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
         virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+        virtual bool onSetEpilogue(const Epilogue& epilogue) override {
+            return epilogue.empty();
+        }
 
     private:
         std::unique_ptr<Tensor> mWeight;
@@ -52,8 +60,15 @@ public:
         }
         virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override {
             mTempInputs = {inputs[0], mResource->mWeight.get(), mResource->mBias.get()};
+            if (inputs.size() > 1) {
+                // The residual of epilogue
+                mTempInputs.emplace_back(inputs[1]);
+            }
             return mOrigin->onResize(mTempInputs, outputs);
         }
+        virtual bool onSetEpilogue(const Epilogue& epilogue) override {
+            return mOrigin->onSetEpilogue(epilogue);
+        }
         virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
     private:
         FloatExecution(std::shared_ptr<Resource> resource, const Convolution2DCommon* common, Backend* b) : CPUConvolution(common, b) {
@@ -6,11 +6,13 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 
 #include <math.h>
+#include <algorithm>
 #include <numeric>
 
 #include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/CPUDetectionPostProcess.hpp"
-#include "backend/cpu/CPUNonMaxSuppressionV2.hpp"
+#include "backend/cpu/compute/NonMaxSuppression.hpp"
+#include "core/Concurrency.h"
 
 namespace MNN {
 
@@ -46,7 +48,7 @@ static void _decodeBoxes(const Tensor* boxesEncoding, const Tensor* anchors, con
     }
 }
 
-static void _NonMaxSuppressionMultiClassFastImpl(const DetectionPostProcessParamT& postProcessParam,
+static void _NonMaxSuppressionMultiClassFastImpl(const NonMaxSuppression& nms, const DetectionPostProcessParamT& postProcessParam,
                                                  const Tensor* decodedBoxes, const Tensor* classPredictions,
                                                  Tensor* detectionBoxes, Tensor* detectionClass,
                                                  Tensor* detectionScores, Tensor* numDetections) {
@@ -76,8 +78,11 @@ static void _NonMaxSuppressionMultiClassFastImpl(const DetectionPostProcessParam
     }
 
     std::vector<int> seleted;
-    NonMaxSuppressionSingleClasssImpl(decodedBoxes, maxScores.data(), postProcessParam.maxDetections,
-                                      postProcessParam.iouThreshold, postProcessParam.nmsScoreThreshold, &seleted);
+    NonMaxSuppression::Param param;
+    param.maxDetections  = postProcessParam.maxDetections;
+    param.iouThreshold   = postProcessParam.iouThreshold;
+    param.scoreThreshold = postProcessParam.nmsScoreThreshold;
+    nms.run(decodedBoxes->host<float>(), maxScores.data(), numBoxes, param, seleted);
 
     const auto decodedBoxesPtr = reinterpret_cast<const BoxCornerEncoding*>(decodedBoxes->host<float>());
     auto detectionBoxesPtr     = reinterpret_cast<BoxCornerEncoding*>(detectionBoxes->host<float>());
@@ -100,13 +105,48 @@ static void _NonMaxSuppressionMultiClassFastImpl(const DetectionPostProcessParam
     *numDetectionsPtr = outputBoxIndex;
 }
 
+// NMS for every class, then keep the best maxDetections of all classes
+static void _NonMaxSuppressionMultiClassRegularImpl(const NonMaxSuppression& nms, const DetectionPostProcessParamT& postProcessParam,
+                                                    const Tensor* decodedBoxes, const Tensor* classPredictions,
+                                                    Tensor* detectionBoxes, Tensor* detectionClass,
+                                                    Tensor* detectionScores, Tensor* numDetections) {
+    const int numBoxes               = decodedBoxes->length(0);
+    const int numClasses             = postProcessParam.numClasses;
+    const int numClassWithBackground = classPredictions->length(2);
+    const int labelOffset            = numClassWithBackground - numClasses;
+
+    NonMaxSuppression::BatchLayout layout;
+    layout.numClasses       = numClasses;
+    layout.numBoxes         = numBoxes;
+    layout.scoreClassStride = 1;
+    layout.scoreBoxStride   = numClassWithBackground;
+    NonMaxSuppression::Param param;
+    param.maxDetections  = postProcessParam.detectionsPerClass;
+    param.iouThreshold   = postProcessParam.iouThreshold;
+    param.scoreThreshold = postProcessParam.nmsScoreThreshold;
+    std::vector<NonMaxSuppression::Selection> selected;
+    nms.runBatched(decodedBoxes->host<float>(), classPredictions->host<float>() + labelOffset, layout, param, selected);
+    // The better score first, and the smaller class for the same score
+    std::stable_sort(selected.begin(), selected.end(), [](const NonMaxSuppression::Selection& a, const NonMaxSuppression::Selection& b) {
+        return a.score > b.score;
+    });
+
+    const auto decodedBoxesPtr = reinterpret_cast<const BoxCornerEncoding*>(decodedBoxes->host<float>());
+    auto detectionBoxesPtr     = reinterpret_cast<BoxCornerEncoding*>(detectionBoxes->host<float>());
+    auto detectionClassesPtr   = detectionClass->host<float>();
+    auto detectionScoresPtr    = detectionScores->host<float>();
+    const int number = std::min((int)selected.size(), postProcessParam.maxDetections);
+    for (int i = 0; i < number; ++i) {
+        detectionBoxesPtr[i]   = decodedBoxesPtr[selected[i].boxIndex];
+        detectionClassesPtr[i] = selected[i].classId;
+        detectionScoresPtr[i]  = selected[i].score;
+    }
+    *numDetections->host<float>() = number;
+}
+
 CPUDetectionPostProcess::CPUDetectionPostProcess(Backend* bn, const MNN::Op* op) : Execution(bn) {
     auto param = op->main_as_DetectionPostProcessParam();
     param->UnPackTo(&mParam);
-    if (mParam.useRegularNMS) {
-        MNN_ERROR("TODO, use regular NMS to process decoded boxes!");
-        return;
-    }
 }
 
 ErrorCode CPUDetectionPostProcess::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
@@ -131,12 +171,20 @@ ErrorCode CPUDetectionPostProcess::onExecute(const std::vector<Tensor*>& inputs,
     scaleValues.w = mParam.centerSizeEncoding[3];
     _decodeBoxes(inputs[0], inputs[2], scaleValues, mDecodedBoxes.get());
 
+    NonMaxSuppression nms([this](int number, const std::function<void(int)>& function) {
+        MNN_CONCURRENCY_BEGIN(tId, number) {
+            function((int)tId);
+        }
+        MNN_CONCURRENCY_END();
+    }, static_cast<CPUBackend*>(backend())->threadNumber());
     if (mParam.useRegularNMS) {
-        return NOT_SUPPORT;
+        // perform NMS for each class
+        _NonMaxSuppressionMultiClassRegularImpl(nms, mParam, mDecodedBoxes.get(), inputs[1], outputs[0], outputs[1],
+                                                outputs[2], outputs[3]);
     } else {
         // perform NMS on max scores
-        _NonMaxSuppressionMultiClassFastImpl(mParam, mDecodedBoxes.get(), inputs[1], outputs[0], outputs[1], outputs[2],
-                                             outputs[3]);
+        _NonMaxSuppressionMultiClassFastImpl(nms, mParam, mDecodedBoxes.get(), inputs[1], outputs[0], outputs[1],
+                                             outputs[2], outputs[3]);
     }
 
     return NO_ERROR;
@@ -0,0 +1,129 @@
+//
+//  CPUElementwiseFuse.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/15.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "CPUElementwiseFuse.hpp"
+#include "CPUBackend.hpp"
+#include "core/Macro.h"
+#include "core/Concurrency.h"
+#include "core/TensorUtils.hpp"
+
+// Elements of each block, intermediate results of one block stay in L1
+#define MNN_ELEMENTWISE_FUSE_BLOCK 256
+
+namespace MNN {
+
+CPUElementwiseFuse::CPUElementwiseFuse(Backend *b, std::vector<Step>&& steps) : Execution(b) {
+    mSteps = std::move(steps);
+    auto core = static_cast<CPUBackend*>(b)->functions();
+    auto precision = static_cast<CPUBackend*>(b)->precisionMode();
+    mBinaryProcs.resize(mSteps.size(), nullptr);
+    mUnaryProcs.resize(mSteps.size(), nullptr);
+    for (int i = 0; i < mSteps.size(); ++i) {
+        if (STEP_BINARY == mSteps[i].kind) {
+            mBinaryProcs[i] = core->MNNSelectBinaryFunctionForFloat(mSteps[i].opType);
+        } else {
+            mUnaryProcs[i] = core->MNNSelectUnaryFunctionForFloat(mSteps[i].opType, precision);
+        }
+        if (nullptr == mBinaryProcs[i] && nullptr == mUnaryProcs[i]) {
+            mValid = false;
+        }
+    }
+}
+
+ErrorCode CPUElementwiseFuse::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    auto cpuBn = static_cast<CPUBackend*>(backend());
+    mTotalSize = cpuBn->getTensorSize(outputs[0]);
+    mInputScalar.resize(inputs.size());
+    for (int i = 0; i < inputs.size(); ++i) {
+        mInputScalar[i] = TensorUtils::getRawSize(inputs[i]) == 1 && mTotalSize != 1;
+    }
+    auto blockNumber = UP_DIV(mTotalSize, MNN_ELEMENTWISE_FUSE_BLOCK);
+    mThreadNumber = ALIMIN(cpuBn->threadNumber(), blockNumber);
+    mThreadNumber = ALIMAX(mThreadNumber, 1);
+    // The last step writes to output directly
+    int bytes = cpuBn->functions()->bytes;
+    mCache.reset(Tensor::createDevice<uint8_t>({mThreadNumber, (int)(mSteps.size() - 1) * MNN_ELEMENTWISE_FUSE_BLOCK * bytes + 1}));
+    auto res = backend()->onAcquireBuffer(mCache.get(), Backend::DYNAMIC);
+    if (!res) {
+        return OUT_OF_MEMORY;
+    }
+    backend()->onReleaseBuffer(mCache.get(), Backend::DYNAMIC);
+    return NO_ERROR;
+}
+
+ErrorCode CPUElementwiseFuse::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    auto bytes = static_cast<CPUBackend*>(backend())->functions()->bytes;
+    auto outputPtr = outputs[0]->host<uint8_t>();
+    auto blockNumber = UP_DIV(mTotalSize, MNN_ELEMENTWISE_FUSE_BLOCK);
+    MNN_CONCURRENCY_BEGIN(tId, mThreadNumber) {
+        auto cache = mCache->host<uint8_t>() + tId * mCache->stride(0);
+        for (int block = (int)tId; block < blockNumber; block += mThreadNumber) {
+            auto start = block * MNN_ELEMENTWISE_FUSE_BLOCK;
+            auto size = ALIMIN(MNN_ELEMENTWISE_FUSE_BLOCK, mTotalSize - start);
+            auto source = [&](int src, bool& scalar) -> const uint8_t* {
+                if (src >= 0) {
+                    scalar = mInputScalar[src];
+                    if (scalar) {
+                        return inputs[src]->host<uint8_t>();
+                    }
+                    return inputs[src]->host<uint8_t>() + start * bytes;
+                }
+                scalar = false;
+                return cache + (-src - 1) * MNN_ELEMENTWISE_FUSE_BLOCK * bytes;
+            };
+            for (int i = 0; i < mSteps.size(); ++i) {
+                auto& step = mSteps[i];
+                uint8_t* dst = cache + i * MNN_ELEMENTWISE_FUSE_BLOCK * bytes;
+                if (i == mSteps.size() - 1) {
+                    dst = outputPtr + start * bytes;
+                }
+                bool scalar0 = false;
+                auto src0 = source(step.src0, scalar0);
+                if (STEP_UNARY == step.kind) {
+                    mUnaryProcs[i](dst, src0, size);
+                    continue;
+                }
+                bool scalar1 = false;
+                auto src1 = source(step.src1, scalar1);
+                int broadcastIndex = -1;
+                if (scalar0) {
+                    broadcastIndex = 0;
+                } else if (scalar1) {
+                    broadcastIndex = 1;
+                }
+                mBinaryProcs[i](dst, src0, src1, size, broadcastIndex);
+            }
+        }
+    }
+    MNN_CONCURRENCY_END();
+    return NO_ERROR;
+}
+
+class CPUElementwiseFuseCreator : public CPUBackend::Creator {
+public:
+    virtual Execution *onCreate(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs,
+                                const MNN::Op *op, Backend *backend) const override {
+        auto extra = op->main_as_Extra();
+        if (nullptr == extra || nullptr == extra->type() || extra->type()->str() != CPUElementwiseFuse::TYPE || nullptr == extra->info()) {
+            return nullptr;
+        }
+        auto info = (const int32_t*)extra->info()->data();
+        auto infoSize = extra->info()->size() / sizeof(int32_t);
+        if (infoSize < 2 || info[0] != inputs.size() || infoSize != 2 + 4 * info[1]) {
+            MNN_ERROR("Invalid %s program\n", CPUElementwiseFuse::TYPE);
+            return nullptr;
+        }
+        std::vector<CPUElementwiseFuse::Step> steps(info[1]);
+        ::memcpy(steps.data(), info + 2, steps.size() * sizeof(CPUElementwiseFuse::Step));
+        return new CPUElementwiseFuse(backend, std::move(steps));
+    }
+};
+
+REGISTER_CPU_OP_CREATOR(CPUElementwiseFuseCreator, OpType_Extra);
+
+} // namespace MNN
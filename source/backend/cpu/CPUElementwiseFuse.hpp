@@ -0,0 +1,50 @@
+//
+//  CPUElementwiseFuse.hpp
+//  MNN
+//
+//  Created by MNN on 2024/03/15.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef CPUElementwiseFuse_hpp
+#define CPUElementwiseFuse_hpp
+
+#include "core/Execution.hpp"
+#include "compute/CommonOptFunction.h"
+namespace MNN {
+/**
+ Run a chain of float elementwise BinaryOp / UnaryOp as one Extra op, block by block, so the
+ intermediate results stay in cache. The program is stored in Extra's info as int32:
+ [inputNumber, stepNumber, (kind, opType, src0, src1) * stepNumber]
+ src >= 0 means the input index, src < 0 means the result of step (-src - 1).
+ The result of last step is the output. Inputs must have the output's size or be scalar.
+ */
+class CPUElementwiseFuse : public Execution {
+public:
+    enum StepKind {
+        STEP_BINARY = 0,
+        STEP_UNARY = 1,
+    };
+    static constexpr const char* TYPE = "ElementwiseFuse";
+    struct Step {
+        int kind;
+        int opType;
+        int src0;
+        int src1;
+    };
+    CPUElementwiseFuse(Backend *b, std::vector<Step>&& steps);
+    virtual ~CPUElementwiseFuse() = default;
+    virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+
+private:
+    std::vector<Step> mSteps;
+    std::vector<MNNBinaryExecute> mBinaryProcs;
+    std::vector<MNNUnaryExecute> mUnaryProcs;
+    std::vector<bool> mInputScalar;
+    std::shared_ptr<Tensor> mCache;
+    int mTotalSize;
+    int mThreadNumber;
+};
+} // namespace MNN
+#endif /* CPUElementwiseFuse_hpp */
@@ -10,18 +10,45 @@
 #include "backend/cpu/CPUBackend.hpp"
 #include "core/Macro.h"
 #include "core/FileLoader.hpp"
+#include "core/TensorUtils.hpp"
 namespace MNN {
 class CPUExternalConst : public Execution {
 public:
-    CPUExternalConst(const Op* op, Backend* bn) : Execution(bn) {
+    CPUExternalConst(const Op* op, Tensor* output, Backend* bn) : Execution(bn) {
         auto blob = op->main_as_Blob();
         mExternalFile = op->externalPath()->str();
         if (nullptr != blob->external()) {
             mOffset = blob->external()->data()[0];
             mSize = blob->external()->data()[1];
         }
+        // The executions reading the same file share one mapping of the runtime
+        auto runtime = static_cast<const CPURuntime*>(static_cast<CPUBackend*>(bn)->getRuntime());
+        mMapper = runtime->mapFile(mExternalFile);
+        if (nullptr != mMapper && (mOffset < 0 || mSize < 0 || !mMapper->contains(mMapper->data() + mOffset, (size_t)mSize))) {
+            mMapper = nullptr;
+        }
+        // The output refers to the mapping instead of copying from it, if it's aligned. It's set before the pipeline
+        // allocates memory, and as outside memory the pipeline never allocates, recycles or reuses it
+        if (nullptr != mMapper && (size_t)mSize >= output->usize()) {
+            auto ptr = mMapper->data() + mOffset;
+            if (0 == ((size_t)ptr) % output->getType().bytes()) {
+                auto des = TensorUtils::getDescribeOrigin(output);
+                des->mem = new MappedMemObj(mMapper, ptr, output->usize());
+                des->setBackend(bn);
+                TensorUtils::getDescribe(output)->memoryType = Tensor::InsideDescribe::MEMORY_OUTSIDE;
+                output->buffer().host = (uint8_t*)ptr;
+            }
+        }
     }
     virtual ErrorCode onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override {
+        if (nullptr != mMapper) {
+            auto ptr = mMapper->data() + mOffset;
+            // Misaligned mapping, copy to the allocated output
+            if (outputs[0]->host<uint8_t>() != ptr) {
+                ::memcpy(outputs[0]->host<char>(), ptr, std::min((size_t)mSize, outputs[0]->usize()));
+            }
+            return NO_ERROR;
+        }
         FileLoader l(mExternalFile.c_str());
         l.offset(mOffset);
         l.read(outputs[0]->host<char>(), mSize);
@@ -29,6 +56,7 @@ public:
     }
 private:
     std::string mExternalFile;
+    std::shared_ptr<FileMapper> mMapper;
     int64_t mOffset = 0;
     int64_t mSize = 0;
 };
@@ -40,7 +68,7 @@ public:
         if (op->externalPath() == nullptr) {
             return nullptr;
         }
-        return new CPUExternalConst(op, backend);
+        return new CPUExternalConst(op, outputs[0], backend);
     }
 };
 
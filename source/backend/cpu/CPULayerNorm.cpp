@@ -61,6 +61,24 @@ std::shared_ptr<CPULayerNorm::Resource> CPULayerNorm::makeResource(const MNN::Op
     return res;
 }
 
+void CPULayerNorm::_residualNorm(const std::vector<Tensor*> &inputs, const std::vector<Tensor*> &outputs, const float* gamma, const float* beta) {
+    // The sum of a row is added and normalized while it's in cache, the residual stream is written only if it's needed
+    auto input0 = inputs[0]->host<float>();
+    auto input1 = inputs[1]->host<float>();
+    auto output = outputs[0]->host<float>();
+    auto sum = outputs.size() > 1 ? outputs[1]->host<float>() : nullptr;
+    auto threadNumber = ALIMIN(static_cast<CPUBackend*>(backend())->threadNumber(), mOutterSize);
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        for (int o = (int)tId; o < mOutterSize; o += threadNumber) {
+            auto offset = o * mInnerSize;
+            float* sumRow = nullptr != sum ? sum + offset : (float*)(mTmpSum.ptr() + tId * mInnerSize * sizeof(float));
+            mAdd(sumRow, input0 + offset, input1 + offset, mInnerSize, -1);
+            MNNNorm(output + offset, sumRow, gamma, beta, mResource->mEpsilon, mInnerSize, mResource->mRMSNorm);
+        }
+    }
+    MNN_CONCURRENCY_END();
+}
+
 ErrorCode CPULayerNorm::onExecute(const std::vector<Tensor*> &inputs,
                                   const std::vector<Tensor*> &outputs) {
     const float* gamma = mResource->mIniGammaBeta ? mResource->mGamma->host<float>() : nullptr;
@@ -79,6 +97,10 @@ ErrorCode CPULayerNorm::onExecute(const std::vector<Tensor*> &inputs,
     if (CPUBackend::getDataType(inputs[0]) == DataType_DT_INT8 || inputs[0]->getType().bytes() == 1) {
         bytes = 1;
     }
+    if (mResidual) {
+        _residualNorm(inputs, outputs, gamma, beta);
+        return NO_ERROR;
+    }
 
     MNN_CONCURRENCY_BEGIN(ttId, threadNumber) {
         for (int tId=ttId; tId < mOutterSize; tId += threadNumber) {
@@ -139,6 +161,13 @@ ErrorCode CPULayerNorm::onResize(const std::vector<Tensor*> &inputs,
     auto threadNumber = ALIMIN(bn->threadNumber(), mOutterSize);
     auto buf = bn->getBufferAllocator();
 
+    if (mResidual) {
+        if (outputs.size() == 1) {
+            mTmpSum = buf->alloc(threadNumber * mInnerSize * sizeof(float));
+            buf->free(mTmpSum);
+        }
+        return NO_ERROR;
+    }
     if (CPUBackend::getDataType(inputs[0]) == DataType_DT_INT8 || inputs[0]->getType().bytes() == 1 || bn->functions()->bytes != 4) {
         mTmpInputFloat = buf->alloc(threadNumber * mInnerSize * sizeof(float));
         mTmpOutputFloat = buf->alloc(threadNumber * mInnerSize * sizeof(float));
@@ -148,6 +177,24 @@ ErrorCode CPULayerNorm::onResize(const std::vector<Tensor*> &inputs,
     return NO_ERROR;
 }
 
+bool CPULayerNorm::onSetPrologue(const Prologue& prologue) {
+    mResidual = false;
+    if (prologue.empty()) {
+        return true;
+    }
+    // Only the residual add in fp32 is supported
+    auto core = static_cast<CPUBackend*>(backend())->functions();
+    if (Prologue::NONE != prologue.scale || prologue.mask || core->bytes != 4) {
+        return false;
+    }
+    mAdd = core->MNNSelectBinaryFunctionForFloat(BinaryOpOperation_ADD);
+    if (nullptr == mAdd) {
+        return false;
+    }
+    mResidual = true;
+    return true;
+}
+
 CPULayerNorm::~CPULayerNorm() {
     // Do nothing
 }
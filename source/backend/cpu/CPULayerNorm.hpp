@@ -12,6 +12,7 @@
 #include "core/Execution.hpp"
 #include "core/Macro.h"
 #include "core/BufferAllocator.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
 namespace MNN {
 class CPULayerNorm : public Execution {
 public:
@@ -30,14 +31,20 @@ public:
     virtual ErrorCode onExecute(const std::vector<Tensor*> &inputs, const std::vector<Tensor*> &outputs) override;
     virtual ErrorCode onResize(const std::vector<Tensor*> &inputs, const std::vector<Tensor*> &outputs) override;
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
+    virtual bool onSetPrologue(const Prologue& prologue) override;
 
     static std::shared_ptr<Resource> makeResource(const MNN::Op* op, Backend* backend);
 private:
+    void _residualNorm(const std::vector<Tensor*> &inputs, const std::vector<Tensor*> &outputs, const float* gamma, const float* beta);
     std::shared_ptr<Resource> mResource;
     int mInnerSize = 1;
     int mOutterSize = 1;
     MemChunk mTmpInputFloat;
     MemChunk mTmpOutputFloat;
+    // x = inputs[0] + inputs[1] before norm, which is kept in outputs[1] or the temp buffer
+    bool mResidual = false;
+    MNNBinaryExecute mAdd = nullptr;
+    MemChunk mTmpSum;
 };
 } // namespace MNN
 #endif /* CPULayerNorm_hpp */
@@ -102,7 +102,7 @@ ErrorCode CPUMatMul::onResize(const std::vector<Tensor*>& inputs, const std::vec
     bool useBias = false;
     MemChunk bdestAlloc;
     bool bdestNeedFree = false;
-    if (inputs.size() > 2) {
+    if (inputs.size() - mEpilogue.extraInputs() > 2) {
         auto bias = inputs[2];
         useBias = true;
         auto biasLength = bias->elementSize();
@@ -148,6 +148,14 @@ ErrorCode CPUMatMul::onResize(const std::vector<Tensor*>& inputs, const std::vec
     return NO_ERROR;
 }
 
+bool CPUMatMul::onSetEpilogue(const Epilogue& epilogue) {
+    if (!epilogue.quantScale.empty()) {
+        // The output is not in NC4HW4
+        return false;
+    }
+    return mEpilogue.set(epilogue, backend());
+}
+
 ErrorCode CPUMatMul::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
 
     auto APtr = inputs[0]->host<float>();
@@ -155,10 +163,15 @@ ErrorCode CPUMatMul::onExecute(const std::vector<Tensor*>& inputs, const std::ve
     auto CPtr = outputs[0]->host<float>();
 
     const float* biasPtr = nullptr;
-    if (inputs.size() > 2) {
+    if (inputs.size() - mEpilogue.extraInputs() > 2) {
         biasPtr = inputs[2]->host<float>();
     }
+    mEpilogue.prepare(inputs, outputs);
     execute(APtr, BPtr, CPtr, biasPtr);
+    if (0 == mE && !mEpilogue.empty()) {
+        // Computed by MNNComputeMatMulForE_1 / MNNComputeMatMulForH_1
+        mEpilogue.applyLine(0, outputs[0]->elementSize());
+    }
     return NO_ERROR;
 }
 
@@ -182,6 +195,7 @@ void CPUMatMul::execute(const float* APtr, const float* BPtr, float* CPtr, const
         }
         int tileCount = UP_DIV(mE, eP);
         int numberThread = mSupportMultiThread ? ((CPUBackend*)backend())->threadNumber() : 1;
+        bool hasEpilogue = !mEpilogue.empty();
         MNN_CONCURRENCY_BEGIN(tId, numberThread) {
             auto TA = mTempA.ptr() + tId * eP * mL * core->bytes;
             auto TB = mTempB.ptr();
@@ -233,10 +247,18 @@ void CPUMatMul::execute(const float* APtr, const float* BPtr, float* CPtr, const
                     // hC4, e, 4 -> e, h
                     auto dst = (uint8_t*)CPtr + xStart * mH * core->bytes;
                     core->MNNUnpackCUnitTranspose((float*)dst, (const float*)TC, xC, mH, area);
+                    if (hasEpilogue) {
+                        mEpilogue.applyLine(xStart * mH, xC * mH);
+                    }
                 } else {
                     // hC4, e, 4 -> h, e
                     auto dst = (uint8_t*)CPtr + xStart * core->bytes;
                     core->MNNUnpackCUnit((float*)dst, (const float*)TC, xC, mH, area);
+                    if (hasEpilogue) {
+                        for (int y = 0; y < mH; ++y) {
+                            mEpilogue.applyLine(y * mE + xStart, xC);
+                        }
+                    }
                 }
             }
         };
@@ -12,6 +12,7 @@
 #include <functional>
 #include "core/Execution.hpp"
 #include "backend/cpu/compute/StrassenMatmulComputor.hpp"
+#include "backend/cpu/compute/GemmEpilogue.hpp"
 
 namespace MNN {
 
@@ -21,6 +22,7 @@ public:
     virtual ~CPUMatMul() = default;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual bool onSetEpilogue(const Epilogue& epilogue) override;
     void execute(const float* APtr, const float* BPtr, float* CPtr, const float* BiasPtr);
 
 private:
@@ -41,7 +43,7 @@ private:
     int mL;
     int mH;
     std::vector<float> mPostParameters;
-
+    GemmEpilogue mEpilogue;
 };
 } // namespace MNN
 
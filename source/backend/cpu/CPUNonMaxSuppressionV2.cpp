@@ -13,9 +13,11 @@
 // edited from tensorflow - non_max_suppression_op.cc by MNN.
 
 #include "backend/cpu/CPUNonMaxSuppressionV2.hpp"
-#include <math.h>
-#include <queue>
+#include <algorithm>
+#include <limits>
 #include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/compute/NonMaxSuppression.hpp"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
 
 namespace MNN {
@@ -24,86 +26,6 @@ CPUNonMaxSuppressionV2::CPUNonMaxSuppressionV2(Backend* backend, const Op* op) :
     // nothing to do
 }
 
-// Return intersection-over-union overlap between boxes i and j
-static inline float IOU(const float* boxes, int i, int j) {
-    const float yMinI = std::min<float>(boxes[i * 4 + 0], boxes[i * 4 + 2]);
-    const float xMinI = std::min<float>(boxes[i * 4 + 1], boxes[i * 4 + 3]);
-    const float yMaxI = std::max<float>(boxes[i * 4 + 0], boxes[i * 4 + 2]);
-    const float xMaxI = std::max<float>(boxes[i * 4 + 1], boxes[i * 4 + 3]);
-    const float yMinJ = std::min<float>(boxes[j * 4 + 0], boxes[j * 4 + 2]);
-    const float xMinJ = std::min<float>(boxes[j * 4 + 1], boxes[j * 4 + 3]);
-    const float yMaxJ = std::max<float>(boxes[j * 4 + 0], boxes[j * 4 + 2]);
-    const float xMaxJ = std::max<float>(boxes[j * 4 + 1], boxes[j * 4 + 3]);
-    const float areaI = (yMaxI - yMinI) * (xMaxI - xMinI);
-    const float areaJ = (yMaxJ - yMinJ) * (xMaxJ - xMinJ);
-    if (areaI <= 0 || areaJ <= 0)
-        return 0.0;
-    const float intersectionYMin = std::max<float>(yMinI, yMinJ);
-    const float intersectionXMin = std::max<float>(xMinI, xMinJ);
-    const float intersectionYMax = std::min<float>(yMaxI, yMaxJ);
-    const float intersectionXMax = std::min<float>(xMaxI, xMaxJ);
-    const float intersectionArea = std::max<float>(intersectionYMax - intersectionYMin, 0.0) *
-                                   std::max<float>(intersectionXMax - intersectionXMin, 0.0);
-    return intersectionArea / (areaI + areaJ - intersectionArea);
-}
-
-void NonMaxSuppressionSingleClasssImpl(const Tensor* decodedBoxes, const float* scores, int maxDetections,
-                                       float iouThreshold, float scoreThreshold, std::vector<int32_t>* selected) {
-    MNN_ASSERT(iouThreshold >= 0.0f && iouThreshold <= 1.0f);
-    MNN_ASSERT(decodedBoxes->dimensions() == 2);
-    const int numBoxes = decodedBoxes->length(0);
-    MNN_ASSERT(decodedBoxes->length(1) == 4)
-
-    const int outputNum = std::min(maxDetections, numBoxes);
-    std::vector<float> scoresData(numBoxes);
-    std::copy_n(scores, numBoxes, scoresData.begin());
-
-    struct Candidate {
-        int boxIndex;
-        float score;
-    };
-
-    auto cmp = [](const Candidate bsI, const Candidate bsJ) { return bsI.score < bsJ.score; };
-
-    std::priority_queue<Candidate, std::deque<Candidate>, decltype(cmp)> candidatePriorityQueue(cmp);
-
-    for (int i = 0; i < scoresData.size(); ++i) {
-        if (scoresData[i] > scoreThreshold) {
-            candidatePriorityQueue.emplace(Candidate({i, scoresData[i]}));
-        }
-    }
-
-    // std::vector<float> selectedScores;
-    Candidate nextCandidate;
-    float iou, originalScore;
-
-    const auto boxesPtr = decodedBoxes->host<float>();
-    while (selected->size() < outputNum && !candidatePriorityQueue.empty()) {
-        nextCandidate = candidatePriorityQueue.top();
-        originalScore = nextCandidate.score;
-        candidatePriorityQueue.pop();
-
-        // Overlapping boxes are likely to have similar scores,
-        // therefore we iterate through the previously selected boxes backwards
-        // in order to see if `next_candidate` should be suppressed.
-        bool shouldSelect = true;
-        for (int j = (int)selected->size() - 1; j >= 0; --j) {
-            iou = IOU(boxesPtr, nextCandidate.boxIndex, selected->at(j));
-            if (iou == 0.0) {
-                continue;
-            }
-            if (iou > iouThreshold) {
-                shouldSelect = false;
-            }
-        }
-
-        if (shouldSelect) {
-            selected->push_back(nextCandidate.boxIndex);
-            // selectedScores.push_back(nextCandidate.score);
-        }
-    }
-}
-
 ErrorCode CPUNonMaxSuppressionV2::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     std::vector<int> selected;
     const int maxDetections    = inputs[2]->host<int32_t>()[0];
@@ -114,8 +36,18 @@ ErrorCode CPUNonMaxSuppressionV2::onExecute(const std::vector<Tensor*>& inputs,
     if (inputs.size() > 4) {
         scoreThreshold = inputs[4]->host<float>()[0];
     }
-    const auto scores          = inputs[1]->host<float>();
-    NonMaxSuppressionSingleClasssImpl(inputs[0], scores, maxDetections, iouThreshold, scoreThreshold, &selected);
+    MNN_ASSERT(inputs[0]->dimensions() == 2 && inputs[0]->length(1) == 4);
+    NonMaxSuppression::Param param;
+    param.maxDetections  = maxDetections;
+    param.iouThreshold   = iouThreshold;
+    param.scoreThreshold = scoreThreshold;
+    NonMaxSuppression nms([this](int number, const std::function<void(int)>& function) {
+        MNN_CONCURRENCY_BEGIN(tId, number) {
+            function((int)tId);
+        }
+        MNN_CONCURRENCY_END();
+    }, static_cast<CPUBackend*>(backend())->threadNumber());
+    nms.run(inputs[0]->host<float>(), inputs[1]->host<float>(), inputs[0]->length(0), param, selected);
     std::copy_n(selected.begin(), selected.size(), outputs[0]->host<int32_t>());
     for (int i = selected.size(); i < outputs[0]->elementSize(); i++) {
         outputs[0]->host<int32_t>()[i] = -1;
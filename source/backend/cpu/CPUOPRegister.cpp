@@ -34,6 +34,7 @@ extern void ___CPUROIAlignCreator__OpType_ROIAlign__();
 extern void ___CPUROIPoolingCreator__OpType_ROIPooling__();
 extern void ___CPUTopKV2Creator__OpType_TopKV2__();
 extern void ___CPUUnaryCreator__OpType_UnaryOp__();
+extern void ___CPUElementwiseFuseCreator__OpType_Extra__();
 extern void ___CPUReductionCreator__OpType_Reduction__();
 extern void ___CPUReluCreator__OpType_ReLU__();
 extern void ___CPUReluCreator__OpType_PReLU__();
@@ -113,6 +114,7 @@ ___CPUROIAlignCreator__OpType_ROIAlign__();
 ___CPUROIPoolingCreator__OpType_ROIPooling__();
 ___CPUTopKV2Creator__OpType_TopKV2__();
 ___CPUUnaryCreator__OpType_UnaryOp__();
+___CPUElementwiseFuseCreator__OpType_Extra__();
 ___CPUReductionCreator__OpType_Reduction__();
 ___CPUReluCreator__OpType_ReLU__();
 ___CPUReluCreator__OpType_PReLU__();
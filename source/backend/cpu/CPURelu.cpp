@@ -16,6 +16,7 @@
 #include "core/TensorUtils.hpp"
 namespace MNN {
 CPURelu::CPURelu(Backend *b, float slope) : Execution(b) {
+    mSlopeValue = slope;
     auto core = static_cast<CPUBackend*>(b)->functions();
     mSlope.reset(core->bytes * core->pack);
     if (core->bytes < 4) {
@@ -31,6 +32,14 @@ CPURelu::CPURelu(Backend *b, float slope) : Execution(b) {
         }
     }
 }
+bool CPURelu::onClone(Backend* bn, const Op* op, Execution** dst) {
+    if (nullptr == dst) {
+        return true;
+    }
+    *dst = new CPURelu(bn, mSlopeValue);
+    return true;
+}
+
 ErrorCode CPURelu::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     auto core = static_cast<CPUBackend*>(backend())->functions();
     mRealSize = static_cast<CPUBackend*>(backend())->getTensorSize(inputs[0]);
@@ -21,7 +21,9 @@ public:
     virtual ~CPURelu() = default;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
 private:
+    float mSlopeValue;
     AutoStorage<uint8_t> mSlope;
     AutoStorage<uint8_t> mCacheSrc;
     AutoStorage<uint8_t> mCacheDst;
@@ -27,9 +27,7 @@
 
 #if __APPLE__
 #include "TargetConditionals.h"
-#if __aarch64__
 #include <sys/sysctl.h>
-#endif
 #if TARGET_OS_IPHONE
 #include <mach/machine.h>
 #include <sys/types.h>
@@ -375,6 +373,101 @@ float MNNGetCPUFlops(uint32_t number) {
     return flops;
 }
 
+#if defined(__linux__) || defined(__ANDROID__)
+static size_t _readCacheSize(int cpu, int index, int* level) {
+    char path[256];
+    char content[64];
+    sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/type", cpu, index);
+    FILE* fp = fopen(path, "rb");
+    if (nullptr == fp) {
+        return 0;
+    }
+    bool isData = nullptr != fgets(content, sizeof(content), fp) && 0 != strncmp(content, "Instruction", 11);
+    fclose(fp);
+    if (!isData) {
+        *level = 0;
+        return 0;
+    }
+    sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+    fp = fopen(path, "rb");
+    if (nullptr == fp || 1 != fscanf(fp, "%d", level)) {
+        *level = 0;
+    }
+    if (nullptr != fp) {
+        fclose(fp);
+    }
+    sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/size", cpu, index);
+    fp = fopen(path, "rb");
+    if (nullptr == fp) {
+        return 0;
+    }
+    size_t size = 0;
+    char unit = 0;
+    if (fscanf(fp, "%zu%c", &size, &unit) >= 1) {
+        if ('K' == unit || 'k' == unit) {
+            size *= 1024;
+        } else if ('M' == unit || 'm' == unit) {
+            size *= 1024 * 1024;
+        }
+    }
+    fclose(fp);
+    return size;
+}
+#endif
+
+// [0]: last level, [1]: L1, [2]: L2, [3]: L3
+static std::vector<size_t> _detectCacheSize() {
+    std::vector<size_t> cacheSize(4, 0);
+#if defined(__linux__) || defined(__ANDROID__)
+    // Use the largest cpu, which is the one usually bound by MNN_CPU_MODE_BIG
+    for (int cpu = 0; cpu < 1024; ++cpu) {
+        int index = 0;
+        for (; index < 8; ++index) {
+            int cacheLevel = -1;
+            auto size = _readCacheSize(cpu, index, &cacheLevel);
+            if (cacheLevel < 0) {
+                break;
+            }
+            if (cacheLevel >= 1 && cacheLevel <= 3) {
+                cacheSize[cacheLevel] = std::max(cacheSize[cacheLevel], size);
+            }
+        }
+        if (0 == index) {
+            // No more cpu
+            break;
+        }
+    }
+#elif defined(__APPLE__)
+    int64_t value = 0;
+    size_t valueSize = sizeof(value);
+    if (0 == sysctlbyname("hw.l1dcachesize", &value, &valueSize, nullptr, 0)) {
+        cacheSize[1] = (size_t)value;
+    }
+    valueSize = sizeof(value);
+    if (0 == sysctlbyname("hw.l2cachesize", &value, &valueSize, nullptr, 0)) {
+        cacheSize[2] = (size_t)value;
+    }
+    valueSize = sizeof(value);
+    if (0 == sysctlbyname("hw.l3cachesize", &value, &valueSize, nullptr, 0)) {
+        cacheSize[3] = (size_t)value;
+    }
+#endif
+    for (int i = 1; i < 4; ++i) {
+        if (cacheSize[i] > 0) {
+            cacheSize[0] = cacheSize[i];
+        }
+    }
+    return cacheSize;
+}
+
+size_t MNNGetCPUCacheSize(int level) {
+    static std::vector<size_t> gCacheSize = _detectCacheSize();
+    if (level < 0 || level > 3) {
+        return 0;
+    }
+    return gCacheSize[level];
+}
+
 // cpuinfo
 // Reference from: https://github.com/pytorch/cpuinfo
 #ifdef __ANDROID__
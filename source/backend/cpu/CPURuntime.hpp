@@ -9,6 +9,7 @@
 #define CPURuntime_hpp
 
 #include <stdint.h>
+#include <stddef.h>
 #include "core/Macro.h"
 struct cpuinfo_arm_isa {
     bool fp16arith;
@@ -33,6 +34,8 @@ typedef enum {
 int MNNSetCPUThreadsMode(MNNCPUThreadsMode mode);
 
 float MNNGetCPUFlops(uint32_t number);
+// Size in bytes of the data cache of the level (1 - 3) of the largest cpu, 0 for the last level. Return 0 if unknown
+size_t MNNGetCPUCacheSize(int level);
 void cpuinfo_arm_init(struct cpuinfo_arm_isa* cpuinfo_isa);
 
 #endif /* CPUInfo_hpp */
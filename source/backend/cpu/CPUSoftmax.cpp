@@ -200,6 +200,31 @@ ErrorCode CPUSoftmax::onResize(const std::vector<Tensor *> &inputs, const std::v
 
     const auto layout = TensorUtils::getDescribe(input)->dimensionFormat;
     mNeedUnpackC4     = layout == MNN_DATA_FORMAT_NC4HW4;
+    if (!mPrologue.empty()) {
+        // The fused scale and mask only support the last axis of float tensor
+        if (mNeedUnpackC4 || axis != dimensions - 1) {
+            return NOT_SUPPORT;
+        }
+        mChannel = input->length(axis);
+        mOutside = 1;
+        mOutsideDims.resize(axis);
+        mMaskStrides.assign(axis, 0);
+        for (int i = 0; i < axis; ++i) {
+            mOutsideDims[i] = input->length(i);
+            mOutside *= input->length(i);
+        }
+        if (mPrologue.mask) {
+            auto mask   = inputs[inputs.size() - 1];
+            int offset  = dimensions - mask->dimensions();
+            int stride  = mChannel;
+            for (int i = axis - 1; i >= 0 && i >= offset; --i) {
+                auto length = mask->length(i - offset);
+                mMaskStrides[i] = length == 1 ? 0 : stride;
+                stride *= length;
+            }
+        }
+        return NO_ERROR;
+    }
 
     if (mNeedUnpackC4) {
         int totalSize = 1;
@@ -248,9 +273,44 @@ ErrorCode CPUSoftmax::onResize(const std::vector<Tensor *> &inputs, const std::v
     return NO_ERROR;
 }
 
+void CPUSoftmax::_scaleMaskSoftmax(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    auto inputPtr  = inputs[0]->host<float>();
+    auto outputPtr = outputs[0]->host<float>();
+    float scale    = 1.0f;
+    if (Prologue::NONE != mPrologue.scale) {
+        scale = inputs[1]->host<float>()[0];
+        if (Prologue::DIV == mPrologue.scale) {
+            scale = 1.0f / scale;
+        }
+    }
+    const float* maskPtr = mPrologue.mask ? inputs[inputs.size() - 1]->host<float>() : nullptr;
+    int threadNumber = ALIMIN(static_cast<CPUBackend*>(backend())->threadNumber(), mOutside);
+    int outsideDims = (int)mOutsideDims.size();
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        for (int o = tId; o < mOutside; o += threadNumber) {
+            const float* maskO = nullptr;
+            if (nullptr != maskPtr) {
+                int offset = 0;
+                int index  = o;
+                for (int d = outsideDims - 1; d >= 0; --d) {
+                    offset += (index % mOutsideDims[d]) * mMaskStrides[d];
+                    index /= mOutsideDims[d];
+                }
+                maskO = maskPtr + offset;
+            }
+            MNNScaleMaskSoftmax(outputPtr + o * mChannel, inputPtr + o * mChannel, maskO, scale, mChannel);
+        }
+    }
+    MNN_CONCURRENCY_END();
+}
+
 ErrorCode CPUSoftmax::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
-    MNN_ASSERT(1 == inputs.size());
     MNN_ASSERT(1 == outputs.size());
+    if (!mPrologue.empty()) {
+        _scaleMaskSoftmax(inputs, outputs);
+        return NO_ERROR;
+    }
+    MNN_ASSERT(1 == inputs.size());
     auto inputTensor        = inputs[0];
     auto outputTensor       = outputs[0];
     const auto inputDataPtr = inputTensor->host<float>();
@@ -280,6 +340,18 @@ ErrorCode CPUSoftmax::onExecute(const std::vector<Tensor *> &inputs, const std::
     return NO_ERROR;
 }
 
+bool CPUSoftmax::onSetPrologue(const Prologue& prologue) {
+    // The prologue is computed in fp32
+    if (!prologue.empty() && static_cast<CPUBackend*>(backend())->functions()->bytes != 4) {
+        return false;
+    }
+    if (prologue.residual) {
+        return false;
+    }
+    mPrologue = prologue;
+    return true;
+}
+
 CPUSoftmax::CPUSoftmax(Backend *b, int axis) : MNN::Execution(b), mAxis(axis), mStorage(2), mNeedUnpackC4(false) {
     // nothing to do
 }
@@ -18,10 +18,12 @@ public:
     virtual ~CPUSoftmax() = default;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual bool onSetPrologue(const Prologue& prologue) override;
     static Execution* create(const MNN::Op *op, Backend *backend);
 
 private:
     int _softmaxCommon(const uint8_t* srcData, uint8_t* dstData);
+    void _scaleMaskSoftmax(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs);
 
     int mAxis;
     Tensor mStorage;
@@ -32,6 +34,12 @@ private:
     int mInside;
     int mOutside;
     int mChannel;
+
+    // softmax(x * scale + mask) of last axis
+    Prologue mPrologue;
+    // The outside dimensions of input and the strides of mask for them, 0 for broadcast
+    std::vector<int> mOutsideDims;
+    std::vector<int> mMaskStrides;
 };
 } // namespace MNN
 
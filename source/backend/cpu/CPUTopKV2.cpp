@@ -10,41 +10,170 @@
 #include "backend/cpu/CPUBackend.hpp"
 #include "core/Macro.h"
 #include "core/Concurrency.h"
+#include "core/BufferAllocator.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
 #include <algorithm>
+#include <string.h>
 namespace MNN {
+// Use heap for k not larger than it, otherwise use radix select
+#define TOPK_HEAP_MAX_K 64
+// Split the row for multi-thread if it's not less than it
+#define TOPK_SPLIT_ROW_SIZE 16384
+// Number of keys checked with threshold once in heap select
+#define TOPK_FILTER_UNIT 64
+
+/**
+ The values are mapped to uint32 keys keeping the order (reversed for smallest), so the same kernel works for float and
+ int32. The candidate with larger key is better, and the one with smaller index is better for the same key.
+ */
+struct TopKCandidate {
+    uint32_t key;
+    int32_t index;
+};
+static inline bool _better(const TopKCandidate& a, const TopKCandidate& b) {
+    return a.key > b.key || (a.key == b.key && a.index < b.index);
+}
 
 template <typename T>
-void findTopK(int32_t rowSize, int32_t numRows, const T* data, int32_t k, int32_t* outputIndexes, T* outputValues, bool largest) {
-    struct DataType {
-        T value;
-        int index;
-    };
-    std::vector<DataType> cacheData(rowSize);
-    auto compareL = [](const DataType& A, const DataType& B) {
-        return A.value > B.value;
-    };
-    auto compareM = [](const DataType& A, const DataType& B) {
-        return A.value < B.value;
-    };
-    for (int row = 0; row < numRows; row++) {
-        const T* valuesRow = data + row * rowSize;
-        int32_t* indexesRow = outputIndexes + row * k;
-        T* outputRow         = outputValues + row * k;
-        for (int i=0; i<rowSize; ++i) {
-            cacheData[i].value = valuesRow[i];
-            cacheData[i].index = i;
+static inline void _computeKeys(const T* src, uint32_t* dst, int size, uint32_t flip);
+template <>
+inline void _computeKeys<float>(const float* src, uint32_t* dst, int size, uint32_t flip) {
+    auto s = reinterpret_cast<const int32_t*>(src);
+    for (int i = 0; i < size; ++i) {
+        // Negative: reverse all bits, positive: set the sign bit
+        uint32_t mask = (uint32_t)(s[i] >> 31) | 0x80000000u;
+        dst[i] = ((uint32_t)s[i] ^ mask) ^ flip;
+    }
+}
+template <>
+inline void _computeKeys<int32_t>(const int32_t* src, uint32_t* dst, int size, uint32_t flip) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = ((uint32_t)src[i] ^ 0x80000000u) ^ flip;
+    }
+}
+
+// Select the best k of [0, size) into dst by a heap of size k, the keys not larger than the worst one are filtered by block
+template <typename T>
+static void _heapSelect(const T* src, int size, int offset, int k, uint32_t flip, TopKCandidate* dst) {
+    uint32_t keys[TOPK_FILTER_UNIT];
+    int number = 0;
+    uint32_t threshold = 0;
+    for (int start = 0; start < size; start += TOPK_FILTER_UNIT) {
+        int count = ALIMIN(size - start, TOPK_FILTER_UNIT);
+        _computeKeys<T>(src + start, keys, count, flip);
+        if (number == k) {
+            uint32_t maxKey = 0;
+            for (int i = 0; i < count; ++i) {
+                maxKey = ALIMAX(maxKey, keys[i]);
+            }
+            // The index is increasing, so the same key as the threshold is not better
+            if (maxKey <= threshold) {
+                continue;
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            if (number < k) {
+                dst[number++] = {keys[i], offset + start + i};
+                std::push_heap(dst, dst + number, _better);
+                if (number == k) {
+                    threshold = dst[0].key;
+                }
+                continue;
+            }
+            if (keys[i] <= threshold) {
+                continue;
+            }
+            std::pop_heap(dst, dst + k, _better);
+            dst[k - 1] = {keys[i], offset + start + i};
+            std::push_heap(dst, dst + k, _better);
+            threshold = dst[0].key;
         }
-        if (largest) {
-            std::partial_sort(cacheData.begin(), cacheData.begin() + k, cacheData.end(), compareL);
+    }
+}
+
+// Select the best k of [0, size) into dst by finding the k-th key with radix, keys and indices are scratch of size
+template <typename T>
+static void _radixSelect(const T* src, int size, int offset, int k, uint32_t flip, uint32_t* keys, int32_t* indices, TopKCandidate* dst) {
+    _computeKeys<T>(src, keys, size, flip);
+    int histogram[256];
+    // Find the k-th key from the high byte, the candidates are compacted into indices after the first pass
+    uint32_t prefix = 0;
+    uint32_t prefixMask = 0;
+    int remain = k;
+    int candidate = size;
+    bool compacted = false;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        ::memset(histogram, 0, sizeof(histogram));
+        if (!compacted) {
+            for (int i = 0; i < size; ++i) {
+                histogram[(keys[i] >> shift) & 0xFF]++;
+            }
+        } else {
+            for (int i = 0; i < candidate; ++i) {
+                histogram[(keys[indices[i]] >> shift) & 0xFF]++;
+            }
+        }
+        int bucket = 255;
+        for (; bucket > 0; --bucket) {
+            if (histogram[bucket] >= remain) {
+                break;
+            }
+            remain -= histogram[bucket];
+        }
+        prefix |= ((uint32_t)bucket << shift);
+        prefixMask |= (0xFFu << shift);
+        if (shift == 0) {
+            break;
+        }
+        // Keep the keys in the bucket of k-th
+        int newCandidate = 0;
+        if (!compacted) {
+            for (int i = 0; i < size; ++i) {
+                if ((keys[i] & prefixMask) == prefix) {
+                    indices[newCandidate++] = i;
+                }
+            }
+            compacted = true;
         } else {
-            std::partial_sort(cacheData.begin(), cacheData.begin() + k, cacheData.end(), compareM);
+            for (int i = 0; i < candidate; ++i) {
+                if ((keys[indices[i]] & prefixMask) == prefix) {
+                    indices[newCandidate++] = indices[i];
+                }
+            }
         }
-        for (int i=0; i<k; ++i) {
-            outputRow[i] = cacheData[i].value;
-            indexesRow[i] = cacheData[i].index;
+        candidate = newCandidate;
+    }
+    // Take all keys larger than the k-th and the first remain ones equal to it
+    const uint32_t kth = prefix;
+    int number = 0;
+    for (int i = 0; i < size; ++i) {
+        auto key = keys[i];
+        if (key > kth) {
+            dst[number++] = {key, offset + i};
+        } else if (key == kth && remain > 0) {
+            dst[number++] = {key, offset + i};
+            remain--;
         }
     }
+    MNN_ASSERT(number == k);
+}
+
+template <typename T>
+static void _selectTopK(const T* src, int size, int offset, int k, uint32_t flip, uint32_t* keys, int32_t* indices, TopKCandidate* dst) {
+    if (k <= TOPK_HEAP_MAX_K) {
+        _heapSelect<T>(src, size, offset, k, flip, dst);
+    } else {
+        _radixSelect<T>(src, size, offset, k, flip, keys, indices, dst);
+    }
+}
+
+template <typename T>
+static void _writeTopK(const T* src, TopKCandidate* candidates, int k, T* outputValues, int32_t* outputIndexes) {
+    std::sort(candidates, candidates + k, _better);
+    for (int i = 0; i < k; ++i) {
+        outputIndexes[i] = candidates[i].index;
+        outputValues[i]  = src[candidates[i].index];
+    }
 }
 
 CPUTopKV2::CPUTopKV2(Backend* b, const Op* op) : MNN::Execution(b) {
@@ -54,6 +183,89 @@ CPUTopKV2::CPUTopKV2(Backend* b, const Op* op) : MNN::Execution(b) {
     }
 }
 
+ErrorCode CPUTopKV2::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    auto inputTensor = inputs[0];
+    auto output      = outputs[0];
+    const int rowSize = inputTensor->length(inputTensor->dimensions() - 1);
+    const int k       = output->length(output->dimensions() - 1);
+    if (rowSize <= 0 || k <= 0) {
+        mThreadNumber = 0;
+        return NO_ERROR;
+    }
+    const int numRows = inputTensor->elementSize() / rowSize;
+    int threadNumber = static_cast<CPUBackend*>(backend())->threadNumber();
+    // Split a row for threads if there are not enough rows
+    mSplitRow = numRows < threadNumber && rowSize >= TOPK_SPLIT_ROW_SIZE && threadNumber > 1;
+    if (mSplitRow) {
+        mThreadNumber = threadNumber;
+        mChunkSize    = UP_DIV(rowSize, threadNumber);
+    } else {
+        mThreadNumber = ALIMIN(threadNumber, numRows);
+        mChunkSize    = rowSize;
+    }
+    // Radix select needs the keys and the indices of candidates for a chunk
+    size_t keySize = k > TOPK_HEAP_MAX_K ? mChunkSize : 0;
+    auto bufferAlloc = static_cast<CPUBackend*>(backend())->getBufferAllocator();
+    mKeys = bufferAlloc->alloc(keySize * mThreadNumber * sizeof(uint32_t) + 1);
+    mIndices = bufferAlloc->alloc(keySize * mThreadNumber * sizeof(int32_t) + 1);
+    // Each thread selects k candidates, which are merged if the row is split
+    mCandidates = bufferAlloc->alloc(k * mThreadNumber * sizeof(TopKCandidate));
+    if (mKeys.invalid() || mIndices.invalid() || mCandidates.invalid()) {
+        return OUT_OF_MEMORY;
+    }
+    bufferAlloc->free(mKeys);
+    bufferAlloc->free(mIndices);
+    bufferAlloc->free(mCandidates);
+    return NO_ERROR;
+}
+
+template <typename T>
+void CPUTopKV2::_findTopK(int32_t rowSize, int32_t numRows, const T* data, int32_t k, int32_t* outputIndexes, T* outputValues) {
+    const uint32_t flip = mLargest ? 0 : 0xFFFFFFFFu;
+    auto candidates = reinterpret_cast<TopKCandidate*>(mCandidates.ptr());
+    auto keysOrigin = reinterpret_cast<uint32_t*>(mKeys.ptr());
+    auto indicesOrigin = reinterpret_cast<int32_t*>(mIndices.ptr());
+    const int keyStride = k > TOPK_HEAP_MAX_K ? mChunkSize : 0;
+    if (!mSplitRow) {
+        MNN_CONCURRENCY_BEGIN(tId, mThreadNumber) {
+            auto threadCandidates = candidates + tId * k;
+            auto keys = keysOrigin + tId * keyStride;
+            auto indices = indicesOrigin + tId * keyStride;
+            for (int row = (int)tId; row < numRows; row += mThreadNumber) {
+                const T* valuesRow = data + row * rowSize;
+                _selectTopK<T>(valuesRow, rowSize, 0, k, flip, keys, indices, threadCandidates);
+                _writeTopK<T>(valuesRow, threadCandidates, k, outputValues + row * k, outputIndexes + row * k);
+            }
+        }
+        MNN_CONCURRENCY_END();
+        return;
+    }
+    // Select the best k of every chunk, and the best k of the row is in them
+    std::vector<int> candidateNumber(mThreadNumber);
+    for (int row = 0; row < numRows; ++row) {
+        const T* valuesRow = data + row * rowSize;
+        MNN_CONCURRENCY_BEGIN(tId, mThreadNumber) {
+            int start = (int)tId * mChunkSize;
+            int size  = ALIMIN(rowSize - start, mChunkSize);
+            int number = ALIMIN(size, k);
+            candidateNumber[tId] = ALIMAX(number, 0);
+            if (number > 0) {
+                _selectTopK<T>(valuesRow + start, size, start, number, flip, keysOrigin + tId * keyStride, indicesOrigin + tId * keyStride, candidates + tId * k);
+            }
+        }
+        MNN_CONCURRENCY_END();
+        int total = 0;
+        for (int i = 0; i < mThreadNumber; ++i) {
+            if (total != i * k) {
+                ::memmove(candidates + total, candidates + i * k, candidateNumber[i] * sizeof(TopKCandidate));
+            }
+            total += candidateNumber[i];
+        }
+        std::nth_element(candidates, candidates + k - 1, candidates + total, _better);
+        _writeTopK<T>(valuesRow, candidates, k, outputValues + row * k, outputIndexes + row * k);
+    }
+}
+
 ErrorCode CPUTopKV2::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     const int k        = inputs[1]->host<int32_t>()[0];
     auto inputTensor   = inputs[0];
@@ -68,8 +280,11 @@ ErrorCode CPUTopKV2::onExecute(const std::vector<Tensor*>& inputs, const std::ve
     const int rowC4ElementSize = rowC4Blocks * 4;
     MNN_ASSERT(k <= rowSize);
     const int numRows = inputTensor->elementSize() / rowSize;
+    if (0 == mThreadNumber) {
+        return NO_ERROR;
+    }
 
-    if (k == 1 && mLargest) {
+    if (k == 1 && mLargest && !mSplitRow) {
         if (halide_type_float == inputTensor->getType().code) {
             float* inputData   = inputTensor->host<float>();
             float* topkData    = outputData->host<float>();
@@ -121,12 +336,12 @@ ErrorCode CPUTopKV2::onExecute(const std::vector<Tensor*>& inputs, const std::ve
         auto inputData   = inputTensor->host<float>();
         auto topkData    = outputData->host<float>();
         int* indicesData = outputIndices->host<int32_t>();
-        findTopK<float>(rowSize, numRows, inputData, k, indicesData, topkData, mLargest);
+        _findTopK<float>(rowSize, numRows, inputData, k, indicesData, topkData);
     } else if(halide_type_int == inputTensor->getType().code && 32 == inputTensor->getType().bits) {
         auto inputData   = inputTensor->host<int32_t>();
         auto topkData    = outputData->host<int32_t>();
         int* indicesData = outputIndices->host<int32_t>();
-        findTopK<int32_t>(rowSize, numRows, inputData, k, indicesData, topkData, mLargest);
+        _findTopK<int32_t>(rowSize, numRows, inputData, k, indicesData, topkData);
     } else {
         MNN_PRINT("TODO\n");
         MNN_ASSERT(false);
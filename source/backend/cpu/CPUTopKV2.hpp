@@ -10,6 +10,7 @@
 #define CPUTOPKV2_HPP
 
 #include "core/Execution.hpp"
+#include "core/BufferAllocator.hpp"
 #include "MNN_generated.h"
 
 namespace MNN {
@@ -17,10 +18,20 @@ class CPUTopKV2 : public Execution {
 public:
     CPUTopKV2(Backend *b, const Op* op);
     virtual ~CPUTopKV2() = default;
+    virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
 
 private:
+    template <typename T>
+    void _findTopK(int32_t rowSize, int32_t numRows, const T* data, int32_t k, int32_t* outputIndexes, T* outputValues);
     bool mLargest = true;
+    // Split one row for threads if the rows are fewer than threads
+    bool mSplitRow = false;
+    int mThreadNumber = 1;
+    int mChunkSize = 0;
+    MemChunk mKeys;
+    MemChunk mIndices;
+    MemChunk mCandidates;
 };
 } // namespace MNN
 
@@ -403,9 +403,9 @@ MNNUnaryExecute CPUUnary::selectForFloat(int type, int precision) {
         case UnaryOpOperation_COSH:
             return _unaryOp<UnaryCosh<float>, float>;
         case UnaryOpOperation_ERF:
-            return _unaryOp<UnaryErf<float>, float>;
+            return (MNNUnaryExecute)MNNErf;
         case UnaryOpOperation_ERFC:
-            return _unaryOp<UnaryErfc<float>, float>;
+            return (MNNUnaryExecute)MNNErfc;
         case UnaryOpOperation_ERFINV:
             return _unaryOp<UnaryErfinv<float>, float>;
         case UnaryOpOperation_EXPM1:
@@ -419,7 +419,7 @@ MNNUnaryExecute CPUUnary::selectForFloat(int type, int precision) {
         case UnaryOpOperation_GELU:
             return (MNNUnaryExecute)MNNGeluCommon;
         case UnaryOpOperation_GELU_STANDARD:
-            return (MNNUnaryExecute)MNNGeluStandardCommon;
+            return (MNNUnaryExecute)MNNGeluStandard;
         default:
             MNN_ASSERT(false);
             break;
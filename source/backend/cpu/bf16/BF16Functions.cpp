@@ -881,6 +881,12 @@ bool BF16Functions::init() {
         gInstance->MNNPackC4ForMatMul_A = _AVX_MNNPackC4ForMatMul_A_BF16;
         gInstance->MNNPackedMatMul = _AVX_MNNPackedMatMulFMA_BF16;
         gInstance->MNNPackedMatMulRemain = _AVX_MNNPackedMatMulRemainFMA_BF16;
+#if defined(MNN_AVX512_BF16) && !defined(MNN_SSE_USE_FP16_INSTEAD)
+        if ((cpuFlags & libyuv::kCpuHasAVX512BF16) && (cpuFlags & libyuv::kCpuHasAVX512VL)) {
+            gInstance->MNNPackedMatMul = _AVX512_MNNPackedMatMulBF16;
+            gInstance->MNNPackedMatMulRemain = _AVX512_MNNPackedMatMulRemainBF16;
+        }
+#endif
         return true;
     }
 #elif defined(MNN_USE_NEON)
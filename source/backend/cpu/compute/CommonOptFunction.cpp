@@ -13,6 +13,7 @@
 #include "ImageProcessFunction.hpp"
 #include <string.h>
 #include <algorithm>
+#include <limits>
 #include <cmath>
 #include <math.h>
 #include "math/Vec.hpp"
@@ -885,6 +886,41 @@ void MNNGemmHybridInt4FP32(float* C, const int8_t* A, const int8_t* B, size_t sr
 }
 #endif
 
+void MNNDynamicQuantRowFP32(const float* src, int8_t* dst, float* dequantScale, int32_t* sum, size_t channel, size_t realSize, size_t stride, int pack) {
+    // src / dst: (channel/pack, stride/pack, pack), the padding of the last quad is not read and set to zero
+#ifdef MNN_USE_SSE
+    uint8_t* dstPtr = reinterpret_cast<uint8_t*>(dst);
+    const int offset = 128;
+#else
+    int8_t* dstPtr = dst;
+    const int offset = 0;
+#endif
+    auto depthQuad = UP_DIV(channel, pack);
+    for (int i = 0; i < realSize; ++i) {
+        float absmaxVal = 0.0f;
+        for (int c = 0; c < channel; ++c) {
+            absmaxVal = std::max(absmaxVal, std::abs(src[(c / pack) * stride + i * pack + c % pack]));
+        }
+        float quantScale = absmaxVal > 0.0f ? 127.0f / absmaxVal : 0.0f;
+        dequantScale[i] = absmaxVal / 127.0f;
+        int acc = 0;
+        for (int z = 0; z < depthQuad; ++z) {
+            auto srcZ = src + z * stride + i * pack;
+            auto dstZ = dstPtr + z * stride + i * pack;
+            int valid = std::min(pack, (int)channel - z * pack);
+            for (int k = 0; k < valid; ++k) {
+                int val = (int)roundf(srcZ[k] * quantScale);
+                acc += val;
+                dstZ[k] = val + offset;
+            }
+            for (int k = valid; k < pack; ++k) {
+                dstZ[k] = offset;
+            }
+        }
+        sum[i] = acc;
+    }
+}
+
 void MNNPackC4ForMatMul_A(float* destOrigin, float const** sourceGroup, const int32_t* info, const int32_t* el) {
     int number = info[0];
     int eReal = info[1];
@@ -2678,12 +2714,6 @@ void MNNHardSwishCommon(float* dst, const float* src, size_t size) {
 #endif
 }
 
-void MNNGeluStandardCommon(float* dst, const float* src, size_t size) {
-    for (int i = 0; i < size; i++) {
-        dst[i] = (erf(src[i] * 0.7071067932881648) + 1) * src[i] * 0.5;
-    }
-}
-
 void MNNGeluCommon(float* dst, const float* src, size_t size) {
     int sizeQuad = static_cast<int32_t>(size / 8);
     int remain = static_cast<int32_t>(size) % 8;
@@ -2720,6 +2750,52 @@ void MNNGeluCommon(float* dst, const float* src, size_t size) {
 #endif
 }
 
+#ifndef MNN_USE_SSE
+void MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size) {
+    // y = x * scale + mask, then softmax(y), the exp and sum are computed by MNNExp
+    float maxValue = -std::numeric_limits<float>::max();
+    for (int i = 0; i < size; ++i) {
+        auto y = source[i] * scale;
+        if (nullptr != mask) {
+            y += mask[i];
+        }
+        dest[i] = y;
+        maxValue = ALIMAX(maxValue, y);
+    }
+    float exprOffset[4] = {1.0f, 0.0f, -maxValue, 0.0f};
+    MNNExp(dest, dest, exprOffset, size);
+    float sumValue = 1.0f / exprOffset[3];
+    for (int i = 0; i < size; ++i) {
+        dest[i] *= sumValue;
+    }
+}
+
+void MNNErf(float* dst, const float* src, size_t size) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = erff(src[i]);
+    }
+}
+
+void MNNErfc(float* dst, const float* src, size_t size) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = erfcf(src[i]);
+    }
+}
+
+void MNNGeluStandard(float* dst, const float* src, size_t size) {
+    // x * 0.5 * erfc(-x / sqrt(2)) avoid the cancellation of 1 + erf(x) for negative x
+    for (int i = 0; i < size; ++i) {
+        dst[i] = (float)(0.5 * src[i] * erfc(-src[i] * 0.7071067811865476));
+    }
+}
+
+void MNNSiLU(float* dst, const float* src, size_t size) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = src[i] / (1.0f + expf(-src[i]));
+    }
+}
+#endif
+
 void MNNScaleAndAddBiasScalar(float* dst, const float* src, float bias, float alpha, size_t number) {
     int numberC4 = (int)number / 4;
     int start = 0;
@@ -3308,6 +3384,7 @@ void MNNCoreFunctionInit() {
     gCoreFunction->MNNQuantScale = MNNQuantScaleFP32;
     gCoreFunction->MNNQuantSum = MNNQuantSumFP32;
 #endif
+    gCoreFunction->MNNDynamicQuantRow = MNNDynamicQuantRowFP32;
     gCoreFunction->MNNCountMaxMinValue = MNNCountMaxMinValue;
     gCoreFunction->MNNGetSparseMatMulPackMode = MNNGetSparseMatMulPackMode;
     gCoreFunction->MNNAdjustOptimalSparseKernel = _MNNAdjustOptimalSparseKernel;
@@ -91,8 +91,14 @@ void MNNSigmoidLowp(float* dst, const float* src, size_t dataSize);
 void MNNReluWithSlopeCommon(float* dst, const float* src, size_t size, float slope);
 void MNNHardSwishCommon(float* dst, const float* src, size_t size);
 void MNNGeluCommon(float* dst, const float* src, size_t size);
-void MNNGeluStandardCommon(float* dst, const float* src, size_t size);
 void MNNSoftmax(float* dest, const float* source, size_t size);
+// softmax(source * scale + mask) of size elements, mask can be nullptr
+void MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size);
+// Vectorized erf, erfc, exact gelu: x * Phi(x) and silu: x * sigmoid(x), max error of a few ulp
+void MNNErf(float* dst, const float* src, size_t size);
+void MNNErfc(float* dst, const float* src, size_t size);
+void MNNGeluStandard(float* dst, const float* src, size_t size);
+void MNNSiLU(float* dst, const float* src, size_t size);
 void MNNNorm(float* dest, const float* source, const float *gamma, const float *beta, float epsilon, size_t size, bool RMSNorm = false);
 
 // Get Pack for MatMul's e , l , h , the pack number must be 1 or 4 * n
@@ -128,6 +134,7 @@ void MNNAbsMaxFP32(const float* source, float* absmax, size_t src_depth_quad, si
 void MNNQuantScaleFP32(float* absmax, float* quant_scale, float* dequant_scale, size_t thread, size_t batch);
 void MNNDynamicQuantFP32(const float* src, int8_t* dst, const float* scale, float* sum, size_t src_depth_quad, size_t realSize, int pack);
 void MNNQuantSumFP32(float* sum, const float* dequant_scale, size_t thread, size_t batch);
+void MNNDynamicQuantRowFP32(const float* src, int8_t* dst, float* dequantScale, int32_t* sum, size_t channel, size_t realSize, size_t stride, int pack);
 
 
 void MNNPackForSparseMatMul_B(float* dest, unsigned int* NNZMap, int* dataOffsetMap, int sparseBlockOC, const float* source, size_t h, size_t l, const int eP, bool transpose);
@@ -201,6 +208,9 @@ struct CoreFunctions {
     void(*MNNQuantScale)(float* absmax, float* quant_scale, float* dequant_scale, size_t thread, size_t batch);
     void(*MNNDynamicQuant)(const float* src, int8_t* dst, const float* scale, float* sum, size_t src_depth_quad, size_t realSize, int pack);
     void(*MNNQuantSum)(float* sum, const float* dequant_scale, size_t thread, size_t batch);
+    // Quantize realSize rows of channel in C(pack) layout to int8 by the absmax of each row, dst has the same layout (+128 for sse),
+    // stride is the number of elements between two channel quads, output dequant scale (absmax / 127) and sum of int8 for each row
+    void(*MNNDynamicQuantRow)(const float* src, int8_t* dst, float* dequantScale, int32_t* sum, size_t channel, size_t realSize, size_t stride, int pack);
     void(*MNNGemmHybridInt4)(float* C, const int8_t* A, const int8_t* B, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, size_t realSize, const float** param);
     void(*MNNGemmHybridInt8)(float* C, const int8_t* A, const int8_t* B, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, size_t realSize, const float** param);
     void(*MNNPackedMatMul_int8)(float* C, const float* A, const float* B, const size_t* parameter, const float* postParameters, const float* bias, const float* k, const float* b);
@@ -255,6 +265,10 @@ struct CoreFunctions {
     void(*MNNConvRunForLineDepthwise)(float* dst, const float* src, const float* weight, size_t width, size_t src_w_setup,
                                     size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step, size_t height,
                                     size_t srcHStep, size_t dstHStep);
+    // MNNConvRunForLineDepthwise with bias and post treatment: parameters are the post parameters of convolution, hardswish after clamp if parameters[4] != 0
+    void(*MNNConvRunForLineDepthwisePost)(float* dst, const float* src, const float* weight, size_t width, size_t src_w_setup,
+                                    size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step, size_t height,
+                                    size_t srcHStep, size_t dstHStep, const float* bias, const float* parameters) = nullptr;
     void(*MNNAxByClampBroadcastUnit)(float* C, const float* A, const float* B, size_t width, size_t cStride, size_t aStride, size_t height, const float* parameters);
     void(*MNNMultiAndDestTransformCommon23)(float **cacheLine, const float *weigth, float *dest, int cacheLineSize, int ow, const float* bias, const float* post);
     void(*MNNSourceTransformCommonF23)(const float *source, float *dest, int unit, int iw, int pad, int su, int eu);
@@ -9,6 +9,7 @@
 #include "Convolution1x1Strassen.hpp"
 #include "DenseConvolutionTiledExecutor.hpp"
 #include <string.h>
+#include "core/AutoStorage.h"
 #include "core/BufferAllocator.hpp"
 #include "backend/cpu/CPUBackend.hpp"
 #include "core/Concurrency.h"
@@ -59,18 +60,24 @@ Convolution1x1Strassen::Convolution1x1Strassen(const Convolution2DCommon *common
         MNN_ERROR("Not Enough Memory\n");
         return;
     }
-    if (core->bytes < 4) {
-        AutoRelease<Tensor> tempTensor(Tensor::createDevice<float>({outputCount * mSrcCount}));
-        mValid = b->onAcquireBuffer(tempTensor.get(), Backend::STATIC);
-        if (!mValid) {
-            MNN_ERROR("Not Enough Memory\n");
-            return;
+    auto weightPtr = mResource->mWeight->host<float>();
+    auto srcCount  = mSrcCount;
+    // quantInfo holds originWeight if it is dequantized
+    auto pack = [weightPtr, originWeight, srcCount, outputCount, core, quantInfo]() {
+        if (core->bytes < 4) {
+            AutoStorage<int16_t> temp(outputCount * srcCount);
+            core->MNNFp32ToLowp(originWeight, temp.get(), outputCount * srcCount);
+            core->MNNPackForMatMul_B(weightPtr, (const float*)temp.get(), outputCount, srcCount, true);
+        } else {
+            core->MNNPackForMatMul_B(weightPtr, originWeight, outputCount, srcCount, true);
         }
-        core->MNNFp32ToLowp(originWeight, tempTensor->host<int16_t>(), outputCount * mSrcCount);
-        core->MNNPackForMatMul_B(mResource->mWeight->host<float>(), tempTensor->host<float>(), outputCount, mSrcCount, true);
-        b->onReleaseBuffer(tempTensor.get(), Backend::STATIC);
+    };
+    auto cpuBn = static_cast<CPUBackend*>(b);
+    if (cpuBn->weightPackMode() > 0) {
+        mResource->mLazyPack.reset(new CPULazyPack(pack));
+        cpuBn->addLazyPack(mResource->mLazyPack);
     } else {
-        core->MNNPackForMatMul_B(mResource->mWeight->host<float>(), originWeight, outputCount, mSrcCount, true);
+        pack();
     }
 }
 Convolution1x1Strassen::Convolution1x1Strassen(std::shared_ptr<CPUConvolution::Resource> resource, const Convolution2DCommon *common, Backend* b) : CPUConvolution(common, b) {
@@ -150,6 +157,10 @@ ErrorCode Convolution1x1Strassen::onResize(const std::vector<Tensor *> &inputs,
             unit.offset[2] = 0;
             unit.offset[0] = core->pack * planeStart * bytes;
             unit.offset[3] = core->pack * planeStart * bytes;
+            unit.range[0] = planeStart;
+            unit.range[1] = planeSize;
+            unit.range[2] = 0;
+            unit.range[3] = ocC4;
             unit.mStracssenComputor.reset(new StrassenMatrixComputor(backend(), false, maxDepth, dequantAlpha, dequantBias, dequantBits));
             int e = planeSize;
             int l = ic;
@@ -193,6 +204,10 @@ ErrorCode Convolution1x1Strassen::onResize(const std::vector<Tensor *> &inputs,
             unit.offset[2] = core->pack * ocStart * bytes;
             unit.offset[0] = 0;
             unit.offset[3] = core->pack * matrixSizeE * ocStart * bytes;
+            unit.range[0] = 0;
+            unit.range[1] = matrixSizeE;
+            unit.range[2] = ocStart;
+            unit.range[3] = ocStart + ocSize;
 
             unit.mStracssenComputor.reset(new StrassenMatrixComputor(backend(), false, maxDepth, dequantAlpha, dequantBias, dequantBits));
             int e = matrixSizeE;
@@ -214,7 +229,16 @@ ErrorCode Convolution1x1Strassen::onResize(const std::vector<Tensor *> &inputs,
     return NO_ERROR;
 }
 
+bool Convolution1x1Strassen::onSetEpilogue(const Epilogue& epilogue) {
+    return mEpilogue.set(epilogue, backend());
+}
+
 ErrorCode Convolution1x1Strassen::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    if (nullptr != mResource->mLazyPack) {
+        mResource->mLazyPack->run();
+    }
+    mEpilogue.prepare(inputs, outputs);
+    bool hasEpilogue = !mEpilogue.empty();
     auto size   = mUnits.size();
     auto input  = inputs[0];
     auto output = outputs[0];
@@ -228,6 +252,9 @@ ErrorCode Convolution1x1Strassen::onExecute(const std::vector<Tensor *> &inputs,
         auto &unit = mUnits[tId];
         if (unit.mValid) {
             unit.mStracssenComputor->onExecute(inputPtr + unit.offset[0], weightPtr + unit.offset[1], biasPtr + unit.offset[2], outputPtr + unit.offset[3]);
+            if (hasEpilogue) {
+                mEpilogue.applyPack(unit.range[2], unit.range[3], unit.range[0], unit.range[1]);
+            }
         }
     }
     MNN_CONCURRENCY_END();
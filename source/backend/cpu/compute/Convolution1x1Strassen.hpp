@@ -12,6 +12,7 @@
 #include <functional>
 #include "backend/cpu/CPUConvolution.hpp"
 #include "backend/cpu/compute/StrassenMatmulComputor.hpp"
+#include "backend/cpu/compute/GemmEpilogue.hpp"
 namespace MNN {
 class Convolution1x1Strassen : public CPUConvolution {
 public:
@@ -24,17 +25,20 @@ public:
 
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
+    virtual bool onSetEpilogue(const Epilogue& epilogue) override;
 private:
     std::shared_ptr<CPUConvolution::Resource> mResource;
 
     struct Unit {
         bool mValid = true;
         int offset[4];//Input, Weight, Output, Bias
+        int range[4];//Plane start, Plane size, Channel block start, Channel block end
         std::shared_ptr<StrassenMatrixComputor> mStracssenComputor;
     };
 
     std::vector<Unit> mUnits;
     float mWeightBytes = 4;
+    GemmEpilogue mEpilogue;
 };
 } // namespace MNN
 
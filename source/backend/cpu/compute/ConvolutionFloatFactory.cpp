@@ -16,15 +16,132 @@
 #include "backend/cpu/compute/ConvolutionWinogradBridge.hpp"
 #include "backend/cpu/compute/DenseConvolutionTiledExecutor.hpp"
 #include "backend/cpu/compute/ConvolutionHybrid.hpp"
+#include "backend/cpu/compute/GemmInt8Executor.hpp"
 #ifdef MNN_USE_SPARSE_COMPUTE
 #include "backend/cpu/compute/SparseConvolutionTiledExecutor.hpp"
 #endif
+#include <algorithm>
+#include <sstream>
+#include <MNN/AutoTime.hpp>
 #include "core/Macro.h"
 #include "core/OpCommonUtils.hpp"
 #include "backend/cpu/OneDNNConvolution.hpp"
 
 namespace MNN {
 
+// Kernel choices for Interpreter::CPU_KERNEL_TUNING, winograd with unit u is TUNE_WINOGRAD + u
+enum TuneChoice {
+    TUNE_TILED = 0,
+    TUNE_STRASSEN = 1,
+    TUNE_WINOGRAD = 16,
+};
+
+static std::string _tuneKey(const Convolution2DCommon* common, const Tensor* input, const Tensor* output, CPUBackend* backend) {
+    auto core = backend->functions();
+    auto pad = ConvolutionCommon::convolutionPad(input, output, common);
+    std::ostringstream key;
+    key << "conv_k" << common->kernelX() << "x" << common->kernelY() << "_s" << common->strideX() << "x" << common->strideY()
+        << "_d" << common->dilateX() << "x" << common->dilateY() << "_p" << pad.first << "x" << pad.second
+        << "_i" << input->batch() << "x" << input->channel() << "x" << input->height() << "x" << input->width()
+        << "_o" << output->channel() << "x" << output->height() << "x" << output->width()
+        << "_t" << backend->threadNumber() << "_c" << core->pack << "x" << core->bytes;
+    return key.str();
+}
+
+// Create the execution on a temporary backend and run it with zero input, return the time in us, or -1 if it can't run
+static float _measureUnit(const Tensor* input, const Tensor* output, CPUBackend* backend, const std::function<Execution*(Backend*)>& creator) {
+    std::shared_ptr<Backend> tempBackend(backend->getRuntime()->onCreate());
+    auto tempCpu = static_cast<CPUBackend*>(tempBackend.get());
+    if (tempCpu->functions() != backend->functions() || tempCpu->threadNumber() != backend->threadNumber()) {
+        // The backend created by user config can't be reproduced
+        return -1.0f;
+    }
+    std::shared_ptr<Tensor> tempInput(Tensor::createDevice<float>(input->shape(), Tensor::CAFFE_C4));
+    std::shared_ptr<Tensor> tempOutput(Tensor::createDevice<float>(output->shape(), Tensor::CAFFE_C4));
+    std::vector<Tensor*> inputs{tempInput.get()};
+    std::vector<Tensor*> outputs{tempOutput.get()};
+    std::shared_ptr<Execution> exe;
+    tempBackend->onResizeBegin();
+    bool valid = tempBackend->onAcquireBuffer(tempInput.get(), Backend::STATIC) && tempBackend->onAcquireBuffer(tempOutput.get(), Backend::STATIC);
+    if (valid) {
+        ::memset(tempInput->host<void>(), 0, tempCpu->getTensorSize(tempInput.get()) * CPUBackend::getBytes(tempCpu, tempInput.get()));
+        exe.reset(creator(tempBackend.get()));
+        valid = nullptr != exe && NO_ERROR == exe->onResize(inputs, outputs);
+    }
+    valid = NO_ERROR == tempBackend->onResizeEnd() && valid;
+    float cost = -1.0f;
+    if (valid) {
+        const int loop = 3;
+        tempBackend->onExecuteBegin();
+        // The first run may pack weight
+        valid = NO_ERROR == exe->onExecute(inputs, outputs);
+        Timer timer;
+        for (int i = 0; i < loop && valid; ++i) {
+            valid = NO_ERROR == exe->onExecute(inputs, outputs);
+        }
+        if (valid) {
+            cost = (float)timer.durationInUs() / (float)loop;
+        }
+        tempBackend->onExecuteEnd();
+    }
+    exe.reset();
+    tempBackend->onReleaseBuffer(tempInput.get(), Backend::STATIC);
+    tempBackend->onReleaseBuffer(tempOutput.get(), Backend::STATIC);
+    return cost;
+}
+
+// Choose the kernel by measuring or the choice stored in cache, return nullptr if there is nothing to choose
+static Execution* _createTunedUnit(const Tensor* input, const Tensor* output, CPUBackend* backend, const Convolution2DCommon* common,
+                                   const float* originWeight, size_t originWeightSize, const float* bias, size_t biasSize,
+                                   std::shared_ptr<ConvolutionCommon::Int8Common> weightQuantInfo, bool fastWay) {
+    std::vector<int> choices{TUNE_TILED};
+    std::vector<WinogradConfig> winogradConfigs;
+    if (fastWay) {
+        choices.emplace_back(TUNE_STRASSEN);
+    } else if (originWeightSize > 0 && ConvolutionWinogradBridge::canUseWinograd(common)) {
+        PerfConfig convPerfconfig = DenseConvolutionTiledExecutor::bestTileConvolutionConfig(common, input, output, backend->threadNumber(), backend);
+        winogradConfigs = ConvolutionWinogradBridge::winogradUnitCandidates(common, input, output, backend->threadNumber(), backend, convPerfconfig);
+        for (auto& config : winogradConfigs) {
+            choices.emplace_back(TUNE_WINOGRAD + config.unit);
+        }
+    }
+    if (choices.size() <= 1) {
+        return nullptr;
+    }
+    auto createChoice = [&](int choice, Backend* bn) -> Execution* {
+        if (TUNE_STRASSEN == choice) {
+            return new Convolution1x1Strassen(common, bn, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
+        }
+        for (auto& config : winogradConfigs) {
+            if (TUNE_WINOGRAD + config.unit == choice) {
+                return ConvolutionWinogradBridge::createWinogradImpl(common, input, output, bn, originWeight, originWeightSize, bias, biasSize, config);
+            }
+        }
+        return new DenseConvolutionTiledExecutor(common, bn, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
+    };
+    auto runtime = static_cast<const CPURuntime*>(backend->getRuntime());
+    auto key = _tuneKey(common, input, output, backend);
+    int bestChoice = -1;
+    if (runtime->findTuneChoice(key, bestChoice) && std::find(choices.begin(), choices.end(), bestChoice) != choices.end()) {
+        return createChoice(bestChoice, backend);
+    }
+    float bestCost = -1.0f;
+    for (auto choice : choices) {
+        auto cost = _measureUnit(input, output, backend, [&](Backend* bn) {
+            return createChoice(choice, bn);
+        });
+        if (cost >= 0.0f && (bestCost < 0.0f || cost < bestCost)) {
+            bestCost = cost;
+            bestChoice = choice;
+        }
+    }
+    if (bestCost < 0.0f) {
+        return nullptr;
+    }
+    runtime->addTuneChoice(key, bestChoice);
+    return createChoice(bestChoice, backend);
+}
+
 static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend* backend,
                               const Convolution2D* conv2d, const float* originWeight, size_t originWeightSize, const float* bias, size_t biasSize, std::shared_ptr<ConvolutionCommon::Int8Common> weightQuantInfo, bool supportSparse, bool lowMemory) {
     auto cpuBackend = (CPUBackend*)backend;
@@ -52,6 +169,12 @@ static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend
             return new DenseConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
         }
     }
+    if (cpuBackend->getRuntime()->getKernelTuning() > 0) {
+        auto tuned = _createTunedUnit(input, output, cpuBackend, common, originWeight, originWeightSize, bias, biasSize, weightQuantInfo, fastWay);
+        if (nullptr != tuned) {
+            return tuned;
+        }
+    }
     if (fastWay) {
         return new Convolution1x1Strassen(common, backend, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
     }
@@ -59,12 +182,12 @@ static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend
         return new DenseConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
     }
     if (!ConvolutionWinogradBridge::canUseWinograd(common)) {
-        return new DenseConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize, nullptr);
+        return new DenseConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
     }
     PerfConfig convPerfconfig = DenseConvolutionTiledExecutor::bestTileConvolutionConfig(common, input, output, cpuBackend->threadNumber(), backend);
     auto winogradConfig = ConvolutionWinogradBridge::bestWinogradUnit(common, input, output, cpuBackend->threadNumber(), backend, convPerfconfig);
     if (winogradConfig.unit <= 1) {
-        return new DenseConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize, nullptr);
+        return new DenseConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize, weightQuantInfo);
     }
     return ConvolutionWinogradBridge::createWinogradImpl(common, input, output, backend, originWeight, originWeightSize, bias, biasSize,
                                    winogradConfig);
@@ -105,11 +228,31 @@ Execution* ConvolutionFloatFactory::create(const std::vector<Tensor*>& inputs, c
             // The weight is storage as float sparse, but the backend don't support sparse compute, expand it
             forceFloat = true;
         }
-        quanCommon = ConvolutionCommon::load(conv2d, backend, forceFloat, lowMemory);
+        // Keep the int8 weight for int8 gemm with dynamic quantized input
+        bool dynamicQuant = static_cast<CPUBackend*>(backend)->getRuntime()->getDynamicQuant() > 0 && !forceFloat
+            && !conv2d->quanParameter()->has_scaleInt();
+        quanCommon = ConvolutionCommon::load(conv2d, backend, forceFloat, lowMemory || dynamicQuant);
         if (nullptr == quanCommon) {
             MNN_ERROR("Memory not Enough, can't extract IDST Convolution: %s \n", op->name()->c_str());
             return nullptr;
         }
+        if (dynamicQuant) {
+            if (DynamicGemmInt8Executor::support(conv2d->common(), inputs[0], outputs[0], backend, quanCommon.get())) {
+                std::unique_ptr<DynamicGemmInt8Executor> exe(new DynamicGemmInt8Executor(conv2d->common(), backend, quanCommon.get(),
+                                                                                         conv2d->bias()->data(), conv2d->bias()->size()));
+                if (exe->valid()) {
+                    return exe.release();
+                }
+            }
+            if (!lowMemory) {
+                // Back to float
+                quanCommon = ConvolutionCommon::load(conv2d, backend, forceFloat, false);
+                if (nullptr == quanCommon) {
+                    MNN_ERROR("Memory not Enough, can't extract IDST Convolution: %s \n", op->name()->c_str());
+                    return nullptr;
+                }
+            }
+        }
 
         if (conv2d->quanParameter()->has_scaleInt()) {
             if (bytes < 4) {
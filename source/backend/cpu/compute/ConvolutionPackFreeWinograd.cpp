@@ -16,6 +16,7 @@
 #include "math/WingoradGenerater.hpp"
 #include <MNN/AutoTime.hpp>
 #include "core/MemoryFormater.h"
+#include "backend/cpu/CPURuntime.hpp"
 #ifdef MNN_USE_NEON
 #include <arm_neon.h>
 #endif
@@ -26,6 +27,23 @@ constexpr int FUSE_THRESHHOLD_DENOMINATOR = 10;
 using namespace MNN::Math;
 
 namespace MNN {
+// Cache sizes for the unit cost model, from the detected L2 of one core and last level cache (MNNGetCPUCacheSize).
+// The transformed tile shares L2 with the weight block and the destination, so only half of L2 is counted for it.
+// The last level cache is shared with other cores and processes, so at most gMaxLLCShare is counted for the weight:
+// on a 2MB L2 / 105MB L3 Xeon, the measured unit choice matches a 1MB / 16MB model.
+// The defaults are used when the sizes can't be detected, such as on Windows.
+static const size_t gDefaultL2CacheSize = 2 * 1024 * 1024;
+static const size_t gDefaultLLCSize = 16 * 1024 * 1024;
+static const size_t gMaxLLCShare = 16 * 1024 * 1024;
+static size_t _getL2TileBytes() {
+    auto size = MNNGetCPUCacheSize(2);
+    return (size > 0 ? size : gDefaultL2CacheSize) / 2;
+}
+static size_t _getLLCWeightBytes() {
+    auto size = MNNGetCPUCacheSize(0);
+    return std::min(size > 0 ? size : gDefaultLLCSize, gMaxLLCShare);
+}
+
 ConvolutionPackFreeWinograd::ConvolutionPackFreeWinograd(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output,
                                          Backend *b, const float *originWeight, size_t originWeightSize,
                                          const float *bias, size_t biasSize, WinogradConfig config)
@@ -33,8 +51,6 @@ ConvolutionPackFreeWinograd::ConvolutionPackFreeWinograd(const Convolution2DComm
 
     mResource.reset(new Resource);
     mResource->backend = b;
-    mDestUnrollTransform.reset(new CoreFunctions::WinoUnrollDestTransFunc[CONVOLUTION_WINOGRAD_MAX_UNIT + 1],
-        std::default_delete<CoreFunctions::WinoUnrollDestTransFunc[]>());
 
     if (!mResource->copyBiasAlign(bias, biasSize)) {
         MNN_ERROR("Not Enough Memory\n");
@@ -656,9 +672,16 @@ WinogradConfig ConvolutionPackFreeWinograd::updateBestWinogradUnit(const Convolu
     constexpr int ePackUnit = 14;
     constexpr int InnerEPackCount = 8;
     constexpr int OuterEPackCount = 2;
+    // The transformed tile (srcUnit2 * (ic + oc) * eTile) beyond L2 of one core makes transforms and multiply read from L3
+    static const size_t l2CacheFloats = _getL2TileBytes() / sizeof(float);
+    constexpr float l2MissCost = 2.0f;
+    // The transformed weight (srcUnit2 * ic * oc) beyond the last level cache is streamed from memory for each eTile
+    static const size_t llcFloats = _getLLCWeightBytes() / sizeof(float);
+    constexpr float llcMissCost = 4.0f;
     for (int ePack = ePackUnit; ePack <= ePackUnit; ePack += ePackUnit) {
-        int unit2   = UP_DIV(batch * ow * oh, ePack);
-        int maxUnit = (int)::sqrtf((float)unit2);
+        // A unit larger than the output only computes padding. Small outputs are not limited further, so that
+        // F(6,3) / F(4,5) stay candidates and the weight traffic below decides
+        int maxUnit = std::max(ow, oh);
         maxUnit     = std::min(maxUnit, CONVOLUTION_WINOGRAD_MAX_UNIT);
         maxUnit     = std::max(maxUnit, CONVOLUTION_WINOGRAD_MIN_UNIT);
         std::set<int> supportSu{4, 6, 8};
@@ -679,6 +702,7 @@ WinogradConfig ConvolutionPackFreeWinograd::updateBestWinogradUnit(const Convolu
             auto wUnit = UP_DIV(ow, dstUnit);
             auto hUnit = UP_DIV(oh, dstUnit);
             auto totalCount   = wUnit * hUnit * batch;
+            float weightCache = (size_t)srcUnit2 * ic * oc4 * pack > llcFloats ? llcMissCost : 1.0f;
 
             WinogradConfig thisConfig(dstUnit, false, ePack * OuterEPackCount, ePack, dynamicHPack, -1);
             float outerFlops[4], innerFlops[4];
@@ -703,11 +727,14 @@ WinogradConfig ConvolutionPackFreeWinograd::updateBestWinogradUnit(const Convolu
             outerFlops[2] = outerCoefficient * srcUnit2 * (2 * ic - 1) * eTile * oc4 * pack;
             outerFlops[3] = outerCoefficient * (srcUnit + dstUnit) * dstUnit * (2 * srcUnit - 6) * oc4 * ePack * pack;
 
-            outerBandwidth[0] = outerCoefficient *  2 * 2 * srcUnit2 * ic4 * eTile * pack;
+            float tileCache = (size_t)srcUnit2 * (ic4 + oc4) * pack * eTile > l2CacheFloats ? l2MissCost : 1.0f;
+            outerBandwidth[0] = tileCache * outerCoefficient *  2 * 2 * srcUnit2 * ic4 * eTile * pack;
             outerBandwidth[1] = 0;
-            outerBandwidth[2] = outerCoefficient * srcUnit2 * (eTile * ic + oc4 * pack * ic + eTile * oc4 * pack);
+            // The transformed weight (srcUnit2 * ic * oc) is read once for each eTile, whether the tile is full or not
+            float outerWeightCount = 1 + (tileCount - 1) / threadNumber;
+            outerBandwidth[2] = tileCache * outerCoefficient * srcUnit2 * (eTile * ic + eTile * oc4 * pack) + weightCache * outerWeightCount * srcUnit2 * oc4 * pack * ic;
 
-            outerBandwidth[3] = outerCoefficient * ((srcUnit + dstUnit) * 2 * 2 * dstUnit * oc4) * eTile * pack;
+            outerBandwidth[3] = tileCache * outerCoefficient * ((srcUnit + dstUnit) * 2 * 2 * dstUnit * oc4) * eTile * pack;
 
             eTile = ePack * InnerEPackCount;
             tileCount = UP_DIV(totalCount, eTile);
@@ -727,10 +754,11 @@ WinogradConfig ConvolutionPackFreeWinograd::updateBestWinogradUnit(const Convolu
             innerFlops[2] = innerCoefficient * UP_DIV(srcUnit2 * UP_DIV(oc, dynamicHPack), threadNumber) * (2 * ic - 1) * eTile * UP_DIV(dynamicHPack, pack);
             innerFlops[3] = innerCoefficient * (srcUnit + dstUnit) * dstUnit * (2 * srcUnit - 6) * UP_DIV(oc4 * eTile, threadNumber) * pack;
 
-            innerBandwidth[0] = innerCoefficient * UP_DIV(ic4 * eTile, threadNumber) * 2 * 2 * srcUnit2 * pack;
+            tileCache = (size_t)srcUnit2 * (ic4 + oc4) * pack * std::min(eTile, totalCount) > l2CacheFloats ? l2MissCost : 1.0f;
+            innerBandwidth[0] = tileCache * innerCoefficient * UP_DIV(ic4 * eTile, threadNumber) * 2 * 2 * srcUnit2 * pack;
             innerBandwidth[1] = 0;
-            innerBandwidth[2] = innerCoefficient * UP_DIV(srcUnit2 * UP_DIV(oc, dynamicHPack), threadNumber) * (eTile * ic + dynamicHPack * ic + eTile * dynamicHPack);
-            innerBandwidth[3] = innerCoefficient * (srcUnit + dstUnit) * 2 * 2 * dstUnit * UP_DIV(oc4 * eTile, threadNumber) * pack;
+            innerBandwidth[2] = UP_DIV(srcUnit2 * UP_DIV(oc, dynamicHPack), threadNumber) * (tileCache * innerCoefficient * (eTile * ic + eTile * dynamicHPack) + weightCache * tileCount * dynamicHPack * ic);
+            innerBandwidth[3] = tileCache * innerCoefficient * (srcUnit + dstUnit) * 2 * 2 * dstUnit * UP_DIV(oc4 * eTile, threadNumber) * pack;
             for (int i = 0; i < sizeof(outerFlops) / sizeof(float); i++) {
                  outer[i] = std::max(outerBandwidth[i] * roofLine, outerFlops[i]);
                  inner[i] = std::max(innerBandwidth[i] * roofLine, innerFlops[i]);
@@ -772,6 +800,9 @@ bool ConvolutionPackFreeWinograd::updateWinogradBuffer(const Tensor* input, cons
     int alpha2       = alpha * alpha;
 
     mSourceUnrollTransform =  core->chooseWinoSourceUnrollTransform(alpha, alpha);
+    // The table may be shared with clones, don't modify it in place
+    mDestUnrollTransform.reset(new CoreFunctions::WinoUnrollDestTransFunc[CONVOLUTION_WINOGRAD_MAX_UNIT + 1],
+        std::default_delete<CoreFunctions::WinoUnrollDestTransFunc[]>());
     core->chooseWinoDestUnrollTransform(mDestUnrollTransform.get(), CONVOLUTION_WINOGRAD_MAX_UNIT + 1, alpha, unit);
 
     int srcCount                       = input->channel();
@@ -798,13 +829,22 @@ bool ConvolutionPackFreeWinograd::updateWinogradBuffer(const Tensor* input, cons
     mB = generator.B();
     // Transform Kernel
     auto G = generator.G();
-    // replace Tensor::createDevice by Tensor::create and allocTransformWeight's alloc=true to avoid malloc by onAcquireBuffer
     std::shared_ptr<Tensor> sourceWeight(Tensor::create<float>(
         std::vector<int>{outputCount, srcCount, kernelSize, kernelSize}, (void *)mOriginWeight, Tensor::CAFFE));
-    auto tempWeight = generator.allocTransformWeight(sourceWeight.get(), lPack, hPack, true);
-
-    auto shape = tempWeight->shape();
+    auto weightShape = generator.allocTransformWeight(sourceWeight.get(), lPack, hPack, false);
+    auto shape = weightShape->shape();
     shape.push_back(bytes);
+    // The packed weight depends only on unit and hPack, keep it when resize just changes the tile
+    if (nullptr != mResource->mWeight && mResource->mWeight->shape() == shape) {
+        mPostParameters = getPostParameters();
+        return true;
+    }
+    // replace Tensor::createDevice by Tensor::create and allocTransformWeight's alloc=true to avoid malloc by onAcquireBuffer
+    auto tempWeight = generator.allocTransformWeight(sourceWeight.get(), lPack, hPack, true);
+    if (nullptr != mResource->mWeight) {
+        // Clones share the resource and keep the weight of their unit
+        mResource.reset(new Resource(*mResource));
+    }
     mResource->mWeight.reset(Tensor::createDevice<uint8_t>(shape));
     mValid = backend()->onAcquireBuffer(mResource->mWeight.get(), Backend::STATIC);
     if (!mValid) {
@@ -828,6 +868,10 @@ ErrorCode ConvolutionPackFreeWinograd::onResize(const std::vector<Tensor *> &inp
     auto output  = outputs[0];
     int threadNumber = std::max(((CPUBackend *)backend())->threadNumber(), 1);
     WinogradConfig bestConfig = updateBestWinogradUnit(mCommon, input, output, threadNumber, backend());
+    if (nullptr == mOriginWeight && (bestConfig.unit != mConvPerfconfig.unit || bestConfig.hPack != mConvPerfconfig.hPack)) {
+        // A clone has no origin weight to transform for another unit
+        bestConfig = mConvPerfconfig;
+    }
     if (bestConfig != mConvPerfconfig) {
         mConvPerfconfig = bestConfig;
         updateWinogradBuffer(input, output);
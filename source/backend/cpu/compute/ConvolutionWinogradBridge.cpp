@@ -33,6 +33,44 @@ WinogradConfig ConvolutionWinogradBridge::bestWinogradUnit(const Convolution2DCo
 
 }
 
+std::vector<WinogradConfig> ConvolutionWinogradBridge::winogradUnitCandidates(const Convolution2DCommon *common, const Tensor *inputTensor,
+                                          const Tensor *outputTensor, int threadNumber, Backend* b, const PerfConfig& denseConfig) {
+    std::vector<WinogradConfig> candidates;
+    auto best = bestWinogradUnit(common, inputTensor, outputTensor, threadNumber, b, denseConfig);
+    if (best.unit <= 1) {
+        return candidates;
+    }
+    candidates.emplace_back(best);
+    auto core = static_cast<CPUBackend*>(b)->functions();
+#ifdef MNN_USE_SSE
+    if (16 == core->pack) {
+        // The tile and pack of packfree winograd are estimated with the unit, only use the best one
+        return candidates;
+    }
+#endif
+    if (static_cast<CPUBackend*>(b)->getRuntime()->getWinogradMemoryLevel() != 3) {
+        // Larger unit use more memory
+        return candidates;
+    }
+    int kernelSize = common->kernelY();
+    int maxSize = std::max(outputTensor->width(), outputTensor->height());
+    CoreFunctions::WinoUnrollDestTransFunc destTransform[CONVOLUTION_WINOGRAD_MAX_UNIT + 1];
+    for (int u = CONVOLUTION_WINOGRAD_MIN_UNIT; u <= CONVOLUTION_WINOGRAD_MAX_UNIT && u <= maxSize; ++u) {
+        int srcUnit = u + kernelSize - 1;
+        if (u == best.unit || (srcUnit != 4 && srcUnit != 6 && srcUnit != 8)) {
+            continue;
+        }
+        core->chooseWinoDestUnrollTransform(destTransform, CONVOLUTION_WINOGRAD_MAX_UNIT + 1, srcUnit, u);
+        if (nullptr == destTransform[srcUnit]) {
+            continue;
+        }
+        WinogradConfig config;
+        config.unit = u;
+        candidates.emplace_back(config);
+    }
+    return candidates;
+}
+
 bool ConvolutionWinogradBridge::canUseWinograd(const Convolution2DCommon *common) {
     return ConvolutionPackWinograd::canUseWinograd(common);
 }
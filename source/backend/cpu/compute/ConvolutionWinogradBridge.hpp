@@ -22,6 +22,10 @@ public:
     static WinogradConfig bestWinogradUnit(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output,
         int threadnumber, Backend* b, const PerfConfig& denseConfig);
 
+    // Configs of different units for measuring, the estimated best one is the first. Empty if winograd is slower by estimation.
+    static std::vector<WinogradConfig> winogradUnitCandidates(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output,
+        int threadnumber, Backend* b, const PerfConfig& denseConfig);
+
     static ConvolutionWinogradImpl* createWinogradImpl(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output, Backend *b,
         const float *originWeight, size_t originWeightSize, const float *bias, size_t biasSize,
         WinogradConfig config);
@@ -10,6 +10,7 @@
 #include <MNN/AutoTime.hpp>
 #include "backend/cpu/CPUBackend.hpp"
 #include "CommonOptFunction.h"
+#include "core/AutoStorage.h"
 #include "core/Concurrency.h"
 #include "ConvOpt.h"
 #include "core/Macro.h"
@@ -199,21 +200,28 @@ DenseConvolutionTiledExecutor::DenseConvolutionTiledExecutor(const Convolution2D
         if (!mValid) {
             return;
         }
-        std::shared_ptr<Tensor> cache(Tensor::createDevice<uint8_t>({outputCount * srcCount * common->kernelX() * common->kernelY() * (int)sizeof(float)})); // cache must be float
-        mValid = mValid && backend()->onAcquireBuffer(cache.get(), Backend::STATIC);
-        if (!mValid) {
-            return;
+        auto weightPtr = mResource->mWeight->host<float>();
+        int kernelSize = common->kernelX() * common->kernelY();
+        // int8Info holds originWeight if it is dequantized
+        auto pack = [weightPtr, originWeight, srcCount, outputCount, kernelSize, core, int8Info]() {
+            AutoStorage<float> cache(outputCount * srcCount * kernelSize); // cache must be float
+            initWeight(weightPtr, originWeight, cache.get(), srcCount, outputCount, kernelSize, core);
+        };
+        auto cpuBn = static_cast<CPUBackend*>(b);
+        if (cpuBn->weightPackMode() > 0) {
+            mResource->mLazyPack.reset(new CPULazyPack(pack));
+            cpuBn->addLazyPack(mResource->mLazyPack);
+        } else {
+            pack();
         }
-        initWeight(mResource->mWeight->host<float>(), originWeight, cache->host<float>(), srcCount, outputCount, common->kernelX() * common->kernelY(), core);
-        // MNN_PRINT("srcCount:%d, outputCount:%d, dense weight matrix tile:", srcCount, outputCount);
-        // formatMatrix(mResource->mWeight->host<float>(), {UP_DIV(outputCount, hP), lSize, hP});
-        backend()->onReleaseBuffer(cache.get(), Backend::STATIC);
     }
     mProxy.reset(new DenseConvolutionTiledImpl(common, b, mResource.get()));
+    mProxy->setEpilogue(&mEpilogue);
 }
 
 DenseConvolutionTiledExecutor::DenseConvolutionTiledExecutor(std::shared_ptr<CPUConvolution::Resource> res, const Convolution2DCommon* common, Backend* b) : ConvolutionTiledExecutor(res, b) {
     mProxy.reset(new DenseConvolutionTiledImpl(common, b, mResource.get()));
+    mProxy->setEpilogue(&mEpilogue);
 }
 
 DenseConvolutionTiledExecutor::~DenseConvolutionTiledExecutor() {
@@ -232,7 +240,15 @@ bool DenseConvolutionTiledExecutor::onClone(Backend* bn, const Op* op, Execution
     return true;
 }
 
+bool DenseConvolutionTiledExecutor::onSetEpilogue(const Epilogue& epilogue) {
+    return mEpilogue.set(epilogue, backend());
+}
+
 ErrorCode DenseConvolutionTiledExecutor::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    if (nullptr != mResource->mLazyPack) {
+        mResource->mLazyPack->run();
+    }
+    mEpilogue.prepare(inputs, outputs);
     auto code = mProxy->onExecute(mInputs, outputs);
     return code;
 }
@@ -633,6 +649,9 @@ ErrorCode DenseConvolutionTiledImpl::onResize(const std::vector<Tensor*>& inputs
                             wquantStride = static_cast<int32_t>(blockSize * bk * hP * halfStride);
                             matmulUnit(_dstFloatPtr, (float*)(_APtr + eP * finishedL * bytes), (float*)(_weightPtr + wquantStride), paraParameters, relufp32, exeBiasPtr, (float*)(k + bk * ocUp4 * bytes), (float*)(b + bk * ocUp4 * bytes));
                         }
+                        if (nullptr != mEpilogue && !mEpilogue->empty()) {
+                            mEpilogue->applyPack(ocIndex / unit, UP_DIV(ocIndex + (int)paraParameters[2], unit), start, xC);
+                        }
                     }
                 }
                 MNN_CONCURRENCY_END();
@@ -664,6 +683,9 @@ ErrorCode DenseConvolutionTiledImpl::onResize(const std::vector<Tensor*>& inputs
                             wquantStride = static_cast<int32_t>(blockSize * bk * hP * halfStride);
                             matmulRemain(_dstFloatPtr, (float*)(_APtr + eP * finishedL * bytes), (float*)(_weightPtr + wquantStride), xC, paraParameters, relufp32, exeBiasPtr, (float*)(k + bk * ocUp4 * bytes), (float*)(b + bk * ocUp4 * bytes));
                         }
+                        if (nullptr != mEpilogue && !mEpilogue->empty()) {
+                            mEpilogue->applyPack(ocIndex / unit, UP_DIV(ocIndex + (int)paraParameters[2], unit), start, xC);
+                        }
                     }
                 }
                 MNN_CONCURRENCY_END();
@@ -780,6 +802,9 @@ ErrorCode DenseConvolutionTiledImpl::onResize(const std::vector<Tensor*>& inputs
                     }
                     // matmulRemain(_dstFloatPtr, (float*)gemmBuffer, (float*)weightPtr, xC, parameters, postParameters.data(), biasPtr, k, b);
                 }
+                if (nullptr != mEpilogue && !mEpilogue->empty()) {
+                    mEpilogue->applyPack(0, UP_DIV(outputChannel, unit), start, xC);
+                }
 
 #ifdef PROFILE_DETAIL
              macs[tId] += 2.0 * xC * L * oC4 * unit; // bias
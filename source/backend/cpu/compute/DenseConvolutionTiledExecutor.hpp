@@ -13,6 +13,7 @@
 #include <functional>
 #include "backend/cpu/CPUConvolution.hpp"
 #include "ConvolutionTiledExecutor.hpp"
+#include "GemmEpilogue.hpp"
 // Tiled Slide Window or Im2Col + GEMM
 namespace MNN {
 typedef void(*lowMemoryMatmulUnit)(float* C, const float* A, const float* B, const size_t* parameter, const float* postParameters, const float* bias, const float* k, const float* b);
@@ -30,8 +31,12 @@ public:
     void getPackParameter(int* eP, int* lP, int* hP, const CoreFunctions* core) override;
     static PerfConfig bestTileConvolutionConfig(const Convolution2DCommon *common, const Tensor *inputTensor,
                                           const Tensor *outputTensor, int threadNumber, Backend* b);
+    void setEpilogue(const GemmEpilogue* epilogue) {
+        mEpilogue = epilogue;
+    }
 protected:
-
+    // Applied on each output tile after matmul, owned by the executor
+    const GemmEpilogue* mEpilogue = nullptr;
 };
 class DenseConvolutionTiledExecutor : public ConvolutionTiledExecutor {
 public:
@@ -44,7 +49,8 @@ public:
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
-    void initWeight(float *dest, const float *source, float* cache, int depth, int outputCount, int kernelSize, const CoreFunctions* function);
+    virtual bool onSetEpilogue(const Epilogue& epilogue) override;
+    static void initWeight(float *dest, const float *source, float* cache, int depth, int outputCount, int kernelSize, const CoreFunctions* function);
     static PerfConfig bestTileConvolutionConfig(const Convolution2DCommon *common, const Tensor *inputTensor,
                                           const Tensor *outputTensor, int threadNumber, Backend* b) {
         return DenseConvolutionTiledImpl::bestTileConvolutionConfig(common, inputTensor, outputTensor, threadNumber, b);
@@ -58,6 +64,7 @@ public:
 protected:
     DequantizeCache mWeightCache;
     std::shared_ptr<DenseConvolutionTiledImpl> mProxy;
+    GemmEpilogue mEpilogue;
 };
 
 class ConvolutionTiledExecutorMultiInput : public Execution {
@@ -0,0 +1,112 @@
+//
+//  GemmEpilogue.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "backend/cpu/compute/GemmEpilogue.hpp"
+#include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Macro.h"
+
+namespace MNN {
+bool GemmEpilogue::set(const Epilogue& epilogue, Backend* backend) {
+    mResidual = false;
+    mActivation = Epilogue::NONE;
+    mUnary = nullptr;
+    mQuantScale.clear();
+    if (epilogue.empty()) {
+        return true;
+    }
+    auto cpuBn = static_cast<CPUBackend*>(backend);
+    auto core = cpuBn->functions();
+    if (core->bytes != 4) {
+        return false;
+    }
+    mPack = core->pack;
+    mAdd = core->MNNSelectBinaryFunctionForFloat(BinaryOpOperation_ADD);
+    MNNUnaryExecute unary = nullptr;
+    if (Epilogue::UNARY == epilogue.activation) {
+        unary = core->MNNSelectUnaryFunctionForFloat(epilogue.unaryType, cpuBn->precisionMode());
+    } else if (Epilogue::SILU == epilogue.activation) {
+        unary = (MNNUnaryExecute)MNNSiLU;
+    }
+    if ((Epilogue::UNARY == epilogue.activation || Epilogue::SILU == epilogue.activation) && nullptr == unary) {
+        return false;
+    }
+    if (epilogue.residual && nullptr == mAdd) {
+        return false;
+    }
+    mResidual = epilogue.residual;
+    mActivation = epilogue.activation;
+    mMinValue = epilogue.minValue;
+    mMaxValue = epilogue.maxValue;
+    mUnary = unary;
+    if (!epilogue.quantScale.empty()) {
+        // One scale for each channel, padded to pack
+        auto& scale = epilogue.quantScale;
+        if (1 == scale.size()) {
+            mQuantScale.resize(mPack, scale[0]);
+        } else {
+            mQuantScale.resize(UP_DIV(scale.size(), mPack) * mPack, 0.0f);
+            ::memcpy(mQuantScale.data(), scale.data(), scale.size() * sizeof(float));
+        }
+        mQuantZero = epilogue.quantZero;
+        mQuantMin = epilogue.quantMin;
+        mQuantMax = epilogue.quantMax;
+        mFloat2Int8 = cpuBn->int8Functions()->MNNFloat2Int8;
+    }
+    return true;
+}
+
+void GemmEpilogue::prepare(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    auto output = outputs[0];
+    mOutput = output->host<float>();
+    mResidualPtr = mResidual ? inputs[inputs.size() - 1]->host<float>() : nullptr;
+    mQuantPtr = mQuantScale.empty() ? nullptr : outputs[outputs.size() - 1]->host<int8_t>();
+    mPlane = output->batch();
+    for (int i = 2; i < output->dimensions(); ++i) {
+        mPlane *= output->length(i);
+    }
+}
+
+void GemmEpilogue::_run(float* dst, const float* residual, int8_t* quant, const float* scale, size_t size) const {
+    if (nullptr != residual) {
+        mAdd(dst, dst, residual, (int)size, -1);
+    }
+    switch (mActivation) {
+        case Epilogue::CLAMP:
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] = ALIMIN(ALIMAX(dst[i], mMinValue), mMaxValue);
+            }
+            break;
+        case Epilogue::UNARY:
+        case Epilogue::SILU:
+            mUnary(dst, dst, (int)size);
+            break;
+        default:
+            break;
+    }
+    if (nullptr != quant) {
+        mFloat2Int8(dst, quant, size / mPack, scale, mQuantMin, mQuantMax, mQuantZero);
+    }
+}
+
+void GemmEpilogue::applyPack(int zStart, int zEnd, size_t start, size_t size) const {
+    bool single = mQuantScale.size() == mPack;
+    for (int z = zStart; z < zEnd; ++z) {
+        auto offset = (z * mPlane + start) * mPack;
+        auto residual = nullptr != mResidualPtr ? mResidualPtr + offset : nullptr;
+        auto quant = nullptr != mQuantPtr ? mQuantPtr + offset : nullptr;
+        auto scale = single ? mQuantScale.data() : mQuantScale.data() + z * mPack;
+        _run(mOutput + offset, residual, quant, scale, size * mPack);
+    }
+}
+
+void GemmEpilogue::applyLine(size_t start, size_t size) const {
+    auto residual = nullptr != mResidualPtr ? mResidualPtr + start : nullptr;
+    _run(mOutput + start, residual, nullptr, nullptr, size);
+}
+} // namespace MNN
@@ -0,0 +1,67 @@
+//
+//  GemmEpilogue.hpp
+//  MNN
+//
+//  Created by MNN on 2024/03/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef GemmEpilogue_hpp
+#define GemmEpilogue_hpp
+
+#include "core/Execution.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "backend/cpu/compute/Int8FunctionsOpt.h"
+
+namespace MNN {
+/**
+ Run the fused Epilogue of convolution / matmul on the output tile just computed, while it's still in cache.
+ The residual is the last input of the execution and the quantized output is the last output.
+ Only fp32 outputs are supported: set returns false for a low precision backend (bf16 / fp16), whose ops run unfused.
+ */
+class GemmEpilogue {
+public:
+    GemmEpilogue() = default;
+    ~GemmEpilogue() = default;
+
+    // Return false if the backend can't run the epilogue, the empty epilogue is always accepted
+    bool set(const Epilogue& epilogue, Backend* backend);
+    inline bool empty() const {
+        return !mResidual && Epilogue::NONE == mActivation && mQuantScale.empty();
+    }
+    // Number of inputs / outputs appended by the epilogue
+    inline int extraInputs() const {
+        return mResidual ? 1 : 0;
+    }
+    // Bind the tensors before execute
+    void prepare(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs);
+
+    // For output in NC4HW4: the channel blocks [zStart, zEnd) of planes [start, start + size)
+    void applyPack(int zStart, int zEnd, size_t start, size_t size) const;
+    // For output in NCHW: elements [start, start + size), quantize is not supported
+    void applyLine(size_t start, size_t size) const;
+
+private:
+    void _run(float* dst, const float* residual, int8_t* quant, const float* scale, size_t size) const;
+
+    bool mResidual = false;
+    Epilogue::Activation mActivation = Epilogue::NONE;
+    float mMinValue;
+    float mMaxValue;
+    MNNBinaryExecute mAdd = nullptr;
+    MNNUnaryExecute mUnary = nullptr;
+    std::vector<float> mQuantScale;
+    ssize_t mQuantZero;
+    ssize_t mQuantMin;
+    ssize_t mQuantMax;
+    decltype(CoreInt8Functions::MNNFloat2Int8) mFloat2Int8 = nullptr;
+    int mPack = 4;
+
+    float* mOutput = nullptr;
+    const float* mResidualPtr = nullptr;
+    int8_t* mQuantPtr = nullptr;
+    size_t mPlane = 0;
+};
+} // namespace MNN
+
+#endif /* GemmEpilogue_hpp */
@@ -6,6 +6,7 @@
 //
 #include "GemmInt8Executor.hpp"
 #include "ConvolutionTiledExecutor.hpp"
+#include "ConvInt8TiledExecutor.hpp"
 #include "CommonOptFunction.h"
 #include "core/Macro.h"
 #include "core/BufferAllocator.hpp"
@@ -181,4 +182,221 @@ ErrorCode GemmInt8Executor::onExecute(const std::vector<Tensor *> &inputs, const
     return NO_ERROR;
 }
 
+bool DynamicGemmInt8Executor::support(const Convolution2DCommon* common, const Tensor* input, const Tensor* output, Backend* bn,
+                                      const ConvolutionCommon::Int8Common* quanCommon) {
+    auto core = static_cast<CPUBackend*>(bn)->functions();
+    auto int8Core = static_cast<CPUBackend*>(bn)->int8Functions();
+    if (core->bytes != 4 || nullptr == core->MNNDynamicQuantRow) {
+        return false;
+    }
+    int UNIT, SRC_UNIT, DST_XUNIT;
+    int8Core->MNNGetGemmUnit(&UNIT, &SRC_UNIT, &DST_XUNIT);
+    if (UNIT != core->pack) {
+        // The output of gemm is written as float C(pack) directly
+        return false;
+    }
+    bool linear = common->kernelX() == 1 && common->kernelY() == 1 && common->strideX() == 1 && common->strideY() == 1
+        && common->group() == 1 && output->width() == input->width() && output->height() == input->height();
+    if (!linear || nullptr == quanCommon || nullptr == quanCommon->weight.get()) {
+        return false;
+    }
+    // Only per output channel scale is supported
+    int oc = common->outputCount();
+    int alphaSize = quanCommon->asymmetric ? 2 * oc : oc;
+    return quanCommon->alpha.size() == alphaSize && quanCommon->weight.size() == oc * input->channel();
+}
+
+DynamicGemmInt8Executor::DynamicGemmInt8Executor(const Convolution2DCommon* common, Backend* bn, const ConvolutionCommon::Int8Common* quanCommon,
+                                                 const float* bias, size_t biasSize) : CPUConvolution(common, bn) {
+    auto core = static_cast<CPUBackend*>(bn)->functions();
+    auto int8Core = static_cast<CPUBackend*>(bn)->int8Functions();
+    int UNIT, SRC_UNIT, DST_XUNIT;
+    int8Core->MNNGetGemmUnit(&UNIT, &SRC_UNIT, &DST_XUNIT);
+    int oc = common->outputCount();
+    int ic = quanCommon->weight.size() / oc;
+    int ocUp = UP_DIV(oc, core->pack) * core->pack;
+    mResource.reset(new CPUConvolution::Resource);
+    mResource->backend = bn;
+    if (!mResource->copyBiasAlign(bias, (int)biasSize)) {
+        mValid = false;
+        return;
+    }
+    std::vector<int> shape;
+    if (SRC_UNIT > UNIT) {
+        shape = {UP_DIV(oc, UNIT), UP_DIV(UP_DIV(ic, UNIT), SRC_UNIT / UNIT), UNIT, SRC_UNIT};
+    } else {
+        shape = {UP_DIV(oc, UNIT), UP_DIV(ic, SRC_UNIT), UNIT, SRC_UNIT};
+    }
+    mResource->mWeight.reset(Tensor::createDevice<int8_t>(shape));
+    mResource->mDequantize.bits = 8;
+    mResource->mDequantize.mScaleBias.reset(Tensor::createDevice<float>({3 * ocUp}));
+    mValid = bn->onAcquireBuffer(mResource->mWeight.get(), Backend::STATIC) && bn->onAcquireBuffer(mResource->mDequantize.mScaleBias.get(), Backend::STATIC);
+    if (!mValid) {
+        MNN_ERROR("Memory not enough for dynamic quant convolution\n");
+        return;
+    }
+    auto weightSrc = quanCommon->weight.get();
+    ConvInt8TiledExecutor::reorderWeight(mResource->mWeight.get(), (const uint8_t*)weightSrc, SRC_UNIT, UNIT, ic, oc, 1);
+    auto scalePtr = mResource->mDequantize.mScaleBias->host<float>();
+    auto minPtr = scalePtr + ocUp;
+    auto offsetPtr = reinterpret_cast<int32_t*>(minPtr + ocUp);
+    ::memset(scalePtr, 0, 3 * ocUp * sizeof(float));
+    for (int o = 0; o < oc; ++o) {
+        if (quanCommon->asymmetric) {
+            minPtr[o] = quanCommon->alpha.get()[2 * o];
+            scalePtr[o] = quanCommon->alpha.get()[2 * o + 1];
+        } else {
+            scalePtr[o] = quanCommon->alpha.get()[o];
+        }
+#ifdef MNN_USE_SSE
+        // The int8 input is stored as uint8 (+128), remove 128 * sum(weight) from the int32 result
+        int32_t weightSum = 0;
+        for (int i = 0; i < ic; ++i) {
+            weightSum += weightSrc[o * ic + i];
+        }
+        offsetPtr[o] = -128 * weightSum;
+#endif
+    }
+}
+
+DynamicGemmInt8Executor::DynamicGemmInt8Executor(std::shared_ptr<CPUConvolution::Resource> resource, const Convolution2DCommon* common, Backend* bn) : CPUConvolution(common, bn), mResource(resource) {
+    // Do nothing
+}
+
+DynamicGemmInt8Executor::~DynamicGemmInt8Executor() {
+    // Do nothing
+}
+
+bool DynamicGemmInt8Executor::onClone(Backend* bn, const Op* op, Execution** dst) {
+    if (nullptr == dst) {
+        return true;
+    }
+    *dst = new DynamicGemmInt8Executor(mResource, op->main_as_Convolution2D()->common(), bn);
+    return true;
+}
+
+ErrorCode DynamicGemmInt8Executor::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    auto input = inputs[0];
+    auto output = outputs[0];
+    auto core = static_cast<CPUBackend*>(backend())->functions();
+    auto int8Core = static_cast<CPUBackend*>(backend())->int8Functions();
+    int UNIT, SRC_UNIT, DST_XUNIT;
+    int8Core->MNNGetGemmUnit(&UNIT, &SRC_UNIT, &DST_XUNIT);
+    ConvolutionTiledExecutor::setIm2ColParameter(mIm2ColParamter, mCommon, input, output, 0, 0, core, int8Core);
+    const int plane = input->batch() * input->height() * input->width();
+    mTileCount = UP_DIV(plane, DST_XUNIT);
+    mThreadNums = std::max(std::min(static_cast<CPUBackend*>(backend())->threadNumber(), mTileCount), 1);
+
+    mQuantInput.reset(Tensor::createDevice<int8_t>({UP_DIV(input->channel(), core->pack), plane, core->pack}));
+    mInputCol.reset(Tensor::createDevice<int8_t>({mThreadNums, mIm2ColParamter.kernelCountUnit * DST_XUNIT * SRC_UNIT}));
+    // Dequant scale and sum of int8 for each row
+    mRowInfo.reset(Tensor::createDevice<float>({2, plane}));
+    bool success = backend()->onAcquireBuffer(mQuantInput.get(), Backend::DYNAMIC) && backend()->onAcquireBuffer(mInputCol.get(), Backend::DYNAMIC)
+        && backend()->onAcquireBuffer(mRowInfo.get(), Backend::DYNAMIC);
+    if (!success) {
+        return OUT_OF_MEMORY;
+    }
+    auto bufferAlloc = static_cast<CPUBackend*>(backend())->getBufferAllocator();
+    auto blitInfoSize = ConvolutionTiledExecutor::computeBlitInfoSize(DST_XUNIT, mIm2ColParamter.ow, 1, mThreadNums);
+    mBlitInfo = bufferAlloc->alloc(blitInfoSize.first);
+    if (mBlitInfo.invalid()) {
+        return OUT_OF_MEMORY;
+    }
+    bufferAlloc->free(mBlitInfo);
+    mBlitInfoStride = blitInfoSize.second;
+    backend()->onReleaseBuffer(mQuantInput.get(), Backend::DYNAMIC);
+    backend()->onReleaseBuffer(mInputCol.get(), Backend::DYNAMIC);
+    backend()->onReleaseBuffer(mRowInfo.get(), Backend::DYNAMIC);
+    return NO_ERROR;
+}
+
+ErrorCode DynamicGemmInt8Executor::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    auto input = inputs[0];
+    auto output = outputs[0];
+    auto core = static_cast<CPUBackend*>(backend())->functions();
+    auto int8Core = static_cast<CPUBackend*>(backend())->int8Functions();
+    int UNIT, SRC_UNIT, DST_XUNIT;
+    int8Core->MNNGetGemmUnit(&UNIT, &SRC_UNIT, &DST_XUNIT);
+    const int pack = core->pack;
+    const int ic = input->channel();
+    const int plane = input->batch() * input->height() * input->width();
+    const int stride = plane * pack;
+    const int ocDiv = UP_DIV(output->channel(), pack);
+    const int ocUp = ocDiv * pack;
+    const int srcDepthQuad = mIm2ColParamter.kernelCountUnit;
+    const int colBufferSize = srcDepthQuad * DST_XUNIT * SRC_UNIT;
+
+    auto scaleBias = mResource->mDequantize.mScaleBias->host<float>();
+    auto weightMin = scaleBias + ocUp;
+    auto bias = mResource->mBias->host<float>();
+    QuanPostTreatParameters quanParam;
+    quanParam.scale = scaleBias;
+    quanParam.bias = reinterpret_cast<const int32_t*>(weightMin + ocUp);
+    quanParam.maxValue = 127;
+    quanParam.minValue = -128;
+    // Save result as float, scaled by weight
+    quanParam.useInt8 = 0;
+    // The normal kernel instead of fast one, the asymmetric weight use full int8 range
+    auto gemmKernel = int8Core->Int8GemmKernel;
+    auto postParameters = getPostParameters();
+    const float minValue = postParameters[2];
+    const float maxValue = postParameters[3];
+
+    auto inputPtr = input->host<float>();
+    auto outputPtr = output->host<float>();
+    auto quantPtr = mQuantInput->host<int8_t>();
+    auto weightPtr = mResource->mWeight->host<int8_t>();
+    auto rowScale = mRowInfo->host<float>();
+    auto rowSum = reinterpret_cast<int32_t*>(rowScale + plane);
+    auto blitProc = int8Core->MNNPackC4Int8ForMatMul_A;
+#ifdef MNN_USE_SSE
+    const int zeroValue = 128;
+#else
+    const int zeroValue = 0;
+#endif
+    MNN_CONCURRENCY_BEGIN(tId, mThreadNums) {
+        auto colAddr = mInputCol->host<int8_t>() + tId * mInputCol->stride(0);
+        auto srcPtr  = (int8_t const **)(mBlitInfo.ptr() + tId * mBlitInfoStride.first);
+        auto el      = (int32_t *)(srcPtr + mBlitInfoStride.second);
+        int32_t info[4];
+        info[1] = plane;
+        info[2] = colBufferSize;
+        info[3] = 1;
+        for (int tIndex = (int)tId; tIndex < mTileCount; tIndex += mThreadNums) {
+            const int xIndexStart = tIndex * DST_XUNIT;
+            const int realDstCount = ALIMIN(plane - xIndexStart, DST_XUNIT);
+            // Quantize the rows of this tile, then the rows are only read by this thread
+            core->MNNDynamicQuantRow(inputPtr + xIndexStart * pack, quantPtr + xIndexStart * pack, rowScale + xIndexStart, rowSum + xIndexStart,
+                                     ic, realDstCount, stride, pack);
+            auto res = ConvolutionTiledExecutor::turnIm2ColToBlitInfo((const float**)srcPtr, el, xIndexStart, realDstCount, mIm2ColParamter, (const uint8_t*)quantPtr, 1);
+            if (res.second) {
+                ::memset(colAddr, zeroValue, colBufferSize);
+            }
+            info[0] = res.first;
+            if (res.first > 0) {
+                blitProc(colAddr, srcPtr, info, el);
+            }
+            auto dstTile = outputPtr + xIndexStart * pack;
+            gemmKernel((int8_t*)dstTile, colAddr, weightPtr, srcDepthQuad, stride * sizeof(float), ocDiv, &quanParam, realDstCount);
+            // Dequant by row scale, sum(x * (w * scale + min)) = rowScale * (sum(xq * wq) * scale + sum(xq) * min)
+            for (int z = 0; z < ocDiv; ++z) {
+                auto dstZ = dstTile + z * stride;
+                auto biasZ = bias + z * pack;
+                auto minZ = weightMin + z * pack;
+                for (int i = 0; i < realDstCount; ++i) {
+                    auto dstX = dstZ + i * pack;
+                    float s = rowScale[xIndexStart + i];
+                    float minScale = s * (float)rowSum[xIndexStart + i];
+                    for (int k = 0; k < pack; ++k) {
+                        float value = dstX[k] * s + minZ[k] * minScale + biasZ[k];
+                        dstX[k] = std::min(std::max(value, minValue), maxValue);
+                    }
+                }
+            }
+        }
+    }
+    MNN_CONCURRENCY_END();
+    return NO_ERROR;
+}
+
 } // namespace MNN
@@ -34,5 +34,36 @@ protected:
     MemChunk mBlitInfo;
     std::pair<size_t, size_t> mBlitInfoStride;
 };
+
+/*
+ 1x1 float convolution (linear layer) with 8 bit quantized weight, computed by int8 gemm:
+ the input is quantized by the absmax of each row (position / token) when executing,
+ the float result is dequantized by the row scale and the weight scale and added with bias in the epilogue.
+ */
+class DynamicGemmInt8Executor : public CPUConvolution {
+public:
+    // Return true if the convolution and the weight quant info can be computed by this executor
+    static bool support(const Convolution2DCommon* common, const Tensor* input, const Tensor* output, Backend* bn,
+                      const ConvolutionCommon::Int8Common* quanCommon);
+    DynamicGemmInt8Executor(const Convolution2DCommon* common, Backend* bn, const ConvolutionCommon::Int8Common* quanCommon,
+                            const float* bias, size_t biasSize);
+    virtual ~DynamicGemmInt8Executor();
+    virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
+private:
+    DynamicGemmInt8Executor(std::shared_ptr<CPUConvolution::Resource> resource, const Convolution2DCommon* common, Backend* bn);
+    // mWeight: int8 weight reordered for gemm, mBias: float bias
+    // mDequantize.mScaleBias: [weight scale(float), weight min(float), offset of int8 input(int32)] x ocUp
+    std::shared_ptr<CPUConvolution::Resource> mResource;
+    ConvolutionCommon::Im2ColParameter mIm2ColParamter;
+    std::shared_ptr<Tensor> mQuantInput;
+    std::shared_ptr<Tensor> mInputCol;
+    std::shared_ptr<Tensor> mRowInfo;
+    int mTileCount;
+    int mThreadNums;
+    MemChunk mBlitInfo;
+    std::pair<size_t, size_t> mBlitInfoStride;
+};
 } // namespace MNN
 #endif /* DeconvInt8Executor_hpp */
@@ -0,0 +1,181 @@
+//
+//  NonMaxSuppression.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/27.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "backend/cpu/compute/NonMaxSuppression.hpp"
+#include <algorithm>
+#include <stdint.h>
+#include "core/Macro.h"
+#include "math/Vec.hpp"
+
+namespace MNN {
+using Vec4 = Math::Vec<float, 4>;
+// Number of boxes in one word of suppression bitmask
+#define NMS_BLOCK 64
+// Sort in parallel if the candidates are not less than it
+#define NMS_PARALLEL_SORT_SIZE 8192
+
+static inline bool _better(float scoreA, int indexA, float scoreB, int indexB) {
+    return scoreA > scoreB || (scoreA == scoreB && indexA < indexB);
+}
+
+NonMaxSuppression::NonMaxSuppression(Parallel parallel, int threadNumber) : mParallel(parallel), mThreadNumber(threadNumber) {
+    if (nullptr == mParallel) {
+        mThreadNumber = 1;
+    }
+    mThreadNumber = ALIMAX(mThreadNumber, 1);
+}
+
+void NonMaxSuppression::_sort(std::vector<Candidate>& candidates, bool parallel) const {
+    auto compare = [](const Candidate& a, const Candidate& b) {
+        return _better(a.score, a.index, b.score, b.index);
+    };
+    int size = (int)candidates.size();
+    if (!parallel || mThreadNumber <= 1 || size < NMS_PARALLEL_SORT_SIZE) {
+        std::sort(candidates.begin(), candidates.end(), compare);
+        return;
+    }
+    // Sort the chunks in parallel, then merge them in pair
+    int chunkNumber = mThreadNumber;
+    int chunk = UP_DIV(size, chunkNumber);
+    auto begin = candidates.begin();
+    mParallel(chunkNumber, [&](int tId) {
+        int start = ALIMIN(tId * chunk, size);
+        int end   = ALIMIN(start + chunk, size);
+        std::sort(begin + start, begin + end, compare);
+    });
+    for (int step = chunk; step < size; step *= 2) {
+        int mergeNumber = UP_DIV(size, 2 * step);
+        mParallel(mergeNumber, [&](int tId) {
+            int start  = tId * 2 * step;
+            int middle = ALIMIN(start + step, size);
+            int end    = ALIMIN(start + 2 * step, size);
+            if (middle < end) {
+                std::inplace_merge(begin + start, begin + middle, begin + end, compare);
+            }
+        });
+    }
+}
+
+void NonMaxSuppression::_run(const float* boxes, const float* scores, int numBoxes, int scoreStride, const Param& param, bool parallel, std::vector<int>& selected, std::vector<float>* selectedScores) const {
+    MNN_ASSERT(param.iouThreshold >= 0.0f && param.iouThreshold <= 1.0f);
+    const int outputNum = ALIMIN(param.maxDetections, numBoxes);
+    if (outputNum <= 0) {
+        return;
+    }
+    // Compact the candidates over the threshold
+    std::vector<Candidate> candidates;
+    candidates.reserve(numBoxes);
+    for (int i = 0; i < numBoxes; ++i) {
+        auto score = scores[i * scoreStride];
+        if (score > param.scoreThreshold) {
+            candidates.push_back({score, i});
+        }
+    }
+    const int number = (int)candidates.size();
+    if (0 == number) {
+        return;
+    }
+    _sort(candidates, parallel);
+    if (1 == outputNum) {
+        selected.push_back(candidates[0].index);
+        if (nullptr != selectedScores) {
+            selectedScores->push_back(candidates[0].score);
+        }
+        return;
+    }
+    // Boxes in sorted order and splited by coordinate, padded for SIMD
+    const int numberPad = ROUND_UP(number, NMS_BLOCK);
+    std::vector<float> sortedBoxes(numberPad * 5, 0.0f);
+    float* y0 = sortedBoxes.data();
+    float* x0 = y0 + numberPad;
+    float* y1 = x0 + numberPad;
+    float* x1 = y1 + numberPad;
+    float* area = x1 + numberPad;
+    for (int i = 0; i < number; ++i) {
+        auto box = boxes + candidates[i].index * 4;
+        y0[i] = ALIMIN(box[0], box[2]);
+        x0[i] = ALIMIN(box[1], box[3]);
+        y1[i] = ALIMAX(box[0], box[2]);
+        x1[i] = ALIMAX(box[1], box[3]);
+        area[i] = (y1[i] - y0[i]) * (x1[i] - x0[i]);
+    }
+    std::vector<uint64_t> suppressed(numberPad / NMS_BLOCK, 0);
+    const Vec4 zero(0.0f);
+    const Vec4 threshold(param.iouThreshold);
+    float overlap[NMS_BLOCK];
+    for (int i = 0; i < number && selected.size() < outputNum; ++i) {
+        if (suppressed[i / NMS_BLOCK] & ((uint64_t)1 << (i % NMS_BLOCK))) {
+            continue;
+        }
+        selected.push_back(candidates[i].index);
+        if (nullptr != selectedScores) {
+            selectedScores->push_back(candidates[i].score);
+        }
+        if (area[i] <= 0.0f) {
+            // The IoU is zero
+            continue;
+        }
+        const Vec4 by0(y0[i]), bx0(x0[i]), by1(y1[i]), bx1(x1[i]), barea(area[i]);
+        // Suppress the boxes after i: IoU > t <=> intersection > t * union, the area of padded boxes is zero
+        for (int block = (i + 1) / NMS_BLOCK; block < numberPad / NMS_BLOCK; ++block) {
+            int start = block * NMS_BLOCK;
+            for (int j = 0; j < NMS_BLOCK; j += 4) {
+                auto offset = start + j;
+                auto h = Vec4::max(Vec4::min(Vec4::load(y1 + offset), by1) - Vec4::max(Vec4::load(y0 + offset), by0), zero);
+                auto w = Vec4::max(Vec4::min(Vec4::load(x1 + offset), bx1) - Vec4::max(Vec4::load(x0 + offset), bx0), zero);
+                auto inter = h * w;
+                auto unionArea = barea + Vec4::load(area + offset) - inter;
+                Vec4::save(overlap + j, inter - threshold * unionArea);
+            }
+            uint64_t mask = 0;
+            for (int j = 0; j < NMS_BLOCK; ++j) {
+                // The box with zero area has no intersection
+                if (overlap[j] > 0.0f && area[start + j] > 0.0f) {
+                    mask |= ((uint64_t)1 << j);
+                }
+            }
+            suppressed[block] |= mask;
+        }
+    }
+}
+
+void NonMaxSuppression::run(const float* boxes, const float* scores, int numBoxes, const Param& param, std::vector<int>& selected) const {
+    _run(boxes, scores, numBoxes, 1, param, true, selected, nullptr);
+}
+
+void NonMaxSuppression::runBatched(const float* boxes, const float* scores, const BatchLayout& layout, const Param& param, std::vector<Selection>& selected) const {
+    const int taskNumber = layout.batch * layout.numClasses;
+    std::vector<std::vector<int>> indexes(taskNumber);
+    std::vector<std::vector<float>> indexScores(taskNumber);
+    auto task = [&](int t, bool parallel) {
+        int b = t / layout.numClasses;
+        int c = t % layout.numClasses;
+        auto boxPtr = boxes + b * layout.boxBatchStride;
+        auto scorePtr = scores + b * layout.scoreBatchStride + c * layout.scoreClassStride;
+        _run(boxPtr, scorePtr, layout.numBoxes, layout.scoreBoxStride, param, parallel, indexes[t], &indexScores[t]);
+    };
+    if (taskNumber >= mThreadNumber && mThreadNumber > 1) {
+        // Parallel for classes
+        int threadNumber = mThreadNumber;
+        mParallel(threadNumber, [&](int tId) {
+            for (int t = tId; t < taskNumber; t += threadNumber) {
+                task(t, false);
+            }
+        });
+    } else {
+        for (int t = 0; t < taskNumber; ++t) {
+            task(t, true);
+        }
+    }
+    for (int t = 0; t < taskNumber; ++t) {
+        for (int i = 0; i < indexes[t].size(); ++i) {
+            selected.push_back({t / layout.numClasses, t % layout.numClasses, indexes[t][i], indexScores[t][i]});
+        }
+    }
+}
+} // namespace MNN
@@ -0,0 +1,71 @@
+//
+//  NonMaxSuppression.hpp
+//  MNN
+//
+//  Created by MNN on 2024/03/27.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef NonMaxSuppression_hpp
+#define NonMaxSuppression_hpp
+
+#include <MNN/MNNDefine.h>
+#include <functional>
+#include <vector>
+
+namespace MNN {
+/**
+ Greedy non max suppression:
+ 1. compact the candidates with score larger than scoreThreshold;
+ 2. sort them by descending score, the smaller index first for the same score, in parallel for many candidates;
+ 3. scan the sorted candidates, each selected box marks the boxes after it with IoU larger than iouThreshold in the
+    suppression bitmask, the IoU of a block of boxes is computed with SIMD.
+ The box is [y0, x0, y1, x1], the order of corners is not required.
+ */
+class MNN_PUBLIC NonMaxSuppression {
+public:
+    // Run task(0) ... task(number - 1), maybe in parallel
+    typedef std::function<void(int number, const std::function<void(int)>& task)> Parallel;
+    struct Param {
+        int maxDetections  = 0;
+        float iouThreshold = 0.0f;
+        float scoreThreshold = 0.0f;
+    };
+    // Boxes and scores of [batch, numClasses, numBoxes], the stride are in floats
+    struct BatchLayout {
+        int batch = 1;
+        int numClasses = 1;
+        int numBoxes = 0;
+        // boxes of batch b start from boxes + b * boxBatchStride
+        int boxBatchStride = 0;
+        // score of box i of class c in batch b is scores[b * scoreBatchStride + c * scoreClassStride + i * scoreBoxStride]
+        int scoreBatchStride = 0;
+        int scoreClassStride = 0;
+        int scoreBoxStride = 1;
+    };
+    struct Selection {
+        int batch;
+        int classId;
+        int boxIndex;
+        float score;
+    };
+    NonMaxSuppression(Parallel parallel = nullptr, int threadNumber = 1);
+
+    // Single class, selected is the indexes of boxes in selection order
+    void run(const float* boxes, const float* scores, int numBoxes, const Param& param, std::vector<int>& selected) const;
+    // Run for every batch and class, at most maxDetections for each class, in order of batch, class and selection
+    void runBatched(const float* boxes, const float* scores, const BatchLayout& layout, const Param& param, std::vector<Selection>& selected) const;
+
+private:
+    struct Candidate {
+        float score;
+        int index;
+    };
+    void _sort(std::vector<Candidate>& candidates, bool parallel) const;
+    void _run(const float* boxes, const float* scores, int numBoxes, int scoreStride, const Param& param, bool parallel, std::vector<int>& selected, std::vector<float>* selectedScores) const;
+    Parallel mParallel;
+    int mThreadNumber;
+};
+} // namespace MNN
+
+#endif /* NonMaxSuppression_hpp */
@@ -29,7 +29,7 @@ bool AVX2Functions::init(int cpuFlags) {
     // Init default functions
     *coreFunction = *MNNGetCoreFunctions();
     *gAVX2CoreInt8Functions = *MNNGetInt8CoreFunctions();
-    _AVX_MNNInt8FunctionInit(gAVX2CoreInt8Functions);
+    _AVX_MNNInt8FunctionInit(gAVX2CoreInt8Functions, cpuFlags & libyuv::kCpuHasAVXVNNI);
     // Init AVX2
     coreFunction->MNNGetMatMulPackMode = _MNNGetMatMulPackMode;
     geP = 24;
@@ -50,6 +50,7 @@ bool AVX2Functions::init(int cpuFlags) {
     coreFunction->MNNDynamicQuant = _AVX_MNNDynamicQuantFP32;
 #endif
     coreFunction->MNNPackC4ForMatMul_A  = _AVX_MNNPackC4ForMatMul_A;
+    coreFunction->MNNDynamicQuantRow = _AVX_MNNDynamicQuantRowFP32;
     coreFunction->MNNPackForMatMul_B    = _AVX_MNNPackForMatMul_B;
     coreFunction->MNNComputeMatMulForE_1 = _AVX_MNNComputeMatMulForE_1;
     coreFunction->MNNComputeMatMulForH_1 = _AVX_MNNComputeMatMulForH_1;
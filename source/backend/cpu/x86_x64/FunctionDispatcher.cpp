@@ -30,6 +30,11 @@ struct FunctionGroup {
     int hP                                                                                       = 4;
     void (*MNNExpC8)(float* dest, const float* source, float* offset, const float* parameters, size_t countC8) = _SSE_MNNExpC8;
     void (*MNNSoftmax)(float* dest, const float* source, size_t size) = _SSE_MNNSoftmax;
+    void (*MNNScaleMaskSoftmax)(float* dest, const float* source, const float* mask, float scale, size_t size) = _SSE_MNNScaleMaskSoftmax;
+    void (*MNNErf)(float* dst, const float* src, size_t size) = _SSE_MNNErf;
+    void (*MNNErfc)(float* dst, const float* src, size_t size) = _SSE_MNNErfc;
+    void (*MNNGeluStandard)(float* dst, const float* src, size_t size) = _SSE_MNNGeluStandard;
+    void (*MNNSiLU)(float* dst, const float* src, size_t size) = _SSE_MNNSiLU;
     void (*MNNReluInt8)(int8_t* dst, const int8_t* src, size_t size, ssize_t zeroPoint) = _SSE_MNNReluInt8;
     void (*MNNHardSwish)(float* dst, const float* src, size_t size) = _SSE_MNNHardSwish;
     void (*MNNGelu)(float* dst, const float* src, size_t size, float* parameters) = _SSE_MNNGelu;
@@ -69,11 +74,30 @@ void MNNFunctionInit() {
         MNN::AVX2Functions::init(cpuFlags);
         gFunc.MNNExpC8 = _AVX_MNNExpC8;
         gFunc.MNNSoftmax = _AVX_MNNSoftmax;
+        gFunc.MNNScaleMaskSoftmax = _AVX_MNNScaleMaskSoftmax;
+        gFunc.MNNErf = _AVX_MNNErf;
+        gFunc.MNNErfc = _AVX_MNNErfc;
+        gFunc.MNNGeluStandard = _AVX_MNNGeluStandard;
+        gFunc.MNNSiLU = _AVX_MNNSiLU;
         gFunc.MNNGelu = _AVX_MNNGelu;
         if (cpuFlags & libyuv::kCpuHasFMA3) {
             gFunc.MNNGelu = _AVX_MNNGeluFMA;
             gFunc.MNNExpC8 = _AVX_MNNExpC8FMA;
+            gFunc.MNNScaleMaskSoftmax = _AVX_MNNScaleMaskSoftmaxFMA;
+            gFunc.MNNErf = _AVX_MNNErfFMA;
+            gFunc.MNNErfc = _AVX_MNNErfcFMA;
+            gFunc.MNNGeluStandard = _AVX_MNNGeluStandardFMA;
+            gFunc.MNNSiLU = _AVX_MNNSiLUFMA;
         }
+#ifdef MNN_AVX512
+        if ((cpuFlags & libyuv::kCpuHasAVX512BW) && (cpuFlags & libyuv::kCpuHasAVX512VL)) {
+            gFunc.MNNScaleMaskSoftmax = _AVX512_MNNScaleMaskSoftmax;
+            gFunc.MNNErf = _AVX512_MNNErf;
+            gFunc.MNNErfc = _AVX512_MNNErfc;
+            gFunc.MNNGeluStandard = _AVX512_MNNGeluStandard;
+            gFunc.MNNSiLU = _AVX512_MNNSiLU;
+        }
+#endif
         gFunc.MNNNorm = _AVX_MNNNorm;
     }
     _SSE_ImageProcessInit(coreFunction, cpuFlags);
@@ -196,6 +220,26 @@ void MNNSoftmax(float* dest, const float* source, size_t size) {
     gFunc.MNNSoftmax(dest, source, size);
 }
 
+void MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size) {
+    gFunc.MNNScaleMaskSoftmax(dest, source, mask, scale, size);
+}
+
+void MNNErf(float* dst, const float* src, size_t size) {
+    gFunc.MNNErf(dst, src, size);
+}
+
+void MNNErfc(float* dst, const float* src, size_t size) {
+    gFunc.MNNErfc(dst, src, size);
+}
+
+void MNNGeluStandard(float* dst, const float* src, size_t size) {
+    gFunc.MNNGeluStandard(dst, src, size);
+}
+
+void MNNSiLU(float* dst, const float* src, size_t size) {
+    gFunc.MNNSiLU(dst, src, size);
+}
+
 void MNNNorm(float* dest, const float* source, const float *gamma, const float *beta, float epsilon, size_t size, bool RMSNorm) {
     gFunc.MNNNorm(dest, source, gamma, beta, epsilon, size, RMSNorm);
 }
@@ -54,9 +54,15 @@ void _AVX_MNNAbsMaxFP32(const float* source, float* absmax, size_t src_depth_qua
 void _AVX_MNNDynamicQuantFP32(const float* src, int8_t* dst, const float* scale, float* sum, size_t src_depth_quad, size_t realSize, int pack);
 #endif
 void _AVX_MNNPackC4ForMatMul_A(float* destOrigin, float const** sourceGroup, const int32_t* info, const int32_t* el);
+void _AVX_MNNDynamicQuantRowFP32(const float* src, int8_t* dst, float* dequantScale, int32_t* sum, size_t channel, size_t realSize, size_t stride, int pack);
 
 void _AVX_MNNExpC8(float* dest, const float* source, float* offset, const float* parameters, size_t countC8);
 void _AVX_MNNSoftmax(float* dest, const float* source, size_t size);
+void _AVX_MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size);
+void _AVX_MNNErf(float* dst, const float* src, size_t size);
+void _AVX_MNNErfc(float* dst, const float* src, size_t size);
+void _AVX_MNNGeluStandard(float* dst, const float* src, size_t size);
+void _AVX_MNNSiLU(float* dst, const float* src, size_t size);
 void _AVX_MNNFloat2Int8(const float* src, int8_t* dst, size_t sizeQuad, const float* scalep, ssize_t minV, ssize_t maxV, ssize_t zeroPoint);
 void _AVX_MNNInt8ScaleToFloat(float* dst, const int8_t* src, const float* scale, size_t sizeQuad, ssize_t zeroPoint);
 void _AVX_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dstO, const int8_t* srcO, const int8_t* weightO, const QuanPostTreatParameters* parameters, size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step, int8_t* idxOrder);
@@ -70,7 +76,7 @@ void _AVX_MNNPackedSparseMatMul(float* C, const float* A, const float* B, unsign
 void _AVX_MNNComputeMatMulForH_1(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId);
 
 void _AVX_ReorderInit(void* functions);
-void _AVX_MNNInt8FunctionInit(void* functions);
+void _AVX_MNNInt8FunctionInit(void* functions, bool supportVNNI);
 void _AVX_MNNPackCUnit(float* dst, const float* src, size_t area, size_t depth, int* areaOffset);
 void _AVX_MNNUnpackCUnit(float* dst, const float* src, size_t area, size_t depth, int* areaOffset);
 void _AVX_MNNPackCUnitTranspose(float* dst, const float* src, size_t area, size_t depth, int* areaOffset);
@@ -272,6 +272,62 @@ void _AVX_MNNDynamicQuantFP32(const float* src, int8_t* dst, const float* scale,
 }
 #endif
 
+void _AVX_MNNDynamicQuantRowFP32(const float* src, int8_t* dst, float* dequantScale, int32_t* sum, size_t channel, size_t realSize, size_t stride, int pack) {
+    // pack is 8 for AVX2 and 16 for AVX512, each quad is computed as pack / 8 vectors
+    const int vecs = pack / 8;
+    const int depthQuad = UP_DIV(channel, pack);
+    auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    auto zero = _mm256_setzero_ps();
+    auto plus = _mm256_set1_ps(0.5f);
+    auto minus = _mm256_set1_ps(-0.5f);
+    auto offset = _mm256_set1_epi32(128);
+    auto allValid = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    // The padding of the last quad may be uninitialized, mask it out
+    __m256 tailMask[2];
+    int tailRemain = (int)channel - (depthQuad - 1) * pack;
+    for (int v = 0; v < vecs; ++v) {
+        tailMask[v] = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(tailRemain - v * 8), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+    }
+    for (int i = 0; i < realSize; ++i) {
+        auto maxValue = zero;
+        for (int z = 0; z < depthQuad; ++z) {
+            auto srcZ = src + z * stride + i * pack;
+            for (int v = 0; v < vecs; ++v) {
+                auto mask = z == depthQuad - 1 ? tailMask[v] : allValid;
+                auto x = _mm256_and_ps(_mm256_and_ps(_mm256_loadu_ps(srcZ + 8 * v), absMask), mask);
+                maxValue = _mm256_max_ps(maxValue, x);
+            }
+        }
+        auto m4 = _mm_max_ps(_mm256_castps256_ps128(maxValue), _mm256_extractf128_ps(maxValue, 1));
+        m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+        m4 = _mm_max_ss(m4, _mm_shuffle_ps(m4, m4, 1));
+        float absmaxVal = _mm_cvtss_f32(m4);
+        dequantScale[i] = absmaxVal / 127.0f;
+        auto scale = _mm256_set1_ps(absmaxVal > 0.0f ? 127.0f / absmaxVal : 0.0f);
+        auto acc = _mm256_setzero_si256();
+        for (int z = 0; z < depthQuad; ++z) {
+            auto srcZ = src + z * stride + i * pack;
+            auto dstZ = dst + z * stride + i * pack;
+            for (int v = 0; v < vecs; ++v) {
+                auto mask = z == depthQuad - 1 ? tailMask[v] : allValid;
+                auto f = _mm256_and_ps(_mm256_mul_ps(_mm256_loadu_ps(srcZ + 8 * v), scale), mask);
+                // Round half away from zero as the other int8 kernels
+                f = _mm256_add_ps(f, _mm256_blendv_ps(plus, minus, _mm256_cmp_ps(f, zero, 1)));
+                auto d = _mm256_cvtps_epi32(_mm256_round_ps(f, 3));
+                acc = _mm256_add_epi32(acc, d);
+                d = _mm256_add_epi32(d, offset);
+                d = _mm256_packs_epi32(d, _mm256_permute2x128_si256(d, d, 1));
+                auto d8 = _mm_packus_epi16(_mm256_castsi256_si128(d), _mm_setzero_si128());
+                _mm_storel_epi64((__m128i*)(dstZ + 8 * v), d8);
+            }
+        }
+        auto s4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        s4 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(1, 0, 3, 2)));
+        s4 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum[i] = _mm_cvtsi128_si32(s4);
+    }
+}
+
 void _AVX_MNNComputeMatMulForE_1(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId) {
     auto l = param->l;
     auto h = param->h;
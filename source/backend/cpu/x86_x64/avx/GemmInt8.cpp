@@ -25,6 +25,11 @@ static inline void MNN__mm_storeu_si64(void* add, __m128i value) {
 }
 }  // namespace
 
+#ifdef MNN_AVX_VNNI
+// Define in GemmInt8_AVXVNNI.cpp
+extern void _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_AVXVNNI(int8_t* dst, const int8_t* src, const int8_t* weight, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, const QuanPostTreatParameters* post, size_t realDst);
+#endif
+
 #define POSTTREAT(N) \
 f##N = _mm256_min_ps(f##N, maxValue);\
 f##N = _mm256_max_ps(f##N, minValue);\
@@ -740,11 +745,19 @@ static void _AVXMNNPackC4ForMatMul_A(int8_t* destOrigin, int8_t const** sourceGr
     }
 }
 
-void _AVX_MNNInt8FunctionInit(void* functions) {
+void _AVX_MNNInt8FunctionInit(void* functions, bool supportVNNI) {
     auto gAVX2CoreInt8Functions = (MNN::CoreInt8Functions*)functions;
     // MatMul
-    gAVX2CoreInt8Functions->Int8GemmKernel = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit;
-    gAVX2CoreInt8Functions->Int8GemmKernelFast = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_Fast;
+#ifdef MNN_AVX_VNNI
+    if (supportVNNI) {
+        gAVX2CoreInt8Functions->Int8GemmKernel = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_AVXVNNI;
+        gAVX2CoreInt8Functions->Int8GemmKernelFast = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_AVXVNNI;
+    } else
+#endif
+    {
+        gAVX2CoreInt8Functions->Int8GemmKernel = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit;
+        gAVX2CoreInt8Functions->Int8GemmKernelFast = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_Fast;
+    }
     gAVX2CoreInt8Functions->MNNGetGemmUnit = _AVX2_MNNGetGemmUnit;
     gAVX2CoreInt8Functions->MNNPackC4Int8ForMatMul_A = _AVXMNNPackC4ForMatMul_A;
 
@@ -0,0 +1,88 @@
+//
+//  GemmInt8_AVXVNNI.cpp
+//  MNN
+//
+//  Created by MNN on 2024/04/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifdef MNN_AVX_VNNI
+
+#include "FunctionSummary.hpp"
+#include "core/Macro.h"
+#define AVX2_PACKINT8 8
+#define GEMMINT8_AVX2_E 4
+#define GEMMINT8_AVX2_L 4
+#define GEMMINT8_AVX2_H 8
+
+/*
+ The same layout as _AVX_MNNGemmInt8AddBiasScale_16x4_Unit: 4 (l) x uint8 of src is broadcast, the weight is 8 (h) x 4 (l) int8,
+ vpdpbusd of VEX encoding replaces maddubs + madd, which has no saturation of int16, so it is used for both 8 bit and 7 bit weight.
+ */
+template <int EUNIT>
+static void _AVX_MNNGemmInt8AddBiasScaleUnit_AVXVNNI(int8_t* dst, const int8_t* src, const int8_t* weight, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, const QuanPostTreatParameters* post) {
+    const auto dst_step_tmp = dst_step / sizeof(int8_t);
+    auto zero128 = _mm256_set1_ps(0.0f);
+    auto minValue = _mm256_set1_ps(post->minValue);
+    auto maxValue = _mm256_set1_ps(post->maxValue);
+    auto plus = _mm256_set1_ps(0.5f);
+    auto minus = _mm256_set1_ps(-0.5f);
+    auto offset = _mm256_set1_epi32(128);
+    for (int dz = 0; dz < dst_depth_quad; ++dz) {
+        const auto weight_dz = weight + dz * src_depth_quad * (GEMMINT8_AVX2_L * GEMMINT8_AVX2_H);
+        const auto bias_dz = post->bias + dz * AVX2_PACKINT8;
+        const float* scale_dz = post->scale + dz * AVX2_PACKINT8;
+        auto dst_x = dst + dz * dst_step_tmp;
+        __m256i D[EUNIT];
+        for (int i = 0; i < EUNIT; ++i) {
+            D[i] = _mm256_setzero_si256();
+        }
+        for (int sz = 0; sz < src_depth_quad; ++sz) {
+            const auto weight_sz = weight_dz + sz * (GEMMINT8_AVX2_L * GEMMINT8_AVX2_H);
+            const auto src_z     = src + sz * GEMMINT8_AVX2_L * GEMMINT8_AVX2_E;
+            auto w0 = _mm256_loadu_si256((__m256i*)weight_sz);
+            for (int i = 0; i < EUNIT; ++i) {
+                auto s = _mm256_castps_si256(_mm256_broadcast_ss((float*)src_z + i));
+                D[i] = _mm256_dpbusd_avx_epi32(D[i], s, w0);
+            }
+        }
+        auto biasValue = _mm256_loadu_si256((__m256i*)(bias_dz));
+        auto scaleValue = _mm256_loadu_ps(scale_dz);
+        for (int i = 0; i < EUNIT; ++i) {
+            auto f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(D[i], biasValue)), scaleValue);
+            if (post->useInt8 == 0) {
+                _mm256_storeu_ps(((float*)dst_x) + i * AVX2_PACKINT8, f);
+                continue;
+            }
+            f = _mm256_min_ps(f, maxValue);
+            f = _mm256_max_ps(f, minValue);
+            // Round half away from zero as the other int8 kernels
+            f = _mm256_add_ps(f, _mm256_blendv_ps(plus, minus, _mm256_cmp_ps(f, zero128, 1)));
+            auto d = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_round_ps(f, 3)), offset);
+            d = _mm256_packs_epi32(d, _mm256_permute2x128_si256(d, d, 1));
+            auto d8 = _mm_packus_epi16(_mm256_castsi256_si128(d), _mm_setzero_si128());
+            _mm_storel_epi64((__m128i*)(dst_x + i * AVX2_PACKINT8), d8);
+        }
+    }
+}
+
+void _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_AVXVNNI(int8_t* dst, const int8_t* src, const int8_t* weight, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, const QuanPostTreatParameters* post, size_t realDst) {
+    switch (realDst) {
+        case 4:
+            _AVX_MNNGemmInt8AddBiasScaleUnit_AVXVNNI<4>(dst, src, weight, src_depth_quad, dst_step, dst_depth_quad, post);
+            break;
+        case 3:
+            _AVX_MNNGemmInt8AddBiasScaleUnit_AVXVNNI<3>(dst, src, weight, src_depth_quad, dst_step, dst_depth_quad, post);
+            break;
+        case 2:
+            _AVX_MNNGemmInt8AddBiasScaleUnit_AVXVNNI<2>(dst, src, weight, src_depth_quad, dst_step, dst_depth_quad, post);
+            break;
+        case 1:
+            _AVX_MNNGemmInt8AddBiasScaleUnit_AVXVNNI<1>(dst, src, weight, src_depth_quad, dst_step, dst_depth_quad, post);
+            break;
+        default:
+            break;
+    }
+}
+
+#endif
@@ -8,6 +8,9 @@
 
 #include "FunctionSummary.hpp"
 #include <math.h>
+#include <float.h>
+#include <string.h>
+#include "core/Macro.h"
 
 void _AVX_MNNGelu(float *dst, const float *src, size_t size, float* parameters) {
     // parameters[8] = {0.044715f, 0.79788458f, 378.f, 17325.f, 135135.f, 28.f, 3150.f, 62370.f};
@@ -282,4 +285,217 @@ void _AVX_MNNNorm(float *dst, const float *src, const float *gamma, const float
             dst[i] = (src[i] - mean) * variable;
         }
     }
-}
\ No newline at end of file
+}
+
+static inline __m256 _AVX_MNNExpPoly(__m256 x) {
+    // exp(x) = 2^n * exp(r), n = round(x / ln2), r = x - n * ln2
+    x = _mm256_max_ps(x, _mm256_set1_ps(-87.0f));
+    x = _mm256_min_ps(x, _mm256_set1_ps(87.0f));
+    auto div      = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.4426950408889634f)));
+    auto t        = _mm256_sub_ps(x, _mm256_mul_ps(_mm256_cvtepi32_ps(div), _mm256_set1_ps(0.6931471805599453f)));
+    auto expBasic = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(div, _mm256_set1_epi32(127)), 23));
+    auto c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(1.0f / 120), t), _mm256_set1_ps(1.0f / 24));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t), _mm256_set1_ps(1.0f / 6));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t), _mm256_set1_ps(0.5f));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t), _mm256_set1_ps(1.0f));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t), _mm256_set1_ps(1.0f));
+    return _mm256_mul_ps(expBasic, c);
+}
+
+void _AVX_MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size) {
+    int count  = static_cast<int32_t>(size / 8);
+    int remain = static_cast<int32_t>(size % 8);
+    float temp[8];
+    // step 1: y = x * scale + mask, and get max(y)
+    auto scaleVal = _mm256_set1_ps(scale);
+    auto maxVal   = _mm256_set1_ps(-FLT_MAX);
+    for (int i = 0; i < count; ++i) {
+        auto y = _mm256_mul_ps(_mm256_loadu_ps(source + 8 * i), scaleVal);
+        if (nullptr != mask) {
+            y = _mm256_add_ps(y, _mm256_loadu_ps(mask + 8 * i));
+        }
+        maxVal = _mm256_max_ps(maxVal, y);
+        _mm256_storeu_ps(dest + 8 * i, y);
+    }
+    _mm256_storeu_ps(temp, maxVal);
+    float maxValue = temp[0];
+    for (int i = 1; i < 8; ++i) {
+        maxValue = ALIMAX(maxValue, temp[i]);
+    }
+    for (int i = count * 8; i < size; ++i) {
+        auto y = source[i] * scale;
+        if (nullptr != mask) {
+            y += mask[i];
+        }
+        dest[i]  = y;
+        maxValue = ALIMAX(maxValue, y);
+    }
+    // step 2: exp(y - max) and sum
+    auto maxVec = _mm256_set1_ps(maxValue);
+    auto sumVal = _mm256_setzero_ps();
+    for (int i = 0; i < count; ++i) {
+        auto e = _AVX_MNNExpPoly(_mm256_sub_ps(_mm256_loadu_ps(dest + 8 * i), maxVec));
+        sumVal = _mm256_add_ps(sumVal, e);
+        _mm256_storeu_ps(dest + 8 * i, e);
+    }
+    _mm256_storeu_ps(temp, sumVal);
+    float sumValue = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        sumValue += temp[i];
+    }
+    if (remain > 0) {
+        auto tail = dest + count * 8;
+        for (int i = 0; i < 8; ++i) {
+            temp[i] = i < remain ? tail[i] : maxValue;
+        }
+        _mm256_storeu_ps(temp, _AVX_MNNExpPoly(_mm256_sub_ps(_mm256_loadu_ps(temp), maxVec)));
+        for (int i = 0; i < remain; ++i) {
+            tail[i] = temp[i];
+            sumValue += temp[i];
+        }
+    }
+    // step 3: normalize
+    float recValue = 1.0f / sumValue;
+    auto recVal = _mm256_set1_ps(recValue);
+    for (int i = 0; i < count; ++i) {
+        _mm256_storeu_ps(dest + 8 * i, _mm256_mul_ps(_mm256_loadu_ps(dest + 8 * i), recVal));
+    }
+    for (int i = count * 8; i < size; ++i) {
+        dest[i] *= recValue;
+    }
+}
+
+static inline __m256 _AVX_MNNSelect(__m256 mask, __m256 a, __m256 b) {
+    // mask ? a : b
+    return _mm256_or_ps(_mm256_and_ps(mask, a), _mm256_andnot_ps(mask, b));
+}
+
+// x * x - hi for hi = x * x, by Dekker's split
+static inline __m256 _AVX_MNNSquareError(__m256 x, __m256 hi) {
+    auto c  = _mm256_mul_ps(x, _mm256_set1_ps(4097.0f));
+    auto xh = _mm256_sub_ps(c, _mm256_sub_ps(c, x));
+    auto xl = _mm256_sub_ps(x, xh);
+    auto e  = _mm256_sub_ps(_mm256_mul_ps(xh, xh), hi);
+    e = _mm256_add_ps(e, _mm256_mul_ps(_mm256_add_ps(xh, xh), xl));
+    return _mm256_add_ps(e, _mm256_mul_ps(xl, xl));
+}
+
+// exp(hi + lo) for hi + lo <= 0 and lo is the rounding error of hi, 0 for underflow
+static inline __m256 _AVX_MNNExpAccurate(__m256 hi, __m256 lo) {
+    auto x     = _mm256_add_ps(hi, lo);
+    auto valid = _mm256_cmp_ps(x, _mm256_set1_ps(-87.0f), _CMP_GE_OQ);
+    auto ni    = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_max_ps(x, _mm256_set1_ps(-87.0f)), _mm256_set1_ps(1.44269504088896341f)));
+    auto n     = _mm256_cvtepi32_ps(ni);
+    // Cody-Waite reduction, n * ln2Hi is exact
+    auto t = _mm256_sub_ps(hi, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+    t = _mm256_sub_ps(t, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+    t = _mm256_add_ps(t, lo);
+    auto p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(1.0f / 5040), t), _mm256_set1_ps(1.0f / 720));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 120));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 24));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 6));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(0.5f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f));
+    auto scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(ni, _mm256_set1_epi32(127)), 23));
+    return _mm256_and_ps(_mm256_mul_ps(p, scale), valid);
+}
+
+// erfc(z) for 0 <= z <= 10, -z * z = hi + lo
+static inline __m256 _AVX_MNNErfcPositive(__m256 z, __m256 hi, __m256 lo) {
+    auto t = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), z), _mm256_set1_ps(1.0f)));
+    auto q = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.17087277f), t), _mm256_set1_ps(-0.82215223f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(1.48851587f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(-1.13520398f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(0.27886807f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(-0.18628806f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(0.09678418f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(0.37409196f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(1.00002368f));
+    q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(-1.26551223f));
+    return _mm256_mul_ps(t, _AVX_MNNExpAccurate(hi, _mm256_add_ps(lo, q)));
+}
+
+// erf(x) for |x| < 0.5 by taylor series
+static inline __m256 _AVX_MNNErfSmall(__m256 x) {
+    auto x2 = _mm256_mul_ps(x, x);
+    auto p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(1.20553330e-4f), x2), _mm256_set1_ps(-8.54832702e-4f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(5.22397763e-3f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(-2.68661706e-2f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(1.12837917e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(-3.76126389e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(1.12837917f));
+    return _mm256_mul_ps(p, x);
+}
+
+static inline __m256 _AVX_MNNErfUnit(__m256 x, bool complement) {
+    auto signMask = _mm256_set1_ps(-0.0f);
+    auto z  = _mm256_min_ps(_mm256_andnot_ps(signMask, x), _mm256_set1_ps(10.0f));
+    auto hi = _mm256_mul_ps(z, z);
+    auto lo = _AVX_MNNSquareError(z, hi);
+    auto e  = _AVX_MNNErfcPositive(z, _mm256_xor_ps(hi, signMask), _mm256_xor_ps(lo, signMask));
+    auto small    = _AVX_MNNErfSmall(x);
+    auto isSmall  = _mm256_cmp_ps(z, _mm256_set1_ps(0.5f), _CMP_LT_OQ);
+    auto positive = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GE_OQ);
+    if (complement) {
+        auto large = _AVX_MNNSelect(positive, e, _mm256_sub_ps(_mm256_set1_ps(2.0f), e));
+        return _AVX_MNNSelect(isSmall, _mm256_sub_ps(_mm256_set1_ps(1.0f), small), large);
+    }
+    auto large = _mm256_or_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), e), _mm256_and_ps(x, signMask));
+    return _AVX_MNNSelect(isSmall, small, large);
+}
+
+static inline __m256 _AVX_MNNGeluStandardUnit(__m256 x) {
+    auto signMask = _mm256_set1_ps(-0.0f);
+    // 0.5 * erfc(|x| / sqrt(2)), the exponent -x * x / 2 is split exactly
+    auto ax = _mm256_min_ps(_mm256_andnot_ps(signMask, x), _mm256_set1_ps(14.0f));
+    auto z  = _mm256_mul_ps(ax, _mm256_set1_ps(0.707106781f));
+    auto hi = _mm256_mul_ps(ax, ax);
+    auto lo = _AVX_MNNSquareError(ax, hi);
+    auto half = _mm256_set1_ps(-0.5f);
+    auto e   = _mm256_mul_ps(_mm256_set1_ps(0.5f), _AVX_MNNErfcPositive(z, _mm256_mul_ps(hi, half), _mm256_mul_ps(lo, half)));
+    auto phi = _AVX_MNNSelect(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GE_OQ), _mm256_sub_ps(_mm256_set1_ps(1.0f), e), e);
+    auto small = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), _AVX_MNNErfSmall(_mm256_mul_ps(x, _mm256_set1_ps(0.707106781f)))), _mm256_set1_ps(0.5f));
+    phi = _AVX_MNNSelect(_mm256_cmp_ps(z, _mm256_set1_ps(0.5f), _CMP_LT_OQ), small, phi);
+    return _mm256_mul_ps(x, phi);
+}
+
+static inline __m256 _AVX_MNNSiLUUnit(__m256 x) {
+    // sigmoid(x) = 1 / (1 + e) for x >= 0 and e / (1 + e) for x < 0, e = exp(-|x|)
+    auto e = _AVX_MNNExpAccurate(_mm256_or_ps(x, _mm256_set1_ps(-0.0f)), _mm256_setzero_ps());
+    auto r = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_add_ps(_mm256_set1_ps(1.0f), e));
+    auto s = _AVX_MNNSelect(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GE_OQ), r, _mm256_mul_ps(e, r));
+    return _mm256_mul_ps(x, s);
+}
+
+// Apply the activation for 8 elements at a time, the tail is padded
+template<typename Unit>
+static inline void _AVX_MNNActivation(float* dst, const float* src, size_t size, Unit unit) {
+    size_t count = size / 8;
+    for (size_t i = 0; i < count; ++i) {
+        _mm256_storeu_ps(dst + 8 * i, unit(_mm256_loadu_ps(src + 8 * i)));
+    }
+    size_t remain = size % 8;
+    if (remain > 0) {
+        float temp[8] = {0.0f};
+        ::memcpy(temp, src + 8 * count, remain * sizeof(float));
+        _mm256_storeu_ps(temp, unit(_mm256_loadu_ps(temp)));
+        ::memcpy(dst + 8 * count, temp, remain * sizeof(float));
+    }
+}
+
+void _AVX_MNNErf(float* dst, const float* src, size_t size) {
+    _AVX_MNNActivation(dst, src, size, [](__m256 x) { return _AVX_MNNErfUnit(x, false); });
+}
+
+void _AVX_MNNErfc(float* dst, const float* src, size_t size) {
+    _AVX_MNNActivation(dst, src, size, [](__m256 x) { return _AVX_MNNErfUnit(x, true); });
+}
+
+void _AVX_MNNGeluStandard(float* dst, const float* src, size_t size) {
+    _AVX_MNNActivation(dst, src, size, _AVX_MNNGeluStandardUnit);
+}
+
+void _AVX_MNNSiLU(float* dst, const float* src, size_t size) {
+    _AVX_MNNActivation(dst, src, size, _AVX_MNNSiLUUnit);
+}
@@ -54,6 +54,15 @@ void _AVX512_ReorderInit(void* functions);
 void _AVX512_ExtraInit(void* functions);
 void _AVX512_WinogradInit(void* functions);
 void _AVX512_MNNInt8FunctionInit(void* functions, bool suppotVNNI);
+void _AVX512_MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size);
+void _AVX512_MNNErf(float* dst, const float* src, size_t size);
+void _AVX512_MNNErfc(float* dst, const float* src, size_t size);
+void _AVX512_MNNGeluStandard(float* dst, const float* src, size_t size);
+void _AVX512_MNNSiLU(float* dst, const float* src, size_t size);
+// Native bf16 dot product by vdpbf16ps, the same pack mode as _AVX_MNNGetMatMulPackMode_BF16
+void _AVX512_MNNPackedMatMulBF16(float* C, const float* A, const float* B, const size_t* parameter,
+                                 const float* postParameters, const float* bias, const float* k, const float* b);
+void _AVX512_MNNPackedMatMulRemainBF16(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, const float* postParameters, const float* bias, const float* k, const float* b);
 
 extern MNN::CoreFunctions::MNNPackedMatMulKernel _AVX512_MNNPackedMatMulOC16Functions[AVX512_INPUT_TILE_MAX];
 extern MNN::CoreFunctions::MNNPackedMatMulKernel _AVX512_MNNPackedMatMulOC32Functions[AVX512_INPUT_TILE_MAX];
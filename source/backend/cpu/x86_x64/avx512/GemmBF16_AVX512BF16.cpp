@@ -0,0 +1,100 @@
+//
+//  GemmBF16_AVX512BF16.cpp
+//  MNN
+//
+//  Created by MNN on 2024/04/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#if defined(MNN_SUPPORT_BF16) && defined(MNN_AVX512_BF16)
+
+#include "FunctionSummary.hpp"
+#include "core/Macro.h"
+
+/*
+ Use the layout of _AVX_MNNPackForMatMul_B_BF16 / _AVX_MNNPackC4ForMatMul_A_BF16 (eP = 3, lP = 8, hP = 4):
+ a block of B is 4 (h) x 8 (l) bf16 = 512 bits, the 8 bf16 of l of A is broadcast to 4 x 128 bits,
+ so vdpbf16ps accumulates 2 l for 4 h x 4 l-pair, the 4 lanes of each h are added at the end.
+ */
+static inline __m128 _AVX512_ReduceBF16Dot(__m512 x) {
+    x = _mm512_add_ps(x, _mm512_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    x = _mm512_add_ps(x, _mm512_permute_ps(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm512_castps512_ps128(_mm512_permutexvar_ps(_mm512_setr_epi32(0, 4, 8, 12, 0, 4, 8, 12, 0, 4, 8, 12, 0, 4, 8, 12), x));
+}
+
+static inline __m128 _AVX512_LoadBF16x4(const int16_t* src) {
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)src)), 16));
+}
+
+static inline void _AVX512_StoreBF16x4(int16_t* dst, __m128 x) {
+    // Round to nearest even instead of truncate
+    auto v = _mm_cvtneps_pbh(x);
+    ::memcpy(dst, &v, 4 * sizeof(int16_t));
+}
+
+template <int EUNIT>
+static void _AVX512_MNNPackedMatMulBF16Unit(int16_t* C, const int16_t* A, const int16_t* B, const size_t* parameter, size_t aStride, const float* postParameters, const int16_t* bias) {
+    auto h            = parameter[2];
+    auto l            = parameter[1];
+    auto cStride      = parameter[3] / sizeof(int16_t);
+    auto bExtraStride = parameter[5] / sizeof(int16_t);
+    auto lC8          = UP_DIV(l, 8);
+    auto hC4          = UP_DIV(h, 4);
+    __m128 minValue, maxValue;
+    if (nullptr != postParameters) {
+        minValue = _mm_set1_ps(postParameters[2]);
+        maxValue = _mm_set1_ps(postParameters[3]);
+    }
+    for (int y = 0; y < hC4; ++y) {
+        __m512 S[EUNIT];
+        for (int e = 0; e < EUNIT; ++e) {
+            S[e] = _mm512_setzero_ps();
+        }
+        auto srcUse = A;
+        for (int sy = 0; sy < lC8; ++sy) {
+            auto w = (__m512bh)_mm512_loadu_si512(B);
+            for (int e = 0; e < EUNIT; ++e) {
+                auto s = (__m512bh)_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)(srcUse + 8 * e)));
+                S[e] = _mm512_dpbf16_ps(S[e], s, w);
+            }
+            B += 32;
+            srcUse += aStride * 8;
+        }
+        __m128 biasValue = _mm_setzero_ps();
+        if (nullptr != postParameters && nullptr != bias) {
+            biasValue = _AVX512_LoadBF16x4(bias + 4 * y);
+        }
+        for (int e = 0; e < EUNIT; ++e) {
+            auto sum = _AVX512_ReduceBF16Dot(S[e]);
+            if (nullptr != postParameters) {
+                sum = _mm_add_ps(sum, biasValue);
+                sum = _mm_max_ps(sum, minValue);
+                sum = _mm_min_ps(sum, maxValue);
+            }
+            _AVX512_StoreBF16x4(C + 4 * e, sum);
+        }
+        B += bExtraStride;
+        C += cStride;
+    }
+}
+
+void _AVX512_MNNPackedMatMulBF16(float* C, const float* A, const float* B, const size_t* parameter,
+                                 const float* postParameters, const float* bias, const float* k, const float* b) {
+    _AVX512_MNNPackedMatMulBF16Unit<3>((int16_t*)C, (const int16_t*)A, (const int16_t*)B, parameter, 3, postParameters, (const int16_t*)bias);
+}
+
+void _AVX512_MNNPackedMatMulRemainBF16(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, const float* postParameters, const float* bias, const float* k, const float* b) {
+    auto aStride = parameter[0] / sizeof(int16_t);
+    switch (eSize) {
+        case 2:
+            _AVX512_MNNPackedMatMulBF16Unit<2>((int16_t*)C, (const int16_t*)A, (const int16_t*)B, parameter, aStride, postParameters, (const int16_t*)bias);
+            break;
+        case 1:
+            _AVX512_MNNPackedMatMulBF16Unit<1>((int16_t*)C, (const int16_t*)A, (const int16_t*)B, parameter, aStride, postParameters, (const int16_t*)bias);
+            break;
+        default:
+            break;
+    }
+}
+
+#endif
@@ -0,0 +1,192 @@
+//
+//  MathFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/28.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <float.h>
+#include "FunctionSummary.hpp"
+
+static inline __m512 _AVX512_MNNExpPoly(__m512 x) {
+    // exp(x) = 2^n * exp(r), n = round(x / ln2), r = x - n * ln2, scalef computes 2^n without overflow of exponent
+    x = _mm512_max_ps(x, _mm512_set1_ps(-87.0f));
+    x = _mm512_min_ps(x, _mm512_set1_ps(87.0f));
+    auto n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.4426950408889634f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    auto t = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.6931471805599453f), x);
+    auto c = _mm512_fmadd_ps(_mm512_set1_ps(1.0f / 120), t, _mm512_set1_ps(1.0f / 24));
+    c = _mm512_fmadd_ps(c, t, _mm512_set1_ps(1.0f / 6));
+    c = _mm512_fmadd_ps(c, t, _mm512_set1_ps(0.5f));
+    c = _mm512_fmadd_ps(c, t, _mm512_set1_ps(1.0f));
+    c = _mm512_fmadd_ps(c, t, _mm512_set1_ps(1.0f));
+    return _mm512_scalef_ps(c, n);
+}
+
+void _AVX512_MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size) {
+    int count  = static_cast<int32_t>(size / 16);
+    int remain = static_cast<int32_t>(size % 16);
+    // The tail is computed with masked load / store
+    __mmask16 tailMask = (__mmask16)((1 << remain) - 1);
+    auto tailSrc = source + count * 16;
+    auto tailDst = dest + count * 16;
+    // step 1: y = x * scale + mask, and get max(y)
+    auto scaleVal = _mm512_set1_ps(scale);
+    auto maxVal   = _mm512_set1_ps(-FLT_MAX);
+    for (int i = 0; i < count; ++i) {
+        __m512 y;
+        if (nullptr != mask) {
+            y = _mm512_fmadd_ps(_mm512_loadu_ps(source + 16 * i), scaleVal, _mm512_loadu_ps(mask + 16 * i));
+        } else {
+            y = _mm512_mul_ps(_mm512_loadu_ps(source + 16 * i), scaleVal);
+        }
+        maxVal = _mm512_max_ps(maxVal, y);
+        _mm512_storeu_ps(dest + 16 * i, y);
+    }
+    if (remain > 0) {
+        __m512 y;
+        if (nullptr != mask) {
+            y = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tailMask, tailSrc), scaleVal, _mm512_maskz_loadu_ps(tailMask, mask + count * 16));
+        } else {
+            y = _mm512_mul_ps(_mm512_maskz_loadu_ps(tailMask, tailSrc), scaleVal);
+        }
+        maxVal = _mm512_mask_max_ps(maxVal, tailMask, maxVal, y);
+        _mm512_mask_storeu_ps(tailDst, tailMask, y);
+    }
+    auto maxVec = _mm512_set1_ps(_mm512_reduce_max_ps(maxVal));
+    // step 2: exp(y - max) and sum
+    auto sumVal = _mm512_setzero_ps();
+    for (int i = 0; i < count; ++i) {
+        auto e = _AVX512_MNNExpPoly(_mm512_sub_ps(_mm512_loadu_ps(dest + 16 * i), maxVec));
+        sumVal = _mm512_add_ps(sumVal, e);
+        _mm512_storeu_ps(dest + 16 * i, e);
+    }
+    if (remain > 0) {
+        auto e = _AVX512_MNNExpPoly(_mm512_sub_ps(_mm512_maskz_loadu_ps(tailMask, tailDst), maxVec));
+        sumVal = _mm512_mask_add_ps(sumVal, tailMask, sumVal, e);
+        _mm512_mask_storeu_ps(tailDst, tailMask, e);
+    }
+    // step 3: normalize
+    auto recVal = _mm512_set1_ps(1.0f / _mm512_reduce_add_ps(sumVal));
+    for (int i = 0; i < count; ++i) {
+        _mm512_storeu_ps(dest + 16 * i, _mm512_mul_ps(_mm512_loadu_ps(dest + 16 * i), recVal));
+    }
+    if (remain > 0) {
+        _mm512_mask_storeu_ps(tailDst, tailMask, _mm512_mul_ps(_mm512_maskz_loadu_ps(tailMask, tailDst), recVal));
+    }
+}
+
+// exp(hi + lo) for hi + lo <= 0 and lo is the rounding error of hi, 0 for underflow
+static inline __m512 _AVX512_MNNExpAccurate(__m512 hi, __m512 lo) {
+    auto x     = _mm512_add_ps(hi, lo);
+    auto valid = _mm512_cmp_ps_mask(x, _mm512_set1_ps(-87.0f), _CMP_GE_OQ);
+    auto n     = _mm512_roundscale_ps(_mm512_mul_ps(_mm512_max_ps(x, _mm512_set1_ps(-87.0f)), _mm512_set1_ps(1.44269504088896341f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    // Cody-Waite reduction, n * ln2Hi is exact
+    auto t = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), hi);
+    t = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), t);
+    t = _mm512_add_ps(t, lo);
+    auto p = _mm512_fmadd_ps(_mm512_set1_ps(1.0f / 5040), t, _mm512_set1_ps(1.0f / 720));
+    p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(1.0f / 120));
+    p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(1.0f / 24));
+    p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(1.0f / 6));
+    p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(0.5f));
+    p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(1.0f));
+    p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(1.0f));
+    return _mm512_maskz_scalef_ps(valid, p, n);
+}
+
+// erfc(z) for 0 <= z <= 10, -z * z = hi + lo
+static inline __m512 _AVX512_MNNErfcPositive(__m512 z, __m512 hi, __m512 lo) {
+    auto t = _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_fmadd_ps(_mm512_set1_ps(0.5f), z, _mm512_set1_ps(1.0f)));
+    auto q = _mm512_fmadd_ps(_mm512_set1_ps(0.17087277f), t, _mm512_set1_ps(-0.82215223f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(1.48851587f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(-1.13520398f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(0.27886807f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(-0.18628806f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(0.09678418f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(0.37409196f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(1.00002368f));
+    q = _mm512_fmadd_ps(q, t, _mm512_set1_ps(-1.26551223f));
+    return _mm512_mul_ps(t, _AVX512_MNNExpAccurate(hi, _mm512_add_ps(lo, q)));
+}
+
+// erf(x) for |x| < 0.5 by taylor series
+static inline __m512 _AVX512_MNNErfSmall(__m512 x) {
+    auto x2 = _mm512_mul_ps(x, x);
+    auto p = _mm512_fmadd_ps(_mm512_set1_ps(1.20553330e-4f), x2, _mm512_set1_ps(-8.54832702e-4f));
+    p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(5.22397763e-3f));
+    p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(-2.68661706e-2f));
+    p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(1.12837917e-1f));
+    p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(-3.76126389e-1f));
+    p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(1.12837917f));
+    return _mm512_mul_ps(p, x);
+}
+
+static inline __m512 _AVX512_MNNErfUnit(__m512 x, bool complement) {
+    auto z  = _mm512_min_ps(_mm512_abs_ps(x), _mm512_set1_ps(10.0f));
+    auto hi = _mm512_mul_ps(z, z);
+    auto lo = _mm512_fmsub_ps(z, z, hi);
+    auto e  = _AVX512_MNNErfcPositive(z, _mm512_sub_ps(_mm512_setzero_ps(), hi), _mm512_sub_ps(_mm512_setzero_ps(), lo));
+    auto small    = _AVX512_MNNErfSmall(x);
+    auto isSmall  = _mm512_cmp_ps_mask(z, _mm512_set1_ps(0.5f), _CMP_LT_OQ);
+    auto negative = _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_LT_OQ);
+    if (complement) {
+        auto large = _mm512_mask_sub_ps(e, negative, _mm512_set1_ps(2.0f), e);
+        return _mm512_mask_sub_ps(large, isSmall, _mm512_set1_ps(1.0f), small);
+    }
+    auto large = _mm512_sub_ps(_mm512_set1_ps(1.0f), e);
+    large = _mm512_mask_sub_ps(large, negative, _mm512_setzero_ps(), large);
+    return _mm512_mask_blend_ps(isSmall, large, small);
+}
+
+static inline __m512 _AVX512_MNNGeluStandardUnit(__m512 x) {
+    // 0.5 * erfc(|x| / sqrt(2)), the exponent -x * x / 2 is split exactly
+    auto ax = _mm512_min_ps(_mm512_abs_ps(x), _mm512_set1_ps(14.0f));
+    auto z  = _mm512_mul_ps(ax, _mm512_set1_ps(0.707106781f));
+    auto hi = _mm512_mul_ps(ax, ax);
+    auto lo = _mm512_fmsub_ps(ax, ax, hi);
+    auto half = _mm512_set1_ps(-0.5f);
+    auto e   = _mm512_mul_ps(_mm512_set1_ps(0.5f), _AVX512_MNNErfcPositive(z, _mm512_mul_ps(hi, half), _mm512_mul_ps(lo, half)));
+    auto phi = _mm512_mask_sub_ps(e, _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GE_OQ), _mm512_set1_ps(1.0f), e);
+    auto small = _mm512_fmadd_ps(_mm512_set1_ps(0.5f), _AVX512_MNNErfSmall(_mm512_mul_ps(x, _mm512_set1_ps(0.707106781f))), _mm512_set1_ps(0.5f));
+    phi = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(z, _mm512_set1_ps(0.5f), _CMP_LT_OQ), phi, small);
+    return _mm512_mul_ps(x, phi);
+}
+
+static inline __m512 _AVX512_MNNSiLUUnit(__m512 x) {
+    // sigmoid(x) = 1 / (1 + e) for x >= 0 and e / (1 + e) for x < 0, e = exp(-|x|)
+    auto e = _AVX512_MNNExpAccurate(_mm512_sub_ps(_mm512_setzero_ps(), _mm512_abs_ps(x)), _mm512_setzero_ps());
+    auto r = _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_add_ps(_mm512_set1_ps(1.0f), e));
+    auto s = _mm512_mask_mul_ps(r, _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_LT_OQ), e, r);
+    return _mm512_mul_ps(x, s);
+}
+
+// Apply the activation for 16 elements at a time, the tail is computed with masked load / store
+template<typename Unit>
+static inline void _AVX512_MNNActivation(float* dst, const float* src, size_t size, Unit unit) {
+    size_t count = size / 16;
+    for (size_t i = 0; i < count; ++i) {
+        _mm512_storeu_ps(dst + 16 * i, unit(_mm512_loadu_ps(src + 16 * i)));
+    }
+    size_t remain = size % 16;
+    if (remain > 0) {
+        __mmask16 mask = (__mmask16)((1 << remain) - 1);
+        _mm512_mask_storeu_ps(dst + 16 * count, mask, unit(_mm512_maskz_loadu_ps(mask, src + 16 * count)));
+    }
+}
+
+void _AVX512_MNNErf(float* dst, const float* src, size_t size) {
+    _AVX512_MNNActivation(dst, src, size, [](__m512 x) { return _AVX512_MNNErfUnit(x, false); });
+}
+
+void _AVX512_MNNErfc(float* dst, const float* src, size_t size) {
+    _AVX512_MNNActivation(dst, src, size, [](__m512 x) { return _AVX512_MNNErfUnit(x, true); });
+}
+
+void _AVX512_MNNGeluStandard(float* dst, const float* src, size_t size) {
+    _AVX512_MNNActivation(dst, src, size, _AVX512_MNNGeluStandardUnit);
+}
+
+void _AVX512_MNNSiLU(float* dst, const float* src, size_t size) {
+    _AVX512_MNNActivation(dst, src, size, _AVX512_MNNSiLUUnit);
+}
@@ -184,6 +184,140 @@ void _AVX512_MNNConvRunForLineDepthwise(float* dst, const float* src, const floa
     }
 }
 
+static inline __m512 _AVX512_MNNDepthwisePost(__m512 v, __m512 minF, __m512 maxF, bool hardSwish) {
+    v = _mm512_min_ps(_mm512_max_ps(v, minF), maxF);
+    if (hardSwish) {
+        // x * relu6(x + 3) / 6
+        auto t = _mm512_min_ps(_mm512_max_ps(_mm512_add_ps(v, _mm512_set1_ps(3.0f)), _mm512_setzero_ps()), _mm512_set1_ps(6.0f));
+        v = _mm512_mul_ps(_mm512_mul_ps(v, t), _mm512_set1_ps(1.0f / 6.0f));
+    }
+    return v;
+}
+
+template <int UNIT>
+static inline void _AVX512_MNNDepthwiseStore(float* dst, const __m512* dstValue, __m512 minF, __m512 maxF, bool hardSwish) {
+    for (int i = 0; i < UNIT; ++i) {
+        _mm512_storeu_ps(dst + PACK_UNIT * i, _AVX512_MNNDepthwisePost(dstValue[i], minF, maxF, hardSwish));
+    }
+}
+
+// UNIT outputs of a line for any stride and dilation
+template <int UNIT>
+static inline void _AVX512_MNNDepthwiseBlock(float* dst, const float* src, const float* weight, size_t src_w_setup, size_t fw, size_t fh,
+                                             size_t dilateX_step, size_t dilateY_step, __m512 biasF, __m512 minF, __m512 maxF, bool hardSwish) {
+    __m512 dstValue[UNIT];
+    for (int i = 0; i < UNIT; ++i) {
+        dstValue[i] = biasF;
+    }
+    for (int fy = 0; fy < fh; ++fy) {
+        const float* src_y    = src + fy * dilateY_step;
+        const float* weight_y = weight + fy * fw * PACK_UNIT;
+        for (int fx = 0; fx < fw; ++fx) {
+            const float* src_x = src_y + fx * dilateX_step;
+            auto weightValue   = _mm512_loadu_ps(weight_y + PACK_UNIT * fx);
+            for (int i = 0; i < UNIT; ++i) {
+                dstValue[i] = _mm512_fmadd_ps(_mm512_loadu_ps(src_x + i * src_w_setup), weightValue, dstValue[i]);
+            }
+        }
+    }
+    _AVX512_MNNDepthwiseStore<UNIT>(dst, dstValue, minF, maxF, hardSwish);
+}
+
+/*
+ dilation = Q * stride: the source of the next tap for output i is the source of the current tap for output i + Q,
+ so the source stays in register and only Q new vectors are loaded for each tap.
+ */
+template <int UNIT, int Q>
+static inline void _AVX512_MNNDepthwiseSlide(float* dst, const float* src, const float* weight, size_t src_w_setup, size_t fw, size_t fh,
+                                             size_t dilateX_step, size_t dilateY_step, __m512 biasF, __m512 minF, __m512 maxF, bool hardSwish) {
+    __m512 dstValue[UNIT];
+    __m512 srcValue[UNIT];
+    for (int i = 0; i < UNIT; ++i) {
+        dstValue[i] = biasF;
+    }
+    for (int fy = 0; fy < fh; ++fy) {
+        const float* src_y    = src + fy * dilateY_step;
+        const float* weight_y = weight + fy * fw * PACK_UNIT;
+        for (int i = 0; i < UNIT; ++i) {
+            srcValue[i] = _mm512_loadu_ps(src_y + i * src_w_setup);
+        }
+        for (int fx = 0; fx < fw; ++fx) {
+            auto weightValue = _mm512_loadu_ps(weight_y + PACK_UNIT * fx);
+            for (int i = 0; i < UNIT; ++i) {
+                dstValue[i] = _mm512_fmadd_ps(srcValue[i], weightValue, dstValue[i]);
+            }
+            if (fx + 1 < fw) {
+                for (int i = 0; i < UNIT - Q; ++i) {
+                    srcValue[i] = srcValue[i + Q];
+                }
+                const float* src_x = src_y + (fx + 1) * dilateX_step;
+                for (int i = UNIT - Q; i < UNIT; ++i) {
+                    srcValue[i] = _mm512_loadu_ps(src_x + i * src_w_setup);
+                }
+            }
+        }
+    }
+    _AVX512_MNNDepthwiseStore<UNIT>(dst, dstValue, minF, maxF, hardSwish);
+}
+
+template <int K>
+static void _AVX512_MNNConvRunForLineDepthwisePostUnit(float* dst, const float* src, const float* weight, size_t width, size_t src_w_setup,
+                                                       size_t fh, size_t dilateX_step, size_t dilateY_step, size_t height,
+                                                       size_t srcHStep, size_t dstHStep, const float* bias, const float* parameters) {
+    auto biasF = _mm512_loadu_ps(bias);
+    auto minF = _mm512_set1_ps(parameters[2]);
+    auto maxF = _mm512_set1_ps(parameters[3]);
+    bool hardSwish = parameters[4] != 0.0f;
+    for (int y = 0; y < height; ++y) {
+        auto srcY = src + y * srcHStep;
+        auto dstY = dst + y * dstHStep;
+        int dx = 0;
+        if (dilateX_step == src_w_setup) {
+            for (; dx + 8 <= width; dx += 8) {
+                _AVX512_MNNDepthwiseSlide<8, 1>(dstY + dx * PACK_UNIT, srcY + dx * src_w_setup, weight, src_w_setup, K, fh, dilateX_step, dilateY_step, biasF, minF, maxF, hardSwish);
+            }
+        } else if (dilateX_step == 2 * src_w_setup) {
+            for (; dx + 8 <= width; dx += 8) {
+                _AVX512_MNNDepthwiseSlide<8, 2>(dstY + dx * PACK_UNIT, srcY + dx * src_w_setup, weight, src_w_setup, K, fh, dilateX_step, dilateY_step, biasF, minF, maxF, hardSwish);
+            }
+        }
+        for (; dx + 4 <= width; dx += 4) {
+            _AVX512_MNNDepthwiseBlock<4>(dstY + dx * PACK_UNIT, srcY + dx * src_w_setup, weight, src_w_setup, K, fh, dilateX_step, dilateY_step, biasF, minF, maxF, hardSwish);
+        }
+        for (; dx < width; ++dx) {
+            _AVX512_MNNDepthwiseBlock<1>(dstY + dx * PACK_UNIT, srcY + dx * src_w_setup, weight, src_w_setup, K, fh, dilateX_step, dilateY_step, biasF, minF, maxF, hardSwish);
+        }
+    }
+}
+
+static void _AVX512_MNNConvRunForLineDepthwisePost(float* dst, const float* src, const float* weight, size_t width, size_t src_w_setup,
+                                                   size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step, size_t height,
+                                                   size_t srcHStep, size_t dstHStep, const float* bias, const float* parameters) {
+    switch (fw) {
+        case 5:
+            _AVX512_MNNConvRunForLineDepthwisePostUnit<5>(dst, src, weight, width, src_w_setup, fh, dilateX_step, dilateY_step, height, srcHStep, dstHStep, bias, parameters);
+            break;
+        case 7:
+            _AVX512_MNNConvRunForLineDepthwisePostUnit<7>(dst, src, weight, width, src_w_setup, fh, dilateX_step, dilateY_step, height, srcHStep, dstHStep, bias, parameters);
+            break;
+        default: {
+            _AVX512_MNNConvRunForLineDepthwise(dst, src, weight, width, src_w_setup, fw, fh, dilateX_step, dilateY_step, height, srcHStep, dstHStep);
+            auto biasF = _mm512_loadu_ps(bias);
+            auto minF = _mm512_set1_ps(parameters[2]);
+            auto maxF = _mm512_set1_ps(parameters[3]);
+            bool hardSwish = parameters[4] != 0.0f;
+            for (int y = 0; y < height; ++y) {
+                auto dstY = dst + y * dstHStep;
+                for (int dx = 0; dx < width; ++dx) {
+                    auto dstValue = _mm512_add_ps(_mm512_loadu_ps(dstY + PACK_UNIT * dx), biasF);
+                    _mm512_storeu_ps(dstY + PACK_UNIT * dx, _AVX512_MNNDepthwisePost(dstValue, minF, maxF, hardSwish));
+                }
+            }
+            break;
+        }
+    }
+}
+
 static MNNBinaryExecute _AVX512_MNNSelectBinaryFunctionForFloat(int opType) {
     auto vecF = MNN::selectVector<Vec16, 16, float>(opType);
     if (nullptr != vecF) {
@@ -740,6 +874,7 @@ void _AVX512_ExtraInit(void* functions) {
 
     coreFunction->MNNConvRunForUnitDepthWise = _AVX512_MNNConvRunForUnitDepthWise;
     coreFunction->MNNConvRunForLineDepthwise = _AVX512_MNNConvRunForLineDepthwise;
+    coreFunction->MNNConvRunForLineDepthwisePost = _AVX512_MNNConvRunForLineDepthwisePost;
     coreFunction->MNNAxByClampBroadcastUnit = _AVX512_MNNAxByClampBroadcastUnit;
     coreFunction->MNNStrassenMergeCFunction = _AVX512_MNNStrassenMergeCFunction;
     coreFunction->MNNMultiAndDestTransformCommon23 = _AVX512_MNNMultiAndDestTransformCommon23;
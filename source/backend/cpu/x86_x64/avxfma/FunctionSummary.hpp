@@ -44,6 +44,11 @@ void _AVX_MNNPackedMatMulRemainFMA_BF16(float* C, const float* A, const float* B
 void _AVX_MNNComputeMatMulForH_1FMA(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId);
 void _AVX_MNNGeluFMA(float *dst, const float *src, size_t size, float* parameters);
 void _AVX_MNNExpC8FMA(float* dest, const float* source, float* offset, const float* parameters, size_t countC8);
+void _AVX_MNNScaleMaskSoftmaxFMA(float* dest, const float* source, const float* mask, float scale, size_t size);
+void _AVX_MNNErfFMA(float* dst, const float* src, size_t size);
+void _AVX_MNNErfcFMA(float* dst, const float* src, size_t size);
+void _AVX_MNNGeluStandardFMA(float* dst, const float* src, size_t size);
+void _AVX_MNNSiLUFMA(float* dst, const float* src, size_t size);
 void _AVX_MNNPackedSparseMatMulEpx1NFMA(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, const float* postParameters, const float* bias, unsigned int* NNZMap, int* dataOffsetMap);
 void _AVX_MNNPackedSparseMatMulEpx4NFMA(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, const float* postParameters, const float* bias, unsigned int* NNZMap, int* dataOffsetMap);
 
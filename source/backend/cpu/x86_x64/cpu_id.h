@@ -45,6 +45,8 @@ static const int kCpuHasAVX512VBMI2 = 0x40000;
 static const int kCpuHasAVX512VBITALG = 0x80000;
 static const int kCpuHasAVX512VPOPCNTDQ = 0x100000;
 static const int kCpuHasAVX512VNNI = 0x200000;
+static const int kCpuHasAVXVNNI = 0x400000;
+static const int kCpuHasAVX512BF16 = 0x800000;
 
 // These flags are only valid on MIPS processors.
 static const int kCpuHasMIPS = 0x200000;
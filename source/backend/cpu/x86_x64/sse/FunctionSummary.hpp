@@ -83,6 +83,11 @@ void _SSE_MNNInt8ToInt16(int16_t* dest, const int8_t* source, size_t count);
 void _SSE_MNNPackForMatMul_B_BF16(float* dest, const float* source, size_t h, size_t l, bool transpose);
 void _SSE_MNNReluInt8(int8_t* dst, const int8_t* src, size_t size, ssize_t zeroPoint);
 void _SSE_MNNSoftmax(float* dest, const float* source, size_t size);
+void _SSE_MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size);
+void _SSE_MNNErf(float* dst, const float* src, size_t size);
+void _SSE_MNNErfc(float* dst, const float* src, size_t size);
+void _SSE_MNNGeluStandard(float* dst, const float* src, size_t size);
+void _SSE_MNNSiLU(float* dst, const float* src, size_t size);
 void _SSE_ExtraInit(void* functions);
 void _SSE_MNNNorm(float *dst, const float *src, const float *gamma, const float *beta, float epsilon, size_t size, bool RMSNorm);
 void _SSE_ImageProcessInit(void* functions, int cpuFlags);
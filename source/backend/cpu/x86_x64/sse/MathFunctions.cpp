@@ -10,6 +10,7 @@
 #include <string.h>
 #include <algorithm>
 #include <math.h>
+#include <float.h>
 #include "core/Macro.h"
 #include "FunctionSummary.hpp"
 
@@ -333,3 +334,209 @@ void _SSE_MNNReluWithSlopeChannelInt8(int8_t* dst, const int8_t* src, const floa
     }
 }
 
+static inline __m128 _SSE_MNNExpPoly(__m128 x) {
+    // exp(x) = 2^n * exp(r), n = round(x / ln2), r = x - n * ln2
+    x = _mm_max_ps(x, _mm_set1_ps(-87.0f));
+    x = _mm_min_ps(x, _mm_set1_ps(87.0f));
+    auto div     = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.4426950408889634f)));
+    auto t       = _mm_sub_ps(x, _mm_mul_ps(_mm_cvtepi32_ps(div), _mm_set1_ps(0.6931471805599453f)));
+    auto expBasic = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(div, _mm_set1_epi32(127)), 23));
+    auto c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.0f / 120), t), _mm_set1_ps(1.0f / 24));
+    c = _mm_add_ps(_mm_mul_ps(c, t), _mm_set1_ps(1.0f / 6));
+    c = _mm_add_ps(_mm_mul_ps(c, t), _mm_set1_ps(0.5f));
+    c = _mm_add_ps(_mm_mul_ps(c, t), _mm_set1_ps(1.0f));
+    c = _mm_add_ps(_mm_mul_ps(c, t), _mm_set1_ps(1.0f));
+    return _mm_mul_ps(expBasic, c);
+}
+
+void _SSE_MNNScaleMaskSoftmax(float* dest, const float* source, const float* mask, float scale, size_t size) {
+    int count  = static_cast<int32_t>(size / 4);
+    int remain = static_cast<int32_t>(size % 4);
+    float temp[4];
+    // step 1: y = x * scale + mask, and get max(y)
+    auto scaleVal = _mm_set1_ps(scale);
+    auto maxVal   = _mm_set1_ps(-FLT_MAX);
+    for (int i = 0; i < count; ++i) {
+        auto y = _mm_mul_ps(_mm_loadu_ps(source + 4 * i), scaleVal);
+        if (nullptr != mask) {
+            y = _mm_add_ps(y, _mm_loadu_ps(mask + 4 * i));
+        }
+        maxVal = _mm_max_ps(maxVal, y);
+        _mm_storeu_ps(dest + 4 * i, y);
+    }
+    _mm_storeu_ps(temp, maxVal);
+    float maxValue = ALIMAX(ALIMAX(temp[0], temp[1]), ALIMAX(temp[2], temp[3]));
+    for (int i = count * 4; i < size; ++i) {
+        auto y = source[i] * scale;
+        if (nullptr != mask) {
+            y += mask[i];
+        }
+        dest[i]  = y;
+        maxValue = ALIMAX(maxValue, y);
+    }
+    // step 2: exp(y - max) and sum
+    auto maxVec = _mm_set1_ps(maxValue);
+    auto sumVal = _mm_setzero_ps();
+    for (int i = 0; i < count; ++i) {
+        auto e = _SSE_MNNExpPoly(_mm_sub_ps(_mm_loadu_ps(dest + 4 * i), maxVec));
+        sumVal = _mm_add_ps(sumVal, e);
+        _mm_storeu_ps(dest + 4 * i, e);
+    }
+    _mm_storeu_ps(temp, sumVal);
+    float sumValue = temp[0] + temp[1] + temp[2] + temp[3];
+    if (remain > 0) {
+        auto tail = dest + count * 4;
+        for (int i = 0; i < 4; ++i) {
+            temp[i] = i < remain ? tail[i] : maxValue;
+        }
+        _mm_storeu_ps(temp, _SSE_MNNExpPoly(_mm_sub_ps(_mm_loadu_ps(temp), maxVec)));
+        for (int i = 0; i < remain; ++i) {
+            tail[i] = temp[i];
+            sumValue += temp[i];
+        }
+    }
+    // step 3: normalize
+    float recValue = 1.0f / sumValue;
+    auto recVal = _mm_set1_ps(recValue);
+    for (int i = 0; i < count; ++i) {
+        _mm_storeu_ps(dest + 4 * i, _mm_mul_ps(_mm_loadu_ps(dest + 4 * i), recVal));
+    }
+    for (int i = count * 4; i < size; ++i) {
+        dest[i] *= recValue;
+    }
+}
+
+static inline __m128 _SSE_MNNSelect(__m128 mask, __m128 a, __m128 b) {
+    // mask ? a : b
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// x * x - hi for hi = x * x, by Dekker's split
+static inline __m128 _SSE_MNNSquareError(__m128 x, __m128 hi) {
+    auto c  = _mm_mul_ps(x, _mm_set1_ps(4097.0f));
+    auto xh = _mm_sub_ps(c, _mm_sub_ps(c, x));
+    auto xl = _mm_sub_ps(x, xh);
+    auto e  = _mm_sub_ps(_mm_mul_ps(xh, xh), hi);
+    e = _mm_add_ps(e, _mm_mul_ps(_mm_add_ps(xh, xh), xl));
+    return _mm_add_ps(e, _mm_mul_ps(xl, xl));
+}
+
+// exp(hi + lo) for hi + lo <= 0 and lo is the rounding error of hi, 0 for underflow
+static inline __m128 _SSE_MNNExpAccurate(__m128 hi, __m128 lo) {
+    auto x     = _mm_add_ps(hi, lo);
+    auto valid = _mm_cmpge_ps(x, _mm_set1_ps(-87.0f));
+    auto ni    = _mm_cvtps_epi32(_mm_mul_ps(_mm_max_ps(x, _mm_set1_ps(-87.0f)), _mm_set1_ps(1.44269504088896341f)));
+    auto n     = _mm_cvtepi32_ps(ni);
+    // Cody-Waite reduction, n * ln2Hi is exact
+    auto t = _mm_sub_ps(hi, _mm_mul_ps(n, _mm_set1_ps(0.693359375f)));
+    t = _mm_sub_ps(t, _mm_mul_ps(n, _mm_set1_ps(-2.12194440e-4f)));
+    t = _mm_add_ps(t, lo);
+    auto p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.0f / 5040), t), _mm_set1_ps(1.0f / 720));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 120));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 24));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 6));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(0.5f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f));
+    auto scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(ni, _mm_set1_epi32(127)), 23));
+    return _mm_and_ps(_mm_mul_ps(p, scale), valid);
+}
+
+// erfc(z) for 0 <= z <= 10, -z * z = hi + lo
+static inline __m128 _SSE_MNNErfcPositive(__m128 z, __m128 hi, __m128 lo) {
+    auto t = _mm_div_ps(_mm_set1_ps(1.0f), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.5f), z), _mm_set1_ps(1.0f)));
+    auto q = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.17087277f), t), _mm_set1_ps(-0.82215223f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(1.48851587f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(-1.13520398f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(0.27886807f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(-0.18628806f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(0.09678418f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(0.37409196f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(1.00002368f));
+    q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(-1.26551223f));
+    return _mm_mul_ps(t, _SSE_MNNExpAccurate(hi, _mm_add_ps(lo, q)));
+}
+
+// erf(x) for |x| < 0.5 by taylor series
+static inline __m128 _SSE_MNNErfSmall(__m128 x) {
+    auto x2 = _mm_mul_ps(x, x);
+    auto p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.20553330e-4f), x2), _mm_set1_ps(-8.54832702e-4f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(5.22397763e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-2.68661706e-2f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.12837917e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-3.76126389e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.12837917f));
+    return _mm_mul_ps(p, x);
+}
+
+static inline __m128 _SSE_MNNErfUnit(__m128 x, bool complement) {
+    auto signMask = _mm_set1_ps(-0.0f);
+    auto z  = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(10.0f));
+    auto hi = _mm_mul_ps(z, z);
+    auto lo = _SSE_MNNSquareError(z, hi);
+    auto e  = _SSE_MNNErfcPositive(z, _mm_xor_ps(hi, signMask), _mm_xor_ps(lo, signMask));
+    auto small    = _SSE_MNNErfSmall(x);
+    auto isSmall  = _mm_cmplt_ps(z, _mm_set1_ps(0.5f));
+    auto positive = _mm_cmpge_ps(x, _mm_setzero_ps());
+    if (complement) {
+        auto large = _SSE_MNNSelect(positive, e, _mm_sub_ps(_mm_set1_ps(2.0f), e));
+        return _SSE_MNNSelect(isSmall, _mm_sub_ps(_mm_set1_ps(1.0f), small), large);
+    }
+    auto large = _mm_or_ps(_mm_sub_ps(_mm_set1_ps(1.0f), e), _mm_and_ps(x, signMask));
+    return _SSE_MNNSelect(isSmall, small, large);
+}
+
+static inline __m128 _SSE_MNNGeluStandardUnit(__m128 x) {
+    auto signMask = _mm_set1_ps(-0.0f);
+    // 0.5 * erfc(|x| / sqrt(2)), the exponent -x * x / 2 is split exactly
+    auto ax = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(14.0f));
+    auto z  = _mm_mul_ps(ax, _mm_set1_ps(0.707106781f));
+    auto hi = _mm_mul_ps(ax, ax);
+    auto lo = _SSE_MNNSquareError(ax, hi);
+    auto half = _mm_set1_ps(-0.5f);
+    auto e   = _mm_mul_ps(_mm_set1_ps(0.5f), _SSE_MNNErfcPositive(z, _mm_mul_ps(hi, half), _mm_mul_ps(lo, half)));
+    auto phi = _SSE_MNNSelect(_mm_cmpge_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(1.0f), e), e);
+    auto small = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.5f), _SSE_MNNErfSmall(_mm_mul_ps(x, _mm_set1_ps(0.707106781f)))), _mm_set1_ps(0.5f));
+    phi = _SSE_MNNSelect(_mm_cmplt_ps(z, _mm_set1_ps(0.5f)), small, phi);
+    return _mm_mul_ps(x, phi);
+}
+
+static inline __m128 _SSE_MNNSiLUUnit(__m128 x) {
+    // sigmoid(x) = 1 / (1 + e) for x >= 0 and e / (1 + e) for x < 0, e = exp(-|x|)
+    auto e = _SSE_MNNExpAccurate(_mm_or_ps(x, _mm_set1_ps(-0.0f)), _mm_setzero_ps());
+    auto r = _mm_div_ps(_mm_set1_ps(1.0f), _mm_add_ps(_mm_set1_ps(1.0f), e));
+    auto s = _SSE_MNNSelect(_mm_cmpge_ps(x, _mm_setzero_ps()), r, _mm_mul_ps(e, r));
+    return _mm_mul_ps(x, s);
+}
+
+// Apply the activation for 4 elements at a time, the tail is padded
+template<typename Unit>
+static inline void _SSE_MNNActivation(float* dst, const float* src, size_t size, Unit unit) {
+    size_t count = size / 4;
+    for (size_t i = 0; i < count; ++i) {
+        _mm_storeu_ps(dst + 4 * i, unit(_mm_loadu_ps(src + 4 * i)));
+    }
+    size_t remain = size % 4;
+    if (remain > 0) {
+        float temp[4] = {0.0f};
+        ::memcpy(temp, src + 4 * count, remain * sizeof(float));
+        _mm_storeu_ps(temp, unit(_mm_loadu_ps(temp)));
+        ::memcpy(dst + 4 * count, temp, remain * sizeof(float));
+    }
+}
+
+void _SSE_MNNErf(float* dst, const float* src, size_t size) {
+    _SSE_MNNActivation(dst, src, size, [](__m128 x) { return _SSE_MNNErfUnit(x, false); });
+}
+
+void _SSE_MNNErfc(float* dst, const float* src, size_t size) {
+    _SSE_MNNActivation(dst, src, size, [](__m128 x) { return _SSE_MNNErfUnit(x, true); });
+}
+
+void _SSE_MNNGeluStandard(float* dst, const float* src, size_t size) {
+    _SSE_MNNActivation(dst, src, size, _SSE_MNNGeluStandardUnit);
+}
+
+void _SSE_MNNSiLU(float* dst, const float* src, size_t size) {
+    _SSE_MNNActivation(dst, src, size, _SSE_MNNSiLUUnit);
+}
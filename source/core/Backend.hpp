@@ -210,6 +210,21 @@ public:
         return 0;
     }
 
+    /**
+     * @brief measure the dynamic memory (activation arena) allocated by this backend in MB
+     */
+    virtual float onGetDynamicMemoryInMB() const {
+        return 0.0f;
+    }
+
+    /**
+     * @brief get statistic of the dynamic memory, the peak is counted from the last call with resetPeak
+     * @return false if not supported
+     */
+    virtual bool onGetDynamicMemoryStatistic(BufferAllocator::Statistic& statistic, bool resetPeak) {
+        return false;
+    }
+
 private:
     const MNNForwardType mType;
 };
@@ -245,6 +260,30 @@ public:
         mAllocatorType = static_cast<AllocatorType>(type);
     }
 
+    void setWeightPackMode(int mode) {
+        mWeightPackMode = mode;
+    }
+
+    int getWeightPackMode() const {
+        return mWeightPackMode;
+    }
+
+    void setKernelTuning(int mode) {
+        mKernelTuning = mode;
+    }
+
+    int getKernelTuning() const {
+        return mKernelTuning;
+    }
+
+    void setDynamicQuant(int mode) {
+        mDynamicQuant = mode;
+    }
+
+    int getDynamicQuant() const {
+        return mDynamicQuant;
+    }
+
     AllocatorType getAllocatorType() const {
         return mAllocatorType;
     }
@@ -273,6 +312,14 @@ public:
         return 0.0f;
     }
 
+    /**
+     @brief Get statistic of the memory allocated by runtime, including weights and the dynamic memory allocated from it
+     @return false if not supported
+     */
+    virtual bool onGetMemoryStatistic(BufferAllocator::Statistic& statistic) const {
+        return false;
+    }
+
     // If buffer is not nullptr, try copy cache, else delete cache
     virtual bool onSetCache(const void* buffer, size_t size) {
         //default cache valid, avoid being reset
@@ -321,6 +368,9 @@ private:
     std::future<int> mFuture;
     AllocatorType mAllocatorType = Allocator_Eager;
     int mWinogradMemoryLevel = 3;
+    int mWeightPackMode = 0;
+    int mKernelTuning = 0;
+    int mDynamicQuant = 0;
 };
 
 /** abstract Runtime register */
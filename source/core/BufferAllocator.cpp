@@ -75,6 +75,21 @@ private:
 ErrorCode BufferAllocator::compute() {
     return NO_ERROR;
 }
+void BufferAllocator::getStatistic(Statistic& statistic) const {
+    statistic.totalBytes = totalSize();
+    statistic.usedBytes = mUsedSize;
+    statistic.peakUsedBytes = mPeakUsedSize;
+    statistic.freeBytes = 0;
+    statistic.largestFreeBytes = 0;
+}
+void BufferAllocator::onUse(size_t size) {
+    mUsedSize += size;
+    mPeakUsedSize = ALIMAX(mPeakUsedSize, mUsedSize);
+}
+void BufferAllocator::onUnuse(size_t size) {
+    MNN_ASSERT(mUsedSize >= size);
+    mUsedSize = mUsedSize >= size ? mUsedSize - size : 0;
+}
 std::shared_ptr<BufferAllocator::Allocator> BufferAllocator::Allocator::createDefault() {
     std::shared_ptr<BufferAllocator::Allocator> _res;
     _res.reset(new DefaultAllocator);
@@ -105,11 +120,11 @@ MemChunk EagerBufferAllocator::alloc(size_t size, bool separate, size_t align) {
         if (nullptr != mCurrentFreeList) {
             pointer = getFromFreeList(mCurrentFreeList, size, false, align);
         }
-        if (nullptr != pointer.first) {
-            return MemChunk(pointer);
+        if (nullptr == pointer.first) {
+            pointer = getFromFreeList(&mFreeList, size, true, align);
         }
-        pointer = getFromFreeList(&mFreeList, size, true, align);
         if (nullptr != pointer.first) {
+            onUse(mUsedList[pointer]->size);
             return MemChunk(pointer);
         }
     }
@@ -129,6 +144,7 @@ MemChunk EagerBufferAllocator::alloc(size_t size, bool separate, size_t align) {
     node->pointer      = pointer;
     mUsedList[pointer] = node;
     node->outside      = mAllocator.get();
+    onUse(size);
     MNN_ASSERT(pointer.second % align == 0);
 #ifdef DUMP_USAGE
     MNN_PRINT("mTotalSize: %f\n", mTotalSize / 1024.0f / 1024.0f);
@@ -179,6 +195,7 @@ bool EagerBufferAllocator::free(MemChunk chunk) {
     // mark as reusable
     auto node = x->second;
     mUsedList.erase(x);
+    onUnuse(node->size);
     if (nullptr != mCurrentFreeList) {
         returnMemory(mCurrentFreeList, node, false);
     } else {
@@ -199,6 +216,8 @@ void EagerBufferAllocator::release(bool allRelease) {
         mUsedList.clear();
         mFreeList.clear();
         mTotalSize = 0;
+        mUsedSize = 0;
+        mPeakUsedSize = 0;
         return;
     }
     for (auto f : mFreeList) {
@@ -210,6 +229,20 @@ void EagerBufferAllocator::release(bool allRelease) {
     mFreeList.clear();
 }
 
+void EagerBufferAllocator::getStatistic(Statistic& statistic) const {
+    BufferAllocator::getStatistic(statistic);
+    auto collect = [&statistic](const FREELIST& list) {
+        for (auto& iter : list) {
+            statistic.freeBytes += iter.first;
+            statistic.largestFreeBytes = ALIMAX(statistic.largestFreeBytes, iter.first);
+        }
+    };
+    collect(mFreeList);
+    for (auto& group : mGroups) {
+        collect(*group);
+    }
+}
+
 void EagerBufferAllocator::barrierBegin() {
     MNN_ASSERT(mGroups.empty());
 }
@@ -304,6 +337,7 @@ MemChunk DeferBufferAllocator::alloc(size_t size, bool separate, size_t align) {
     if (mFreeList.empty() || separate) {
         auto newChunk = createMemNode(size);
         insert_after(newChunk);
+        onUse(size);
 #ifdef DUMP_USAGE
     MNN_PRINT("Defer alloc: %p\n", newChunk);
 #endif
@@ -327,6 +361,7 @@ MemChunk DeferBufferAllocator::alloc(size_t size, bool separate, size_t align) {
     }
     // equal no change; small expand
     selectChunk->size = size;
+    onUse(size);
 #ifdef DUMP_USAGE
     MNN_PRINT("Defer alloc: %p\n", selectChunk);
 #endif
@@ -344,6 +379,7 @@ bool DeferBufferAllocator::free(MemChunk chunk) {
     if (!node) {
         return false;
     }
+    onUnuse(node->size);
     auto left = node->left;
     auto right = node->right;
     if (left && !left->usage) {
@@ -371,6 +407,14 @@ size_t DeferBufferAllocator::totalSize() const {
     return mTotalSize;
 }
 
+void DeferBufferAllocator::getStatistic(Statistic& statistic) const {
+    BufferAllocator::getStatistic(statistic);
+    for (auto& iter : mFreeList) {
+        statistic.freeBytes += iter.chunk->size;
+        statistic.largestFreeBytes = ALIMAX(statistic.largestFreeBytes, iter.chunk->size);
+    }
+}
+
 void DeferBufferAllocator::barrierBegin() {
     MNN_ASSERT(!mBarrrier);
     mBarrrier = true;
@@ -392,6 +436,8 @@ void DeferBufferAllocator::endGroup() {
 
 void DeferBufferAllocator::reset() {
     mTotalSize = 0;
+    mUsedSize = 0;
+    mPeakUsedSize = 0;
     mChunks.clear();
     mFreeList.clear();
     // mPtr.reset(nullptr);
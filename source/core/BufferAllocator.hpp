@@ -87,6 +87,16 @@ public:
         static std::shared_ptr<Allocator> createDefault();
         static std::shared_ptr<Allocator> createRecurse(BufferAllocator* parent);
     };
+    struct Statistic {
+        // Memory allocated from parent
+        size_t totalBytes = 0;
+        // Memory in use, and the max of it since the last resetPeak
+        size_t usedBytes = 0;
+        size_t peakUsedBytes = 0;
+        // Memory in free lists, and the largest block of them
+        size_t freeBytes = 0;
+        size_t largestFreeBytes = 0;
+    };
     BufferAllocator() = default;
     virtual ~BufferAllocator() = default;
     virtual MemChunk alloc(size_t size, bool separate = false, size_t align = 0) = 0;
@@ -99,6 +109,15 @@ public:
     virtual void endGroup() {}
     virtual void reset() {}
     virtual ErrorCode compute();
+    virtual void getStatistic(Statistic& statistic) const;
+    void resetPeak() {
+        mPeakUsedSize = mUsedSize;
+    }
+protected:
+    void onUse(size_t size);
+    void onUnuse(size_t size);
+    size_t mUsedSize = 0;
+    size_t mPeakUsedSize = 0;
 };
 
 
@@ -165,6 +184,7 @@ public:
     void barrierEnd() override;
     void beginGroup() override;
     void endGroup() override;
+    void getStatistic(Statistic& statistic) const override;
 
 private:
     class Node : public RefCount {
@@ -210,6 +230,7 @@ public:
     void endGroup() override;
     void reset() override;
     ErrorCode compute() override;
+    void getStatistic(Statistic& statistic) const override;
 private:
     std::vector<std::unique_ptr<MemNode>> mChunks;
     MemNode *mHead = nullptr, *mTail = nullptr;
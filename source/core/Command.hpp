@@ -29,6 +29,8 @@ struct Command {
     bool canVectorize = false;
     #endif
     int group = 0;
+    // Fused into the epilogue of another command, skipped on resize and execute
+    bool fused = false;
 };
 struct CommandBuffer {
     std::vector<std::shared_ptr<Command>> command;
@@ -12,14 +12,65 @@
 #include <MNN/MNNForwardType.h>
 #include <MNN/ErrorCode.hpp>
 #include <MNN/Tensor.hpp>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 #include "NonCopyable.hpp"
 
 namespace MNN {
 class Backend;
 struct Op;
 
+/** element-wise ops fused after convolution / matmul, applied in order: residual add, activation, quantize */
+struct Epilogue {
+    enum Activation {
+        NONE = 0,
+        // clamp to [minValue, maxValue]
+        CLAMP,
+        // UnaryOpOperation of unaryType
+        UNARY,
+        // x * sigmoid(x)
+        SILU,
+    };
+    // add the residual, which is appended to the inputs
+    bool residual = false;
+    Activation activation = NONE;
+    float minValue = -std::numeric_limits<float>::max();
+    float maxValue = std::numeric_limits<float>::max();
+    int unaryType = 0;
+    // quantize to int8 if not empty, the quantized tensor is appended to the outputs
+    std::vector<float> quantScale;
+    int quantZero = 0;
+    int quantMin = -128;
+    int quantMax = 127;
+
+    bool empty() const {
+        return !residual && NONE == activation && quantScale.empty();
+    }
+};
+
+/** element-wise ops fused before the execution: x * scale + mask for softmax of last axis, x + residual for normalization */
+struct Prologue {
+    enum Scale {
+        NONE = 0,
+        // multiply by the scalar tensor
+        MUL,
+        // divide by the scalar tensor
+        DIV,
+    };
+    // the scalar tensor is appended to the inputs
+    Scale scale = NONE;
+    // add the mask broadcast to the input, which is appended to the inputs after the scale
+    bool mask = false;
+    // add the residual tensor appended to the inputs, the sum is written to the second output if it exists
+    bool residual = false;
+
+    bool empty() const {
+        return NONE == scale && !mask && !residual;
+    }
+};
+
 /** abstract execution */
 class Execution : public NonCopyable {
 public:
@@ -63,6 +114,24 @@ public:
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) {
         return false;
     }
+
+    /**
+     * @brief fuse the element-wise ops after the execution, called before onResize
+     * @param epilogue the ops to fuse, empty epilogue to reset
+     * @return false if not support, then the ops are executed separately
+     */
+    virtual bool onSetEpilogue(const Epilogue& epilogue) {
+        return epilogue.empty();
+    }
+
+    /**
+     * @brief fuse the element-wise ops before the execution, called before onResize
+     * @param prologue the ops to fuse, empty prologue to reset
+     * @return false if not support, then the ops are executed separately
+     */
+    virtual bool onSetPrologue(const Prologue& prologue) {
+        return prologue.empty();
+    }
 public:
     /**
      * @brief designed for plugin system. not ready yet.
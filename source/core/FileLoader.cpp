@@ -9,6 +9,12 @@
 #include "core/FileLoader.hpp"
 #if defined(_MSC_VER)
 #include "Windows.h"
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MNN_FILE_MAPPER_POSIX
 #endif
 namespace MNN {
 static FILE* _OpenFile(const char* file) {
@@ -154,4 +160,79 @@ bool FileLoader::read(char* buffer, int64_t size) {
     return fread(buffer, 1, size, mFile) == size;
 }
 
+FileMapper::FileMapper(const char* file) {
+    if (nullptr == file || 0 == file[0]) {
+        return;
+    }
+#if defined(_MSC_VER)
+    wchar_t wFilename[1024];
+    if (0 == MultiByteToWideChar(CP_ACP, 0, file, -1, wFilename, sizeof(wFilename))) {
+        return;
+    }
+    auto handle = CreateFileW(wFilename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == handle) {
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || 0 == fileSize.QuadPart) {
+        CloseHandle(handle);
+        return;
+    }
+    auto mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (nullptr == mapping) {
+        CloseHandle(handle);
+        return;
+    }
+    auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (nullptr == data) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return;
+    }
+    mFile    = handle;
+    mMapping = mapping;
+    mData    = data;
+    mSize    = (size_t)fileSize.QuadPart;
+#elif defined(MNN_FILE_MAPPER_POSIX)
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (0 != fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return;
+    }
+    auto data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference of the file
+    close(fd);
+    if (MAP_FAILED == data) {
+        return;
+    }
+    mData = data;
+    mSize = (size_t)st.st_size;
+#endif
+}
+
+FileMapper::~FileMapper() {
+    if (nullptr == mData) {
+        return;
+    }
+#if defined(_MSC_VER)
+    UnmapViewOfFile(mData);
+    CloseHandle(mMapping);
+    CloseHandle(mFile);
+#elif defined(MNN_FILE_MAPPER_POSIX)
+    munmap(mData, mSize);
+#endif
+}
+
+bool FileMapper::contains(const void* ptr, size_t size) const {
+    if (nullptr == mData || nullptr == ptr) {
+        return false;
+    }
+    auto start = (const uint8_t*)ptr;
+    return start >= data() && size <= mSize && (size_t)(start - data()) <= mSize - size;
+}
+
 } // namespace MNN
@@ -44,5 +44,33 @@ private:
     std::string mFilePath;
     bool mInited = false;
 };
+
+/** Read-only mapping of a whole file, pages are loaded by os when first touched */
+class MNN_PUBLIC FileMapper {
+public:
+    FileMapper(const char* file);
+    ~FileMapper();
+    FileMapper(const FileMapper&) = delete;
+    FileMapper& operator=(const FileMapper&) = delete;
+
+    bool valid() const {
+        return nullptr != mData;
+    }
+    inline const uint8_t* data() const {
+        return (const uint8_t*)mData;
+    }
+    inline size_t size() const {
+        return mSize;
+    }
+    // Return true if [ptr, ptr + size) lies in the mapped memory
+    bool contains(const void* ptr, size_t size) const;
+private:
+    void* mData  = nullptr;
+    size_t mSize = 0;
+#if defined(_MSC_VER)
+    void* mFile    = nullptr;
+    void* mMapping = nullptr;
+#endif
+};
 } // namespace MNN
 #endif
@@ -29,6 +29,16 @@ namespace MNN {
 
 struct Content {
     AutoStorage<uint8_t> buffer;
+    // For createFromMappedFile: read-only mapping of the model, buffer is empty then
+    std::shared_ptr<FileMapper> mapper;
+    // Mapping of the external weight file shared by the sessions, created with the first one
+    std::shared_ptr<FileMapper> externalMapper;
+    const uint8_t* modelData() const {
+        return nullptr != mapper ? mapper->data() : buffer.get();
+    }
+    size_t modelSize() const {
+        return nullptr != mapper ? mapper->size() : buffer.size();
+    }
     const Net* net = nullptr;
     std::vector<std::unique_ptr<Session>> sessions;
     std::map<Tensor*, const Session*> tensorMap;
@@ -40,6 +50,15 @@ struct Content {
     std::string bizCode;
     std::string uuid;
     std::string externalFile;
+    // For Session_Const_Share: const tensors and the session whose packed weights are shared
+    std::shared_ptr<Schedule::ScheduleInfo> sharedConst;
+    const Session* sharedSession = nullptr;
+    // Keep the static memory of shared weights valid after sharedSession released
+    RuntimeInfo sharedRuntime;
+    // The config of sharedSession, a session is cloned from it only if the config matches
+    MNNForwardType sharedType = MNN_FORWARD_CPU;
+    int sharedNumThread = 0;
+    BackendConfig sharedBackendConfig;
 #ifdef MNN_INTERNAL_ENABLED
     std::map<std::string, std::string> basicLogginData;
     std::map<const Session*, std::tuple<int, int>> sessionInfo;
@@ -96,6 +115,21 @@ Interpreter* Interpreter::createFromFile(const char* file) {
 
     return createFromBufferInternal(net, true);
 }
+Interpreter* Interpreter::createFromMappedFile(const char* file) {
+    if (nullptr == file) {
+        MNN_PRINT("NULL file for create interpreter\n");
+        return nullptr;
+    }
+    std::shared_ptr<FileMapper> mapper(new FileMapper(file));
+    if (!mapper->valid()) {
+        MNN_PRINT("Map %s failed, load it by read\n", file);
+        return createFromFile(file);
+    }
+    auto net = new Content;
+    net->mapper = mapper;
+    net->externalFile = std::string(file) + ".weight";
+    return createFromBufferInternal(net, true);
+}
 Interpreter* Interpreter::createFromBuffer(const void* buffer, size_t size) {
     if (nullptr == buffer || 0 == size) {
         MNN_PRINT("Buffer is null for create interpreter\n");
@@ -118,14 +152,14 @@ Interpreter* Interpreter::createFromBufferInternal(Content* net, bool enforceAut
         return nullptr;
     }
 #ifndef MNN_BUILD_MINI
-    flatbuffers::Verifier verify((const uint8_t*)(net->buffer.get()), net->buffer.size());
+    flatbuffers::Verifier verify(net->modelData(), net->modelSize());
     if (false == VerifyNetBuffer(verify)) {
         MNN_PRINT("Invalidate buffer to create interpreter\n");
         delete net;
         return nullptr;
     }
 #endif
-    net->net = GetNet(net->buffer.get());
+    net->net = GetNet(net->modelData());
     if (nullptr == net->net->oplists()) {
         MNN_ERROR("Model has no oplist\n");
         delete net;
@@ -162,7 +196,7 @@ void Interpreter::setSessionMode(SessionMode mode) {
 }
 
 void Interpreter::setCacheFile(const char* cacheFile, size_t keySize) {
-    if (nullptr == cacheFile || nullptr == mNet->buffer.get()) {
+    if (nullptr == cacheFile || nullptr == mNet->modelData()) {
         MNN_ERROR("Empty cacheFile or the interpreter invalid\n");
         return;
     }
@@ -190,6 +224,7 @@ void Interpreter::setCacheFile(const char* cacheFile, size_t keySize) {
 
 void Interpreter::setExternalFile(const char* file, size_t flag) {
     mNet->externalFile = file;
+    mNet->externalMapper = nullptr;
 }
 
 ErrorCode Interpreter::updateCacheFile(Session *session, int flag) {
@@ -240,6 +275,9 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
     RuntimeInfo runtime = createRuntime(configs);
     runtime.second->setAllocatorType(mNet->modes.memoryAllocatorType);
     runtime.second->setWinogradMemoryLevel(mNet->modes.winogradMemoryUsed);
+    runtime.second->setWeightPackMode(mNet->modes.weightPackMode);
+    runtime.second->setKernelTuning(mNet->modes.cpuKernelTuning);
+    runtime.second->setDynamicQuant(mNet->modes.cpuDynamicQuant);
     if (runtime.first.empty()) {
         MNN_ERROR("Runtime not valid for create session\n");
         return nullptr;
@@ -247,8 +285,37 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
     return createMultiPathSession(configs, std::move(runtime));
 }
 
+static BackendConfig _getBackendConfig(const ScheduleConfig& config) {
+    if (nullptr == config.backendConfig) {
+        return BackendConfig();
+    }
+    return *config.backendConfig;
+}
+
+// Only the session created by one config without extra output / path can be cloned
+static bool _isSimpleConfig(const std::vector<ScheduleConfig>& configs) {
+    if (configs.size() != 1) {
+        return false;
+    }
+    auto& config = configs[0];
+    return config.saveTensors.empty() && config.path.inputs.empty() && config.path.outputs.empty();
+}
+
+static bool _canShareSession(const Content* net, const std::vector<ScheduleConfig>& configs) {
+    if (!_isSimpleConfig(configs)) {
+        return false;
+    }
+    // The clone reuses the executions of sharedSession, so the runtime must be created with the same config
+    auto& config = configs[0];
+    auto backendConfig = _getBackendConfig(config);
+    return Schedule::getApprociateType(config) == net->sharedType && config.numThread == net->sharedNumThread
+        && backendConfig.precision == net->sharedBackendConfig.precision
+        && backendConfig.memory == net->sharedBackendConfig.memory
+        && backendConfig.power == net->sharedBackendConfig.power;
+}
+
 Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>& configs, const RuntimeInfo& runtime) {
-    if (nullptr == mNet->buffer.get()) {
+    if (nullptr == mNet->modelData()) {
         MNN_ERROR("The model buffer has been released. Can't create session\n");
         return nullptr;
     }
@@ -261,12 +328,49 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
     Timer _timer;
 #endif
     int cacheMode = 0; // No cache
+    bool shareConst = mNet->modes.constMode == Session_Const_Share;
+    if (shareConst && nullptr != mNet->sharedSession && _canShareSession(mNet, configs)) {
+        // Clone the executions of shared session, packed weights are referenced instead of recomputed
+        RuntimeInfo rt = runtime;
+        std::unique_ptr<Session> newSession(const_cast<Session*>(mNet->sharedSession)->clone(std::move(rt), mNet->sharedConst));
+        if (newSession->valid()) {
+            auto result = newSession.get();
+            if (mNet->modes.inputMode == Session_Input_Inside && mNet->modes.resizeMode == Session_Resize_Direct) {
+                result->resize();
+            }
+            mNet->sessions.emplace_back(std::move(newSession));
+            return result;
+        }
+    }
     Schedule::ScheduleInfo info;
     info.externalWeightPath = mNet->externalFile;
+    if (nullptr != mNet->mapper) {
+        info.modelMapper = mNet->mapper;
+        if (nullptr == mNet->externalMapper) {
+            mNet->externalMapper.reset(new FileMapper(mNet->externalFile.c_str()));
+        }
+        if (mNet->externalMapper->valid()) {
+            info.externalMapper = mNet->externalMapper;
+        }
+    }
+    if (shareConst && nullptr != mNet->sharedConst) {
+        info.defaultBackend = mNet->sharedConst->defaultBackend;
+        info.allTensors = mNet->sharedConst->allTensors;
+    }
     auto success = Schedule::schedule(info, mNet->net, configs, runtime);
     if (!success) {
         return nullptr;
     }
+    if (shareConst && nullptr == mNet->sharedConst) {
+        mNet->sharedConst.reset(new Schedule::ScheduleInfo);
+        mNet->sharedConst->defaultBackend = info.defaultBackend;
+        mNet->sharedConst->allTensors.resize(info.allTensors.size());
+        for (int i = 0; i < info.allTensors.size(); ++i) {
+            if (TensorUtils::getDescribe(info.allTensors[i].get())->usage == Tensor::InsideDescribe::CONSTANT) {
+                mNet->sharedConst->allTensors[i] = info.allTensors[i];
+            }
+        }
+    }
     RuntimeInfo rt = runtime;
     bool valid  = false;
     if (mNet->cacheBuffer.get() != nullptr) {
@@ -312,6 +416,13 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
     // Reset cache
     result->loadCache(nullptr, 0);
 
+    if (shareConst && nullptr == mNet->sharedSession && result->canClone() && _isSimpleConfig(configs)) {
+        mNet->sharedSession = result;
+        mNet->sharedRuntime = runtime;
+        mNet->sharedType = Schedule::getApprociateType(configs[0]);
+        mNet->sharedNumThread = configs[0].numThread;
+        mNet->sharedBackendConfig = _getBackendConfig(configs[0]);
+    }
     mNet->sessions.emplace_back(std::move(newSession));
 
 #ifdef MNN_INTERNAL_ENABLED
@@ -330,7 +441,7 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
         metrics.emplace("Mode", std::to_string(mode));
         metrics.emplace("Cache", std::to_string(cacheMode));
         metrics.emplace("CacheSize", std::to_string((float)(mNet->lastCacheSize / 1024.0f)));
-        metrics.emplace("ModelSize", std::to_string ((float)mNet->buffer.size() / 1024.0f / 1024.0f));
+        metrics.emplace("ModelSize", std::to_string ((float)mNet->modelSize() / 1024.0f / 1024.0f));
         metrics.emplace("Usage", std::to_string((int) mNet->net->usage()));
         metrics.emplace("API", "Interpreter::createMultiPathSession");
         logAsync(metrics);
@@ -361,6 +472,9 @@ bool Interpreter::releaseSession(Session* session) {
         }
 
         if ((*iter).get() == session) {
+            if (mNet->sharedSession == session) {
+                mNet->sharedSession = nullptr;
+            }
             mNet->sessions.erase(iter);
             return true;
         }
@@ -453,7 +567,7 @@ void Interpreter::resizeSession(Session* session) {
 
 void Interpreter::resizeSession(Session* session, int needRelloc) {
     std::unique_lock<std::mutex> _l(mNet->lock);
-    if (mNet->buffer.get() == nullptr) {
+    if (mNet->modelData() == nullptr) {
         MNN_ERROR("The model buffer has been released. Can't resize session\n");
         return;
     }
@@ -513,8 +627,10 @@ void Interpreter::releaseModel() {
     for (auto& session : mNet->sessions) {
         session->waitAsyncResize();
     }
-    if (mNet->buffer.get() != nullptr && mNet->net->usage() != Usage_INFERENCE_STATIC) {
+    if (mNet->modelData() != nullptr && mNet->net->usage() != Usage_INFERENCE_STATIC && 0 == mNet->modes.weightPackMode) {
         mNet->buffer.release();
+        // Const tensors aliasing the mapping hold their own reference
+        mNet->mapper = nullptr;
     }
     mNet->cacheBuffer.release();
 }
@@ -565,14 +681,18 @@ const char* Interpreter::uuid() const {
 }
 
 std::pair<const void*, size_t> Interpreter::getModelBuffer() const {
-    return std::make_pair(mNet->buffer.get(), mNet->buffer.size());
+    return std::make_pair(mNet->modelData(), mNet->modelSize());
 }
 ErrorCode Interpreter::updateSessionToModel(Session* session) {
     std::unique_lock<std::mutex> _l(mNet->lock);
-    if (mNet->buffer.get() == nullptr) {
+    if (mNet->modelData() == nullptr) {
         MNN_ERROR("Can't updateSessionToModel because you called releaseModel before\n");
         return INPUT_DATA_ERROR;
     }
+    if (nullptr != mNet->mapper) {
+        MNN_ERROR("Can't updateSessionToModel for read-only mapped model\n");
+        return NOT_SUPPORT;
+    }
     return session->updateToModel((Net*)mNet->net);
 }
 
@@ -700,6 +700,12 @@ Execution* OpCommonUtils::createExecutionWithExternal(Backend* backend, const st
         execution->onClone(backend, op, &copyExe);
         if (nullptr != copyExe) {
             delete execution;
+            auto runtime = backend->getRuntime();
+            if (nullptr != runtime && 0 != runtime->getWeightPackMode()) {
+                // The lazy packed weight still refers to the rebuilt op
+                tmpstore.reset(new BufferStorage);
+                tmpstore->storage = builder.ReleaseRaw(tmpstore->allocated_size, tmpstore->offset);
+            }
             return copyExe;
         } else {
 #ifdef DEBUG
@@ -12,9 +12,14 @@
 #include "core/Macro.h"
 #include "core/TensorUtils.hpp"
 #include "core/WrapExecution.hpp"
+#include "core/TraceBuffer.hpp"
 #include "geometry/GeometryComputerUtils.hpp"
 #include "shape/SizeComputer.hpp"
 #include "core/OpCommonUtils.hpp"
+#include "backend/cpu/CPUBackend.hpp"
+#include <algorithm>
+#include <atomic>
+#include <set>
 
 // TODO: Find better way for debug
 //#define MNN_OP_SEPERATE
@@ -178,6 +183,16 @@ static bool _allocTensor(Tensor* t, Backend* curBackend, bool outputStatic, int
     return true;
 }
 
+static std::string _commandName(const Command& cmd) {
+    if (nullptr != cmd.info.get()) {
+        return cmd.info->name();
+    }
+    if (nullptr != cmd.op->name()) {
+        return cmd.op->name()->str();
+    }
+    return EnumNameOpType(cmd.op->type());
+}
+
 void Pipeline::UnitInfo::setUp(const Command& command, int index, const Op* originOp, int totalIndex) {
     if (nullptr != command.op->name()) {
         mContent->name = command.op->name()->str();
@@ -245,6 +260,9 @@ Pipeline::Pipeline(const std::string& externalFile, Schedule::PipelineInfo&& inf
 
 }
 ErrorCode Pipeline::encode(bool supportDebug, bool permitCodegen) {
+    mParallelStages.clear();
+    // The fused commands are not executed, so don't fuse for debug callback
+    mFuseEpilogue = !supportDebug;
     auto& mBackend = mInfo.first.cache.first;
     auto& mBackupBackend = mInfo.first.cache.second;
     // Static Model just copy info to command buffer
@@ -582,7 +600,19 @@ void Pipeline::_pushTuningTask(std::vector<Schedule::OpCacheInfo>&& initInfos) {
     const_cast<Runtime*>(mRuntime)->setAsyncWork(std::move(future));
 }
 
-static ErrorCode _createExecutions(Schedule::PipelineInfo& mInfo, const std::string& externalFile, std::vector<std::shared_ptr<BufferStorage>>& extraStorage) {
+// Static memory in use of the runtimes, 0 if they don't support memory statistic
+static size_t _staticUsedBytes(const std::vector<const Runtime*>& runtimes) {
+    size_t bytes = 0;
+    BufferAllocator::Statistic statistic;
+    for (auto rt : runtimes) {
+        if (rt->onGetMemoryStatistic(statistic)) {
+            bytes += statistic.usedBytes;
+        }
+    }
+    return bytes;
+}
+
+static ErrorCode _createExecutions(Schedule::PipelineInfo& mInfo, const std::string& externalFile, std::vector<std::shared_ptr<BufferStorage>>& extraStorage, const std::vector<const Runtime*>& runtimes, std::map<const Execution*, size_t>& staticBytes) {
     FileLoader loader(externalFile.c_str());
     auto& mBackend = mInfo.first.cache.first;
     auto& mBackupBackend = mInfo.first.cache.second;
@@ -609,6 +639,8 @@ static ErrorCode _createExecutions(Schedule::PipelineInfo& mInfo, const std::str
                 }
             }
             std::shared_ptr<BufferStorage> tmpStorage;
+            bool create = nullptr == iter.execution;
+            size_t staticBytesBefore = create ? _staticUsedBytes(runtimes) : 0;
             if (nullptr == iter.execution) {
                 iter.execution.reset(OpCommonUtils::createExecutionWithExternal(mBackend.get(), iter.inputs, iter.outputs, iter.op, &loader, tmpStorage));
             }
@@ -631,11 +663,32 @@ static ErrorCode _createExecutions(Schedule::PipelineInfo& mInfo, const std::str
                 iter.execution = nullptr;
                 return OUT_OF_MEMORY;
             }
+            if (create) {
+                auto staticBytesAfter = _staticUsedBytes(runtimes);
+                if (staticBytesAfter > staticBytesBefore) {
+                    staticBytes[iter.execution.get()] = staticBytesAfter - staticBytesBefore;
+                } else {
+                    staticBytes.erase(iter.execution.get());
+                }
+            }
             if ((!cached) && iter.buffer == nullptr && (iter.op->type() != OpType_Raster) && (iter.op->type() != OpType_BinaryOp)) {
                 info.executionCache.insert(std::make_pair(iter.op, iter.execution));
             }
         }
     }
+    if (!staticBytes.empty()) {
+        // Remove the records of released executions
+        std::map<const Execution*, size_t> aliveBytes;
+        for (auto& info : mInfo.second) {
+            for (auto& iterP : info.executeBuffer.command) {
+                auto record = staticBytes.find(iterP->execution.get());
+                if (record != staticBytes.end()) {
+                    aliveBytes.insert(*record);
+                }
+            }
+        }
+        staticBytes = std::move(aliveBytes);
+    }
     return NO_ERROR;
 }
 static void _SetTensorBackend(Schedule::PipelineInfo& mInfo, bool ownInputs) {
@@ -866,13 +919,13 @@ static ErrorCode _InsertCopy(Schedule::PipelineInfo& mInfo, std::map<Tensor*, st
 void Pipeline::_recycleDynamicMemory(Command* command) {
     for (auto& t : command->workOutputs) {
         auto memoryType = _getTensorStorageType(t, mOutputStatic);
-        if (Backend::DYNAMIC == memoryType) {
+        if (Backend::DYNAMIC == memoryType && TensorUtils::getDescribe(t)->memoryType != Tensor::InsideDescribe::MEMORY_OUTSIDE) {
             TensorUtils::getDescribeOrigin(t)->mem = nullptr;
         }
     }
     for (auto& t : command->workInputs) {
         auto memoryType = _getTensorStorageType(t, mOutputStatic);
-        if (Backend::DYNAMIC == memoryType) {
+        if (Backend::DYNAMIC == memoryType && TensorUtils::getDescribe(t)->memoryType != Tensor::InsideDescribe::MEMORY_OUTSIDE) {
             TensorUtils::getDescribeOrigin(t)->mem = nullptr;
         }
     }
@@ -949,6 +1002,576 @@ ErrorCode Pipeline::fixResizeCache() {
     MNN_PRINT("Fix: %d - Total: %d, rate = %f\n", fixNumber, totalNumber, (float)fixNumber / (float)totalNumber);
     return NO_ERROR;
 }
+// The backends of MNN_FORWARD_CPU and MNN_FORWARD_CPU_EXTENSION are all CPUBackend, nullptr for others
+static CPUBackend* _getCPUBackend(Backend* bn) {
+    if (nullptr == bn || (bn->type() != MNN_FORWARD_CPU && bn->type() != MNN_FORWARD_CPU_EXTENSION)) {
+        return nullptr;
+    }
+    return static_cast<CPUBackend*>(bn);
+}
+
+bool Pipeline::_supportInterOpParallel() const {
+    if (mInterOpParallel < 2) {
+        return false;
+    }
+    return nullptr != _getCPUBackend(mInfo.first.cache.first.get()) && nullptr != _getCPUBackend(mInfo.first.cache.second.get());
+}
+
+static void _collectRealDescribe(const Tensor* t, std::vector<const Tensor::InsideDescribe::NativeInsideDescribe*>& result) {
+    auto des = TensorUtils::getDescribe(t);
+    if (des->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+        for (auto& reg : des->regions) {
+            _collectRealDescribe(reg.origin, result);
+        }
+        return;
+    }
+    result.emplace_back(des);
+}
+
+static bool _sameShape(const Tensor* a, const Tensor* b) {
+    if (a->getType() != b->getType() || TensorUtils::getDescribe(a)->dimensionFormat != TensorUtils::getDescribe(b)->dimensionFormat) {
+        return false;
+    }
+    return a->shape() == b->shape();
+}
+
+// Match the element-wise command reading the output of a convolution / matmul, return false if not match
+static bool _matchEpilogue(const Command& cmd, const Tensor* current, Epilogue& epilogue, Tensor*& residual) {
+    if (cmd.workInputs.empty() || cmd.workOutputs.size() != 1 || !_sameShape(current, cmd.workOutputs[0])) {
+        return false;
+    }
+    auto op = cmd.op;
+    bool hasActivation = Epilogue::NONE != epilogue.activation;
+    switch (op->type()) {
+        case OpType_BinaryOp: {
+            auto param = op->main_as_BinaryOp();
+            if (hasActivation || epilogue.residual || cmd.workInputs.size() != 2 || param->opType() != BinaryOpOperation_ADD) {
+                return false;
+            }
+            auto other = cmd.workInputs[0] == current ? cmd.workInputs[1] : cmd.workInputs[0];
+            if (other == current || !_sameShape(current, other)) {
+                return false;
+            }
+            epilogue.residual = true;
+            residual = other;
+            if (1 == param->activationType()) {
+                epilogue.activation = Epilogue::CLAMP;
+                epilogue.minValue = 0.0f;
+            }
+            return true;
+        }
+        case OpType_ReLU: {
+            if (hasActivation || (nullptr != op->main_as_Relu() && 0.0f != op->main_as_Relu()->slope())) {
+                return false;
+            }
+            epilogue.activation = Epilogue::CLAMP;
+            epilogue.minValue = 0.0f;
+            return true;
+        }
+        case OpType_ReLU6: {
+            if (hasActivation) {
+                return false;
+            }
+            epilogue.activation = Epilogue::CLAMP;
+            epilogue.minValue = 0.0f;
+            epilogue.maxValue = 6.0f;
+            if (nullptr != op->main_as_Relu6()) {
+                epilogue.minValue = op->main_as_Relu6()->minValue();
+                epilogue.maxValue = op->main_as_Relu6()->maxValue();
+            }
+            return true;
+        }
+        case OpType_UnaryOp: {
+            if (hasActivation) {
+                return false;
+            }
+            auto type = op->main_as_UnaryOp()->opType();
+            if (type != UnaryOpOperation_SIGMOID && type != UnaryOpOperation_TANH && type != UnaryOpOperation_GELU && type != UnaryOpOperation_GELU_STANDARD && type != UnaryOpOperation_HARDSWISH) {
+                return false;
+            }
+            epilogue.activation = Epilogue::UNARY;
+            epilogue.unaryType = type;
+            return true;
+        }
+        default:
+            break;
+    }
+    return false;
+}
+
+// The commands to fuse and the commands reading / writing each tensor
+struct FuseGraph {
+    std::vector<Command*> commands;
+    std::map<const Tensor::InsideDescribe::NativeInsideDescribe*, std::vector<int>> readers;
+    std::map<const Tensor::InsideDescribe::NativeInsideDescribe*, int> producers;
+    std::map<const Execution*, int> executionUse;
+
+    // The tensor can be replaced if it's only read by the commands fused
+    bool intermediate(const Tensor* t, int readNumber) const {
+        auto des = TensorUtils::getDescribe(t);
+        if (des->usage != Tensor::InsideDescribe::NORMAL || des->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+            return false;
+        }
+        auto iter = readers.find(des);
+        return iter != readers.end() && iter->second.size() == readNumber;
+    }
+    // Record the tensor read by the command since fusion, such as the residual of epilogue
+    void addReader(const Tensor* t, int index) {
+        std::vector<const Tensor::InsideDescribe::NativeInsideDescribe*> reads;
+        _collectRealDescribe(t, reads);
+        for (auto des : reads) {
+            readers[des].emplace_back(index);
+        }
+    }
+};
+
+// Collect the commands and reset the fusion of last time
+static void _buildFuseGraph(Schedule::PipelineInfo& mInfo, FuseGraph& graph) {
+    auto& commands = graph.commands;
+    for (auto& info : mInfo.second) {
+        if (info.type == Schedule::CONSTANT) {
+            continue;
+        }
+        for (auto& cmdP : info.executeBuffer.command) {
+            cmdP->fused = false;
+            if (nullptr != cmdP->execution) {
+                cmdP->execution->onSetEpilogue(Epilogue());
+                cmdP->execution->onSetPrologue(Prologue());
+            }
+            commands.emplace_back(cmdP.get());
+        }
+    }
+    std::vector<const Tensor::InsideDescribe::NativeInsideDescribe*> reads;
+    for (int i = 0; i < commands.size(); ++i) {
+        auto cmd = commands[i];
+        graph.executionUse[cmd->execution.get()] += 1;
+        reads.clear();
+        for (auto t : cmd->workInputs) {
+            _collectRealDescribe(t, reads);
+        }
+        for (auto des : reads) {
+            graph.readers[des].emplace_back(i);
+        }
+        for (auto t : cmd->workOutputs) {
+            graph.producers[TensorUtils::getDescribe(t)] = i;
+        }
+    }
+}
+
+/** Fuse the residual add, activation and quantize after convolution / matmul into their epilogue, the fused commands are
+ skipped on resize and execute. Only for release mode, since the origin outputs of the fused commands are not computed. */
+static void _fuseEpilogue(FuseGraph& graph) {
+    auto& commands = graph.commands;
+    auto& readers = graph.readers;
+    auto& producers = graph.producers;
+    auto intermediate = [&graph](const Tensor* t, int readNumber) {
+        return graph.intermediate(t, readNumber);
+    };
+    for (int i = 0; i < commands.size(); ++i) {
+        auto cmd = commands[i];
+        if (cmd->fused || nullptr == cmd->execution || cmd->workOutputs.size() != 1 || cmd->outputs.size() != 1 || cmd->workOutputs[0] != cmd->outputs[0] || graph.executionUse[cmd->execution.get()] != 1) {
+            continue;
+        }
+        auto type = cmd->op->type();
+        if (type != OpType_Convolution && type != OpType_ConvolutionDepthwise && type != OpType_MatMul) {
+            continue;
+        }
+        auto backend = cmd->execution->backend();
+        Epilogue epilogue;
+        Tensor* current = cmd->workOutputs[0];
+        Tensor* residual = nullptr;
+        Tensor* quant = nullptr;
+        std::vector<Command*> fused;
+        if (current->getType() != halide_type_of<float>()) {
+            continue;
+        }
+        while (nullptr == quant) {
+            auto currentDes = TensorUtils::getDescribe(current);
+            auto readIter = readers.find(currentDes);
+            if (readIter == readers.end()) {
+                break;
+            }
+            auto& reader = readIter->second;
+            auto usable = [&](const Command* next) {
+                return !next->fused && nullptr != next->execution && next->execution->backend() == backend && next->group == cmd->group;
+            };
+            if (2 == reader.size() && Epilogue::NONE == epilogue.activation && intermediate(current, 2)) {
+                // SiLU: x * sigmoid(x)
+                auto sigmoid = commands[reader[0]];
+                auto mul = commands[reader[1]];
+                if (sigmoid->op->type() != OpType_UnaryOp) {
+                    std::swap(sigmoid, mul);
+                }
+                bool match = usable(sigmoid) && usable(mul) && sigmoid->op->type() == OpType_UnaryOp && sigmoid->op->main_as_UnaryOp()->opType() == UnaryOpOperation_SIGMOID;
+                match = match && mul->op->type() == OpType_BinaryOp && mul->op->main_as_BinaryOp()->opType() == BinaryOpOperation_MUL && 0 == mul->op->main_as_BinaryOp()->activationType();
+                match = match && sigmoid->workInputs.size() == 1 && sigmoid->workOutputs.size() == 1 && intermediate(sigmoid->workOutputs[0], 1);
+                match = match && mul->workInputs.size() == 2 && mul->workOutputs.size() == 1 && _sameShape(current, mul->workOutputs[0]);
+                match = match && ((mul->workInputs[0] == current && mul->workInputs[1] == sigmoid->workOutputs[0]) || (mul->workInputs[1] == current && mul->workInputs[0] == sigmoid->workOutputs[0]));
+                if (!match) {
+                    break;
+                }
+                epilogue.activation = Epilogue::SILU;
+                fused.emplace_back(sigmoid);
+                fused.emplace_back(mul);
+                current = mul->workOutputs[0];
+                continue;
+            }
+            if (1 != reader.size() || !intermediate(current, 1)) {
+                break;
+            }
+            auto next = commands[reader[0]];
+            if (!usable(next)) {
+                break;
+            }
+            if (next->op->type() == OpType_FloatToInt8) {
+                // The float output is kept, and the quantized result is written into the output of FloatToInt8
+                auto param = next->op->main_as_QuantizedFloatParam();
+                if (nullptr == param || nullptr == param->tensorScale() || next->workOutputs.size() != 1 || currentDes->dimensionFormat != MNN_DATA_FORMAT_NC4HW4) {
+                    break;
+                }
+                auto scaleSize = param->tensorScale()->size();
+                if (scaleSize != 1 && scaleSize != current->channel()) {
+                    break;
+                }
+                epilogue.quantScale.assign(param->tensorScale()->data(), param->tensorScale()->data() + scaleSize);
+                epilogue.quantZero = param->zeroPoint();
+                epilogue.quantMin = param->clampMin();
+                epilogue.quantMax = param->clampMax();
+                quant = next->workOutputs[0];
+                fused.emplace_back(next);
+                break;
+            }
+            Tensor* nextResidual = nullptr;
+            if (!_matchEpilogue(*next, current, epilogue, nextResidual)) {
+                break;
+            }
+            if (nullptr != nextResidual) {
+                // The residual must be computed before the convolution / matmul
+                auto producer = producers.find(TensorUtils::getDescribe(nextResidual));
+                if (producer != producers.end() && producer->second >= i) {
+                    epilogue.residual = false;
+                    epilogue.activation = Epilogue::NONE;
+                    break;
+                }
+                residual = nextResidual;
+            }
+            fused.emplace_back(next);
+            current = next->workOutputs[0];
+        }
+        if (fused.empty() || !cmd->execution->onSetEpilogue(epilogue)) {
+            continue;
+        }
+        if (nullptr != residual) {
+            cmd->workInputs.emplace_back(residual);
+            graph.addReader(residual, i);
+        }
+        if (nullptr != quant) {
+            cmd->workOutputs = {current, quant};
+        } else {
+            cmd->workOutputs = {current};
+        }
+        for (auto f : fused) {
+            f->fused = true;
+            f->workInputs.clear();
+            f->workOutputs.clear();
+        }
+    }
+}
+
+// Whether the loop is the broadcast binary made by GeometryBinary: out = op(in0, in1), the view of the input xIndex is the same as output
+static bool _isBroadcastLoop(const LoopParam* loop, BinaryOpOperation type, int xIndex) {
+    if (nullptr == loop->commands() || 1 != loop->loopNumber() || 3 != loop->tensorNumber() || (nullptr != loop->initCommand() && loop->initCommand()->size() > 0)) {
+        return false;
+    }
+    auto inputIndexes = loop->inputIndexes();
+    auto outputIndexes = loop->outputIndexes();
+    if (nullptr == inputIndexes || nullptr == outputIndexes || 2 != inputIndexes->size() || 0 != inputIndexes->data()[0] || 1 != inputIndexes->data()[1] || 1 != outputIndexes->size() || 2 != outputIndexes->data()[0]) {
+        return false;
+    }
+    for (int i = 0; i < loop->commands()->size(); ++i) {
+        auto rcmd = loop->commands()->GetAs<RegionCommand>(i);
+        auto subOp = rcmd->op();
+        if (nullptr == subOp || subOp->type() != OpType_BinaryOp || subOp->main_as_BinaryOp()->opType() != type || 0 != subOp->main_as_BinaryOp()->activationType()) {
+            return false;
+        }
+        auto indexes = rcmd->indexes();
+        auto view = rcmd->view();
+        if (nullptr == indexes || nullptr == view || 3 != indexes->size() || 3 != view->size() || 2 != indexes->data()[0] || 0 != indexes->data()[1] || 1 != indexes->data()[2]) {
+            return false;
+        }
+        auto dst = view->GetAs<View>(0);
+        auto src = view->GetAs<View>(xIndex + 1);
+        if (dst->offset() != src->offset() || nullptr == dst->stride() || nullptr == src->stride() || dst->stride()->size() != src->stride()->size()) {
+            return false;
+        }
+        for (int j = 0; j < dst->stride()->size(); ++j) {
+            if (dst->stride()->data()[j] != src->stride()->data()[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Match the add of broadcast mask before softmax, directly or by loop for broadcast, return false if not match
+static bool _matchMaskAdd(const Command& cmd, const Tensor* current, Tensor*& input, Tensor*& mask) {
+    if (cmd.workInputs.size() != 2 || cmd.workOutputs.size() != 1 || TensorUtils::getDescribe(cmd.workOutputs[0]) != TensorUtils::getDescribe(current)) {
+        return false;
+    }
+    auto op = cmd.op;
+    bool isLoop = op->type() == OpType_While && op->main_type() == OpParameter_LoopParam;
+    if (op->type() == OpType_BinaryOp) {
+        if (op->main_as_BinaryOp()->opType() != BinaryOpOperation_ADD || 0 != op->main_as_BinaryOp()->activationType()) {
+            return false;
+        }
+    } else if (!isLoop) {
+        return false;
+    }
+    // The input is the one with same shape, the mask is broadcast to it at the last dimensions
+    for (int i = 0; i < 2; ++i) {
+        auto x = cmd.workInputs[i];
+        auto m = cmd.workInputs[1 - i];
+        if (!_sameShape(current, x) || m->getType() != current->getType() || TensorUtils::getDescribe(m)->dimensionFormat != TensorUtils::getDescribe(current)->dimensionFormat) {
+            continue;
+        }
+        if (TensorUtils::getDescribe(x)->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL || TensorUtils::getDescribe(m)->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+            continue;
+        }
+        int offset = current->dimensions() - m->dimensions();
+        bool broadcast = offset >= 0 && m->dimensions() > 0 && m->length(m->dimensions() - 1) == current->length(current->dimensions() - 1);
+        for (int d = 0; d < m->dimensions() && broadcast; ++d) {
+            broadcast = m->length(d) == 1 || m->length(d) == current->length(d + offset);
+        }
+        if (broadcast && isLoop) {
+            broadcast = _isBroadcastLoop(op->main_as_LoopParam(), BinaryOpOperation_ADD, i);
+        }
+        if (broadcast) {
+            input = x;
+            mask = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Match the multiply / divide by scalar before softmax, return false if not match
+static bool _matchScale(const Command& cmd, const Tensor* current, Tensor*& input, Tensor*& scale, Prologue& prologue) {
+    if (cmd.op->type() != OpType_BinaryOp || cmd.workInputs.size() != 2 || cmd.workOutputs.size() != 1 || TensorUtils::getDescribe(cmd.workOutputs[0]) != TensorUtils::getDescribe(current)) {
+        return false;
+    }
+    auto param = cmd.op->main_as_BinaryOp();
+    if (0 != param->activationType()) {
+        return false;
+    }
+    auto isScalar = [current](const Tensor* t) {
+        return t->getType() == current->getType() && 1 == t->elementSize() && TensorUtils::getDescribe(t)->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL;
+    };
+    auto type = param->opType();
+    if (type == BinaryOpOperation_MUL) {
+        if (isScalar(cmd.workInputs[0]) && _sameShape(current, cmd.workInputs[1])) {
+            scale = cmd.workInputs[0];
+            input = cmd.workInputs[1];
+        } else if (isScalar(cmd.workInputs[1]) && _sameShape(current, cmd.workInputs[0])) {
+            scale = cmd.workInputs[1];
+            input = cmd.workInputs[0];
+        } else {
+            return false;
+        }
+        prologue.scale = Prologue::MUL;
+        return true;
+    }
+    if ((type == BinaryOpOperation_REALDIV || type == BinaryOpOperation_DIV) && isScalar(cmd.workInputs[1]) && _sameShape(current, cmd.workInputs[0])) {
+        scale = cmd.workInputs[1];
+        input = cmd.workInputs[0];
+        prologue.scale = Prologue::DIV;
+        return true;
+    }
+    return false;
+}
+
+/** Fuse the scale and mask before softmax of last axis: softmax(x * scale + mask), mostly in unfused attention */
+static void _fuseSoftmax(FuseGraph& graph) {
+    auto& commands = graph.commands;
+    for (int i = 0; i < commands.size(); ++i) {
+        auto cmd = commands[i];
+        if (cmd->fused || nullptr == cmd->execution || cmd->op->type() != OpType_Softmax || cmd->workInputs.size() != 1 || cmd->workOutputs.size() != 1 || graph.executionUse[cmd->execution.get()] != 1) {
+            continue;
+        }
+        Tensor* current = cmd->workInputs[0];
+        auto format = TensorUtils::getDescribe(current)->dimensionFormat;
+        if (current->getType() != halide_type_of<float>() || format == MNN_DATA_FORMAT_NC4HW4 || current->dimensions() < 1) {
+            continue;
+        }
+        int axis = nullptr != cmd->op->main_as_Axis() ? cmd->op->main_as_Axis()->axis() : -1;
+        if (axis < 0) {
+            axis += current->dimensions();
+        }
+        if (axis != current->dimensions() - 1) {
+            continue;
+        }
+        // The producer of the tensor only read by the next command
+        auto producer = [&](const Tensor* t) -> Command* {
+            if (!graph.intermediate(t, 1)) {
+                return nullptr;
+            }
+            auto iter = graph.producers.find(TensorUtils::getDescribe(t));
+            if (iter == graph.producers.end()) {
+                return nullptr;
+            }
+            auto p = commands[iter->second];
+            if (p->fused || nullptr == p->execution || p->execution->backend() != cmd->execution->backend() || p->group != cmd->group) {
+                return nullptr;
+            }
+            return p;
+        };
+        Prologue prologue;
+        Tensor* scale = nullptr;
+        Tensor* mask = nullptr;
+        std::vector<Command*> fused;
+        auto add = producer(current);
+        Tensor* input = nullptr;
+        if (nullptr != add && _matchMaskAdd(*add, current, input, mask)) {
+            prologue.mask = true;
+            fused.emplace_back(add);
+            current = input;
+        }
+        auto mul = producer(current);
+        if (nullptr != mul && _matchScale(*mul, current, input, scale, prologue)) {
+            fused.emplace_back(mul);
+            current = input;
+        }
+        if (fused.empty() || TensorUtils::getDescribe(current)->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL || !cmd->execution->onSetPrologue(prologue)) {
+            continue;
+        }
+        cmd->workInputs = {current};
+        if (nullptr != scale) {
+            cmd->workInputs.emplace_back(scale);
+        }
+        if (nullptr != mask) {
+            cmd->workInputs.emplace_back(mask);
+        }
+        for (auto f : fused) {
+            f->fused = true;
+            f->workInputs.clear();
+            f->workOutputs.clear();
+        }
+    }
+}
+
+/** Fuse the residual add before layer norm / rms norm: y = norm(a + b). The sum is still written by the norm if others read
+ it, mostly the residual stream of transformer blocks, so the add and norm are computed in one pass */
+static void _fuseNorm(FuseGraph& graph) {
+    auto& commands = graph.commands;
+    for (int i = 0; i < commands.size(); ++i) {
+        auto cmd = commands[i];
+        if (cmd->fused || nullptr == cmd->execution || cmd->op->type() != OpType_LayerNorm || cmd->workInputs.size() != 1 || cmd->workOutputs.size() != 1 || graph.executionUse[cmd->execution.get()] != 1) {
+            continue;
+        }
+        Tensor* sum = cmd->workInputs[0];
+        auto sumDes = TensorUtils::getDescribe(sum);
+        if (sum->getType() != halide_type_of<float>() || nullptr != sumDes->quantAttr.get() || nullptr != TensorUtils::getDescribe(cmd->workOutputs[0])->quantAttr.get()) {
+            continue;
+        }
+        auto producer = graph.producers.find(sumDes);
+        if (producer == graph.producers.end()) {
+            continue;
+        }
+        auto add = commands[producer->second];
+        if (add->fused || nullptr == add->execution || add->execution->backend() != cmd->execution->backend() || add->group != cmd->group) {
+            continue;
+        }
+        if (add->op->type() != OpType_BinaryOp || add->op->main_as_BinaryOp()->opType() != BinaryOpOperation_ADD || 0 != add->op->main_as_BinaryOp()->activationType()) {
+            continue;
+        }
+        if (add->workInputs.size() != 2 || add->workOutputs.size() != 1 || add->workOutputs[0] != sum) {
+            continue;
+        }
+        bool match = true;
+        for (auto t : add->workInputs) {
+            auto des = TensorUtils::getDescribe(t);
+            match = match && _sameShape(sum, t) && nullptr == des->quantAttr.get() && des->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL;
+        }
+        // The sum is written by the norm now, so the others must read it after the norm
+        auto readers = graph.readers.find(sumDes);
+        if (readers != graph.readers.end()) {
+            for (auto r : readers->second) {
+                match = match && r >= i;
+            }
+        }
+        Prologue prologue;
+        prologue.residual = true;
+        if (!match || !cmd->execution->onSetPrologue(prologue)) {
+            continue;
+        }
+        cmd->workInputs = {add->workInputs[0], add->workInputs[1]};
+        if (!graph.intermediate(sum, 1)) {
+            cmd->workOutputs.emplace_back(sum);
+        }
+        add->fused = true;
+        add->workInputs.clear();
+        add->workOutputs.clear();
+    }
+}
+
+void Pipeline::_buildParallelStages() {
+    mParallelStages.clear();
+    // Put every command into the first stage after all the commands it depends on
+    std::map<const Tensor::InsideDescribe::NativeInsideDescribe*, int> lastWrite;
+    std::map<const Tensor::InsideDescribe::NativeInsideDescribe*, int> lastRead;
+    std::vector<const Tensor::InsideDescribe::NativeInsideDescribe*> reads;
+    std::vector<const Tensor::InsideDescribe::NativeInsideDescribe*> writes;
+    for (auto& info : mInfo.second) {
+        if (info.type == Schedule::CONSTANT) {
+            continue;
+        }
+        for (auto& cmdP : info.executeBuffer.command) {
+            if (cmdP->fused) {
+                continue;
+            }
+            reads.clear();
+            writes.clear();
+            for (auto t : cmdP->workInputs) {
+                _collectRealDescribe(t, reads);
+            }
+            for (auto t : cmdP->workOutputs) {
+                _collectRealDescribe(t, writes);
+            }
+            int stage = 0;
+            for (auto des : reads) {
+                auto iter = lastWrite.find(des);
+                if (iter != lastWrite.end()) {
+                    stage = ALIMAX(stage, iter->second + 1);
+                }
+            }
+            for (auto des : writes) {
+                auto iter = lastWrite.find(des);
+                if (iter != lastWrite.end()) {
+                    stage = ALIMAX(stage, iter->second + 1);
+                }
+                iter = lastRead.find(des);
+                if (iter != lastRead.end()) {
+                    stage = ALIMAX(stage, iter->second + 1);
+                }
+            }
+            if (stage >= mParallelStages.size()) {
+                mParallelStages.resize(stage + 1);
+            }
+            mParallelStages[stage].emplace_back(cmdP.get());
+            for (auto des : reads) {
+                auto iter = lastRead.find(des);
+                if (iter == lastRead.end()) {
+                    lastRead.insert(std::make_pair(des, stage));
+                } else {
+                    iter->second = ALIMAX(iter->second, stage);
+                }
+            }
+            for (auto des : writes) {
+                lastWrite[des] = stage;
+            }
+        }
+    }
+}
+
 ErrorCode Pipeline::_allocForTensor(int index, bool allocInput) {
 #ifdef MNN_PIPELINE_DEBUG
     int resizeNumber = 0;
@@ -990,61 +1613,176 @@ ErrorCode Pipeline::_allocForTensor(int index, bool allocInput) {
     auto& mBackupBackend = mInfo.first.cache.second;
     mBackend->onResizeBegin();
     mBackupBackend->onResizeBegin();
-    for (auto& info : mInfo.second) {
-        if (info.type == Schedule::CONSTANT) {
-            continue;
+    // Memory record: the dynamic memory used by each command and the tensors alive when it reaches the peak
+    std::vector<Backend*> recordBackends;
+    {
+        BufferAllocator::Statistic statistic;
+        if (mBackend->onGetDynamicMemoryStatistic(statistic, true)) {
+            recordBackends.emplace_back(mBackend.get());
         }
-        auto& buffer = info.executeBuffer;
-        for (int cmdIndex=0; cmdIndex < buffer.command.size(); ++cmdIndex) {
-            auto& iterP = buffer.command[cmdIndex];
-            auto& iter = *iterP;
-#ifdef MNN_PIPELINE_DEBUG
-            auto memory = const_cast<Runtime*>(mRuntime)->onGetMemoryInMB();
-            if (nullptr != info.op->name()) {
-                MNN_PRINT("%f, before Resize: %s - %d\n", memory, info.op->name()->c_str(), cmdIndex);
-            }
-#endif
-            // Alloc for Tensors
-            auto curBackend = iter.execution->backend();
-            if (allocInput) {
-                for (auto t : iter.workInputs) {
-                    auto allocRes = _allocTensor(t, curBackend, mOutputStatic, index);
-                    if (!allocRes) {
-                        return OUT_OF_MEMORY;
-                    }
+        if (mBackupBackend.get() != mBackend.get() && mBackupBackend->onGetDynamicMemoryStatistic(statistic, true)) {
+            recordBackends.emplace_back(mBackupBackend.get());
+        }
+    }
+    mMemoryRecord.commandPeakBytes.clear();
+    mMemoryRecord.peakBytes = 0;
+    mMemoryRecord.peakOpName.clear();
+    mMemoryRecord.peakFragmentation = 0.0f;
+    mMemoryRecord.peakTensors.clear();
+    // Dynamic tensors alive now and the commands producing them, nullptr for the pipeline's inputs
+    std::map<const Tensor::InsideDescribe*, std::pair<const Tensor*, const Command*>> liveTensors;
+    auto trackTensor = [&](Tensor* t, const Command* producer) {
+        if (recordBackends.empty() || TensorUtils::getDescribe(t)->group != index) {
+            return;
+        }
+        if (nullptr != TensorUtils::getDescribeOrigin(t)->mem.get() && _getTensorStorageType(t, mOutputStatic) == Backend::DYNAMIC) {
+            liveTensors.insert(std::make_pair(TensorUtils::getDescribeOrigin(t), std::make_pair(t, producer)));
+        }
+    };
+    auto recordCommand = [&](const Command& iter) {
+        if (recordBackends.empty()) {
+            return;
+        }
+        BufferAllocator::Statistic statistic;
+        size_t peakBytes = 0, freeBytes = 0, largestFreeBytes = 0;
+        for (auto bn : recordBackends) {
+            bn->onGetDynamicMemoryStatistic(statistic, true);
+            peakBytes += statistic.peakUsedBytes;
+            freeBytes += statistic.freeBytes;
+            largestFreeBytes = ALIMAX(largestFreeBytes, statistic.largestFreeBytes);
+        }
+        mMemoryRecord.commandPeakBytes[&iter] = peakBytes;
+        if (peakBytes <= mMemoryRecord.peakBytes) {
+            return;
+        }
+        mMemoryRecord.peakBytes = peakBytes;
+        mMemoryRecord.peakOpName = _commandName(iter);
+        mMemoryRecord.peakFragmentation = freeBytes > 0 ? 1.0f - (float)largestFreeBytes / (float)freeBytes : 0.0f;
+        mMemoryRecord.peakTensors.clear();
+        for (auto& live : liveTensors) {
+            auto name = nullptr != live.second.second ? _commandName(*live.second.second) : std::string("input");
+            mMemoryRecord.peakTensors.emplace_back(std::make_pair(std::move(name), live.second.first->usize()));
+        }
+        std::sort(mMemoryRecord.peakTensors.begin(), mMemoryRecord.peakTensors.end(), [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b) {
+            return a.second > b.second;
+        });
+    };
+    auto resizeCommand = [&](Command& iter) {
+        if (iter.fused) {
+            return NO_ERROR;
+        }
+        // Alloc for Tensors
+        auto curBackend = iter.execution->backend();
+        if (allocInput) {
+            for (auto t : iter.workInputs) {
+                auto allocRes = _allocTensor(t, curBackend, mOutputStatic, index);
+                if (!allocRes) {
+                    return OUT_OF_MEMORY;
+                }
+                if (liveTensors.find(TensorUtils::getDescribeOrigin(t)) == liveTensors.end()) {
+                    trackTensor(t, nullptr);
                 }
             }
-            {
-                for (auto t : iter.workOutputs) {
-                    auto res = _allocTensor(t, curBackend, mOutputStatic, index);
-                    if (!res) {
-                        return OUT_OF_MEMORY;
-                    }
+        }
+        {
+            for (auto t : iter.workOutputs) {
+                auto res = _allocTensor(t, curBackend, mOutputStatic, index);
+                if (!res) {
+                    return OUT_OF_MEMORY;
                 }
+                trackTensor(t, &iter);
             }
+        }
 #ifdef MNN_PIPELINE_DEBUG
-            if (iter.info != nullptr) {
-                MNN_PRINT("before Resize 2, calling: %s - %d \n", iter.info->name().c_str(), cmdIndex);
-            }
+        if (iter.info != nullptr) {
+            MNN_PRINT("before Resize 2, calling: %s \n", iter.info->name().c_str());
+        }
 #endif
-            if (iter.group == index) {
+        if (iter.group == index) {
 #ifdef MNN_PIPELINE_DEBUG
-                resizeNumber++;
+            resizeNumber++;
 #endif
-                auto code = iter.execution->onResize(iter.workInputs, iter.workOutputs);
-                if (NO_ERROR != code) {
+            auto code = iter.execution->onResize(iter.workInputs, iter.workOutputs);
+            if (NO_ERROR != code) {
 #ifdef MNN_PIPELINE_DEBUG
-                    MNN_ERROR("Pipeline Resize error: %d\n", code);
+                MNN_ERROR("Pipeline Resize error: %d\n", code);
+#endif
+                if (iter.info.get()) {
+                    MNN_ERROR("Resize error for type = %s, name = %s \n", iter.info->type().c_str(), iter.info->name().c_str());
+                }
+                return code;
+            }
+        }
+        recordCommand(iter);
+        // Free mid tensor
+        for (auto t : iter.workInputs) {
+            _releaseTensor(t, allocInput, index);
+            if (nullptr == TensorUtils::getDescribeOrigin(t)->mem.get()) {
+                liveTensors.erase(TensorUtils::getDescribeOrigin(t));
+            }
+        }
+        return NO_ERROR;
+    };
+    if (_supportInterOpParallel()) {
+        _buildParallelStages();
+    } else {
+        mParallelStages.clear();
+    }
+    if (mParallelStages.empty()) {
+        for (auto& info : mInfo.second) {
+            if (info.type == Schedule::CONSTANT) {
+                continue;
+            }
+            auto& buffer = info.executeBuffer;
+            for (int cmdIndex=0; cmdIndex < buffer.command.size(); ++cmdIndex) {
+                auto& iter = *buffer.command[cmdIndex];
+#ifdef MNN_PIPELINE_DEBUG
+                auto memory = const_cast<Runtime*>(mRuntime)->onGetMemoryInMB();
+                if (nullptr != info.op->name()) {
+                    MNN_PRINT("%f, before Resize: %s - %d\n", memory, info.op->name()->c_str(), cmdIndex);
+                }
 #endif
-                    if (iter.info.get()) {
-                        MNN_ERROR("Resize error for type = %s, name = %s \n", iter.info->type().c_str(), iter.info->name().c_str());
+                auto code = resizeCommand(iter);
+                if (NO_ERROR != code) {
+                    return code;
+                }
+            }
+        }
+    } else {
+        // The commands in one stage run concurrently, the memory used by them must not overlap
+        // _supportInterOpParallel has checked that both backends are CPUBackend
+        std::vector<CPUBackend*> backends = {_getCPUBackend(mBackend.get())};
+        if (mBackupBackend.get() != mBackend.get()) {
+            backends.emplace_back(_getCPUBackend(mBackupBackend.get()));
+        }
+        for (auto& stage : mParallelStages) {
+            if (1 == stage.size()) {
+                auto code = resizeCommand(*stage[0]);
+                if (NO_ERROR != code) {
+                    return code;
+                }
+                continue;
+            }
+            for (auto bn : backends) {
+                bn->onParallelResizeBegin();
+            }
+            for (auto cmd : stage) {
+                for (auto bn : backends) {
+                    bn->onParallelGroupBegin();
+                }
+                auto code = resizeCommand(*cmd);
+                for (auto bn : backends) {
+                    bn->onParallelGroupEnd();
+                }
+                if (NO_ERROR != code) {
+                    for (auto bn : backends) {
+                        bn->onParallelResizeEnd();
                     }
                     return code;
                 }
             }
-            // Free mid tensor
-            for (auto t : iter.workInputs) {
-                _releaseTensor(t, allocInput, index);
+            for (auto bn : backends) {
+                bn->onParallelResizeEnd();
             }
         }
     }
@@ -1083,7 +1821,7 @@ ErrorCode Pipeline::allocMemory(bool firstMalloc, bool forbidReplace) {
                     }
                     auto des = TensorUtils::getDescribe(t);
                     auto usage = des->usage;
-                    if (TensorUtils::getDescribeOrigin(t)->mContent.use_count() > 1 && usage != Tensor::InsideDescribe::CONSTANT) {
+                    if (TensorUtils::getDescribeOrigin(t)->mContent.use_count() > 1 && usage != Tensor::InsideDescribe::CONSTANT && des->memoryType != Tensor::InsideDescribe::MEMORY_OUTSIDE) {
                         TensorUtils::getDescribeOrigin(t)->mem = nullptr;
                         auto res = TensorUtils::getDescribeOrigin(t)->getBackend()->onAcquireBuffer(t, Backend::STATIC);
                         if (!res) {
@@ -1145,7 +1883,11 @@ ErrorCode Pipeline::allocMemory(bool firstMalloc, bool forbidReplace) {
         }
     }
     {
-        auto code = _createExecutions(mInfo, mExternalFile, mExternalStorage);
+        std::vector<const Runtime*> runtimes = {mRuntime};
+        if (mCpuRuntime != mRuntime) {
+            runtimes.emplace_back(mCpuRuntime);
+        }
+        auto code = _createExecutions(mInfo, mExternalFile, mExternalStorage, runtimes, mMemoryRecord.executionStaticBytes);
         if (NO_ERROR != code) {
             return code;
         }
@@ -1161,10 +1903,68 @@ ErrorCode Pipeline::allocMemory(bool firstMalloc, bool forbidReplace) {
         }
     }
     /* Insert Wrap End*/
+    if (mFuseEpilogue) {
+        FuseGraph graph;
+        _buildFuseGraph(mInfo, graph);
+        _fuseEpilogue(graph);
+        _fuseSoftmax(graph);
+        _fuseNorm(graph);
+    }
 
     return _allocForTensor(0, mAllocInput);
 }
 
+void Pipeline::getMemoryReport(Interpreter::MemoryReport& report) const {
+    for (auto& info : mInfo.second) {
+        if (info.type == Schedule::CONSTANT) {
+            continue;
+        }
+        Interpreter::MemoryReport::OpMemory opMemory;
+        std::set<const Execution*> executions;
+        for (auto& iterP : info.executeBuffer.command) {
+            auto execution = iterP->execution.get();
+            auto staticIter = mMemoryRecord.executionStaticBytes.find(execution);
+            if (staticIter != mMemoryRecord.executionStaticBytes.end() && executions.insert(execution).second) {
+                opMemory.staticBytes += staticIter->second;
+            }
+            auto dynamicIter = mMemoryRecord.commandPeakBytes.find(iterP.get());
+            if (dynamicIter != mMemoryRecord.commandPeakBytes.end()) {
+                opMemory.dynamicBytes = ALIMAX(opMemory.dynamicBytes, dynamicIter->second);
+            }
+        }
+        if (0 == opMemory.staticBytes && 0 == opMemory.dynamicBytes) {
+            continue;
+        }
+        if (nullptr != info.op->name()) {
+            opMemory.name = info.op->name()->str();
+        } else {
+            opMemory.name = EnumNameOpType(info.op->type());
+        }
+        report.ops.emplace_back(std::move(opMemory));
+    }
+    BufferAllocator::Statistic statistic;
+    auto& cache = mInfo.first.cache;
+    if (cache.first->onGetDynamicMemoryStatistic(statistic, false)) {
+        report.dynamicBytes += statistic.totalBytes;
+    }
+    if (cache.second.get() != cache.first.get() && cache.second->onGetDynamicMemoryStatistic(statistic, false)) {
+        report.dynamicBytes += statistic.totalBytes;
+    }
+    report.dynamicPeakBytes += mMemoryRecord.peakBytes;
+    if (mMemoryRecord.peakBytes > report.peakOpBytes) {
+        report.peakOpBytes = mMemoryRecord.peakBytes;
+        report.peakOpName = mMemoryRecord.peakOpName;
+        report.peakFragmentation = mMemoryRecord.peakFragmentation;
+        report.peakTensors.clear();
+        for (auto& t : mMemoryRecord.peakTensors) {
+            Interpreter::MemoryReport::TensorMemory tensorMemory;
+            tensorMemory.op = t.first;
+            tensorMemory.bytes = t.second;
+            report.peakTensors.emplace_back(std::move(tensorMemory));
+        }
+    }
+}
+
 void Pipeline::_copyInputs() {
     for (auto& iter : mInfo.first.inputTensorCopyCache) {
         auto& tensorCache = iter.second;
@@ -1183,11 +1983,82 @@ void Pipeline::_copyInputs() {
         std::get<3>(tensorCache) = false;
     }
 }
+// Record the command for MNN::Trace, the name, type and flops come from debug info if it's prepared, otherwise from the op
+static void _traceCommand(const Command& cmd, uint64_t beginUs) {
+    uint64_t bytes = 0;
+    for (auto t : cmd.workInputs) {
+        if (nullptr != t) {
+            bytes += t->usize();
+        }
+    }
+    for (auto t : cmd.workOutputs) {
+        bytes += t->usize();
+    }
+    if (nullptr != cmd.info.get()) {
+        traceRecord(cmd.info->name().c_str(), cmd.info->type().c_str(), "op", beginUs, cmd.info->flops(), bytes);
+        return;
+    }
+    auto name = nullptr != cmd.op->name() ? cmd.op->name()->c_str() : "";
+    auto flops = SizeComputer::computeFlops(cmd.op, cmd.inputs, cmd.outputs);
+    traceRecord(name, EnumNameOpType(cmd.op->type()), "op", beginUs, flops, bytes);
+}
+
+static ErrorCode _executeCommand(Command& cmd, bool trace) {
+    if (cmd.fused) {
+        return NO_ERROR;
+    }
+    if (!trace) {
+        return cmd.execution->onExecute(cmd.workInputs, cmd.workOutputs);
+    }
+    auto beginUs = TraceBuffer::now();
+    auto code = cmd.execution->onExecute(cmd.workInputs, cmd.workOutputs);
+    _traceCommand(cmd, beginUs);
+    return code;
+}
+
+ErrorCode Pipeline::_executeParallel() {
+    auto cpuBackend = _getCPUBackend(mInfo.first.cache.first.get());
+    bool trace = nullptr != TraceBuffer::current();
+    for (auto& stage : mParallelStages) {
+        if (1 == stage.size() || nullptr == cpuBackend) {
+            // Run in order if there is no CPUBackend to dispatch the stage
+            for (auto cmd : stage) {
+                auto code = _executeCommand(*cmd, trace);
+                if (NO_ERROR != code) {
+                    return code;
+                }
+            }
+            continue;
+        }
+        int groupNumber = ALIMIN((int)stage.size(), mInterOpParallel);
+        std::atomic<int> errorCode(NO_ERROR);
+        cpuBackend->onParallelExecute([&](int tId) {
+            for (int i = tId; i < stage.size(); i += groupNumber) {
+                auto cmd = stage[i];
+                auto code = _executeCommand(*cmd, trace);
+                if (NO_ERROR != code) {
+                    errorCode = code;
+                }
+            }
+        }, groupNumber);
+        if (NO_ERROR != errorCode) {
+            return (ErrorCode)errorCode.load();
+        }
+    }
+    return NO_ERROR;
+}
+
 ErrorCode Pipeline::execute() {
     _copyInputs();
     auto& mBackend = mInfo.first.cache.first;
     auto& mBackupBackend = mInfo.first.cache.second;
     mBackend->onExecuteBegin();
+    if (!mParallelStages.empty()) {
+        auto code = _executeParallel();
+        mBackend->onExecuteEnd();
+        return code;
+    }
+    bool trace = nullptr != TraceBuffer::current();
     for (auto& info : mInfo.second) {
         if (info.type == Schedule::CONSTANT) {
             continue;
@@ -1215,7 +2086,7 @@ ErrorCode Pipeline::execute() {
                 MNN_PRINT("Group: %d, %s - %d, type=%s, inputs: %s, devices: %s - %s\n", info.group, info.op->name()->c_str(), cmdIndex, EnumNameOpType(cmd.op->type()), groupOfInput.c_str(), deviceOfInput.c_str(), deviceOfOutput.c_str());
             }
 #endif
-            auto code = cmd.execution->onExecute(cmd.workInputs, cmd.workOutputs);
+            auto code = _executeCommand(cmd, trace);
             if (NO_ERROR != code) {
                 mBackend->onExecuteEnd();
                 return code;
@@ -1230,36 +2101,48 @@ ErrorCode Pipeline::executeCallBack(const TensorCallBackWithInfo& before, const
     _copyInputs();
     auto& mBackend = mInfo.first.cache.first;
     auto& mBackupBackend = mInfo.first.cache.second;
-    mBackend->onExecuteBegin();
-    for (auto& info : mInfo.second) {
-        if (info.type == Schedule::CONSTANT) {
-            continue;
-        }
-        auto& buffer = info.executeBuffer;
-        for (int cmdIndex=0; cmdIndex < buffer.command.size(); ++cmdIndex) {
-            auto cmdP = buffer.command[cmdIndex];
-            auto& cmd = *cmdP;
-            if (nullptr == cmd.info.get()) {
-                auto code = cmd.execution->onExecute(cmd.workInputs, cmd.workOutputs);
-                if (NO_ERROR != code) {
-                    mBackend->onExecuteEnd();
-                    return code;
-                }
+    // The memory is planned in stage order if inter-op parallel is open, so the commands must be run in that order
+    std::vector<Command*> commands;
+    if (mParallelStages.empty()) {
+        for (auto& info : mInfo.second) {
+            if (info.type == Schedule::CONSTANT) {
                 continue;
             }
-            auto run = before(cmd.workInputs, cmd.info.get());
-            if (run) {
-                auto code = cmd.execution->onExecute(cmd.workInputs, cmd.workOutputs);
-                if (NO_ERROR != code) {
-                    mBackend->onExecuteEnd();
-                    return code;
+            for (auto& cmdP : info.executeBuffer.command) {
+                if (!cmdP->fused) {
+                    commands.emplace_back(cmdP.get());
                 }
             }
-            auto stop = !(after(cmd.workOutputs, cmd.info.get()));
-            if (stop) {
+        }
+    } else {
+        for (auto& stage : mParallelStages) {
+            commands.insert(commands.end(), stage.begin(), stage.end());
+        }
+    }
+    bool trace = nullptr != TraceBuffer::current();
+    mBackend->onExecuteBegin();
+    for (auto cmdP : commands) {
+        auto& cmd = *cmdP;
+        if (nullptr == cmd.info.get()) {
+            auto code = _executeCommand(cmd, trace);
+            if (NO_ERROR != code) {
                 mBackend->onExecuteEnd();
-                return CALL_BACK_STOP;
+                return code;
             }
+            continue;
+        }
+        auto run = before(cmd.workInputs, cmd.info.get());
+        if (run) {
+            auto code = _executeCommand(cmd, trace);
+            if (NO_ERROR != code) {
+                mBackend->onExecuteEnd();
+                return code;
+            }
+        }
+        auto stop = !(after(cmd.workOutputs, cmd.info.get()));
+        if (stop) {
+            mBackend->onExecuteEnd();
+            return CALL_BACK_STOP;
         }
     }
     mBackend->onExecuteEnd();
@@ -31,6 +31,10 @@ public:
     ~Pipeline();
     ErrorCode fixResizeCache();
     void openResizeCheck();
+    /** number: max number of independent commands run at the same time, less than 2 means sequential execute */
+    void setInterOpParallel(int number) {
+        mInterOpParallel = number;
+    }
 
     class UnitInfo : public OperatorInfo {
     public:
@@ -58,6 +62,8 @@ public:
     float flops() const {
         return mFlops;
     }
+    /** append the memory of this pipeline to report, see Interpreter::MEMORY_REPORT */
+    void getMemoryReport(Interpreter::MemoryReport& report) const;
     friend class Session;
     MNNForwardType getMainForwardType() const  {
         return mInfo.first.cache.first->type();
@@ -68,12 +74,17 @@ private:
     void _copyInputs();
     void _pushTuningTask(std::vector<Schedule::OpCacheInfo>&& initInfos);
     void _recycleDynamicMemory(Command* command);
+    bool _supportInterOpParallel() const;
+    void _buildParallelStages();
+    ErrorCode _executeParallel();
     Schedule::PipelineInfo mInfo;
     bool mAllocInput;
     bool mOutputStatic;
     TuningAttr mTuneAttr;
     float mFlops = 0.0f;
     bool mIsQuantModel = false;
+    // Fuse the element-wise ops into the epilogue of convolution / matmul
+    bool mFuseEpilogue = false;
 
     // For gpu or other backend
     std::map<Tensor*, std::shared_ptr<Tensor>> mCacheConstTensors;
@@ -86,6 +97,24 @@ private:
     const Runtime* mCpuRuntime;
     std::string mExternalFile;
     std::vector<std::shared_ptr<BufferStorage>> mExternalStorage;
+
+    // Inter-op parallel: commands in the same stage don't depend on each other
+    int mInterOpParallel = 0;
+    std::vector<std::vector<Command*>> mParallelStages;
+
+    // Memory recorded when creating executions and resizing
+    struct MemoryRecord {
+        // Static memory allocated when creating the execution
+        std::map<const Execution*, size_t> executionStaticBytes;
+        // Dynamic memory in use when resizing the command
+        std::map<const Command*, size_t> commandPeakBytes;
+        size_t peakBytes = 0;
+        std::string peakOpName;
+        float peakFragmentation = 0.0f;
+        // Producer op name and bytes of the dynamic tensors alive at peak, in descending order of bytes
+        std::vector<std::pair<std::string, size_t>> peakTensors;
+    };
+    MemoryRecord mMemoryRecord;
 };
 } // namespace MNN
 
@@ -21,6 +21,7 @@ namespace MNN {
 
 struct Op;
 struct Net;
+class FileMapper;
 
 /** net scheduler */
 class MNN_PUBLIC Schedule {
@@ -114,6 +115,9 @@ public:
         bool needInputContentForShape = false;
         /** external weight*/
         std::string externalWeightPath;
+        /** read-only mapping of model and external weight, const tensors alias them if set*/
+        std::shared_ptr<FileMapper> modelMapper;
+        std::shared_ptr<FileMapper> externalMapper;
     };
 
     /**
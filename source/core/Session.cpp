@@ -16,6 +16,7 @@
 #include "core/AutoStorage.h"
 #include "core/RuntimeFactory.hpp"
 #include "core/TensorUtils.hpp"
+#include "core/TraceBuffer.hpp"
 #include "utils/InitNet.hpp"
 
 using namespace std;
@@ -59,6 +60,8 @@ void Session::ModeGroup::setMode(Interpreter::SessionMode mode) {
         memoryUsageMode = mode;
     } else if(mode == Interpreter::Session_Codegen_Disable || mode == Interpreter::Session_Codegen_Enable) {
         codegenMode = mode;
+    } else if(mode == Interpreter::Session_Const_Separate || mode == Interpreter::Session_Const_Share) {
+        constMode = mode;
     }
 }
 void Session::ModeGroup::setHint(Interpreter::HintMode mode, int hint) {
@@ -78,6 +81,27 @@ void Session::ModeGroup::setHint(Interpreter::HintMode mode, int hint) {
         case Interpreter::STRICT_CHECK_MODEL:
             checkNetBuffer = hint > 0;
             break;
+        case Interpreter::INTER_OP_PARALLEL:
+            interOpParallel = hint;
+            break;
+        case Interpreter::WEIGHT_PACK_MODE:
+            weightPackMode = hint;
+            break;
+        case Interpreter::SHAPE_CACHE_SIZE:
+            shapeCacheSize = hint;
+            break;
+        case Interpreter::SHAPE_BUCKET_SIZE:
+            shapeBucketSize = hint;
+            break;
+        case Interpreter::SUBMODULE_PARALLEL:
+            subModuleParallel = hint;
+            break;
+        case Interpreter::CPU_KERNEL_TUNING:
+            cpuKernelTuning = hint;
+            break;
+        case Interpreter::CPU_DYNAMIC_QUANT:
+            cpuDynamicQuant = hint;
+            break;
         default:
             break;
     }
@@ -98,6 +122,7 @@ Session::Session(Schedule::ScheduleInfo&& info, const ModeGroup& mode, RuntimeIn
         auto rt    = mRuntime.first.find(iter.first.info.type)->second.get();
         auto cpuRuntime = mRuntime.second;
         std::shared_ptr<Pipeline> newPipeline(new Pipeline( mInfo.externalWeightPath, std::move(iter), mode.inputMode == Interpreter::Session_Input_Inside, mode.outputMode == Interpreter::Session_Output_User, attr, rt, cpuRuntime.get(), mMode.geometryMask));
+        newPipeline->setInterOpParallel(mode.interOpParallel);
         mPipelines.emplace_back(std::move(newPipeline));
     }
     mCallBackMode = mode.callBackMode;
@@ -115,6 +140,20 @@ Session::~Session() {
     mRuntime.first.clear();
     mRuntime.second = nullptr;
 }
+float Session::getDynamicMemoryInMB() const {
+    float summer = 0.0f;
+    for (auto& iter : mPipelines) {
+        auto& cache = iter->getPipelineInfo().first.cache;
+        if (nullptr != cache.first.get()) {
+            summer += cache.first->onGetDynamicMemoryInMB();
+        }
+        if (nullptr != cache.second.get() && cache.second.get() != cache.first.get()) {
+            summer += cache.second->onGetDynamicMemoryInMB();
+        }
+    }
+    return summer;
+}
+
 Schedule::PipelineInfo& Session::getPipelineInfo(int index) const {
     MNN_ASSERT(index >= 0);
     MNN_ASSERT(index < mPipelines.size());
@@ -203,6 +242,7 @@ void Session::_clearCache() {
 }
 
 ErrorCode Session::resize() {
+    TraceScope _trace("Session::resize", "resize");
 #ifdef LOG_VERBOSE
     for (auto& iter : mInfo.inputTensors) {
         auto& inputTensor = iter.second;
@@ -286,6 +326,39 @@ ErrorCode Session::fixResizeCache() {
     return NO_ERROR;
 }
 
+void Session::getMemoryReport(const RuntimeInfo& runtime, const std::vector<const Session*>& sessions, Interpreter::MemoryReport& report) {
+    auto topNumber = report.topNumber;
+    report = Interpreter::MemoryReport();
+    report.topNumber = topNumber;
+    std::set<const Runtime*> runtimes;
+    runtimes.insert(runtime.second.get());
+    for (auto& r : runtime.first) {
+        runtimes.insert(r.second.get());
+    }
+    size_t largestFreeBytes = 0;
+    for (auto rt : runtimes) {
+        BufferAllocator::Statistic statistic;
+        if (rt->onGetMemoryStatistic(statistic)) {
+            report.runtimeBytes += statistic.totalBytes;
+            report.runtimeFreeBytes += statistic.freeBytes;
+            largestFreeBytes = ALIMAX(largestFreeBytes, statistic.largestFreeBytes);
+        } else {
+            report.runtimeBytes += (size_t)(const_cast<Runtime*>(rt)->onGetMemoryInMB() * 1024.0f * 1024.0f);
+        }
+    }
+    if (report.runtimeFreeBytes > 0) {
+        report.runtimeFragmentation = 1.0f - (float)largestFreeBytes / (float)report.runtimeFreeBytes;
+    }
+    for (auto session : sessions) {
+        for (auto& iter : session->mPipelines) {
+            iter->getMemoryReport(report);
+        }
+    }
+    if (report.topNumber >= 0 && report.peakTensors.size() > (size_t)report.topNumber) {
+        report.peakTensors.resize(report.topNumber);
+    }
+}
+
 bool Session::getInfo(Interpreter::SessionInfoCode code, void* ptr) const {
     switch (code) {
         case Interpreter::MEMORY: {
@@ -336,6 +409,10 @@ bool Session::getInfo(Interpreter::SessionInfoCode code, void* ptr) const {
             *dst = mPipelines[0]->getPipelineInfo().first.info.numThread;
             return true;
         }
+        case Interpreter::MEMORY_REPORT: {
+            getMemoryReport(mRuntime, {this}, *(Interpreter::MemoryReport*)ptr);
+            return true;
+        }
         // TODO: Support other debug info
         default:
             break;
@@ -438,16 +515,25 @@ static void initTensors(std::vector<std::shared_ptr<Tensor>>& tensors, const std
 }
 
 Session* Session::clone(RuntimeInfo&& runtime, std::shared_ptr<Schedule::ScheduleInfo> sharedConst) {
-    // TODO: Currently only valid for Module api's onClone
+    // Used by Module api's onClone and Interpreter's Session_Const_Share mode
     Schedule::ScheduleInfo scheduleInfo;
     scheduleInfo.defaultBackend = mInfo.defaultBackend;
     scheduleInfo.pipelineInfo.resize(1);
     scheduleInfo.externalWeightPath = mInfo.externalWeightPath;
-    Session::ModeGroup modes;
+    scheduleInfo.validForResize = mInfo.validForResize;
+    scheduleInfo.needInputContentForShape = mInfo.needInputContentForShape;
     scheduleInfo.defaultBackend = sharedConst->defaultBackend;
     scheduleInfo.constReplaceBackend = sharedConst->constReplaceBackend;
     scheduleInfo.allTensors = sharedConst->allTensors;
     initTensors(scheduleInfo.allTensors, mInfo.allTensors);
+    for (auto& iter : mInfo.inputTensors) {
+        auto index = TensorUtils::getDescribe(iter.second)->index;
+        scheduleInfo.inputTensors.insert(std::make_pair(iter.first, scheduleInfo.allTensors[index].get()));
+    }
+    for (auto& iter : mInfo.outputTensor) {
+        auto index = TensorUtils::getDescribe(iter.second)->index;
+        scheduleInfo.outputTensor.insert(std::make_pair(iter.first, scheduleInfo.allTensors[index].get()));
+    }
     MNN_ASSERT(1 == mPipelines.size());
     auto& srcPipelineInfo = mPipelines[0]->getPipelineInfo();
     auto& opCaches = srcPipelineInfo.second;
@@ -33,10 +33,18 @@ public:
         Interpreter::SessionMode resizeMode = Interpreter::Session_Resize_Direct;
         Interpreter::SessionMode memoryUsageMode = Interpreter::Session_Memory_Collect;
         Interpreter::SessionMode codegenMode = Interpreter::Session_Codegen_Disable;
+        Interpreter::SessionMode constMode = Interpreter::Session_Const_Separate;
         int memoryAllocatorType = 0;
         int maxTuningNumber = MNN_DEFAULT_TUNING_NUMBER;
         int winogradMemoryUsed = 3;
         int geometryMask = 0xFFFF;
+        int interOpParallel = 0;
+        int weightPackMode = 0;
+        int shapeCacheSize = 0;
+        int shapeBucketSize = 0;
+        int subModuleParallel = 0;
+        int cpuKernelTuning = 0;
+        int cpuDynamicQuant = 0;
         bool checkNetBuffer = true;
         void setHint(Interpreter::HintMode hint, int magic);
         void setMode(Interpreter::SessionMode mode);
@@ -46,6 +54,9 @@ public:
     ~Session();
 
     Session* clone(RuntimeInfo&& runtime, std::shared_ptr<Schedule::ScheduleInfo> sharedConst);
+    bool canClone() const {
+        return 1 == mPipelines.size();
+    }
 public:
     /**
      * @brief infer.
@@ -63,6 +74,11 @@ public:
                               bool sync = false) const;
 
     bool getInfo(Interpreter::SessionInfoCode code, void* ptr) const;
+    /** fill the memory report of the sessions using the runtime, see Interpreter::MEMORY_REPORT */
+    static void getMemoryReport(const RuntimeInfo& runtime, const std::vector<const Session*>& sessions, Interpreter::MemoryReport& report);
+
+    // Activation memory allocated by the backends of this session, zero before the first resize
+    float getDynamicMemoryInMB() const;
 
     void openResizeCheck();
     ErrorCode fixResizeCache();
@@ -85,10 +101,19 @@ public:
         mNeedMalloc = flag;
     }
 
+    // If resize() will encode or allocate, which creates executions
+    bool needResizeOrMalloc() const {
+        return mNeedResize || mNeedMalloc;
+    }
+
     Runtime* getCPURuntime() {
         return mRuntime.second.get();
     }
 
+    const RuntimeInfo& getRuntime() const {
+        return mRuntime;
+    }
+
 public:
     /**
      * @brief get backend that create the tensor.
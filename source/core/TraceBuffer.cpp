@@ -0,0 +1,198 @@
+//
+//  TraceBuffer.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "core/TraceBuffer.hpp"
+#include <MNN/Trace.hpp>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "core/Macro.h"
+
+namespace MNN {
+// Not nullptr only when the trace is started
+static std::atomic<TraceBuffer*> gCurrent(nullptr);
+static std::mutex gTraceLock;
+// Number of traceRecord calls that may be using a buffer loaded from gCurrent
+static std::atomic<int> gWriters(0);
+// The buffer used last time, kept for dump. The replaced buffers are released once no writer may use them
+static std::shared_ptr<TraceBuffer> gLastBuffer;
+static std::vector<std::shared_ptr<TraceBuffer>> gRetiredBuffers;
+
+// gTraceLock must be held. A writer entering after gCurrent is replaced loads the new one, so the retired buffers
+// are unreachable once no writer is inside traceRecord
+static void _releaseRetiredBuffers() {
+    if (gRetiredBuffers.empty() || gWriters.load() > 0) {
+        return;
+    }
+    gRetiredBuffers.clear();
+}
+
+TraceBuffer::TraceBuffer(int capacity) {
+    mCapacity = capacity;
+    mSlots.reset(new Slot[capacity]);
+    for (int i = 0; i < capacity; ++i) {
+        mSlots[i].sequence.store(0);
+    }
+    mNext.store(0);
+}
+
+TraceBuffer* TraceBuffer::current() {
+    return gCurrent.load(std::memory_order_acquire);
+}
+
+uint64_t TraceBuffer::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int _threadId() {
+    static std::atomic<int> gThreadNumber(0);
+    static thread_local int tid = gThreadNumber.fetch_add(1);
+    return tid;
+}
+
+void TraceBuffer::record(const char* name, const char* type, const char* category, uint64_t beginUs, uint64_t endUs, float flops, uint64_t bytes) {
+    auto index = mNext.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = mSlots[index % mCapacity];
+    // Claim the slot, so that a writer wrapped onto it doesn't interleave the fields with this one
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    while (true) {
+        if (sequence >= 2 * index + 1) {
+            // A newer event has claimed the slot, this one is overwritten anyway
+            return;
+        }
+        if (sequence % 2 == 1) {
+            // An older writer is still writing the slot
+            std::this_thread::yield();
+            sequence = slot.sequence.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.sequence.compare_exchange_weak(sequence, 2 * index + 1, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    auto& event = slot.event;
+    ::strncpy(event.name, nullptr != name ? name : "", sizeof(event.name) - 1);
+    event.name[sizeof(event.name) - 1] = 0;
+    ::strncpy(event.type, nullptr != type ? type : "", sizeof(event.type) - 1);
+    event.type[sizeof(event.type) - 1] = 0;
+    event.category = category;
+    event.tid = _threadId();
+    event.beginUs = beginUs;
+    event.endUs = endUs;
+    event.flops = flops;
+    event.bytes = bytes;
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<TraceBuffer::Event> TraceBuffer::events() const {
+    std::vector<Event> res;
+    auto end = mNext.load(std::memory_order_acquire);
+    auto begin = end > mCapacity ? end - mCapacity : 0;
+    res.reserve(end - begin);
+    for (auto index = begin; index < end; ++index) {
+        auto& slot = mSlots[index % mCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != 2 * index + 2) {
+            // Not written yet or overwritten
+            continue;
+        }
+        Event event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != 2 * index + 2) {
+            continue;
+        }
+        res.emplace_back(event);
+    }
+    return res;
+}
+
+void traceRecord(const char* name, const char* type, const char* category, uint64_t beginUs, float flops, uint64_t bytes) {
+    gWriters.fetch_add(1);
+    auto buffer = gCurrent.load();
+    if (nullptr != buffer) {
+        buffer->record(name, type, category, beginUs, TraceBuffer::now(), flops, bytes);
+    }
+    gWriters.fetch_sub(1);
+}
+
+void Trace::start(int capacity) {
+    if (capacity <= 0) {
+        MNN_ERROR("Trace capacity must be positive\n");
+        return;
+    }
+    std::unique_lock<std::mutex> _l(gTraceLock);
+    gCurrent.store(nullptr, std::memory_order_release);
+    if (nullptr != gLastBuffer) {
+        gRetiredBuffers.emplace_back(gLastBuffer);
+    }
+    gLastBuffer.reset(new TraceBuffer(capacity));
+    gCurrent.store(gLastBuffer.get());
+    _releaseRetiredBuffers();
+}
+
+void Trace::stop() {
+    std::unique_lock<std::mutex> _l(gTraceLock);
+    gCurrent.store(nullptr, std::memory_order_release);
+    _releaseRetiredBuffers();
+}
+
+bool Trace::enabled() {
+    return nullptr != TraceBuffer::current();
+}
+
+static void _writeString(FILE* f, const char* str) {
+    fputc('"', f);
+    for (auto c = str; *c != 0; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', f);
+            fputc(*c, f);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(f, "\\u%04x", (int)(unsigned char)*c);
+        } else {
+            fputc(*c, f);
+        }
+    }
+    fputc('"', f);
+}
+
+bool Trace::dump(const char* fileName) {
+    std::vector<TraceBuffer::Event> events;
+    {
+        std::unique_lock<std::mutex> _l(gTraceLock);
+        if (nullptr != gLastBuffer) {
+            events = gLastBuffer->events();
+        }
+        _releaseRetiredBuffers();
+    }
+    if (events.empty()) {
+        MNN_ERROR("No trace event recorded\n");
+        return false;
+    }
+    auto f = fopen(fileName, "wb");
+    if (nullptr == f) {
+        MNN_ERROR("Can't open %s for trace\n", fileName);
+        return false;
+    }
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (int i = 0; i < events.size(); ++i) {
+        auto& e = events[i];
+        fprintf(f, "{\"name\":");
+        _writeString(f, e.name);
+        fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%llu,\"dur\":%llu,\"args\":{\"type\":", e.category, e.tid,
+                (unsigned long long)e.beginUs, (unsigned long long)(e.endUs - e.beginUs));
+        _writeString(f, e.type);
+        fprintf(f, ",\"mflops\":%f,\"bytes\":%llu}}%s\n", e.flops, (unsigned long long)e.bytes, i + 1 < events.size() ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+    return true;
+}
+
+} // namespace MNN
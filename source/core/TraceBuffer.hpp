@@ -0,0 +1,85 @@
+//
+//  TraceBuffer.hpp
+//  MNN
+//
+//  Created by MNN on 2024/03/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef TraceBuffer_hpp
+#define TraceBuffer_hpp
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <MNN/MNNDefine.h>
+
+namespace MNN {
+/** Lock-free ring buffer for MNN::Trace, writers overwrite the earliest events when it's full. */
+class MNN_PUBLIC TraceBuffer {
+public:
+    struct Event {
+        char name[64];
+        char type[32];
+        const char* category;
+        int tid;
+        uint64_t beginUs;
+        uint64_t endUs;
+        float flops; // In M
+        uint64_t bytes;
+    };
+    TraceBuffer(int capacity);
+    ~TraceBuffer() = default;
+
+    // Current buffer, nullptr if the trace is not started
+    static TraceBuffer* current();
+    // Time in us for beginUs / endUs
+    static uint64_t now();
+
+    void record(const char* name, const char* type, const char* category, uint64_t beginUs, uint64_t endUs, float flops, uint64_t bytes);
+    // Copy the complete events in record order
+    std::vector<Event> events() const;
+
+private:
+    struct Slot {
+        // 2 * index + 2 when the event of index is written, 2 * index + 1 while the writer claiming it by CAS writes
+        std::atomic<uint64_t> sequence;
+        Event event;
+    };
+    std::unique_ptr<Slot[]> mSlots;
+    uint64_t mCapacity;
+    std::atomic<uint64_t> mNext;
+};
+
+// Record an event on current buffer from begin to now if the trace is started
+MNN_PUBLIC void traceRecord(const char* name, const char* type, const char* category, uint64_t beginUs, float flops = 0.0f, uint64_t bytes = 0);
+
+// Record the scope as an event if the trace is started when entering it
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category) {
+        mName = name;
+        mCategory = category;
+        mTrace = nullptr != TraceBuffer::current();
+        if (mTrace) {
+            mBeginUs = TraceBuffer::now();
+        }
+    }
+    ~TraceScope() {
+        if (mTrace) {
+            traceRecord(mName, "", mCategory, mBeginUs);
+        }
+    }
+
+private:
+    const char* mName;
+    const char* mCategory;
+    bool mTrace;
+    uint64_t mBeginUs = 0;
+};
+
+} // namespace MNN
+
+#endif
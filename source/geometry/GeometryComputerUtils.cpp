@@ -163,7 +163,10 @@ ErrorCode GeometryComputerUtils::shapeComputeAndGeometryTransform(
             auto des = TensorUtils::getDescribe(t);
             auto usage = des->usage;
             auto type = des->memoryType;
-            MNN_ASSERT(type != Tensor::InsideDescribe::MEMORY_OUTSIDE);
+            if (type == Tensor::InsideDescribe::MEMORY_OUTSIDE) {
+                // Set by the execution, such as a const mapping a file, keep it
+                continue;
+            }
             MNN_ASSERT(type != Tensor::InsideDescribe::MEMORY_HOST);
             if (TensorUtils::getDescribeOrigin(t)->mContent.use_count() > 1) {
                 TensorUtils::getDescribeOrigin(t)->mContent.reset(new  Tensor::InsideDescribe::NativeInsideDescribe);
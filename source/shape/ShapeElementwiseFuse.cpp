@@ -0,0 +1,42 @@
+//
+//  ShapeElementwiseFuse.cpp
+//  MNN
+//
+//  Created by MNN on 2024/03/15.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "shape/SizeComputer.hpp"
+#include "core/Macro.h"
+#include "core/TensorUtils.hpp"
+
+namespace MNN {
+
+class ShapeElementwiseFuse : public SizeComputer {
+    virtual bool onComputeSize(const MNN::Op* op, const std::vector<Tensor*>& inputs,
+                               const std::vector<Tensor*>& outputs) const override {
+        if (inputs.empty() || outputs.empty()) {
+            return false;
+        }
+        auto extra = op->main_as_Extra();
+        if (nullptr == extra || nullptr == extra->type() || extra->type()->str() != "ElementwiseFuse") {
+            // Other extra op: the same as input
+            if (outputs.size() != 1 && outputs.size() != inputs.size()) {
+                return false;
+            }
+            for (int i = 0; i < outputs.size(); ++i) {
+                TensorUtils::copyShape(inputs[i], outputs[i], true);
+                outputs[i]->buffer().type = inputs[i]->buffer().type;
+            }
+            return true;
+        }
+        // Fused elementwise ops: broadcast of all inputs
+        outputs[0]->buffer().type = inputs[0]->buffer().type;
+        TensorUtils::getDescribe(outputs[0])->dimensionFormat = TensorUtils::getDescribe(inputs[0])->dimensionFormat;
+        return SizeComputer::computeBroadCastDims(op, inputs, outputs);
+    }
+};
+
+REGISTER_SHAPE(ShapeElementwiseFuse, OpType_Extra);
+
+} // namespace MNN
@@ -4,6 +4,7 @@ extern void ___ShapeSizeComputer__OpType_Shape__();
 extern void ___ShapeRasterComputer__OpType_Raster__();
 extern void ___PriorBoxComputer__OpType_PriorBox__();
 extern void ___ShapeBroadcastTo__OpType_BroadcastTo__();
+extern void ___ShapeElementwiseFuse__OpType_Extra__();
 extern void ___InterpComputer__OpType_Interp__();
 extern void ___CropSizeComputer__OpType_Crop__();
 extern void ___MatMulSizeComputer__OpType_MatMul__();
@@ -126,6 +127,7 @@ ___ShapeSizeComputer__OpType_Shape__();
 ___ShapeRasterComputer__OpType_Raster__();
 ___PriorBoxComputer__OpType_PriorBox__();
 ___ShapeBroadcastTo__OpType_BroadcastTo__();
+___ShapeElementwiseFuse__OpType_Extra__();
 ___InterpComputer__OpType_Interp__();
 ___CropSizeComputer__OpType_Crop__();
 ___MatMulSizeComputer__OpType_MatMul__();
@@ -9,9 +9,60 @@
 #include "core/TensorUtils.hpp"
 #include <unordered_map>
 #include "core/OpCommonUtils.hpp"
+#include "core/FileLoader.hpp"
+#include "backend/cpu/CPUBackend.hpp"
 #include "half.hpp"
 
 namespace MNN {
+static bool _aliasMappedBlob(const Op* op, Tensor* output, Backend* defaultBackend, const std::shared_ptr<FileMapper>& modelMapper, const std::shared_ptr<FileMapper>& externalMapper) {
+    if (OpType_Const != op->type() || defaultBackend->type() != MNN_FORWARD_CPU) {
+        return false;
+    }
+    auto parameter = op->main_as_Blob();
+    if (parameter->dataType() == DataType_DT_HALF || parameter->dataFormat() == MNN_DATA_FORMAT_NC4HW4) {
+        return false;
+    }
+    auto size = output->usize();
+    const uint8_t* src = nullptr;
+    std::shared_ptr<FileMapper> owner;
+    if (USE_EXTERNAL_DATA(parameter)) {
+        if (nullptr == externalMapper || nullptr != op->externalPath() || parameter->external()->data()[1] < (int64_t)size) {
+            return false;
+        }
+        src   = externalMapper->data() + parameter->external()->data()[0];
+        owner = externalMapper;
+    } else {
+        if (nullptr == modelMapper) {
+            return false;
+        }
+        switch (parameter->dataType()) {
+            case DataType_DT_FLOAT:
+                src = nullptr != parameter->float32s() ? (const uint8_t*)parameter->float32s()->Data() : nullptr;
+                break;
+            case DataType_DT_INT32:
+                src = nullptr != parameter->int32s() ? (const uint8_t*)parameter->int32s()->Data() : nullptr;
+                break;
+            case DataType_DT_QUINT8:
+            case DataType_DT_UINT8:
+                src = nullptr != parameter->uint8s() ? (const uint8_t*)parameter->uint8s()->Data() : nullptr;
+                break;
+            case DataType_DT_INT8:
+                src = nullptr != parameter->int8s() ? (const uint8_t*)parameter->int8s()->Data() : nullptr;
+                break;
+            default:
+                break;
+        }
+        owner = modelMapper;
+    }
+    // Misaligned data can't be used directly
+    if (nullptr == src || 0 != ((size_t)src) % output->getType().bytes() || !owner->contains(src, size)) {
+        return false;
+    }
+    TensorUtils::getDescribeOrigin(output)->mem = new MappedMemObj(owner, src, size);
+    output->buffer().host = (uint8_t*)src;
+    return true;
+}
+
 bool needComputeOp(const Op* op) {
     if (op->type() != OpType_Input && op->type() != OpType_Const && op->type() != OpType_TrainableParam) {
         return true;
@@ -41,7 +92,8 @@ bool computeShapeForBlob(const Blob* parameter, Tensor* output) {
     return zeroShape;
 }
 
-bool initConstTensors(std::vector<std::shared_ptr<Tensor>>& tensors, const Net* net, Backend* defaultBackend, ErrorCode& code, FileLoader* external) {
+bool initConstTensors(std::vector<std::shared_ptr<Tensor>>& tensors, const Net* net, Backend* defaultBackend, ErrorCode& code, FileLoader* external,
+                      std::shared_ptr<FileMapper> modelMapper, std::shared_ptr<FileMapper> externalMapper) {
     bool valid    = true;
     tensors.resize(net->tensorName()->size());
     // Set up const
@@ -65,6 +117,10 @@ bool initConstTensors(std::vector<std::shared_ptr<Tensor>>& tensors, const Net*
             if (zeroShape) {
                 continue;
             }
+            if (_aliasMappedBlob(op, output, defaultBackend, modelMapper, externalMapper)) {
+                // The mapped memory is read-only, use it without copy
+                continue;
+            }
             auto res = defaultBackend->onAcquireBuffer(output, Backend::STATIC);
             if (!res) {
                 code = OUT_OF_MEMORY;
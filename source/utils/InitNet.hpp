@@ -13,10 +13,13 @@
 
 namespace MNN {
 class FileLoader;
+class FileMapper;
 MNN_PUBLIC bool needComputeOp(const Op* op);
 MNN_PUBLIC bool computeShapeForBlob(const Blob* parameter, Tensor* output);
 
-MNN_PUBLIC bool initConstTensors(std::vector<std::shared_ptr<Tensor>>& tensors, const Net* net, Backend* defaultBackend, ErrorCode& code, FileLoader* external);
+// If net / external weight are mapped by modelMapper / externalMapper, const tensors on cpu alias the mapped memory
+MNN_PUBLIC bool initConstTensors(std::vector<std::shared_ptr<Tensor>>& tensors, const Net* net, Backend* defaultBackend, ErrorCode& code, FileLoader* external,
+                                 std::shared_ptr<FileMapper> modelMapper = nullptr, std::shared_ptr<FileMapper> externalMapper = nullptr);
 // init Tensors by net
 MNN_PUBLIC bool initTensors(std::vector<std::shared_ptr<Tensor>>& allTensors, const Net* net);
 // init Pipeline Infos by oplist and tensors
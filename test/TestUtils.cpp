@@ -49,6 +49,59 @@ void dispatch(std::function<void(MNNForwardType)> payload, MNNForwardType backen
     }
 }
 // simulate bf16, prune fp32 tailing precision to bf16 precision
+std::string readFileToString(const char* fileName) {
+    std::string content;
+    auto file = fopen(fileName, "rb");
+    if (nullptr == file) {
+        return content;
+    }
+    char buffer[1024];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, size);
+    }
+    fclose(file);
+    return content;
+}
+
+void fillSessionInput(MNN::Interpreter* net, MNN::Session* session, const char* name, int seed, int modulus, float scale) {
+    auto input = net->getSessionInput(session, name);
+    std::shared_ptr<Tensor> host(Tensor::createHostTensorFromDevice(input, false));
+    auto ptr = host->host<float>();
+    for (int i = 0; i < host->elementSize(); ++i) {
+        ptr[i] = (float)((i * 7 + seed * 13) % modulus - modulus / 2) * scale;
+    }
+    input->copyFromHostTensor(host.get());
+}
+
+static std::vector<float> _readAsFloat(const Tensor* tensor) {
+    std::vector<float> result(tensor->elementSize());
+    for (int i = 0; i < result.size(); ++i) {
+        if (tensor->getType() == halide_type_of<int8_t>()) {
+            result[i] = tensor->host<int8_t>()[i];
+        } else {
+            result[i] = tensor->host<float>()[i];
+        }
+    }
+    return result;
+}
+
+bool checkSessionOutput(MNN::Interpreter* net, MNN::Session* reference, MNN::Session* session, const char* name, float rtol) {
+    std::shared_ptr<Tensor> h0(Tensor::createHostTensorFromDevice(net->getSessionOutput(reference, name), true));
+    std::shared_ptr<Tensor> h1(Tensor::createHostTensorFromDevice(net->getSessionOutput(session, name), true));
+    if (h0->elementSize() != h1->elementSize() || h0->getType() != h1->getType()) {
+        MNN_ERROR("Output %s mismatch in size or type\n", name);
+        return false;
+    }
+    auto expect = _readAsFloat(h0.get());
+    auto result = _readAsFloat(h1.get());
+    if (!checkVectorByRelativeError<float>(result.data(), expect.data(), (int)expect.size(), rtol)) {
+        MNN_ERROR("Output %s error\n", name);
+        return false;
+    }
+    return true;
+}
+
 float convertFP32ToBF16(float fp32Value) {
     uint32_t& s32Value = *(uint32_t*)(&fp32Value);
     s32Value &= 0xffff0000;
@@ -14,6 +14,7 @@
 #include <functional>
 #include <string>
 #include <MNN/MNNForwardType.h>
+#include <MNN/Interpreter.hpp>
 #include <MNN/Tensor.hpp>
 #include <math.h>
 #include <iostream>
@@ -96,6 +97,34 @@ bool checkVectorByRelativeError(const T* result, const T* rightData, const T* al
 
 int getTestPrecision(MNNForwardType forwardType, MNN::BackendConfig::PrecisionMode precision, bool isSupportFp16);
 
+/**
+ @brief read the whole file
+ @param fileName
+ @return content of the file, empty if it can't be opened
+ */
+std::string readFileToString(const char* fileName);
+
+/**
+ @brief fill the float input of session with ((i * 7 + seed * 13) % modulus - modulus / 2) * scale
+ @param net
+ @param session
+ @param name        input name
+ @param seed        different seed gives different data
+ @param modulus
+ @param scale
+ */
+void fillSessionInput(MNN::Interpreter* net, MNN::Session* session, const char* name, int seed, int modulus, float scale);
+
+/**
+ @brief check the output of session with the one of reference session by checkVectorByRelativeError
+ @param net
+ @param reference
+ @param session
+ @param name        output name
+ @param rtol
+ */
+bool checkSessionOutput(MNN::Interpreter* net, MNN::Session* reference, MNN::Session* session, const char* name, float rtol);
+
 float convertFP32ToBF16(float fp32Value);
 float convertFP32ToFP16(float fp32Value);
 
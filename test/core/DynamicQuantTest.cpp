@@ -0,0 +1,103 @@
+//
+//  DynamicQuantTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/04/08.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <string.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "CommonOpCreator.hpp"
+using namespace MNN::Express;
+using namespace MNN;
+
+// Compare the 1x1 convolutions of int8 weight computed by CPU_DYNAMIC_QUANT with the float path
+class DynamicQuantTest : public MNNTestCase {
+public:
+    static VARP _Linear(VARP x, int ic, int oc, bool asymmetric, bool relu6, int seed) {
+        std::vector<float> weight(ic * oc), bias(oc), alpha;
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)((i * 7 + seed) % 31 - 15) / 32.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)(i % 5 - 2) / 4.0f;
+        }
+        for (int o = 0; o < oc; ++o) {
+            auto w = weight.data() + o * ic;
+            float minValue = w[0], maxValue = w[0];
+            for (int i = 1; i < ic; ++i) {
+                minValue = fminf(minValue, w[i]);
+                maxValue = fmaxf(maxValue, w[i]);
+            }
+            if (asymmetric) {
+                alpha.emplace_back(minValue);
+                alpha.emplace_back((maxValue - minValue) / 255.0f);
+            } else {
+                alpha.emplace_back(fmaxf(fabsf(minValue), fabsf(maxValue)) / 127.0f);
+            }
+        }
+        return _HybridConv(weight, bias, alpha, x, {ic, oc}, {1, 1}, VALID, {1, 1}, {1, 1}, 1, {0, 0}, false, relu6, 8, asymmetric);
+    }
+    static bool compute(const flatbuffers::FlatBufferBuilder& builder, int dynamicQuant, std::vector<float>& result) {
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        interp->setSessionHint(Interpreter::CPU_DYNAMIC_QUANT, dynamicQuant);
+        ScheduleConfig config;
+        config.numThread = 2;
+        auto session = interp->createSession(config);
+        auto input = interp->getSessionInput(session, "x");
+        std::shared_ptr<Tensor> hostInput(new Tensor(input, Tensor::CAFFE));
+        auto ptr = hostInput->host<float>();
+        for (int i = 0; i < hostInput->elementSize(); ++i) {
+            // Rows of different range for the scale of each row
+            ptr[i] = (float)((i * 13) % 41 - 20) / 8.0f * (float)(1 + i % 3);
+        }
+        input->copyFromHostTensor(hostInput.get());
+        if (NO_ERROR != interp->runSession(session)) {
+            return false;
+        }
+        auto output = interp->getSessionOutput(session, "y");
+        std::shared_ptr<Tensor> hostOutput(new Tensor(output, Tensor::CAFFE));
+        output->copyToHostTensor(hostOutput.get());
+        result.resize(hostOutput->elementSize());
+        ::memcpy(result.data(), hostOutput->host<float>(), result.size() * sizeof(float));
+        return true;
+    }
+    virtual bool run(int precision) {
+        // Odd channels for the tail of quad, 13 rows for the tail of tile
+        const int seq = 13, ic = 67, hidden = 45, oc = 32;
+        auto x = _Input({1, ic, seq, 1}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        auto y = _Linear(x, ic, hidden, true, true, 3);
+        y = _Linear(y, hidden, oc, false, false, 5);
+        y = _Convert(y, NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        builder.Finish(MNN::Net::Pack(builder, net.get()));
+
+        std::vector<float> expect, result;
+        if (!compute(builder, 0, expect) || !compute(builder, 1, result) || expect.size() != result.size()) {
+            MNN_ERROR("DynamicQuantTest run session error\n");
+            return false;
+        }
+        float maxValue = 0.0f;
+        for (auto v : expect) {
+            maxValue = fmaxf(maxValue, fabsf(v));
+        }
+        // The error of int8 input is about 1 / 254 of the max value in a row
+        for (int i = 0; i < expect.size(); ++i) {
+            if (fabsf(expect[i] - result[i]) > 0.02f * maxValue) {
+                MNN_ERROR("DynamicQuantTest error at %d: %f - %f\n", i, expect[i], result[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(DynamicQuantTest, "core/dynamic_quant");
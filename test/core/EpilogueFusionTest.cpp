@@ -0,0 +1,106 @@
+//
+//  EpilogueFusionTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/Trace.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class EpilogueFusionTest : public MNNTestCase {
+public:
+    static std::vector<float> makeData(int size, int seed) {
+        std::vector<float> data(size);
+        for (int i = 0; i < size; ++i) {
+            data[i] = (float)((i * 7 + seed * 13) % 17 - 8) / 16.0f;
+        }
+        return data;
+    }
+    virtual bool run(int precision) {
+        auto x = _Input({1, 8, 16, 16}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        auto r = _Input({1, 16, 8, 8}, NC4HW4, halide_type_of<float>());
+        r->setName("r");
+        // Dense convolution + residual + relu
+        auto y1 = _Relu(_Add(_Conv(makeData(16 * 8 * 9, 0), makeData(16, 1), x, {8, 16}, {3, 3}, SAME, {2, 2}), r));
+        y1->setName("y1");
+        // 1x1 convolution + gelu
+        auto y2 = _Gelu(_Conv(makeData(16 * 16, 2), makeData(16, 3), y1, {16, 16}, {1, 1}));
+        y2->setName("y2");
+        // 1x1 convolution + silu
+        auto c = _Conv(makeData(8 * 16, 4), makeData(8, 5), y2, {16, 8}, {1, 1});
+        auto y3 = _Multiply(c, _Sigmoid(c));
+        y3->setName("y3");
+        // 1x1 convolution + quantize
+        auto q = _FloatToInt8(_Conv(makeData(8 * 8, 6), makeData(8, 7), y3, {8, 8}, {1, 1}), _Const(makeData(8, 8).data(), {8}, NCHW), -127, 127, 0);
+        q->setName("q");
+        // MatMul + residual + tanh
+        auto a = _Input({32, 24}, NCHW, halide_type_of<float>());
+        a->setName("a");
+        auto ra = _Input({32, 40}, NCHW, halide_type_of<float>());
+        ra->setName("ra");
+        auto y4 = _Tanh(_Add(_MatMul(a, _Const(makeData(24 * 40, 9).data(), {24, 40}, NCHW)), ra));
+        y4->setName("y4");
+        // Depthwise 5x5 + relu6 + hardswish
+        auto d = _Input({1, 24, 15, 13}, NC4HW4, halide_type_of<float>());
+        d->setName("d");
+        auto y5 = _Hardswish(_Conv(makeData(24 * 25, 10), makeData(24, 11), d, {24, 24}, {5, 5}, SAME, {2, 2}, {1, 1}, 24, {0, 0}, false, true));
+        y5->setName("y5");
+        // Dilated depthwise 7x7 + residual + relu
+        auto y6 = _Relu(_Add(_Conv(makeData(24 * 49, 12), makeData(24, 13), d, {24, 24}, {7, 7}, SAME, {1, 1}, {2, 2}, 24), d));
+        y6->setName("y6");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y1, y2, y3, q, y4, y5, y6}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        config.saveTensors = {"y1", "y2", "y3", "q", "y4", "y5", "y6"};
+        // The commands are kept for callback in debug mode
+        interp->setSessionMode(Interpreter::Session_Debug);
+        auto reference = interp->createSession(config);
+        interp->setSessionMode(Interpreter::Session_Release);
+        auto fused = interp->createSession(config);
+        const char* inputs[] = {"x", "r", "a", "ra", "d"};
+        for (int i = 0; i < 5; ++i) {
+            fillSessionInput(interp.get(), reference, inputs[i], i, 17, 1.0f / 16.0f);
+            fillSessionInput(interp.get(), fused, inputs[i], i, 17, 1.0f / 16.0f);
+        }
+        interp->runSession(reference);
+        const char* traceFile = "EpilogueFusionTest.json";
+        Trace::start();
+        interp->runSession(fused);
+        Trace::stop();
+        Trace::dump(traceFile);
+        auto content = readFileToString(traceFile);
+        remove(traceFile);
+        const char* outputs[] = {"y1", "y2", "y3", "q", "y4", "y5", "y6"};
+        for (int i = 0; i < 7; ++i) {
+            if (!checkSessionOutput(interp.get(), reference, fused, outputs[i], 0.01f)) {
+                return false;
+            }
+        }
+        const char* fusedTypes[] = {"\"BinaryOp\"", "\"UnaryOp\"", "\"ReLU\"", "\"FloatToInt8\""};
+        for (auto type : fusedTypes) {
+            if (content.find(type) != std::string::npos) {
+                MNN_ERROR("EpilogueFusionTest %s is not fused\n", type);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(EpilogueFusionTest, "core/epilogue_fusion");
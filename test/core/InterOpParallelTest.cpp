@@ -0,0 +1,98 @@
+//
+//  InterOpParallelTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/04.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class InterOpParallelTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        const int ic = 8, oc = 8, h = 17, w = 17;
+        auto x = _Input({1, ic, h, w}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        std::vector<VARP> branches;
+        for (int b = 0; b < 4; ++b) {
+            std::vector<float> weight(oc * ic * 3 * 3);
+            std::vector<float> bias(oc);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)((i * (b + 3)) % 17 - 8) / 32.0f;
+            }
+            for (int i = 0; i < oc; ++i) {
+                bias[i] = (float)(i - b) / 8.0f;
+            }
+            auto y = _Conv(std::move(weight), std::move(bias), x, {ic, oc}, {3, 3}, SAME);
+            if (b % 2 == 0) {
+                y = _Relu6(y);
+            } else {
+                y = _Sigmoid(y);
+            }
+            y = _Add(y, _Tanh(x));
+            branches.emplace_back(y);
+        }
+        auto z = _Concat(branches, 1);
+        z = _Convert(z, NCHW);
+        z->setName("z");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({z}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+        int sizeOutput    = builderOutput.GetSize();
+        auto bufferOutput = builderOutput.GetBufferPointer();
+
+        auto compute = [&](int parallel, std::vector<float>& result) {
+            std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(bufferOutput, sizeOutput));
+            interp->setSessionHint(Interpreter::INTER_OP_PARALLEL, parallel);
+            ScheduleConfig config;
+            config.numThread = 4;
+            auto session = interp->createSession(config);
+            auto input = interp->getSessionInput(session, "x");
+            std::shared_ptr<Tensor> hostInput(new Tensor(input, Tensor::CAFFE));
+            auto ptr = hostInput->host<float>();
+            for (int i = 0; i < hostInput->elementSize(); ++i) {
+                ptr[i] = (float)(i % 23 - 11) / 11.0f;
+            }
+            // Run twice to make sure the memory reused between runs is valid. The input's memory may be
+            // reused by the ops after its last use, so copy it before every run
+            for (int i = 0; i < 2; ++i) {
+                input->copyFromHostTensor(hostInput.get());
+                auto code = interp->runSession(session);
+                if (NO_ERROR != code) {
+                    return false;
+                }
+            }
+            auto output = interp->getSessionOutput(session, "z");
+            std::shared_ptr<Tensor> hostOutput(new Tensor(output, Tensor::CAFFE));
+            output->copyToHostTensor(hostOutput.get());
+            result.resize(hostOutput->elementSize());
+            ::memcpy(result.data(), hostOutput->host<float>(), result.size() * sizeof(float));
+            return true;
+        };
+        std::vector<float> expect, parallelResult;
+        if (!compute(0, expect) || !compute(4, parallelResult)) {
+            MNN_ERROR("InterOpParallelTest run session error\n");
+            return false;
+        }
+        if (expect.size() != parallelResult.size()) {
+            return false;
+        }
+        for (int i = 0; i < expect.size(); ++i) {
+            if (fabsf(expect[i] - parallelResult[i]) > 0.001f) {
+                MNN_ERROR("InterOpParallelTest error at %d: %f - %f\n", i, expect[i], parallelResult[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(InterOpParallelTest, "core/inter_op_parallel");
@@ -0,0 +1,127 @@
+//
+//  KernelTuningTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class KernelTuningTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        const int ic = 16, oc = 16, h = 14, w = 14;
+        auto x = _Input({1, ic, h, w}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        auto y = x;
+        // 3x3 choose from tiled and winograd units, 1x1 choose from tiled and strassen
+        for (int l = 0; l < 3; ++l) {
+            int kernel = l % 2 == 0 ? 3 : 1;
+            std::vector<float> weight(oc * ic * kernel * kernel);
+            std::vector<float> bias(oc);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)((i * (l + 5)) % 19 - 9) / 64.0f;
+            }
+            for (int i = 0; i < oc; ++i) {
+                bias[i] = (float)(i - l) / 16.0f;
+            }
+            y = _Tanh(_Conv(std::move(weight), std::move(bias), y, {ic, oc}, {kernel, kernel}, SAME));
+        }
+        y = _Convert(y, NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        const char* cacheFile = "KernelTuningTest.cache";
+        remove(cacheFile);
+        auto compute = [&](int tuning, std::vector<float>& result) {
+            std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+            interp->setSessionHint(Interpreter::CPU_KERNEL_TUNING, tuning);
+            if (tuning > 0) {
+                interp->setCacheFile(cacheFile);
+            }
+            ScheduleConfig config;
+            config.numThread = 2;
+            auto session = interp->createSession(config);
+            auto input = interp->getSessionInput(session, "x");
+            std::shared_ptr<Tensor> hostInput(new Tensor(input, Tensor::CAFFE));
+            auto ptr = hostInput->host<float>();
+            for (int i = 0; i < hostInput->elementSize(); ++i) {
+                ptr[i] = (float)(i % 23 - 11) / 11.0f;
+            }
+            input->copyFromHostTensor(hostInput.get());
+            if (NO_ERROR != interp->runSession(session)) {
+                return false;
+            }
+            auto output = interp->getSessionOutput(session, "y");
+            std::shared_ptr<Tensor> hostOutput(new Tensor(output, Tensor::CAFFE));
+            output->copyToHostTensor(hostOutput.get());
+            result.resize(hostOutput->elementSize());
+            ::memcpy(result.data(), hostOutput->host<float>(), result.size() * sizeof(float));
+            return true;
+        };
+        auto readCache = [&]() {
+            std::string content;
+            auto file = fopen(cacheFile, "rb");
+            if (nullptr == file) {
+                return content;
+            }
+            char buffer[256];
+            size_t size;
+            while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                content.append(buffer, size);
+            }
+            fclose(file);
+            return content;
+        };
+        std::vector<float> expect;
+        if (!compute(0, expect)) {
+            MNN_ERROR("KernelTuningTest run session error\n");
+            return false;
+        }
+        // The first run measures and writes the cache, the second run reads it
+        for (int t = 0; t < 2; ++t) {
+            std::vector<float> result;
+            if (!compute(1, result) || result.size() != expect.size()) {
+                MNN_ERROR("KernelTuningTest run tuned session error\n");
+                remove(cacheFile);
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(expect[i] - result[i]) > 0.001f) {
+                    MNN_ERROR("KernelTuningTest %d error at %d: %f - %f\n", t, i, expect[i], result[i]);
+                    remove(cacheFile);
+                    return false;
+                }
+            }
+            auto content = readCache();
+            // One line for magic and one line for each shape of convolution, 3x3 may not have candidates by estimation
+            int lines = 0;
+            for (auto c : content) {
+                if (c == '\n') {
+                    lines++;
+                }
+            }
+            if (lines < 2 || lines > 3) {
+                MNN_ERROR("KernelTuningTest cache file error in %d run, lines = %d\n", t, lines);
+                remove(cacheFile);
+                return false;
+            }
+        }
+        remove(cacheFile);
+        return true;
+    }
+};
+MNNTestSuiteRegister(KernelTuningTest, "core/kernel_tuning");
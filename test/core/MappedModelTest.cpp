@@ -0,0 +1,154 @@
+//
+//  MappedModelTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/08.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <stdio.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class MappedModelTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        const int ic = 4, oc = 8, h = 6, w = 6;
+        auto x = _Input({1, ic, h, w}, NCHW, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(oc * ic * 3 * 3);
+        std::vector<float> bias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 11 - 5) / 16.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)i / 8.0f;
+        }
+        auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {ic, oc}, {3, 3}, SAME);
+        y = _Convert(y, NCHW);
+        std::vector<float> addValue(oc * h * w);
+        for (int i = 0; i < addValue.size(); ++i) {
+            addValue[i] = (float)(i % 9) / 4.0f;
+        }
+        y = _Multiply(_Add(y, _Const(addValue.data(), {1, oc, h, w}, NCHW)), _Scalar<float>(0.5f));
+        y->setName("y");
+        const char* fileName = "MappedModelTest.mnn";
+        Variable::save({y}, fileName);
+
+        auto compute = [&](Interpreter* interp, std::vector<float>& result) {
+            ScheduleConfig config;
+            auto session = interp->createSession(config);
+            if (nullptr == session) {
+                return false;
+            }
+            interp->releaseModel();
+            auto input = interp->getSessionInput(session, "x");
+            auto ptr = input->host<float>();
+            for (int i = 0; i < input->elementSize(); ++i) {
+                ptr[i] = (float)(i % 13 - 6) / 6.0f;
+            }
+            if (NO_ERROR != interp->runSession(session)) {
+                return false;
+            }
+            auto output = interp->getSessionOutput(session, "y");
+            result.resize(output->elementSize());
+            ::memcpy(result.data(), output->host<float>(), result.size() * sizeof(float));
+            return true;
+        };
+        std::shared_ptr<Interpreter> readNet(Interpreter::createFromFile(fileName));
+        std::shared_ptr<Interpreter> mappedNet(Interpreter::createFromMappedFile(fileName));
+        std::vector<float> expect, mappedResult;
+        bool res = nullptr != readNet && nullptr != mappedNet && compute(readNet.get(), expect) && compute(mappedNet.get(), mappedResult);
+        readNet.reset();
+        mappedNet.reset();
+        remove(fileName);
+        if (!res || expect.size() != mappedResult.size()) {
+            MNN_ERROR("MappedModelTest run mapped net error\n");
+            return false;
+        }
+        for (int i = 0; i < expect.size(); ++i) {
+            if (fabsf(expect[i] - mappedResult[i]) > 0.001f) {
+                MNN_ERROR("MappedModelTest error at %d: %f - %f\n", i, expect[i], mappedResult[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(MappedModelTest, "core/mapped_model");
+
+// Const ops reading an external file per op, computed by the CPU backend
+class MappedExternalConstTest : public MNNTestCase {
+public:
+    static VARP createConst(const char* fileName, int64_t offset, int size) {
+        std::unique_ptr<OpT> op(new OpT);
+        op->type = OpType_Const;
+        op->main.type = OpParameter_Blob;
+        op->main.value = new BlobT;
+        auto blob = op->main.AsBlob();
+        blob->dims = {size};
+        blob->dataType = DataType_DT_FLOAT;
+        blob->dataFormat = MNN_DATA_FORMAT_NCHW;
+        blob->external = {offset, (int64_t)(size * sizeof(float))};
+        op->externalPath = fileName;
+        return Variable::create(Expr::create(op.get(), {}, 1));
+    }
+    virtual bool run(int precision) {
+        const int size = 37;
+        const char* fileName = "MappedExternalConstTest.bin";
+        // a, b and then c after 2 bytes, so that c is misaligned and copied
+        std::vector<float> data(3 * size);
+        for (int i = 0; i < data.size(); ++i) {
+            data[i] = (float)(i % 23 - 11) / 8.0f;
+        }
+        std::vector<uint8_t> bytes(data.size() * sizeof(float) + 2, 0);
+        ::memcpy(bytes.data(), data.data(), 2 * size * sizeof(float));
+        ::memcpy(bytes.data() + 2 * size * sizeof(float) + 2, data.data() + 2 * size, size * sizeof(float));
+        FILE* f = fopen(fileName, "wb");
+        if (nullptr == f) {
+            MNN_ERROR("MappedExternalConstTest can't write %s\n", fileName);
+            return false;
+        }
+        fwrite(bytes.data(), 1, bytes.size(), f);
+        fclose(f);
+        bool res = true;
+        {
+            auto a = createConst(fileName, 0, size);
+            auto b = createConst(fileName, size * sizeof(float), size);
+            auto c = createConst(fileName, 2 * size * sizeof(float) + 2, size);
+            auto x = _Input({1}, NCHW, halide_type_of<float>());
+            auto y = a * x + b - c;
+            // The second compute resizes for the new shape of x, the mapped output of a and b must stay valid
+            for (int loop = 0; res && loop < 2; ++loop) {
+                x->resize({1 == loop ? size : 1});
+                auto xPtr = x->writeMap<float>();
+                for (int i = 0; i < x->getInfo()->size; ++i) {
+                    xPtr[i] = 2.0f + (float)i;
+                }
+                auto yPtr = y->readMap<float>();
+                if (nullptr == yPtr) {
+                    MNN_ERROR("MappedExternalConstTest compute error\n");
+                    res = false;
+                    break;
+                }
+                for (int i = 0; i < size; ++i) {
+                    float scale = 2.0f + (1 == loop ? (float)i : 0.0f);
+                    float expect = data[i] * scale + data[size + i] - data[2 * size + i];
+                    if (fabsf(expect - yPtr[i]) > 0.001f) {
+                        MNN_ERROR("MappedExternalConstTest error at %d: %f - %f\n", i, expect, yPtr[i]);
+                        res = false;
+                        break;
+                    }
+                }
+            }
+        }
+        remove(fileName);
+        return res;
+    }
+};
+MNNTestSuiteRegister(MappedExternalConstTest, "core/mapped_external_const");
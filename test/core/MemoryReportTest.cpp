@@ -0,0 +1,115 @@
+//
+//  MemoryReportTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/25.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/Module.hpp>
+#include <string.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class MemoryReportTest : public MNNTestCase {
+public:
+    static const Interpreter::MemoryReport::OpMemory* findOp(const Interpreter::MemoryReport& report, const std::string& name) {
+        for (auto& op : report.ops) {
+            if (op.name == name) {
+                return &op;
+            }
+        }
+        return nullptr;
+    }
+    static bool check(const Interpreter::MemoryReport& report, int topNumber, size_t largestTensor, const char* tag) {
+        // Packed weights are not smaller than the origin weights
+        auto conv1 = findOp(report, "conv1");
+        auto conv2 = findOp(report, "conv2");
+        if (nullptr == conv1 || nullptr == conv2 || conv1->staticBytes < 16 * 8 * 9 * sizeof(float) || conv2->staticBytes < 32 * 16 * sizeof(float)) {
+            MNN_ERROR("%s: static bytes of convolution error\n", tag);
+            return false;
+        }
+        if (report.runtimeBytes == 0 || report.runtimeFragmentation < 0.0f || report.runtimeFragmentation > 1.0f) {
+            MNN_ERROR("%s: runtime memory error\n", tag);
+            return false;
+        }
+        if (report.dynamicPeakBytes < largestTensor || report.dynamicBytes < report.dynamicPeakBytes || report.peakOpBytes != report.dynamicPeakBytes) {
+            MNN_ERROR("%s: dynamic memory error, arena: %zu, peak: %zu\n", tag, report.dynamicBytes, report.dynamicPeakBytes);
+            return false;
+        }
+        if (nullptr == findOp(report, report.peakOpName) || report.peakFragmentation < 0.0f || report.peakFragmentation > 1.0f) {
+            MNN_ERROR("%s: peak op error: %s\n", tag, report.peakOpName.c_str());
+            return false;
+        }
+        // The peak may be reached by the temporary buffers of an op, so only check the tensors are counted in the peak
+        if (report.peakTensors.empty() || report.peakTensors.size() > topNumber || report.peakTensors[0].bytes > report.peakOpBytes) {
+            MNN_ERROR("%s: peak tensors error\n", tag);
+            return false;
+        }
+        for (int i = 1; i < report.peakTensors.size(); ++i) {
+            if (report.peakTensors[i].bytes > report.peakTensors[i - 1].bytes) {
+                MNN_ERROR("%s: peak tensors are not sorted\n", tag);
+                return false;
+            }
+        }
+        return true;
+    }
+    virtual bool run(int precision) {
+        const int h = 16, w = 16;
+        auto x = _Input({1, 8, h, w}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        auto y = _Conv(std::vector<float>(16 * 8 * 9, 0.1f), std::vector<float>(16, 0.0f), x, {8, 16}, {3, 3}, SAME);
+        y->expr().first->setName("conv1");
+        y = _Conv(std::vector<float>(32 * 16, 0.1f), std::vector<float>(32, 0.0f), y, {16, 32}, {1, 1}, VALID);
+        y->expr().first->setName("conv2");
+        y = _Relu(y);
+        y = _Convert(y, NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+        // The largest tensor is the output of conv2 or relu, the peak is not less than it
+        const size_t largestTensor = 32 * h * w * sizeof(float);
+
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        auto session = interp->createSession(config);
+        Interpreter::MemoryReport report;
+        report.topNumber = 2;
+        if (!interp->getSessionInfo(session, Interpreter::MEMORY_REPORT, &report) || !check(report, 2, largestTensor, "Session")) {
+            return false;
+        }
+
+        std::shared_ptr<Executor::RuntimeManager> rtmgr(Executor::RuntimeManager::createRuntimeManager(config));
+        std::shared_ptr<Module> module(Module::load({"x"}, {"y"}, builderOutput.GetBufferPointer(), builderOutput.GetSize(), rtmgr));
+        auto input = _Input({1, 8, h, w}, NC4HW4, halide_type_of<float>());
+        ::memset(input->writeMap<float>(), 0, input->getInfo()->size * sizeof(float));
+        auto output = module->onForward({input});
+        if (output.empty() || nullptr == output[0]->readMap<float>()) {
+            MNN_ERROR("MemoryReportTest module forward error\n");
+            return false;
+        }
+        Interpreter::MemoryReport moduleReport;
+        moduleReport.topNumber = 1;
+        if (!rtmgr->getInfo(Interpreter::MEMORY_REPORT, &moduleReport) || !check(moduleReport, 1, largestTensor, "RuntimeManager")) {
+            return false;
+        }
+        // The sessions of released module are not counted
+        module.reset();
+        output.clear();
+        rtmgr->getInfo(Interpreter::MEMORY_REPORT, &moduleReport);
+        if (!moduleReport.ops.empty()) {
+            MNN_ERROR("MemoryReportTest released module is still reported\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(MemoryReportTest, "core/memory_report");
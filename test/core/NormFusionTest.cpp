@@ -0,0 +1,156 @@
+//
+//  NormFusionTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/04/03.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/Trace.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class NormFusionTest : public MNNTestCase {
+public:
+    static VARP _LayerNorm(VARP x, int size, bool useRMS) {
+        std::unique_ptr<OpT> op(new OpT);
+        op->type       = OpType_LayerNorm;
+        op->main.type  = OpParameter_LayerNorm;
+        op->main.value = new LayerNormT;
+        auto param = op->main.AsLayerNorm();
+        param->axis       = {-1};
+        param->epsilon    = 1e-5f;
+        param->useRMSNorm = useRMS;
+        for (int i = 0; i < size; ++i) {
+            param->gamma.emplace_back(1.0f + 0.01f * (i % 7));
+            param->beta.emplace_back(useRMS ? 0.0f : 0.1f * (i % 3));
+        }
+        return Variable::create(Expr::create(op.get(), {x}));
+    }
+    // The sum is read as the residual of a matmul epilogue before the norm, so the norm can't write it
+    static bool testEpilogueResidual() {
+        const int rows = 6, hidden = 32;
+        auto x = _Input({rows, hidden}, NCHW, halide_type_of<float>());
+        x->setName("x");
+        auto r = _Input({rows, hidden}, NCHW, halide_type_of<float>());
+        r->setName("r");
+        std::vector<float> weight(hidden * hidden);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 11 - 5) / 16.0f;
+        }
+        auto h = _Add(x, r);
+        auto g = _Add(h, _MatMul(x, _Const(weight.data(), {hidden, hidden}, NCHW)));
+        g->setName("g");
+        auto y = _LayerNorm(h, hidden, false);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({g, y}, net.get());
+        // Move the norm before the add of the matmul output, which is fused into the matmul
+        auto& ops = net->oplists;
+        int normIndex = -1, addIndex = -1;
+        for (int i = 0; i < ops.size(); ++i) {
+            if (ops[i]->type == OpType_LayerNorm) {
+                normIndex = i;
+            }
+            if (net->tensorName[ops[i]->outputIndexes[0]] == "g") {
+                addIndex = i;
+            }
+        }
+        if (normIndex < 0 || addIndex < 0 || normIndex < addIndex) {
+            MNN_ERROR("NormFusionTest can't find the ops to reorder\n");
+            return false;
+        }
+        std::unique_ptr<OpT> norm(std::move(ops[normIndex]));
+        ops.erase(ops.begin() + normIndex);
+        ops.insert(ops.begin() + addIndex, std::move(norm));
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        interp->setSessionMode(Interpreter::Session_Debug);
+        auto reference = interp->createSession(config);
+        interp->setSessionMode(Interpreter::Session_Release);
+        auto fused = interp->createSession(config);
+        const char* inputs[] = {"x", "r"};
+        for (int i = 0; i < 2; ++i) {
+            fillSessionInput(interp.get(), reference, inputs[i], i, 23, 0.25f);
+            fillSessionInput(interp.get(), fused, inputs[i], i, 23, 0.25f);
+        }
+        interp->runSession(reference);
+        interp->runSession(fused);
+        return checkSessionOutput(interp.get(), reference, fused, "g", 0.001f) && checkSessionOutput(interp.get(), reference, fused, "y", 0.001f);
+    }
+    virtual bool run(int precision) {
+        if (!testEpilogueResidual()) {
+            return false;
+        }
+        // Odd length of the row for the tail of vectorized kernel
+        const int batch = 2, seq = 5, hidden = 67;
+        auto x = _Input({batch, seq, hidden}, NCHW, halide_type_of<float>());
+        x->setName("x");
+        auto r = _Input({batch, seq, hidden}, NCHW, halide_type_of<float>());
+        r->setName("r");
+        // The residual stream is read after the layer norm
+        auto h = _Add(x, r);
+        auto y1 = _LayerNorm(h, hidden, false);
+        y1->setName("y1");
+        auto stream = _Relu(h);
+        stream->setName("stream");
+        // The sum is only read by the rms norm
+        auto y2 = _LayerNorm(_Add(stream, x), hidden, true);
+        y2->setName("y2");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y1, stream, y2}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        config.saveTensors = {"y1", "stream", "y2"};
+        // The separate add is kept in debug mode
+        interp->setSessionMode(Interpreter::Session_Debug);
+        auto reference = interp->createSession(config);
+        interp->setSessionMode(Interpreter::Session_Release);
+        auto fused = interp->createSession(config);
+        const char* inputs[] = {"x", "r"};
+        for (int i = 0; i < 2; ++i) {
+            fillSessionInput(interp.get(), reference, inputs[i], i, 23, 0.25f);
+            fillSessionInput(interp.get(), fused, inputs[i], i, 23, 0.25f);
+        }
+        interp->runSession(reference);
+        const char* traceFile = "NormFusionTest.json";
+        Trace::start();
+        interp->runSession(fused);
+        Trace::stop();
+        Trace::dump(traceFile);
+        auto content = readFileToString(traceFile);
+        remove(traceFile);
+        const char* outputs[] = {"y1", "stream", "y2"};
+        for (int i = 0; i < 3; ++i) {
+            if (!checkSessionOutput(interp.get(), reference, fused, outputs[i], 0.001f)) {
+                return false;
+            }
+        }
+        if (content.find("\"LayerNorm\"") == std::string::npos) {
+            MNN_ERROR("NormFusionTest LayerNorm is not traced\n");
+            return false;
+        }
+        if (content.find("\"BinaryOp\"") != std::string::npos) {
+            MNN_ERROR("NormFusionTest BinaryOp is not fused\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(NormFusionTest, "core/norm_fusion");
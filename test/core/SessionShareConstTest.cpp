@@ -0,0 +1,122 @@
+//
+//  SessionShareConstTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/06.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class SessionShareConstTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        const int ic = 128, oc = 128;
+        auto x = _Input({1, ic, 4, 4}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(oc * ic * 3 * 3);
+        std::vector<float> bias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 19 - 9) / 256.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)(i % 7) / 8.0f;
+        }
+        auto y = _Conv(std::move(weight), std::move(bias), x, {ic, oc}, {3, 3}, SAME);
+        y = _Convert(y, NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        interp->setSessionMode(Interpreter::Session_Const_Share);
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto compute = [&](Session* session, std::vector<float>& result) {
+            auto input = interp->getSessionInput(session, "x");
+            std::shared_ptr<Tensor> hostInput(new Tensor(input, Tensor::CAFFE));
+            auto ptr = hostInput->host<float>();
+            for (int i = 0; i < hostInput->elementSize(); ++i) {
+                ptr[i] = (float)(i % 13 - 6) / 6.0f;
+            }
+            input->copyFromHostTensor(hostInput.get());
+            if (NO_ERROR != interp->runSession(session)) {
+                return false;
+            }
+            auto output = interp->getSessionOutput(session, "y");
+            std::shared_ptr<Tensor> hostOutput(new Tensor(output, Tensor::CAFFE));
+            output->copyToHostTensor(hostOutput.get());
+            result.resize(hostOutput->elementSize());
+            ::memcpy(result.data(), hostOutput->host<float>(), result.size() * sizeof(float));
+            return true;
+        };
+        auto first = interp->createSession(config);
+        auto second = interp->createSession(config);
+        std::vector<float> firstResult, secondResult;
+        if (!compute(first, firstResult) || !compute(second, secondResult)) {
+            MNN_ERROR("SessionShareConstTest run session error\n");
+            return false;
+        }
+        for (int i = 0; i < firstResult.size(); ++i) {
+            if (fabsf(firstResult[i] - secondResult[i]) > 0.001f) {
+                MNN_ERROR("SessionShareConstTest error at %d: %f - %f\n", i, firstResult[i], secondResult[i]);
+                return false;
+            }
+        }
+        // The packed weight is held by the first session only
+        float firstMemory = 0.0f, secondMemory = 0.0f;
+        interp->getSessionInfo(first, Interpreter::MEMORY, &firstMemory);
+        interp->getSessionInfo(second, Interpreter::MEMORY, &secondMemory);
+        if (secondMemory >= firstMemory) {
+            MNN_ERROR("SessionShareConstTest memory not shared: %f - %f\n", firstMemory, secondMemory);
+            return false;
+        }
+        // A session with another config is not cloned, so it packs its own weight
+        ScheduleConfig otherConfig;
+        otherConfig.numThread = 2;
+        BackendConfig lowMemory;
+        lowMemory.memory = BackendConfig::Memory_Low;
+        otherConfig.backendConfig = &lowMemory;
+        auto third = interp->createSession(otherConfig);
+        std::vector<float> thirdResult;
+        if (!compute(third, thirdResult)) {
+            MNN_ERROR("SessionShareConstTest run session error\n");
+            return false;
+        }
+        float thirdMemory = 0.0f;
+        interp->getSessionInfo(third, Interpreter::MEMORY, &thirdMemory);
+        if (thirdMemory <= secondMemory) {
+            MNN_ERROR("SessionShareConstTest session with other config is cloned: %f - %f\n", thirdMemory, secondMemory);
+            return false;
+        }
+        for (int i = 0; i < firstResult.size(); ++i) {
+            if (fabsf(firstResult[i] - thirdResult[i]) > 0.001f) {
+                MNN_ERROR("SessionShareConstTest error at %d: %f - %f\n", i, firstResult[i], thirdResult[i]);
+                return false;
+            }
+        }
+        interp->releaseSession(third);
+        // Release the first session, the second one must still work
+        interp->releaseSession(first);
+        std::vector<float> secondResultAgain;
+        if (!compute(second, secondResultAgain)) {
+            return false;
+        }
+        for (int i = 0; i < secondResult.size(); ++i) {
+            if (fabsf(secondResultAgain[i] - secondResult[i]) > 0.001f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(SessionShareConstTest, "core/session_share_const");
@@ -0,0 +1,86 @@
+//
+//  SoftmaxFusionTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/28.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/Trace.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class SoftmaxFusionTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        // Odd length of last axis for the tail of vectorized kernel
+        const int batch = 2, head = 3, seq = 5, length = 37;
+        auto x = _Input({batch, head, seq, length}, NCHW, halide_type_of<float>());
+        x->setName("x");
+        // The attention mask broadcast for head and query
+        auto mask = _Input({batch, 1, 1, length}, NCHW, halide_type_of<float>());
+        mask->setName("mask");
+        auto fullMask = _Input({batch, head, seq, length}, NCHW, halide_type_of<float>());
+        fullMask->setName("fullMask");
+        auto y1 = _Softmax(_Add(_Multiply(x, _Scalar<float>(0.125f)), mask), -1);
+        y1->setName("y1");
+        auto y2 = _Softmax(_Divide(x, _Scalar<float>(8.0f)), -1);
+        y2->setName("y2");
+        auto y3 = _Softmax(_Add(fullMask, x), -1);
+        y3->setName("y3");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y1, y2, y3}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        config.saveTensors = {"y1", "y2", "y3"};
+        // The separate scale and mask ops are kept in debug mode
+        interp->setSessionMode(Interpreter::Session_Debug);
+        auto reference = interp->createSession(config);
+        interp->setSessionMode(Interpreter::Session_Release);
+        auto fused = interp->createSession(config);
+        const char* inputs[] = {"x", "mask", "fullMask"};
+        for (int i = 0; i < 3; ++i) {
+            fillSessionInput(interp.get(), reference, inputs[i], i, 23, 1.0f);
+            fillSessionInput(interp.get(), fused, inputs[i], i, 23, 1.0f);
+        }
+        interp->runSession(reference);
+        const char* traceFile = "SoftmaxFusionTest.json";
+        Trace::start();
+        interp->runSession(fused);
+        Trace::stop();
+        Trace::dump(traceFile);
+        auto content = readFileToString(traceFile);
+        remove(traceFile);
+        const char* outputs[] = {"y1", "y2", "y3"};
+        for (int i = 0; i < 3; ++i) {
+            if (!checkSessionOutput(interp.get(), reference, fused, outputs[i], 0.001f)) {
+                return false;
+            }
+        }
+        if (content.find("\"Softmax\"") == std::string::npos) {
+            MNN_ERROR("SoftmaxFusionTest Softmax is not traced\n");
+            return false;
+        }
+        const char* fusedTypes[] = {"\"BinaryOp\"", "\"While\""};
+        for (auto type : fusedTypes) {
+            if (content.find(type) != std::string::npos) {
+                MNN_ERROR("SoftmaxFusionTest %s is not fused\n", type);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(SoftmaxFusionTest, "core/softmax_fusion");
@@ -0,0 +1,152 @@
+//
+//  TraceTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/Trace.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+#include "MNN_generated.h"
+#include "core/TraceBuffer.hpp"
+using namespace MNN::Express;
+using namespace MNN;
+
+class TraceTest : public MNNTestCase {
+public:
+    static int countOf(const std::string& content, const std::string& key) {
+        int number = 0;
+        for (auto pos = content.find(key); pos != std::string::npos; pos = content.find(key, pos + key.size())) {
+            number++;
+        }
+        return number;
+    }
+    virtual bool run(int precision) {
+        const int ic = 8, oc = 8, h = 10, w = 10;
+        auto x = _Input({1, ic, h, w}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(oc * ic * 3 * 3, 0.1f);
+        std::vector<float> bias(oc, 0.0f);
+        auto y = _Relu(_Conv(std::move(weight), std::move(bias), x, {ic, oc}, {3, 3}, SAME));
+        y = _Convert(y, NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        auto session = interp->createSession(config);
+        const char* traceFile = "TraceTest.json";
+
+        Trace::start();
+        if (!Trace::enabled()) {
+            MNN_ERROR("TraceTest start trace failed\n");
+            return false;
+        }
+        interp->resizeSession(session);
+        const int loop = 3;
+        for (int i = 0; i < loop; ++i) {
+            interp->runSession(session);
+        }
+        // Lazy compute of express
+        auto a = _Const(1.0f, {4, 4}, NCHW);
+        auto b = _Sqrt(_Add(a, a));
+        b->readMap<float>();
+        Trace::stop();
+        // Not recorded after stop
+        interp->runSession(session);
+        bool res = Trace::dump(traceFile);
+        auto content = readFileToString(traceFile);
+        remove(traceFile);
+        if (!res || content.find("\"traceEvents\"") == std::string::npos) {
+            MNN_ERROR("TraceTest dump failed\n");
+            return false;
+        }
+        int convNumber = countOf(content, "\"type\":\"Convolution\"");
+        if (convNumber != loop) {
+            MNN_ERROR("TraceTest convolution recorded %d times, expect %d\n", convNumber, loop);
+            return false;
+        }
+        // Flops are computed from the op when the debug info is not prepared
+        auto flopsKey = std::string("\"type\":\"Convolution\",\"mflops\":");
+        auto flopsPos = content.find(flopsKey);
+        float flops = flopsPos == std::string::npos ? 0.0f : atof(content.c_str() + flopsPos + flopsKey.size());
+        if (flops <= 0.0f) {
+            MNN_ERROR("TraceTest convolution flops not recorded\n");
+            return false;
+        }
+        if (countOf(content, "\"cat\":\"resize\"") < 1 || countOf(content, "Executor::compute") < 1) {
+            MNN_ERROR("TraceTest resize or express compute not recorded\n");
+            return false;
+        }
+        // Ring buffer keeps only the last events
+        Trace::start(2);
+        for (int i = 0; i < loop; ++i) {
+            interp->runSession(session);
+        }
+        Trace::stop();
+        res = Trace::dump(traceFile);
+        content = readFileToString(traceFile);
+        remove(traceFile);
+        if (!res || countOf(content, "\"ph\":\"X\"") != 2) {
+            MNN_ERROR("TraceTest ring buffer error\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(TraceTest, "core/trace");
+
+class TraceBufferWrapTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        // Small ring, so that the writers keep wrapping onto the same slots
+        TraceBuffer buffer(3);
+        const int threadNumber = 4;
+        const int eventNumber = 2000;
+        std::atomic<bool> running(true);
+        std::atomic<bool> torn(false);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threadNumber; ++t) {
+            writers.emplace_back([&, t]() {
+                char name[32];
+                for (int i = 0; i < eventNumber; ++i) {
+                    snprintf(name, sizeof(name), "w%d_%d", t, i);
+                    buffer.record(name, name, "op", i, i, (float)i, i);
+                }
+            });
+        }
+        std::thread reader([&]() {
+            while (running) {
+                for (auto& e : buffer.events()) {
+                    if (0 != strcmp(e.name, e.type) || e.beginUs != e.bytes || (float)e.endUs != e.flops) {
+                        torn = true;
+                    }
+                }
+            }
+        });
+        for (auto& w : writers) {
+            w.join();
+        }
+        running = false;
+        reader.join();
+        if (torn) {
+            MNN_ERROR("TraceBufferWrapTest read a torn event\n");
+            return false;
+        }
+        return buffer.events().size() <= 3;
+    }
+};
+MNNTestSuiteRegister(TraceBufferWrapTest, "core/trace_buffer_wrap");
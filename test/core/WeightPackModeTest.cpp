@@ -0,0 +1,89 @@
+//
+//  WeightPackModeTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/11.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class WeightPackModeTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        const int ic = 16, oc = 16, h = 9, w = 9;
+        auto x = _Input({1, ic, h, w}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        auto y = x;
+        // 3x3 and 1x1 convolutions use different executions
+        for (int l = 0; l < 4; ++l) {
+            int kernel = l % 2 == 0 ? 3 : 1;
+            std::vector<float> weight(oc * ic * kernel * kernel);
+            std::vector<float> bias(oc);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)((i * (l + 3)) % 17 - 8) / 64.0f;
+            }
+            for (int i = 0; i < oc; ++i) {
+                bias[i] = (float)(i - l) / 16.0f;
+            }
+            y = _Tanh(_Conv(std::move(weight), std::move(bias), y, {ic, oc}, {kernel, kernel}, SAME));
+        }
+        y = _Convert(y, NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        auto compute = [&](int packMode, std::vector<float>& result) {
+            std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+            interp->setSessionHint(Interpreter::WEIGHT_PACK_MODE, packMode);
+            ScheduleConfig config;
+            config.numThread = 2;
+            auto session = interp->createSession(config);
+            auto input = interp->getSessionInput(session, "x");
+            std::shared_ptr<Tensor> hostInput(new Tensor(input, Tensor::CAFFE));
+            auto ptr = hostInput->host<float>();
+            for (int i = 0; i < hostInput->elementSize(); ++i) {
+                ptr[i] = (float)(i % 23 - 11) / 11.0f;
+            }
+            input->copyFromHostTensor(hostInput.get());
+            if (NO_ERROR != interp->runSession(session)) {
+                return false;
+            }
+            auto output = interp->getSessionOutput(session, "y");
+            std::shared_ptr<Tensor> hostOutput(new Tensor(output, Tensor::CAFFE));
+            output->copyToHostTensor(hostOutput.get());
+            result.resize(hostOutput->elementSize());
+            ::memcpy(result.data(), hostOutput->host<float>(), result.size() * sizeof(float));
+            return true;
+        };
+        std::vector<float> expect;
+        if (!compute(0, expect)) {
+            MNN_ERROR("WeightPackModeTest run session error\n");
+            return false;
+        }
+        for (int mode = 1; mode <= 2; ++mode) {
+            std::vector<float> result;
+            if (!compute(mode, result) || result.size() != expect.size()) {
+                MNN_ERROR("WeightPackModeTest run session error for mode %d\n", mode);
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(expect[i] - result[i]) > 0.001f) {
+                    MNN_ERROR("WeightPackModeTest mode %d error at %d: %f - %f\n", mode, i, expect[i], result[i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(WeightPackModeTest, "core/weight_pack_mode");
@@ -0,0 +1,71 @@
+//
+//  ElementwiseFuseTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/15.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/expr/Expr.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+class ElementwiseFuseTest : public MNNTestCase {
+public:
+    virtual ~ElementwiseFuseTest() = default;
+    virtual bool run(int precision) {
+        // Larger than one block to check the tail
+        const int size = 1000;
+        auto x = _Input({2, size / 2}, NCHW);
+        auto b = _Input({2, size / 2}, NCHW);
+        auto xPtr = x->writeMap<float>();
+        auto bPtr = b->writeMap<float>();
+        for (int i = 0; i < size; ++i) {
+            xPtr[i] = (float)(i % 17 - 8) / 8.0f;
+            bPtr[i] = (float)(i % 5) / 4.0f;
+        }
+        // t is used twice, so the chain is split at t
+        auto t = _Sigmoid(x * _Scalar<float>(2.0f) + b);
+        auto y = _Tanh(_Square(t) - _Scalar<float>(0.5f)) * _Exp(_Negative(t)) / (b + _Scalar<float>(1.0f));
+        auto yPtr = y->readMap<float>();
+        if (nullptr == yPtr || y->getInfo()->size != size) {
+            MNN_ERROR("ElementwiseFuseTest compute error\n");
+            return false;
+        }
+        float limit = precision <= 1 ? 0.001f : 0.05f;
+        for (int i = 0; i < size; ++i) {
+            float tv = 1.0f / (1.0f + expf(-(xPtr[i] * 2.0f + bPtr[i])));
+            float expect = tanhf(tv * tv - 0.5f) * expf(-tv) / (bPtr[i] + 1.0f);
+            if (fabsf(expect - yPtr[i]) > limit) {
+                MNN_ERROR("ElementwiseFuseTest error at %d: %f - %f\n", i, expect, yPtr[i]);
+                return false;
+            }
+        }
+        // Change input content and shape, the fused op should recompute
+        x->resize({3, 7});
+        b->resize({3, 7});
+        xPtr = x->writeMap<float>();
+        bPtr = b->writeMap<float>();
+        for (int i = 0; i < 21; ++i) {
+            xPtr[i] = (float)(i % 7 - 3) / 4.0f;
+            bPtr[i] = (float)(i % 3) / 2.0f;
+        }
+        yPtr = y->readMap<float>();
+        if (nullptr == yPtr || y->getInfo()->size != 21) {
+            MNN_ERROR("ElementwiseFuseTest resize error\n");
+            return false;
+        }
+        for (int i = 0; i < 21; ++i) {
+            float tv = 1.0f / (1.0f + expf(-(xPtr[i] * 2.0f + bPtr[i])));
+            float expect = tanhf(tv * tv - 0.5f) * expf(-tv) / (bPtr[i] + 1.0f);
+            if (fabsf(expect - yPtr[i]) > limit) {
+                MNN_ERROR("ElementwiseFuseTest error after resize at %d: %f - %f\n", i, expect, yPtr[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ElementwiseFuseTest, "expr/ElementwiseFuse");
@@ -7,10 +7,12 @@
 //
 
 #include <MNN/expr/Module.hpp>
+#include <MNN/expr/BatchingModule.hpp>
 #include <MNN/expr/ExprCreator.hpp>
 #include <thread>
 #include "MNNTestSuite.h"
 #include "core/Backend.hpp"
+#include "core/MNNMemoryUtils.h"
 #include "RuntimeAttr.hpp"
 #include <MNN/expr/Executor.hpp>
 #define MNN_OPEN_TIME_TRACE
@@ -323,6 +325,92 @@ public:
 };
 MNNTestSuiteRegister(LoopTest, "expr/LoopTest");
 
+class LoopStateTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        const int size = 64;
+        {
+            auto iter = _Input({}, NCHW, halide_type_of<int>());
+            iter->setName("iter");
+            auto cond = _Input({}, NCHW, halide_type_of<int>());
+            cond->setName("cond");
+            auto h = _Input({1, size}, NCHW, halide_type_of<float>());
+            h->setName("state");
+            auto y = _Tanh(h * _Scalar<float>(0.9f) + _Scalar<float>(0.1f));
+            y->setName("state_next");
+            auto scan = _ReduceSum(y);
+            scan->setName("state_sum");
+            auto resCond = _Scalar<int>(1);
+            resCond->setName("state_cond");
+            // The rows of the state are scanned too, each row is 16 bytes aligned and can be written in place
+            auto rows = _Sqrt(_Abs(y));
+            rows->setName("state_rows");
+            ExecutorScope::Current()->registerSubGraph("state_body", {resCond, y, scan, rows}, {iter, cond, h});
+            auto limit = _Input({}, NCHW, halide_type_of<int>());
+            limit->setName("limit");
+            auto x = _Input({1, size}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            auto u = _Loop({limit, _Scalar<int>(1), x}, "state_body");
+            u[0]->setName("h");
+            u[1]->setName("scan");
+            u[2]->setName("rows");
+            buffer = Variable::save(u);
+        }
+        std::shared_ptr<Module> loopModule(Module::load({"limit", "x"}, {"h", "scan", "rows"}, (const uint8_t*)buffer.data(), buffer.size()), Module::destroy);
+        std::vector<float> input(size);
+        for (int i = 0; i < size; ++i) {
+            input[i] = (float)(i % 9 - 4) / 4.0f;
+        }
+        for (int loop : {1, 17, 40}) {
+            // Compute twice to check the loop state is reset by each forward
+            for (int t = 0; t < 2; ++t) {
+                auto limit = _Input({}, NCHW, halide_type_of<int>());
+                limit->writeMap<int>()[0] = loop;
+                auto x = _Input({1, size}, NCHW, halide_type_of<float>());
+                ::memcpy(x->writeMap<float>(), input.data(), size * sizeof(float));
+                auto outputs = loopModule->onForward({limit, x});
+                if (outputs.size() != 3) {
+                    MNN_ERROR("LoopStateTest forward error\n");
+                    return false;
+                }
+                auto hPtr = outputs[0]->readMap<float>();
+                auto scanPtr = outputs[1]->readMap<float>();
+                auto rowsPtr = outputs[2]->readMap<float>();
+                if (nullptr == hPtr || nullptr == scanPtr || outputs[1]->getInfo()->size != loop
+                    || nullptr == rowsPtr || outputs[2]->getInfo()->size != loop * size) {
+                    MNN_ERROR("LoopStateTest output error for loop %d\n", loop);
+                    return false;
+                }
+                std::vector<float> h = input;
+                for (int l = 0; l < loop; ++l) {
+                    float sum = 0.0f;
+                    for (int i = 0; i < size; ++i) {
+                        h[i] = tanhf(h[i] * 0.9f + 0.1f);
+                        sum += h[i];
+                        if (fabsf(rowsPtr[l * size + i] - sqrtf(fabsf(h[i]))) > 0.001f) {
+                            MNN_ERROR("LoopStateTest rows error for loop %d at %d, %d\n", loop, l, i);
+                            return false;
+                        }
+                    }
+                    if (fabsf(scanPtr[l] - sum) > 0.01f) {
+                        MNN_ERROR("LoopStateTest scan error for loop %d at %d: %f - %f\n", loop, l, scanPtr[l], sum);
+                        return false;
+                    }
+                }
+                for (int i = 0; i < size; ++i) {
+                    if (fabsf(hPtr[i] - h[i]) > 0.001f) {
+                        MNN_ERROR("LoopStateTest state error for loop %d at %d: %f - %f\n", loop, i, hPtr[i], h[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(LoopStateTest, "expr/LoopStateTest");
+
 class ModuleCloneTest : public MNNTestCase {
 public:
     virtual bool run(int precision) {
@@ -1190,3 +1278,660 @@ public:
     }
 };
 MNNTestSuiteRegister(WinogradMemoryTest, "expr/WinogradMemoryTest");
+
+// Rearranged module drops the source weights, lazy packing must not refer to them
+class WeightPackRearrangeTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        {
+            auto x = _Input({1, 64, 9, 9}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            auto y = _Convert(x, NC4HW4);
+            // 3x3 and 1x1 convolutions use different executions, the model is large enough to be unmapped when freed
+            for (int l = 0; l < 4; ++l) {
+                int kernel = l % 2 == 0 ? 3 : 1;
+                std::vector<float> weight(64 * 64 * kernel * kernel);
+                std::vector<float> bias(64);
+                for (int i = 0; i < weight.size(); ++i) {
+                    weight[i] = (float)((i * (l + 3)) % 17 - 8) / 64.0f;
+                }
+                for (int i = 0; i < bias.size(); ++i) {
+                    bias[i] = (float)(i % 16 - l) / 16.0f;
+                }
+                y = _Tanh(_Conv(std::move(weight), std::move(bias), y, {64, 64}, {kernel, kernel}, SAME));
+            }
+            y = _Convert(y, NCHW);
+            y->setName("y");
+            buffer = Variable::save({y});
+        }
+        auto forward = [&](int packMode, bool rearrange, std::vector<float>& result) {
+            MNN::ScheduleConfig sconfig;
+            sconfig.numThread = 2;
+            std::shared_ptr<Executor::RuntimeManager> rtMgr(Executor::RuntimeManager::createRuntimeManager(sconfig));
+            rtMgr->setHint(Interpreter::WEIGHT_PACK_MODE, packMode);
+            Module::Config config;
+            config.rearrange = rearrange;
+            std::shared_ptr<Module> net;
+            {
+                // The module owns a copy of the model, free the source buffer before forward
+                std::vector<int8_t> model = buffer;
+                net.reset(Module::load({"x"}, {"y"}, (const uint8_t*)model.data(), model.size(), rtMgr, &config), Module::destroy);
+            }
+            if (nullptr == net) {
+                return false;
+            }
+            auto x = _Input({1, 64, 9, 9}, NCHW, halide_type_of<float>());
+            auto ptr = x->writeMap<float>();
+            for (int i = 0; i < x->getInfo()->size; ++i) {
+                ptr[i] = (float)(i % 23 - 11) / 11.0f;
+            }
+            auto y = net->onForward({x})[0];
+            auto yPtr = y->readMap<float>();
+            result.assign(yPtr, yPtr + y->getInfo()->size);
+            // The source weights of the lazy packing are released after the first forward
+            y = net->onForward({x})[0];
+            yPtr = y->readMap<float>();
+            for (int i = 0; i < result.size(); ++i) {
+                if (fabsf(result[i] - yPtr[i]) > 0.001f) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        std::vector<float> expect;
+        if (!forward(0, false, expect)) {
+            MNN_ERROR("WeightPackRearrangeTest load error\n");
+            return false;
+        }
+        for (int mode = 0; mode <= 2; ++mode) {
+            std::vector<float> result;
+            if (!forward(mode, true, result) || result.size() != expect.size()) {
+                MNN_ERROR("WeightPackRearrangeTest load error for mode %d\n", mode);
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(expect[i] - result[i]) > 0.001f) {
+                    MNN_ERROR("WeightPackRearrangeTest mode %d error at %d: %f - %f\n", mode, i, expect[i], result[i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(WeightPackRearrangeTest, "expr/WeightPackRearrangeTest");
+
+class ShapeCacheTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        {
+            auto x = _Input({1, 4, -1, -1}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            std::vector<float> weight(8 * 4 * 3 * 3);
+            std::vector<float> bias(8);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 7 - 3) / 8.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / 8.0f;
+            }
+            auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {4, 8}, {3, 3}, SAME);
+            y = _Convert(_Relu(y), NCHW);
+            y->setName("y");
+            buffer = Variable::save({y});
+        }
+        // Position-wise net, which can be padded
+        std::vector<int8_t> pointBuffer;
+        {
+            auto x = _Input({1, 4, -1, -1}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            std::vector<float> weight(8 * 4);
+            std::vector<float> bias(8);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 7 - 3) / 8.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / 8.0f;
+            }
+            auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {4, 8}, {1, 1}, VALID);
+            y = _Convert(_Relu6(y), NCHW) * _Scalar<float>(0.5f) + _Scalar<float>(0.25f);
+            y->setName("y");
+            pointBuffer = Variable::save({y});
+        }
+        auto forward = [&](int cacheSize, int bucket, const std::vector<std::vector<int>>& shapes, std::vector<std::vector<float>>& results, std::vector<std::vector<int>>& outputShapes, const std::vector<int8_t>& buffer) {
+            MNN::ScheduleConfig sconfig;
+            sconfig.numThread = 1;
+            std::shared_ptr<Executor::RuntimeManager> rtMgr(Executor::RuntimeManager::createRuntimeManager(sconfig));
+            rtMgr->setHint(Interpreter::SHAPE_CACHE_SIZE, cacheSize);
+            rtMgr->setHint(Interpreter::SHAPE_BUCKET_SIZE, bucket);
+            Module::Config config;
+            config.shapeMutable = true;
+            std::shared_ptr<Module> net(Module::load({"x"}, {"y"}, (const uint8_t*)buffer.data(), buffer.size(), rtMgr, &config), Module::destroy);
+            for (auto& shape : shapes) {
+                auto x = _Input(shape, NCHW, halide_type_of<float>());
+                auto ptr = x->writeMap<float>();
+                for (int i = 0; i < x->getInfo()->size; ++i) {
+                    ptr[i] = (float)(i % 11 - 5) / 5.0f;
+                }
+                auto y = net->onForward({x})[0];
+                auto info = y->getInfo();
+                auto yPtr = y->readMap<float>();
+                results.emplace_back(std::vector<float>(yPtr, yPtr + info->size));
+                outputShapes.emplace_back(info->dim);
+            }
+        };
+        std::vector<std::vector<int>> shapes {
+            {1, 4, 8, 8}, {1, 4, 12, 10}, {1, 4, 8, 8}, {1, 4, 16, 16}, {1, 4, 12, 10}, {1, 4, 8, 8}
+        };
+        std::vector<std::vector<float>> expect, cached;
+        std::vector<std::vector<int>> expectShapes, cachedShapes;
+        auto compare = [&](const char* name, const std::vector<std::vector<float>>& expect, const std::vector<std::vector<int>>& expectShapes,
+                           const std::vector<std::vector<float>>& result, const std::vector<std::vector<int>>& resultShapes) {
+            if (expectShapes != resultShapes) {
+                MNN_ERROR("ShapeCacheTest %s shape error\n", name);
+                return false;
+            }
+            for (int u = 0; u < expect.size(); ++u) {
+                for (int i = 0; i < expect[u].size(); ++i) {
+                    if (fabsf(expect[u][i] - result[u][i]) > 0.001f) {
+                        MNN_ERROR("ShapeCacheTest %s error for shape %d at %d: %f - %f\n", name, u, i, expect[u][i], result[u][i]);
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+        forward(0, 0, shapes, expect, expectShapes, buffer);
+        forward(2, 0, shapes, cached, cachedShapes, buffer);
+        if (!compare("cache", expect, expectShapes, cached, cachedShapes)) {
+            return false;
+        }
+        // Bucket: the dynamic dims are padded up to multiple of 8, and the outputs are cropped back
+        std::vector<std::vector<int>> bucketInputShapes {{1, 4, 5, 7}, {1, 4, 12, 10}, {1, 4, 6, 8}};
+        std::vector<std::vector<float>> bucketExpect, bucketed;
+        std::vector<std::vector<int>> bucketExpectShapes, bucketShapes;
+        forward(0, 0, bucketInputShapes, bucketExpect, bucketExpectShapes, pointBuffer);
+        forward(2, 8, bucketInputShapes, bucketed, bucketShapes, pointBuffer);
+        if (!compare("bucket", bucketExpect, bucketExpectShapes, bucketed, bucketShapes)) {
+            return false;
+        }
+        // Padding would change the 3x3 convolution at the border, the bucket is ignored
+        bucketExpect.clear();
+        bucketExpectShapes.clear();
+        bucketed.clear();
+        bucketShapes.clear();
+        forward(0, 0, bucketInputShapes, bucketExpect, bucketExpectShapes, buffer);
+        forward(2, 8, bucketInputShapes, bucketed, bucketShapes, buffer);
+        if (!compare("ignored bucket", bucketExpect, bucketExpectShapes, bucketed, bucketShapes)) {
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ShapeCacheTest, "expr/ShapeCacheTest");
+
+class BatchingModuleTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        {
+            auto x = _Input({-1, 4, 6, 6}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            std::vector<float> weight(8 * 4 * 3 * 3);
+            std::vector<float> bias(8);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 7 - 3) / 8.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / 8.0f;
+            }
+            auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {4, 8}, {3, 3}, SAME);
+            y = _Convert(_Relu(y), NCHW);
+            y->setName("y");
+            buffer = Variable::save({y});
+        }
+        Module::Config config;
+        config.shapeMutable = true;
+        std::shared_ptr<Module> net(Module::load({"x"}, {"y"}, (const uint8_t*)buffer.data(), buffer.size(), nullptr, &config), Module::destroy);
+        const int requestNumber = 6;
+        std::vector<VARP> inputs(requestNumber);
+        std::vector<std::vector<float>> expect(requestNumber);
+        for (int r = 0; r < requestNumber; ++r) {
+            inputs[r] = _Input({r % 2 + 1, 4, 6, 6}, NCHW, halide_type_of<float>());
+            auto ptr = inputs[r]->writeMap<float>();
+            for (int i = 0; i < inputs[r]->getInfo()->size; ++i) {
+                ptr[i] = (float)((i + r * 3) % 11 - 5) / 5.0f;
+            }
+            auto y = net->onForward({inputs[r]})[0];
+            auto yPtr = y->readMap<float>();
+            expect[r].assign(yPtr, yPtr + y->getInfo()->size);
+        }
+        BatchingModule::BatchConfig batchConfig;
+        batchConfig.maxBatch = 4;
+        batchConfig.maxWaitUs = 10000;
+        std::shared_ptr<BatchingModule> batching(new BatchingModule(net, batchConfig));
+        std::vector<std::future<std::vector<VARP>>> futures;
+        for (int r = 0; r < requestNumber; ++r) {
+            futures.emplace_back(batching->submit({inputs[r]}));
+        }
+        for (int r = 0; r < requestNumber; ++r) {
+            auto outputs = futures[r].get();
+            if (outputs.size() != 1) {
+                MNN_ERROR("BatchingModuleTest forward error for request %d\n", r);
+                return false;
+            }
+            auto info = outputs[0]->getInfo();
+            auto yPtr = outputs[0]->readMap<float>();
+            if (info->dim[0] != r % 2 + 1 || info->size != expect[r].size()) {
+                MNN_ERROR("BatchingModuleTest shape error for request %d\n", r);
+                return false;
+            }
+            for (int i = 0; i < info->size; ++i) {
+                if (fabsf(expect[r][i] - yPtr[i]) > 0.001f) {
+                    MNN_ERROR("BatchingModuleTest error for request %d at %d: %f - %f\n", r, i, expect[r][i], yPtr[i]);
+                    return false;
+                }
+            }
+        }
+        // The inputs have different batch, so the request can't be merged and must not wait for others
+        {
+            auto a = _Input({1, 4}, NCHW, halide_type_of<float>());
+            a->setName("a");
+            auto b = _Input({2, 4}, NCHW, halide_type_of<float>());
+            b->setName("b");
+            auto c = a + b;
+            c->setName("c");
+            buffer = Variable::save({c});
+        }
+        std::shared_ptr<Module> add(Module::load({"a", "b"}, {"c"}, (const uint8_t*)buffer.data(), buffer.size(), nullptr, &config), Module::destroy);
+        batchConfig.maxWaitUs = 10 * 1000 * 1000;
+        batching.reset(new BatchingModule(add, batchConfig));
+        auto a = _Input({1, 4}, NCHW, halide_type_of<float>());
+        auto b = _Input({2, 4}, NCHW, halide_type_of<float>());
+        auto aPtr = a->writeMap<float>();
+        auto bPtr = b->writeMap<float>();
+        for (int i = 0; i < 8; ++i) {
+            if (i < 4) {
+                aPtr[i] = (float)i;
+            }
+            bPtr[i] = (float)(i * 2);
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto outputs = batching->submit({a, b}).get();
+        auto costUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        if (outputs.size() != 1 || costUs >= batchConfig.maxWaitUs) {
+            MNN_ERROR("BatchingModuleTest request without batch waits for others: %d us\n", (int)costUs);
+            return false;
+        }
+        auto cPtr = outputs[0]->readMap<float>();
+        for (int i = 0; i < 8; ++i) {
+            if (fabsf(cPtr[i] - (float)(i % 4 + i * 2)) > 0.001f) {
+                MNN_ERROR("BatchingModuleTest error for request without batch at %d\n", i);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(BatchingModuleTest, "expr/BatchingModuleTest");
+
+class ForwardAsyncTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        {
+            auto x = _Input({1, 4, 8, 8}, NC4HW4, halide_type_of<float>());
+            x->setName("x");
+            std::vector<float> weight(8 * 4 * 3 * 3);
+            std::vector<float> bias(8);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 5 - 2) / 8.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / 8.0f;
+            }
+            auto y = _Relu(_Conv(std::move(weight), std::move(bias), x, {4, 8}, {3, 3}, SAME));
+            y->setName("y");
+            buffer = Variable::save({y});
+        }
+        std::shared_ptr<Module> net(Module::load({"x"}, {"y"}, (const uint8_t*)buffer.data(), buffer.size()), Module::destroy);
+        const int frameNumber = 5;
+        auto fill = [](VARP x, int frame) {
+            auto ptr = x->writeMap<float>();
+            for (int i = 0; i < x->getInfo()->size; ++i) {
+                ptr[i] = (float)((i + frame * 7) % 13 - 6) / 6.0f;
+            }
+        };
+        auto x = _Input({1, 4, 8, 8}, NCHW, halide_type_of<float>());
+        std::vector<std::vector<float>> expect(frameNumber);
+        for (int f = 0; f < frameNumber; ++f) {
+            fill(x, f);
+            auto y = _Convert(net->onForward({_Convert(x, NC4HW4)})[0], NCHW);
+            auto yPtr = y->readMap<float>();
+            expect[f].assign(yPtr, yPtr + y->getInfo()->size);
+        }
+        for (int doubleBuffer = 0; doubleBuffer < 2; ++doubleBuffer) {
+            net->setAsyncDoubleBuffer(doubleBuffer > 0);
+            std::vector<std::future<std::vector<VARP>>> futures;
+            std::vector<VARP> inputs(frameNumber);
+            for (int f = 0; f < frameNumber; ++f) {
+                if (doubleBuffer) {
+                    // Write every frame to the same variable
+                    fill(x, f);
+                    inputs[f] = x;
+                } else {
+                    inputs[f] = _Input({1, 4, 8, 8}, NCHW, halide_type_of<float>());
+                    fill(inputs[f], f);
+                }
+                futures.emplace_back(net->onForwardAsync({_Convert(inputs[f], NC4HW4)}));
+            }
+            // The caller's Executor and the module are still usable while the async forwards run
+            {
+                auto x0 = _Input({1, 4, 8, 8}, NCHW, halide_type_of<float>());
+                fill(x0, 0);
+                auto y = _Convert(net->onForward({_Convert(x0, NC4HW4)})[0], NCHW);
+                auto yPtr = y->readMap<float>();
+                for (int i = 0; i < expect[0].size(); ++i) {
+                    if (fabsf(expect[0][i] - yPtr[i]) > 0.001f) {
+                        MNN_ERROR("ForwardAsyncTest error for sync forward, doubleBuffer %d, at %d: %f - %f\n", doubleBuffer, i, expect[0][i], yPtr[i]);
+                        return false;
+                    }
+                }
+            }
+            for (int f = 0; f < frameNumber; ++f) {
+                auto outputs = futures[f].get();
+                if (outputs.size() != 1) {
+                    MNN_ERROR("ForwardAsyncTest forward error for frame %d\n", f);
+                    return false;
+                }
+                auto y = _Convert(outputs[0], NCHW);
+                auto yPtr = y->readMap<float>();
+                for (int i = 0; i < expect[f].size(); ++i) {
+                    if (fabsf(expect[f][i] - yPtr[i]) > 0.001f) {
+                        MNN_ERROR("ForwardAsyncTest error for frame %d, doubleBuffer %d, at %d: %f - %f\n", f, doubleBuffer, i, expect[f][i], yPtr[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ForwardAsyncTest, "expr/ForwardAsyncTest");
+
+class SubModuleParallelTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        {
+            // Where splits the net into submodules, the two branches are independent
+            auto x = _Input({4, 16}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            auto ca = _Greater(x * _Scalar<float>(2.0f), _Scalar<float>(0.5f));
+            auto cb = _Less(x - _Scalar<float>(0.25f), _Scalar<float>(0.0f));
+            // Both conditions are computed in the first submodule, so the two Where and their tails run concurrently
+            auto yc = _Tanh(x) + _Cast<float>(ca) - _Cast<float>(cb);
+            auto ya = _ReduceSum(_Cast<float>(_Where(ca)) * _Scalar<float>(0.5f));
+            auto yb = _ReduceSum(_Cast<float>(_Where(cb)) + _Scalar<float>(1.0f));
+            ya->setName("ya");
+            yb->setName("yb");
+            yc->setName("yc");
+            buffer = Variable::save({yc, ya, yb});
+        }
+        auto forward = [&](int parallel, int numThread, std::vector<std::vector<float>>& results) {
+            MNN::ScheduleConfig sconfig;
+            sconfig.numThread = numThread;
+            std::shared_ptr<Executor::RuntimeManager> rtMgr(Executor::RuntimeManager::createRuntimeManager(sconfig));
+            rtMgr->setHint(Interpreter::SUBMODULE_PARALLEL, parallel);
+            std::shared_ptr<Module> net(Module::load({"x"}, {"ya", "yb", "yc"}, (const uint8_t*)buffer.data(), buffer.size(), rtMgr), Module::destroy);
+            for (int t = 0; t < 3; ++t) {
+                auto x = _Input({4, 16}, NCHW, halide_type_of<float>());
+                auto ptr = x->writeMap<float>();
+                for (int i = 0; i < 64; ++i) {
+                    ptr[i] = (float)((i + t * 5) % 9 - 4) / 4.0f;
+                }
+                // The lazy input is shared by the concurrent submodules
+                auto outputs = net->onForward({x * _Scalar<float>(1.0f)});
+                if (outputs.size() != 3) {
+                    return false;
+                }
+                for (auto& y : outputs) {
+                    auto yPtr = y->readMap<float>();
+                    results.emplace_back(std::vector<float>(yPtr, yPtr + y->getInfo()->size));
+                }
+            }
+            return true;
+        };
+        std::vector<std::vector<float>> expect;
+        if (!forward(0, 1, expect)) {
+            MNN_ERROR("SubModuleParallelTest forward error\n");
+            return false;
+        }
+        // The lanes divide the threads, or use one thread each
+        return check(forward, expect, 2, 4) && check(forward, expect, 3, 1);
+    }
+    template <typename T>
+    static bool check(T& forward, const std::vector<std::vector<float>>& expect, int parallel, int numThread) {
+        std::vector<std::vector<float>> result;
+        if (!forward(parallel, numThread, result) || expect.size() != result.size()) {
+            MNN_ERROR("SubModuleParallelTest forward error for parallel %d\n", parallel);
+            return false;
+        }
+        for (int u = 0; u < expect.size(); ++u) {
+            if (expect[u].size() != result[u].size()) {
+                MNN_ERROR("SubModuleParallelTest size error for output %d\n", u);
+                return false;
+            }
+            for (int i = 0; i < expect[u].size(); ++i) {
+                if (fabsf(expect[u][i] - result[u][i]) > 0.001f) {
+                    MNN_ERROR("SubModuleParallelTest parallel %d error for output %d at %d: %f - %f\n", parallel, u, i, expect[u][i], result[u][i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(SubModuleParallelTest, "expr/SubModuleParallelTest");
+
+class ModuleCloneInfoTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        {
+            auto x = _Input({1, 8, 16, 16}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            std::vector<float> weight(16 * 8 * 3 * 3);
+            std::vector<float> bias(16);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 13 - 6) / 16.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / 16.0f;
+            }
+            auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {8, 16}, {3, 3}, SAME);
+            y = _Convert(_Relu(y), NCHW);
+            y->setName("y");
+            buffer = Variable::save({y});
+        }
+        auto makeInput = []() {
+            auto x = _Input({1, 8, 16, 16}, NCHW, halide_type_of<float>());
+            auto ptr = x->writeMap<float>();
+            for (int i = 0; i < x->getInfo()->size; ++i) {
+                ptr[i] = (float)(i % 11 - 5) / 5.0f;
+            }
+            return x;
+        };
+        BackendConfig bnConfig;
+        auto exe = Executor::newExecutor(MNN_FORWARD_CPU, bnConfig, 1);
+        ExecutorScope scope(exe);
+        MNN::ScheduleConfig sconfig;
+        sconfig.numThread = 1;
+        std::shared_ptr<Executor::RuntimeManager> rtMgr(Executor::RuntimeManager::createRuntimeManager(sconfig));
+        Module::Config config;
+        config.shapeMutable = false;
+        std::shared_ptr<Module> net(Module::load({"x"}, {"y"}, (const uint8_t*)buffer.data(), buffer.size(), rtMgr, &config), Module::destroy);
+        auto expectVar = net->onForward({makeInput()})[0];
+        auto expectPtr = expectVar->readMap<float>();
+        std::vector<float> expect(expectPtr, expectPtr + expectVar->getInfo()->size);
+
+        const int cloneNumber = 4;
+        std::vector<std::shared_ptr<Executor>> executors(cloneNumber);
+        std::vector<std::shared_ptr<Module>> clones(cloneNumber);
+        for (int i = 0; i < cloneNumber; ++i) {
+            executors[i] = Executor::newExecutor(MNN_FORWARD_CPU, bnConfig, 1);
+            ExecutorScope current(executors[i]);
+            clones[i].reset(Module::clone(net.get()), Module::destroy);
+        }
+        float info[4];
+        if (!rtMgr->getInfo(Interpreter::CLONE_INFO, info) || (int)info[0] != cloneNumber) {
+            MNN_ERROR("ModuleCloneInfoTest clone number error\n");
+            return false;
+        }
+        // The activation memory is allocated by the first forward
+        if (info[2] != 0.0f) {
+            MNN_ERROR("ModuleCloneInfoTest clone allocate memory before forward: %f MB\n", info[2]);
+            return false;
+        }
+        std::vector<bool> result(cloneNumber, false);
+        {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < cloneNumber; ++i) {
+                threads.emplace_back([&, i]() {
+                    ExecutorScope current(executors[i]);
+                    auto check = [&](Module* m) {
+                        auto y = m->onForward({makeInput()})[0];
+                        auto ptr = y->readMap<float>();
+                        if (nullptr == ptr || y->getInfo()->size != expect.size()) {
+                            return false;
+                        }
+                        for (int j = 0; j < expect.size(); ++j) {
+                            if (fabsf(ptr[j] - expect[j]) > 0.001f) {
+                                return false;
+                            }
+                        }
+                        return true;
+                    };
+                    if (!check(clones[i].get())) {
+                        return;
+                    }
+                    // Clone while the other clones are resizing
+                    std::shared_ptr<Module> another(Module::clone(clones[i].get()), Module::destroy);
+                    result[i] = check(another.get());
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+        for (int i = 0; i < cloneNumber; ++i) {
+            if (!result[i]) {
+                MNN_ERROR("ModuleCloneInfoTest clone %d result error\n", i);
+                return false;
+            }
+        }
+        rtMgr->getInfo(Interpreter::CLONE_INFO, info);
+        if (info[2] <= 0.0f) {
+            MNN_ERROR("ModuleCloneInfoTest clone memory not reported\n");
+            return false;
+        }
+        MNN_PRINT("Clone time: %f ms, memory per clone: %f MB, rebuilt executions: %f\n", info[1], info[2], info[3]);
+        // All clones are made after the first forward of their source, so none of them packs weights again
+        if (info[3] != 0.0f) {
+            MNN_ERROR("ModuleCloneInfoTest clone rebuilds %f executions\n", info[3]);
+            return false;
+        }
+        for (int i = 0; i < cloneNumber; ++i) {
+            ExecutorScope current(executors[i]);
+            clones[i].reset();
+        }
+        rtMgr->getInfo(Interpreter::CLONE_INFO, info);
+        if ((int)info[0] != 0) {
+            MNN_ERROR("ModuleCloneInfoTest released clones still alive: %f\n", info[0]);
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ModuleCloneInfoTest, "expr/ModuleCloneInfoTest");
+
+class BindOutputTest : public MNNTestCase {
+public:
+    virtual bool run(int precision) {
+        std::vector<int8_t> buffer;
+        const int ic = 4, oc = 8, h = 12, w = 12;
+        {
+            auto x = _Input({1, ic, h, w}, NCHW, halide_type_of<float>());
+            x->setName("x");
+            std::vector<float> weight(oc * ic * 3 * 3);
+            std::vector<float> bias(oc);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 7 - 3) / 8.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / 8.0f;
+            }
+            auto y = _Convert(_Relu(_Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {ic, oc}, {3, 3}, SAME)), NCHW);
+            y->setName("y");
+            auto z = _ReduceSum(y * _Scalar<float>(2.0f), {1});
+            z->setName("z");
+            buffer = Variable::save({y, z});
+        }
+        std::shared_ptr<Module> net(Module::load({"x"}, {"y", "z"}, (const uint8_t*)buffer.data(), buffer.size()), Module::destroy);
+        std::shared_ptr<Module> expectNet(Module::load({"x"}, {"y", "z"}, (const uint8_t*)buffer.data(), buffer.size()), Module::destroy);
+        const size_t inputSize = ic * h * w;
+        const size_t outputSizes[2] = {(size_t)oc * h * w, (size_t)h * w};
+        std::shared_ptr<float> inputMemory((float*)MNNMemoryAllocAlign(inputSize * sizeof(float), MNN_MEMORY_ALIGN_DEFAULT), MNNMemoryFreeAlign);
+        std::shared_ptr<float> outputMemory[2];
+        for (int i = 0; i < 2; ++i) {
+            outputMemory[i].reset((float*)MNNMemoryAllocAlign(outputSizes[i] * sizeof(float), MNN_MEMORY_ALIGN_DEFAULT), MNNMemoryFreeAlign);
+            if (!net->bindOutput(i, outputMemory[i].get(), outputSizes[i] * sizeof(float))) {
+                MNN_ERROR("BindOutputTest bind output %d failed\n", i);
+                return false;
+            }
+        }
+        auto check = [&](int t, bool bound) {
+            for (int i = 0; i < inputSize; ++i) {
+                inputMemory.get()[i] = (float)((i + t * 3) % 13 - 6) / 6.0f;
+            }
+            Variable::Info info;
+            info.dim = {1, ic, h, w};
+            info.order = NCHW;
+            info.type = halide_type_of<float>();
+            info.size = (int)inputSize;
+            auto x = Variable::create(Expr::create(std::move(info), inputMemory.get(), VARP::INPUT, Expr::REF));
+            auto outputs = net->onForward({x});
+            auto expectX = _Input({1, ic, h, w}, NCHW, halide_type_of<float>());
+            ::memcpy(expectX->writeMap<float>(), inputMemory.get(), inputSize * sizeof(float));
+            auto expects = expectNet->onForward({expectX});
+            if (outputs.size() != 2 || expects.size() != 2) {
+                return false;
+            }
+            for (int u = 0; u < 2; ++u) {
+                auto ptr = outputs[u]->readMap<float>();
+                auto expectPtr = expects[u]->readMap<float>();
+                if (bound != (ptr == outputMemory[u].get())) {
+                    MNN_ERROR("BindOutputTest output %d bound state error\n", u);
+                    return false;
+                }
+                for (int i = 0; i < outputSizes[u]; ++i) {
+                    if (fabsf(ptr[i] - expectPtr[i]) > 0.001f) {
+                        MNN_ERROR("BindOutputTest output %d error at %d: %f - %f\n", u, i, ptr[i], expectPtr[i]);
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+        if (!check(0, true) || !check(1, true)) {
+            return false;
+        }
+        // Unbind, the outputs use the module's memory again
+        net->bindOutput(0, nullptr, 0);
+        net->bindOutput(1, nullptr, 0);
+        return check(2, false);
+    }
+};
+MNNTestSuiteRegister(BindOutputTest, "expr/BindOutputTest");
@@ -0,0 +1,116 @@
+//
+//  ActivationAccuracyTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/04/02.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+// Compare the activations with long double reference by ulp over a dense sweep of the input range
+class ActivationAccuracyTest : public MNNTestCase {
+public:
+    static std::vector<float> makeInput(float minValue, float maxValue) {
+        std::vector<float> values = {0.0f, -0.0f, 1e-30f, -1e-30f, 1e-7f, -1e-7f};
+        for (float x = minValue; x <= maxValue;) {
+            values.emplace_back(x);
+            x = fmaxf(nextafterf(x, maxValue + 1.0f), x + fmaxf(fabsf(x) * 1e-4f, 1e-6f));
+        }
+        return values;
+    }
+    static int64_t ordered(float v) {
+        int32_t i;
+        ::memcpy(&i, &v, sizeof(int32_t));
+        return i < 0 ? -(int64_t)(i & 0x7fffffff) : i;
+    }
+    static bool check(const char* name, const std::vector<float>& input, const float* output, std::function<long double(long double)> reference, int maxUlp, int precision) {
+        for (int i = 0; i < input.size(); ++i) {
+            auto expect = reference(input[i]);
+            bool valid;
+            if (precision == BackendConfig::Precision_Low) {
+                valid = fabsl(output[i] - expect) <= 1e-2L * fabsl(expect) + 1e-4L;
+            } else if (fabsl(expect) < 1e-30L) {
+                // Denormal results are checked by absolute error
+                valid = fabsl(output[i] - expect) <= 1e-35L;
+            } else {
+                valid = llabs(ordered(output[i]) - ordered((float)expect)) <= maxUlp;
+            }
+            if (!valid) {
+                MNN_ERROR("%s error at x = %.9g: %.9g - %.9g\n", name, input[i], output[i], (double)expect);
+                return false;
+            }
+        }
+        return true;
+    }
+    static VARP _GeluStandard(VARP x) {
+        std::unique_ptr<OpT> op(new OpT);
+        op->type       = OpType_UnaryOp;
+        op->main.type  = OpParameter_UnaryOp;
+        op->main.value = new UnaryOpT;
+        op->main.AsUnaryOp()->opType = UnaryOpOperation_GELU_STANDARD;
+        return Variable::create(Expr::create(op.get(), {x}));
+    }
+    static bool testUnary(const char* name, VARP (*opFunc)(VARP), std::function<long double(long double)> reference, float minValue, float maxValue, int maxUlp, int precision) {
+        auto values = makeInput(minValue, maxValue);
+        auto x = _Input({(int)values.size()}, NCHW, halide_type_of<float>());
+        ::memcpy(x->writeMap<float>(), values.data(), values.size() * sizeof(float));
+        auto y = opFunc(x);
+        auto ptr = y->readMap<float>();
+        if (nullptr == ptr) {
+            MNN_ERROR("%s compute error\n", name);
+            return false;
+        }
+        return check(name, values, ptr, reference, maxUlp, precision);
+    }
+    static bool testSiLU(int precision) {
+        // SiLU has no unary op, x * sigmoid(x) after convolution is computed by the epilogue of convolution
+        auto values = makeInput(-100.0f, 100.0f);
+        auto x = _Input({1, 1, 1, (int)values.size()}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        // Two output channels for convolution instead of depthwise, the first is the identity of x
+        auto c = _Conv(std::vector<float>{1.0f, 1.0f}, std::vector<float>{0.0f, 0.0f}, x, {1, 2}, {1, 1});
+        auto y = _Convert(_Multiply(c, _Sigmoid(c)), NCHW);
+        y->setName("y");
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        builderOutput.Finish(MNN::Net::Pack(builderOutput, net.get()));
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        BackendConfig backendConfig;
+        backendConfig.precision = (BackendConfig::PrecisionMode)precision;
+        config.backendConfig = &backendConfig;
+        interp->setSessionMode(Interpreter::Session_Release);
+        auto session = interp->createSession(config);
+        auto input = interp->getSessionInput(session, "x");
+        std::shared_ptr<Tensor> host(new Tensor(input, Tensor::CAFFE));
+        ::memcpy(host->host<float>(), values.data(), values.size() * sizeof(float));
+        input->copyFromHostTensor(host.get());
+        interp->runSession(session);
+        std::shared_ptr<Tensor> output(Tensor::createHostTensorFromDevice(interp->getSessionOutput(session, "y"), true));
+        return check("SiLU", values, output->host<float>(), [](long double v) { return v / (1.0L + expl(-v)); }, 4, precision);
+    }
+    virtual bool run(int precision) {
+        if (!testUnary("Erf", _Erf, [](long double v) { return erfl(v); }, -12.0f, 12.0f, 4, precision)) {
+            return false;
+        }
+        if (!testUnary("Erfc", _Erfc, [](long double v) { return erfcl(v); }, -12.0f, 12.0f, 8, precision)) {
+            return false;
+        }
+        if (!testUnary("GeluStandard", _GeluStandard, [](long double v) { return 0.5L * v * erfcl(-v / sqrtl(2.0L)); }, -20.0f, 20.0f, 8, precision)) {
+            return false;
+        }
+        return testSiLU(precision);
+    }
+};
+MNNTestSuiteRegister(ActivationAccuracyTest, "op/activation_accuracy");
@@ -836,6 +836,25 @@ protected:
             MNN_ERROR("Error in pick up case 3.\n");
             return false;
         }
+        // Larger winograd units for small output with many channels: F(6,3) / F(4,3) / F(4,5)
+        succ =
+            ConvolutionType().test(type, device_name, "Conv2D", 1, 48, 40, 36, 36, PadMode_CAFFE, 1, 1, 3, 3, 1, 1, 1, precision, sparseAlgo, 1, false);
+        if (!succ) {
+            MNN_ERROR("Error in pick up case 4.\n");
+            return false;
+        }
+        succ =
+            ConvolutionType().test(type, device_name, "Conv2D", 2, 64, 48, 7, 7, PadMode_CAFFE, 1, 1, 3, 3, 1, 1, 1, precision, sparseAlgo, 1, false);
+        if (!succ) {
+            MNN_ERROR("Error in pick up case 5.\n");
+            return false;
+        }
+        succ =
+            ConvolutionType().test(type, device_name, "Conv2D", 1, 72, 40, 14, 14, PadMode_CAFFE, 2, 2, 5, 5, 1, 1, 1, precision, sparseAlgo, 1, false);
+        if (!succ) {
+            MNN_ERROR("Error in pick up case 6.\n");
+            return false;
+        }
 
         return true;
     }
@@ -928,6 +947,25 @@ protected:
                 }
             }
         }
+        // 5x5 / 7x7 kernels of MobileNetV3 / EfficientNet / ConvNeXt, the width covers the blocks of 8, 4 and 1
+        for (int k = 5; k <= 7; k += 2) {
+            for (int oc = 8; oc <= 24; oc += 16) {
+                for (int is = k; is <= 30; is += 5) {
+                    for (int d = 1; d <= 2; d++) {
+                        for (int s = 1; s <= 3; s++) {
+                            for (int p = 0; p <= k / 2 * d; p += k / 2) {
+                                bool succ = ConvolutionCommonTest().test(type, device_name, "DepthwiseConv2D", 1, oc, oc, is, is + 3, PadMode_CAFFE,
+                                                                         p, p, k, k, s, d, oc, precision);
+                                if (!succ) {
+                                    MNN_ERROR("Error for dw oc=%d, ih=%d, iw=%d, k=%d, d=%d, s=%d, p=%d\n", oc, is, is + 3, k, d, s, p);
+                                    return false;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
         // memory leak unit test
         int b = 1, oc = 4, ic = oc, group = oc, is = 2, p = 1, kh = 3, kw = 3, s = 2, d = 1;
         return ConvolutionCommonTest().test(type, device_name, "DepthwiseConv2D", b, ic, oc, is, is,
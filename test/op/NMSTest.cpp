@@ -0,0 +1,142 @@
+//
+//  NMSTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/27.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/expr/Expr.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <math.h>
+#include <algorithm>
+#include <random>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+// Greedy NMS by definition
+static std::vector<int> _referenceNMS(const float* boxes, const float* scores, int numBoxes, int maxDetections, float iouThreshold, float scoreThreshold) {
+    std::vector<int> order;
+    for (int i = 0; i < numBoxes; ++i) {
+        if (scores[i] > scoreThreshold) {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [scores](int a, int b) { return scores[a] > scores[b]; });
+    auto iou = [boxes](int i, int j) {
+        auto a = boxes + i * 4, b = boxes + j * 4;
+        float areaA = (a[2] - a[0]) * (a[3] - a[1]);
+        float areaB = (b[2] - b[0]) * (b[3] - b[1]);
+        if (areaA <= 0 || areaB <= 0) {
+            return 0.0f;
+        }
+        float h = std::max(std::min(a[2], b[2]) - std::max(a[0], b[0]), 0.0f);
+        float w = std::max(std::min(a[3], b[3]) - std::max(a[1], b[1]), 0.0f);
+        return h * w / (areaA + areaB - h * w);
+    };
+    std::vector<int> selected;
+    for (auto i : order) {
+        if (selected.size() >= maxDetections) {
+            break;
+        }
+        bool keep = true;
+        for (auto j : selected) {
+            if (iou(i, j) > iouThreshold) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            selected.push_back(i);
+        }
+    }
+    return selected;
+}
+
+class NMSTest : public MNNTestCase {
+public:
+    virtual ~NMSTest() = default;
+    virtual bool run(int precision) {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<float> pos(0.0f, 1.0f);
+        std::uniform_real_distribution<float> len(0.01f, 0.2f);
+        std::vector<std::tuple<int, int, float, float>> cases = {
+            {10, 5, 0.5f, 0.0f},
+            {1000, 100, 0.5f, 0.3f},
+            {12000, 300, 0.6f, 0.05f},
+            {12000, 12000, 0.3f, 0.5f},
+        };
+        for (auto& c : cases) {
+            int numBoxes = std::get<0>(c);
+            int maxDetections = std::get<1>(c);
+            float iouThreshold = std::get<2>(c), scoreThreshold = std::get<3>(c);
+            auto boxes = _Input({numBoxes, 4}, NCHW);
+            auto scores = _Input({numBoxes}, NCHW);
+            auto boxPtr = boxes->writeMap<float>();
+            auto scorePtr = scores->writeMap<float>();
+            for (int i = 0; i < numBoxes; ++i) {
+                float y = pos(gen), x = pos(gen);
+                boxPtr[4 * i + 0] = y;
+                boxPtr[4 * i + 1] = x;
+                boxPtr[4 * i + 2] = y + len(gen);
+                boxPtr[4 * i + 3] = x + len(gen);
+                // Quantized for the same scores
+                scorePtr[i] = (float)((int)(pos(gen) * 100.0f)) / 100.0f;
+            }
+            auto expected = _referenceNMS(boxPtr, scorePtr, numBoxes, maxDetections, iouThreshold, scoreThreshold);
+            auto output = _Nms(boxes, scores, maxDetections, iouThreshold, scoreThreshold);
+            auto outputPtr = output->readMap<int>();
+            auto size = output->getInfo()->size;
+            for (int i = 0; i < size; ++i) {
+                int expect = i < expected.size() ? expected[i] : -1;
+                if (outputPtr[i] != expect) {
+                    MNN_ERROR("NMS test failed for %d boxes at %d: %d - %d\n", numBoxes, i, outputPtr[i], expect);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(NMSTest, "op/NMS");
+
+class DetectionPostProcessTest : public MNNTestCase {
+public:
+    virtual ~DetectionPostProcessTest() = default;
+    virtual bool run(int precision) {
+        // Anchors of unit size, box encodings are zero, so the boxes are the anchors
+        const int numAnchors = 6, numClasses = 2;
+        const float anchors[] = {
+            0.5f, 0.5f, 1.0f, 1.0f, 0.5f, 0.55f, 1.0f, 1.0f, 0.5f, 5.0f, 1.0f, 1.0f,
+            0.5f, 5.05f, 1.0f, 1.0f, 5.0f, 0.5f, 1.0f, 1.0f, 5.0f, 5.0f, 1.0f, 1.0f,
+        };
+        // Background + 2 classes
+        const float classScores[] = {
+            0.0f, 0.9f, 0.1f, 0.0f, 0.8f, 0.7f, 0.0f, 0.1f, 0.6f,
+            0.0f, 0.2f, 0.95f, 0.0f, 0.05f, 0.01f, 0.0f, 0.3f, 0.4f,
+        };
+        auto boxEncodings = _Const(0.0f, {1, numAnchors, 4}, NCHW);
+        auto classPredictions = _Const(classScores, {1, numAnchors, numClasses + 1}, NCHW);
+        auto anchorVar = _Const(anchors, {numAnchors, 4}, NCHW);
+        auto res = _DetectionPostProcess(boxEncodings, classPredictions, anchorVar, numClasses, 4, 1, 2, 0.25f, 0.5f, true, {10.0f, 10.0f, 5.0f, 5.0f});
+        // Class 0: anchor 0 (0.9), anchor 1 is suppressed by it, anchor 5 (0.3)
+        // Class 1: anchor 3 (0.95), anchor 1 (0.7), then 2 detections per class is reached
+        const float expectClasses[] = {1.0f, 0.0f, 1.0f, 0.0f};
+        const float expectScores[]  = {0.95f, 0.9f, 0.7f, 0.3f};
+        auto classes = res[1]->readMap<float>();
+        auto scores  = res[2]->readMap<float>();
+        auto number  = res[3]->readMap<float>();
+        if (nullptr == classes || (int)number[0] != 4) {
+            MNN_ERROR("DetectionPostProcess regular NMS number error\n");
+            return false;
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (classes[i] != expectClasses[i] || fabsf(scores[i] - expectScores[i]) > 1e-6f) {
+                MNN_ERROR("DetectionPostProcess regular NMS error at %d: %f, %f\n", i, classes[i], scores[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(DetectionPostProcessTest, "op/DetectionPostProcess");
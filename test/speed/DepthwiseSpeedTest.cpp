@@ -0,0 +1,149 @@
+//
+//  DepthwiseSpeedTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/04/10.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <MNN/AutoTime.hpp>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+// The 5x5 / 7x7 depthwise layers of MobileNetV3, EfficientNet and ConvNeXt, and MobileNetV3 in benchmark/models
+class DepthwiseSpeedTest : public MNNTestCase {
+public:
+    enum Activation {
+        NONE = 0,
+        RELU6,
+        HARDSWISH,
+    };
+    struct Layer {
+        const char* name;
+        int channel;
+        int size;
+        int kernel;
+        int stride;
+        int dilate;
+        Activation activation;
+    };
+    static float timeSession(Interpreter* net, Session* session, int loop) {
+        // Warm up
+        net->runSession(session);
+        Timer _t;
+        for (int i = 0; i < loop; ++i) {
+            net->runSession(session);
+        }
+        return (float)_t.durationInUs() / 1000.0f / (float)loop;
+    }
+    static float timeLayer(const Layer& layer, int loop) {
+        auto c = layer.channel;
+        auto x = _Input({1, c, layer.size, layer.size}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(c * layer.kernel * layer.kernel), bias(c);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 17 - 8) / 64.0f;
+        }
+        for (int i = 0; i < c; ++i) {
+            bias[i] = (float)(i % 5 - 2) / 4.0f;
+        }
+        int pad = (layer.kernel - 1) * layer.dilate / 2;
+        auto y = _Conv(std::move(weight), std::move(bias), x, {c, c}, {layer.kernel, layer.kernel}, CAFFE,
+                       {layer.stride, layer.stride}, {layer.dilate, layer.dilate}, c, {pad, pad}, false, RELU6 == layer.activation);
+        if (HARDSWISH == layer.activation) {
+            y = _Hardswish(y);
+        }
+        y->setName("y");
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        builder.Finish(Net::Pack(builder, net.get()));
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto session = interp->createSession(config);
+        return timeSession(interp.get(), session, loop);
+    }
+    // The models in benchmark/models have no weight, fill them as tools/cpp/revertMNNModel.cpp
+    static std::shared_ptr<Interpreter> loadBenchmarkModel(const char* fileName) {
+        std::shared_ptr<Interpreter> net;
+        auto file = fopen(fileName, "rb");
+        if (nullptr == file) {
+            return net;
+        }
+        std::vector<char> buffer;
+        char temp[4096];
+        size_t size;
+        while ((size = fread(temp, 1, sizeof(temp), file)) > 0) {
+            buffer.insert(buffer.end(), temp, temp + size);
+        }
+        fclose(file);
+        auto netT = UnPackNet(buffer.data());
+        for (auto& op : netT->oplists) {
+            if (op->type == OpType_Convolution || op->type == OpType_ConvolutionDepthwise) {
+                auto param = op->main.AsConvolution2D();
+                auto& common = param->common;
+                if (!param->weight.empty() || nullptr != param->quanParameter) {
+                    continue;
+                }
+                param->weight.resize(common->outputCount / common->group * common->inputCount * common->kernelX * common->kernelY);
+                for (int i = 0; i < param->weight.size(); ++i) {
+                    param->weight[i] = (float)(i % 17 - 8) / 64.0f;
+                }
+                param->bias.resize(common->outputCount, 0.1f);
+            } else if (op->type == OpType_Scale) {
+                auto param = op->main.AsScale();
+                param->scaleData.resize(param->channels, 1.0f);
+                param->biasData.resize(param->channels, 0.0f);
+            }
+        }
+        flatbuffers::FlatBufferBuilder builder(1024);
+        builder.Finish(Net::Pack(builder, netT.get()));
+        net.reset(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        return net;
+    }
+    static bool timeModel(const char* fileName, int loop) {
+        auto net = loadBenchmarkModel(fileName);
+        if (nullptr == net) {
+            return false;
+        }
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto session = net->createSession(config);
+        MNN_PRINT("%s: avg time = %f ms\n", fileName, timeSession(net.get(), session, loop));
+        return true;
+    }
+    virtual bool run(int precision) {
+        const Layer layers[] = {
+            {"MobileNetV3 5x5 s2", 72, 56, 5, 2, 1, NONE},
+            {"MobileNetV3 5x5 s1", 120, 28, 5, 1, 1, NONE},
+            {"MobileNetV3 5x5 s2 hardswish", 672, 14, 5, 2, 1, HARDSWISH},
+            {"MobileNetV3 5x5 s1 hardswish", 960, 7, 5, 1, 1, HARDSWISH},
+            {"EfficientNet 5x5 s2 relu6", 144, 56, 5, 2, 1, RELU6},
+            {"EfficientNet 5x5 s1 relu6", 480, 14, 5, 1, 1, RELU6},
+            {"ConvNeXt 7x7 s1", 96, 56, 7, 1, 1, NONE},
+            {"ConvNeXt 7x7 s1", 384, 14, 7, 1, 1, NONE},
+            {"Dilated 5x5 d2 relu6", 120, 28, 5, 1, 2, RELU6},
+            {"Dilated 7x7 s2 d2 hardswish", 64, 56, 7, 2, 2, HARDSWISH},
+        };
+        const int loop = 200;
+        for (auto& layer : layers) {
+            MNN_PRINT("%s: c=%d, %dx%d, avg time = %f ms\n", layer.name, layer.channel, layer.size, layer.size, timeLayer(layer, loop));
+        }
+        const char* models[] = {"benchmark/models/mobilenetV3.mnn", "../benchmark/models/mobilenetV3.mnn"};
+        for (auto model : models) {
+            if (timeModel(model, loop)) {
+                return true;
+            }
+        }
+        MNN_PRINT("Skip mobilenetV3.mnn: can't find benchmark/models, run in the root or build directory of MNN\n");
+        return true;
+    }
+};
+MNNTestSuiteRegister(DepthwiseSpeedTest, "speed/depthwise");
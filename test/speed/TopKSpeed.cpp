@@ -0,0 +1,95 @@
+//
+//  TopKSpeed.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/03/27.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/expr/Expr.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/AutoTime.hpp>
+#include <algorithm>
+#include <random>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+#define TIME 20
+class TopKSpeed : public MNNTestCase {
+public:
+    static std::vector<VARP> _TopK(VARP x, VARP k, bool largest) {
+        std::unique_ptr<MNN::OpT> op(new MNN::OpT);
+        op->type       = MNN::OpType_TopKV2;
+        op->main.type  = MNN::OpParameter_TopKV2;
+        auto param     = new MNN::TopKV2T;
+        param->largest = largest;
+        op->main.value = param;
+        auto expr = Expr::create(std::move(op), {x, k}, 2);
+        return {Variable::create(expr, 0), Variable::create(expr, 1)};
+    }
+    // Check the values with partial_sort, and the indices point to the values
+    static bool check(const float* input, const float* values, const int* indices, int rows, int rowSize, int k, bool largest) {
+        std::vector<float> row(rowSize);
+        for (int y = 0; y < rows; ++y) {
+            auto src = input + y * rowSize;
+            ::memcpy(row.data(), src, rowSize * sizeof(float));
+            if (largest) {
+                std::partial_sort(row.begin(), row.begin() + k, row.end(), std::greater<float>());
+            } else {
+                std::partial_sort(row.begin(), row.begin() + k, row.end());
+            }
+            for (int i = 0; i < k; ++i) {
+                auto value = values[y * k + i];
+                auto index = indices[y * k + i];
+                if (value != row[i] || index < 0 || index >= rowSize || src[index] != value) {
+                    MNN_ERROR("TopK error at row %d, %d: %f - %f\n", y, i, value, row[i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    bool test(int rows, int rowSize, int k, bool largest) {
+        auto x = _Input({rows, rowSize}, NCHW, halide_type_of<float>());
+        auto res = _TopK(x, _Scalar<int>(k), largest);
+        std::mt19937 gen(rows * 31 + k);
+        std::uniform_real_distribution<float> dis(-10.0f, 10.0f);
+        auto ptr = x->writeMap<float>();
+        for (int i = 0; i < rows * rowSize; ++i) {
+            // Quantized to have the same values
+            ptr[i] = (float)((int)(dis(gen) * 1000.0f)) / 1000.0f;
+        }
+        std::vector<float> input(ptr, ptr + rows * rowSize);
+        if (!check(input.data(), res[0]->readMap<float>(), res[1]->readMap<int>(), rows, rowSize, k, largest)) {
+            MNN_ERROR("TopK test failed for rows:%d, size:%d, k:%d\n", rows, rowSize, k);
+            return false;
+        }
+        MNN::Timer _t;
+        for (int i = 0; i < TIME; ++i) {
+            x->writeMap<float>();
+            res[0]->readMap<float>();
+        }
+        float cost = (float)_t.durationInUs() / 1000.0f / (float)TIME;
+        MNN_PRINT("Test Speed for TopK rows:%d, size:%d, k:%d, run %d, avgtime: %f ms\n", rows, rowSize, k, TIME, cost);
+        return true;
+    }
+    virtual bool run(int precision) {
+        std::vector<std::tuple<int, int, int>> cases = {
+            {1, 151936, 1},
+            {1, 151936, 10},
+            {1, 151936, 50},
+            {1, 151936, 1000},
+            {1, 151936, 40000},
+            {16, 32000, 40},
+            {64, 4096, 256},
+            {128, 100, 100},
+        };
+        for (auto& iter : cases) {
+            if (!test(std::get<0>(iter), std::get<1>(iter), std::get<2>(iter), true)) {
+                return false;
+            }
+        }
+        return test(4, 50000, 20, false) && test(2, 50000, 3000, false);
+    }
+};
+MNNTestSuiteRegister(TopKSpeed, "speed/TopK");
@@ -0,0 +1,81 @@
+//
+//  WinogradSpeedTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2024/04/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <MNN/AutoTime.hpp>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+// The 3x3 convolutions of ResNet-50 / VGG-16 and 5x5 convolutions, which choose winograd on CPU
+class WinogradSpeedTest : public MNNTestCase {
+public:
+    struct Layer {
+        const char* name;
+        int ic;
+        int oc;
+        int size;
+        int kernel;
+    };
+    static float timeLayer(const Layer& layer, int loop) {
+        auto x = _Input({1, layer.ic, layer.size, layer.size}, NC4HW4, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(layer.oc * layer.ic * layer.kernel * layer.kernel), bias(layer.oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 17 - 8) / 64.0f;
+        }
+        for (int i = 0; i < layer.oc; ++i) {
+            bias[i] = (float)(i % 5 - 2) / 4.0f;
+        }
+        auto y = _Conv(std::move(weight), std::move(bias), x, {layer.ic, layer.oc}, {layer.kernel, layer.kernel}, SAME,
+                       {1, 1}, {1, 1}, 1, {0, 0}, false, true);
+        y->setName("y");
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        builder.Finish(Net::Pack(builder, net.get()));
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto session = interp->createSession(config);
+        // Warm up
+        interp->runSession(session);
+        Timer _t;
+        for (int i = 0; i < loop; ++i) {
+            interp->runSession(session);
+        }
+        return (float)_t.durationInUs() / 1000.0f / (float)loop;
+    }
+    virtual bool run(int precision) {
+        const Layer layers[] = {
+            {"ResNet-50 3x3", 64, 64, 56, 3},
+            {"ResNet-50 3x3", 128, 128, 28, 3},
+            {"ResNet-50 3x3", 256, 256, 14, 3},
+            {"ResNet-50 3x3", 512, 512, 7, 3},
+            {"VGG-16 3x3", 128, 128, 112, 3},
+            {"VGG-16 3x3", 256, 256, 56, 3},
+            {"VGG-16 3x3", 512, 512, 28, 3},
+            {"VGG-16 3x3", 512, 512, 14, 3},
+            {"5x5", 64, 64, 28, 5},
+            {"5x5", 192, 192, 14, 5},
+        };
+        const int loop = 10;
+        for (auto& layer : layers) {
+            float flops = 2.0f * layer.ic * layer.oc * layer.kernel * layer.kernel * layer.size * layer.size / 1000000.0f;
+            auto time = timeLayer(layer, loop);
+            MNN_PRINT("%s: %d -> %d, %dx%d, avg time = %f ms, %.2f GFLOPS\n", layer.name, layer.ic, layer.oc, layer.size, layer.size,
+                      time, flops / time);
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(WinogradSpeedTest, "speed/winograd");
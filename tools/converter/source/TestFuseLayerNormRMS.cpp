@@ -0,0 +1,126 @@
+//
+//  TestFuseLayerNormRMS.cpp
+//  MNNConverter
+//
+//  Created by MNN on 2024/03/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <iostream>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNN_generated.h"
+#include "PostConverter.hpp"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+// weight * rms_norm(x) along the last axis, as exported by the frameworks
+static VARP _buildRMSNorm(VARP x, VARP weight) {
+    auto square = _Pow(x, _Scalar<float>(2.0f));
+    auto norm   = x * _Rsqrt(_ReduceMean(square, {-1}, true) + _Scalar<float>(1e-6f));
+    return norm * weight;
+}
+
+static void _fillInput(VARP x) {
+    auto size = x->getInfo()->size;
+    auto ptr  = x->writeMap<float>();
+    for (int i = 0; i < size; ++i) {
+        ptr[i] = (float)(i % 13 - 6) / 6.0f;
+    }
+}
+
+// Converts the graph of y with the converter passes, returns the LayerNorm op
+// of the result if any, and the output of the converted graph in result
+static const LayerNormT* _convert(VARP x, VARP y, std::vector<float>& result, std::unique_ptr<NetT>& optimized) {
+    x->setName("x");
+    y->setName("y");
+    std::unique_ptr<NetT> net(new NetT);
+    Variable::save({y}, net.get());
+    net->sourceType = NetSource_ONNX;
+    net->outputName = {"y"};
+    modelConfig config;
+    config.keepInputFormat = true;
+    optimized = optimizeNet(net, false, config);
+    const LayerNormT* layerNorm = nullptr;
+    for (auto& op : optimized->oplists) {
+        if (op->type == OpType_LayerNorm) {
+            layerNorm = op->main.AsLayerNorm();
+        }
+    }
+    flatbuffers::FlatBufferBuilder builder(1024);
+    builder.Finish(Net::Pack(builder, optimized.get()));
+    auto vars   = Variable::loadMap(builder.GetBufferPointer(), builder.GetSize());
+    auto input  = vars["x"];
+    auto output = vars["y"];
+    if (nullptr == input || nullptr == output) {
+        return layerNorm;
+    }
+    _fillInput(input);
+    auto ptr = output->readMap<float>();
+    if (nullptr != ptr) {
+        result.assign(ptr, ptr + output->getInfo()->size);
+    }
+    return layerNorm;
+}
+
+static bool _checkResult(const std::vector<float>& result, const std::vector<float>& expect, const char* name) {
+    if (result.size() != expect.size()) {
+        std::cout << name << ": compute error" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < expect.size(); ++i) {
+        if (fabsf(result[i] - expect[i]) > 0.001f) {
+            std::cout << name << ": error at " << i << ", " << result[i] << " - " << expect[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const int batch = 3, channel = 8;
+    bool res = true;
+    {
+        // A weight with a value for each channel is folded into the gamma
+        std::vector<float> weight(channel);
+        for (int i = 0; i < channel; ++i) {
+            weight[i] = (float)(i + 1) / 4.0f;
+        }
+        auto x = _Input({batch, channel}, NCHW, halide_type_of<float>());
+        _fillInput(x);
+        auto y   = _buildRMSNorm(x, _Const(weight.data(), {channel}, NCHW));
+        auto ptr = y->readMap<float>();
+        std::vector<float> expect(ptr, ptr + y->getInfo()->size);
+        std::vector<float> result;
+        std::unique_ptr<NetT> net;
+        auto layerNorm = _convert(x, y, result, net);
+        if (nullptr == layerNorm || layerNorm->gamma.size() != channel) {
+            std::cout << "FuseLayerNormRMSGamma: the weight of each channel is not folded" << std::endl;
+            res = false;
+        }
+        res = _checkResult(result, expect, "FuseLayerNormRMSGamma") && res;
+    }
+    {
+        // A [1] weight is broadcast to all channels, it must not become a gamma of size 1
+        float scale = 1.5f;
+        auto x = _Input({batch, channel}, NCHW, halide_type_of<float>());
+        _fillInput(x);
+        auto y   = _buildRMSNorm(x, _Const(&scale, {1}, NCHW));
+        auto ptr = y->readMap<float>();
+        std::vector<float> expect(ptr, ptr + y->getInfo()->size);
+        std::vector<float> result;
+        std::unique_ptr<NetT> net;
+        auto layerNorm = _convert(x, y, result, net);
+        if (nullptr != layerNorm && layerNorm->gamma.size() == 1) {
+            std::cout << "FuseLayerNormRMSGamma: the [1] weight is folded as gamma" << std::endl;
+            res = false;
+        }
+        res = _checkResult(result, expect, "FuseLayerNormRMSGamma [1] weight") && res;
+    }
+    if (!res) {
+        return 1;
+    }
+    std::cout << "TestFuseLayerNormRMS passed" << std::endl;
+    return 0;
+}
@@ -115,5 +115,90 @@ FuseLayerNormRMS::FuseLayerNormRMS() {
 
 static FuseLayerNormRMS g_fuse_layer_norm_rms;
 
+// Fold the multiply by weight after rms norm: weight * norm(x), so the whole rms norm is one LayerNorm and the residual add
+// before it can be fused by the runtime
+class FuseLayerNormRMSGamma {
+public:
+    FuseLayerNormRMSGamma();
+
+private:
+    EXPRP norm_;
+    VARP gamma_var_;
+};
+
+FuseLayerNormRMSGamma::FuseLayerNormRMSGamma() {
+    auto match = [this](EXPRP expr) -> bool {
+        if (!expr->get() || !helpers::IsBinaryMul(expr)) {
+            return false;
+        }
+        for (int i = 0; i < 2; ++i) {
+            EXPRP norm  = expr->inputs().at(i)->expr().first;
+            EXPRP gamma = expr->inputs().at(1 - i)->expr().first;
+            if (!norm->get() || norm->get()->type() != OpType_LayerNorm || !helpers::IsConstant(gamma) || norm->outputs().size() != 1) {
+                continue;
+            }
+            auto param = norm->get()->main_as_LayerNorm();
+            if (nullptr == param || !param->useRMSNorm() || nullptr != param->gamma() || nullptr != param->beta() || nullptr != param->external()) {
+                continue;
+            }
+            if (nullptr == param->axis() || param->axis()->size() != 1 || param->group() != 1) {
+                continue;
+            }
+            // The norm is along the last axis, and the weight has one value for each position of it. A scalar or [1]
+            // weight broadcast to the axis, or a weight broadcasting the norm, can't be the gamma
+            auto normInfo = expr->inputs().at(i)->getInfo();
+            if (nullptr == normInfo || normInfo->dim.empty()) {
+                continue;
+            }
+            int normRank = (int)normInfo->dim.size();
+            int normAxis = param->axis()->data()[0];
+            if (normAxis != -1 && normAxis != normRank - 1) {
+                continue;
+            }
+            auto info = expr->inputs().at(1 - i)->getInfo();
+            if (nullptr == info || info->type != halide_type_of<float>() || info->dim.empty() || info->dim.size() > normInfo->dim.size()) {
+                continue;
+            }
+            int channel = normInfo->dim[normRank - 1];
+            if (info->size != channel || info->dim[info->dim.size() - 1] != channel) {
+                continue;
+            }
+            norm_      = norm;
+            gamma_var_ = expr->inputs().at(1 - i);
+            return true;
+        }
+        return false;
+    };
+
+    auto fold = [this](EXPRP expr) -> bool {
+        auto param = norm_->get()->main_as_LayerNorm();
+        const float* gamma = gamma_var_->readMap<float>();
+        if (nullptr == gamma) {
+            return false;
+        }
+        int size = gamma_var_->getInfo()->size;
+        std::unique_ptr<MNN::LayerNormT> layer_norm(new MNN::LayerNormT);
+        layer_norm->axis.assign(param->axis()->begin(), param->axis()->end());
+        layer_norm->epsilon = param->epsilon();
+        layer_norm->useRMSNorm = true;
+        layer_norm->gamma.assign(gamma, gamma + size);
+        layer_norm->beta.resize(size, 0.0f);
+
+        std::unique_ptr<OpT> layer_norm_op(new OpT);
+        layer_norm_op->name       = expr->name();
+        layer_norm_op->type       = OpType_LayerNorm;
+        layer_norm_op->main.type  = OpParameter_LayerNorm;
+        layer_norm_op->main.value = layer_norm.release();
+
+        EXPRP layer_norm_expr = Expr::create(layer_norm_op.get(), {norm_->inputs().at(0)}, 1);
+        layer_norm_expr->setName(expr->name());
+        Expr::replace(expr, layer_norm_expr);
+        return true /*modified*/;
+    };
+    TemplateMerge::getInstance("Merge").insertTemplate("FuseLayerNormRMSGamma", match, fold);
+}
+
+static FuseLayerNormRMSGamma g_fuse_layer_norm_rms_gamma;
+
 } // namespace Express
 } // namespace MNN